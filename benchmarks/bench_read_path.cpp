@@ -0,0 +1,569 @@
+/**
+ * 读取路径端到端基准测试
+ *
+ * fork 一个本地替身进程，按配置映射若干块已知内容的内存，
+ * 然后通过 UserspaceKernelCall 的公开接口对其读取：
+ *   - ReadMemory / ReadMemoryInto：单次读取延迟（每次都重新解析 maps 校验地址）
+ *   - BatchOperations：逐个校验的批量操作
+ *   - BatchOperationsIoUring / BatchOperationsPreadv：经读取引擎的批量操作
+ *   - BatchRead：每批只解析一次 maps 的批量读取（maps 缓存路径）
+ *   - GetProcessMemoryMaps：maps 解析本身
+ *   - ProcessVmReadv：process_vm_readv 的系统调用下限，作为对照
+ *
+ * 除吞吐量外，每项报告调用线程的系统调用次数：
+ *   - syscalls/op：优先通过 perf_event_open 计数 raw_syscalls:sys_enter 跟踪点，
+ *     覆盖 process_vm_readv、io_uring_enter、ioctl、poll、openat 等全部系统调用
+ *     （需要可访问 tracefs 且 perf_event_paranoid 允许）
+ *   - io_syscalls/op：跟踪点不可用时退回 /proc/self/io 的 syscr + syscw，
+ *     只包含 read/write 类系统调用
+ *   两者都只统计调用线程，执行器工作线程上的系统调用不计入。
+ *
+ * 替身进程参数（放在 Google Benchmark 参数之后）：
+ *   --mappings=N        映射数量，默认 64
+ *   --mapping-size=B    每个映射的字节数，默认 2 MiB
+ */
+
+#include "userspace_kernel_call.h"
+#include "batch_arena.h"
+#include "batch_planner.h"
+#include "process_manager.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <linux/perf_event.h>
+#include <iostream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace ukc;
+
+namespace {
+
+struct StandInConfig {
+    size_t mappings = 64;
+    size_t mappingSize = 2 << 20;
+};
+
+/**
+ * 本地替身进程
+ * 子进程映射内存、填充已知内容，通过管道传回各映射地址后阻塞，直到被结束。
+ * 每个映射后跟一个 PROT_NONE 保护页，保证在 maps 中是独立的条目。
+ */
+class StandInProcess {
+public:
+    ~StandInProcess() {
+        stop();
+    }
+
+    bool start(const StandInConfig& config) {
+        mappingSize_ = config.mappingSize;
+
+        int fds[2];
+        if (pipe(fds) != 0) {
+            return false;
+        }
+
+        pid_t parent = getpid();
+        pid_ = fork();
+        if (pid_ < 0) {
+            close(fds[0]);
+            close(fds[1]);
+            return false;
+        }
+
+        if (pid_ == 0) {
+            close(fds[0]);
+            prctl(PR_SET_PDEATHSIG, SIGKILL);
+            if (getppid() != parent) {
+                _exit(1);
+            }
+            runChild(fds[1], config);
+            _exit(0);
+        }
+
+        close(fds[1]);
+        regions_.resize(config.mappings);
+        size_t expected = regions_.size() * sizeof(uintptr_t);
+        size_t received = 0;
+        auto* out = reinterpret_cast<uint8_t*>(regions_.data());
+        while (received < expected) {
+            ssize_t n = read(fds[0], out + received, expected - received);
+            if (n <= 0) {
+                break;
+            }
+            received += static_cast<size_t>(n);
+        }
+        close(fds[0]);
+        return received == expected;
+    }
+
+    void stop() {
+        if (pid_ > 0) {
+            kill(pid_, SIGKILL);
+            waitpid(pid_, nullptr, 0);
+            pid_ = -1;
+        }
+    }
+
+    pid_t pid() const {
+        return pid_;
+    }
+
+    size_t mappingSize() const {
+        return mappingSize_;
+    }
+
+    /**
+     * 第 index 次读取的地址：轮流落在各个映射中，在映射内按 size 步进
+     */
+    uintptr_t addressFor(size_t index, size_t size) const {
+        size_t region = index % regions_.size();
+        size_t slots = std::max<size_t>(mappingSize_ / size, 1);
+        size_t offset = ((index / regions_.size()) % slots) * size;
+        return regions_[region] + offset;
+    }
+
+private:
+    pid_t pid_ = -1;
+    size_t mappingSize_ = 0;
+    std::vector<uintptr_t> regions_;
+
+    static void runChild(int fd, const StandInConfig& config) {
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        std::vector<uintptr_t> addresses;
+        addresses.reserve(config.mappings);
+
+        for (size_t i = 0; i < config.mappings; ++i) {
+            void* mapping = mmap(nullptr, config.mappingSize + page, PROT_READ | PROT_WRITE,
+                                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (mapping == MAP_FAILED) {
+                _exit(1);
+            }
+            auto* bytes = static_cast<uint8_t*>(mapping);
+            std::memset(bytes, static_cast<int>(i & 0xFF), config.mappingSize);
+            mprotect(bytes + config.mappingSize, page, PROT_NONE);
+            addresses.push_back(reinterpret_cast<uintptr_t>(bytes));
+        }
+
+        const auto* data = reinterpret_cast<const uint8_t*>(addresses.data());
+        size_t total = addresses.size() * sizeof(uintptr_t);
+        size_t written = 0;
+        while (written < total) {
+            ssize_t n = write(fd, data + written, total - written);
+            if (n <= 0) {
+                _exit(1);
+            }
+            written += static_cast<size_t>(n);
+        }
+        close(fd);
+
+        for (;;) {
+            pause();
+        }
+    }
+};
+
+StandInProcess standIn;
+UserspaceKernelCall ukcInstance;
+ProcessManager processManager;
+
+/**
+ * 读取 /proc/self/io 中的 read/write 类系统调用计数，不可用时返回 -1
+ */
+long long ioSyscalls() {
+    std::ifstream io("/proc/self/io");
+    if (!io.is_open()) {
+        return -1;
+    }
+
+    long long total = 0;
+    bool found = false;
+    std::string key;
+    long long value = 0;
+    while (io >> key >> value) {
+        if (key == "syscr:" || key == "syscw:") {
+            total += value;
+            found = true;
+        }
+    }
+    return found ? total : -1;
+}
+
+/**
+ * 读取 raw_syscalls:sys_enter 跟踪点的 id，tracefs 不可用时返回 -1
+ */
+long long sysEnterTracepointId() {
+    static const char* const paths[] = {
+        "/sys/kernel/tracing/events/raw_syscalls/sys_enter/id",
+        "/sys/kernel/debug/tracing/events/raw_syscalls/sys_enter/id",
+    };
+    for (const char* path : paths) {
+        std::ifstream file(path);
+        long long id = -1;
+        if (file >> id) {
+            return id;
+        }
+    }
+    return -1;
+}
+
+/**
+ * 调用线程的系统调用计数器
+ * 优先在 raw_syscalls:sys_enter 跟踪点上打开 perf 计数器（统计全部系统调用），
+ * 失败时退回 /proc/self/io 的 read/write 计数。
+ */
+class SyscallCounter {
+public:
+    SyscallCounter() {
+        long long id = sysEnterTracepointId();
+        if (id < 0) {
+            return;
+        }
+
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_TRACEPOINT;
+        attr.size = sizeof(attr);
+        attr.config = static_cast<uint64_t>(id);
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+    }
+
+    ~SyscallCounter() {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    SyscallCounter(const SyscallCounter&) = delete;
+    SyscallCounter& operator=(const SyscallCounter&) = delete;
+
+    /**
+     * 当前计数，不可用时返回 -1
+     */
+    long long read() const {
+        if (fd_ < 0) {
+            return ioSyscalls();
+        }
+        uint64_t value = 0;
+        if (::read(fd_, &value, sizeof(value)) != static_cast<ssize_t>(sizeof(value))) {
+            return -1;
+        }
+        return static_cast<long long>(value);
+    }
+
+    /**
+     * 计数器名：完整统计为 syscalls/op，退回路径为 io_syscalls/op
+     */
+    const char* counterName() const {
+        return fd_ >= 0 ? "syscalls/op" : "io_syscalls/op";
+    }
+
+private:
+    int fd_ = -1;
+};
+
+/**
+ * 在基准循环前后采样系统调用计数，结束时写入 syscalls/op（或 io_syscalls/op）
+ * 计数器按线程打开，基准函数在各自线程上运行，因此每次构造时重新打开。
+ */
+class SyscallMeter {
+public:
+    explicit SyscallMeter(benchmark::State& state, size_t opsPerIteration = 1)
+        : state_(state), opsPerIteration_(opsPerIteration), start_(counter_.read()) {}
+
+    ~SyscallMeter() {
+        long long end = counter_.read();
+        if (start_ < 0 || end < 0 || state_.iterations() == 0) {
+            return;
+        }
+        // 采样本身（读取计数器或 /proc/self/io）也会产生系统调用，数量固定，可忽略
+        double ops = static_cast<double>(state_.iterations()) * opsPerIteration_;
+        state_.counters[counter_.counterName()] = static_cast<double>(end - start_) / ops;
+    }
+
+private:
+    SyscallCounter counter_;
+    benchmark::State& state_;
+    size_t opsPerIteration_;
+    long long start_;
+};
+
+void reportThroughput(benchmark::State& state, size_t opsPerIteration, size_t bytesPerOp) {
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(opsPerIteration));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(opsPerIteration * bytesPerOp));
+}
+
+void BM_ReadMemory(benchmark::State& state) {
+    size_t size = static_cast<size_t>(state.range(0));
+    size_t index = 0;
+    {
+        SyscallMeter meter(state);
+        for (auto _ : state) {
+            auto result = ukcInstance.readMemory(standIn.pid(), standIn.addressFor(index++, size), size);
+            if (result.isError()) {
+                state.SkipWithError(result.errorMessage().c_str());
+                break;
+            }
+            benchmark::DoNotOptimize(result.value().data());
+        }
+    }
+    reportThroughput(state, 1, size);
+}
+
+void BM_ReadMemoryInto(benchmark::State& state) {
+    size_t size = static_cast<size_t>(state.range(0));
+    std::vector<uint8_t> buffer(size);
+    size_t index = 0;
+    {
+        SyscallMeter meter(state);
+        for (auto _ : state) {
+            auto result = ukcInstance.readMemoryInto(
+                standIn.pid(), standIn.addressFor(index++, size), buffer.data(), size
+            );
+            if (result.isError()) {
+                state.SkipWithError(result.errorMessage().c_str());
+                break;
+            }
+            benchmark::DoNotOptimize(buffer.data());
+        }
+    }
+    reportThroughput(state, 1, size);
+}
+
+std::vector<MemoryOperation> makeOperations(size_t count, size_t size) {
+    std::vector<MemoryOperation> operations(count);
+    for (size_t i = 0; i < count; ++i) {
+        operations[i].type = OperationType::Read;
+        operations[i].address = standIn.addressFor(i, size);
+        operations[i].size = size;
+    }
+    return operations;
+}
+
+void BM_BatchOperations(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+    size_t size = static_cast<size_t>(state.range(1));
+    auto operations = makeOperations(count, size);
+    {
+        SyscallMeter meter(state, count);
+        for (auto _ : state) {
+            auto result = ukcInstance.batchOperations(standIn.pid(), operations);
+            if (result.isError()) {
+                state.SkipWithError(result.errorMessage().c_str());
+                break;
+            }
+            benchmark::DoNotOptimize(operations.data());
+        }
+    }
+    reportThroughput(state, count, size);
+}
+
+void BM_BatchOperationsPlanned(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+    size_t size = static_cast<size_t>(state.range(1));
+    auto operations = makeOperations(count, size);
+    BatchPlanner planner;
+    {
+        SyscallMeter meter(state, count);
+        for (auto _ : state) {
+            auto result = ukcInstance.batchOperations(standIn.pid(), operations, planner);
+            if (result.isError()) {
+                state.SkipWithError(result.errorMessage().c_str());
+                break;
+            }
+            benchmark::DoNotOptimize(operations.data());
+        }
+    }
+    reportThroughput(state, count, size);
+}
+
+void runEngineBatch(benchmark::State& state, ReadBackend backend) {
+    size_t count = static_cast<size_t>(state.range(0));
+    size_t size = static_cast<size_t>(state.range(1));
+    auto operations = makeOperations(count, size);
+    ReadEngineConfig config;
+    config.backend = backend;
+    ReadEngine engine(config);
+    if (engine.backend() != backend) {
+        state.SkipWithError("io_uring unavailable");
+        return;
+    }
+    {
+        SyscallMeter meter(state, count);
+        for (auto _ : state) {
+            auto result = ukcInstance.batchOperations(standIn.pid(), operations, engine);
+            if (result.isError()) {
+                state.SkipWithError(result.errorMessage().c_str());
+                break;
+            }
+            benchmark::DoNotOptimize(operations.data());
+        }
+    }
+    reportThroughput(state, count, size);
+}
+
+void BM_BatchOperationsIoUring(benchmark::State& state) {
+    runEngineBatch(state, ReadBackend::IoUring);
+}
+
+void BM_BatchOperationsPreadv(benchmark::State& state) {
+    runEngineBatch(state, ReadBackend::Preadv);
+}
+
+void BM_BatchRead(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+    size_t size = static_cast<size_t>(state.range(1));
+    std::vector<BatchReadRequest> requests(count);
+    for (size_t i = 0; i < count; ++i) {
+        requests[i].address = standIn.addressFor(i, size);
+        requests[i].size = size;
+    }
+    std::vector<BatchReadResult> results;
+    BatchArena arena;
+    {
+        SyscallMeter meter(state, count);
+        for (auto _ : state) {
+            auto result = ukcInstance.batchRead(standIn.pid(), requests, results, arena);
+            if (result.isError()) {
+                state.SkipWithError(result.errorMessage().c_str());
+                break;
+            }
+            benchmark::DoNotOptimize(results.data());
+        }
+    }
+    reportThroughput(state, count, size);
+}
+
+void BM_GetProcessMemoryMaps(benchmark::State& state) {
+    {
+        SyscallMeter meter(state);
+        for (auto _ : state) {
+            auto result = ukcInstance.getProcessMemoryMaps(standIn.pid());
+            if (result.isError()) {
+                state.SkipWithError(result.errorMessage().c_str());
+                break;
+            }
+            benchmark::DoNotOptimize(result.value().data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_ProcessVmReadv(benchmark::State& state) {
+    size_t size = static_cast<size_t>(state.range(0));
+    std::vector<uint8_t> buffer(size);
+    size_t index = 0;
+    {
+        SyscallMeter meter(state);
+        for (auto _ : state) {
+            auto result = processManager.readProcessMemory(
+                standIn.pid(), standIn.addressFor(index++, size), buffer.data(), size
+            );
+            if (result.isError()) {
+                state.SkipWithError(result.errorMessage().c_str());
+                break;
+            }
+            benchmark::DoNotOptimize(buffer.data());
+        }
+    }
+    reportThroughput(state, 1, size);
+}
+
+const int64_t kSizes[] = {8, 64, 512, 4096, 65536, 1 << 20};
+const int64_t kCounts[] = {1, 10, 100, 1000, 10000, 100000};
+// 单批数据总量上限，避免 100k x 1 MiB 这样的组合耗尽内存
+const int64_t kMaxBatchBytes = 64 << 20;
+
+StandInConfig standInConfig;
+
+void singleSizes(benchmark::internal::Benchmark* bench) {
+    for (int64_t size : kSizes) {
+        if (static_cast<size_t>(size) <= standInConfig.mappingSize) {
+            bench->Arg(size);
+        }
+    }
+}
+
+void batchShapes(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"ops", "bytes"});
+    for (int64_t count : kCounts) {
+        for (int64_t size : kSizes) {
+            if (static_cast<size_t>(size) <= standInConfig.mappingSize &&
+                count * size <= kMaxBatchBytes) {
+                bench->Args({count, size});
+            }
+        }
+    }
+}
+
+void registerBenchmarks() {
+    benchmark::RegisterBenchmark("ReadMemory", BM_ReadMemory)->Apply(singleSizes);
+    benchmark::RegisterBenchmark("ReadMemoryInto", BM_ReadMemoryInto)->Apply(singleSizes);
+    benchmark::RegisterBenchmark("BatchOperations", BM_BatchOperations)->Apply(batchShapes);
+    benchmark::RegisterBenchmark("BatchOperationsPlanned", BM_BatchOperationsPlanned)->Apply(batchShapes);
+    benchmark::RegisterBenchmark("BatchOperationsIoUring", BM_BatchOperationsIoUring)->Apply(batchShapes);
+    benchmark::RegisterBenchmark("BatchOperationsPreadv", BM_BatchOperationsPreadv)->Apply(batchShapes);
+    benchmark::RegisterBenchmark("BatchRead", BM_BatchRead)->Apply(batchShapes);
+    benchmark::RegisterBenchmark("GetProcessMemoryMaps", BM_GetProcessMemoryMaps);
+    benchmark::RegisterBenchmark("ProcessVmReadv", BM_ProcessVmReadv)->Apply(singleSizes);
+}
+
+bool parseSize(const char* arg, const char* prefix, size_t& out) {
+    size_t length = std::strlen(prefix);
+    if (std::strncmp(arg, prefix, length) != 0) {
+        return false;
+    }
+    char* end = nullptr;
+    unsigned long long value = std::strtoull(arg + length, &end, 0);
+    if (end == arg + length || *end != '\0' || value == 0) {
+        return false;
+    }
+    out = static_cast<size_t>(value);
+    return true;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+
+    StandInConfig& config = standInConfig;
+    for (int i = 1; i < argc; ++i) {
+        if (!parseSize(argv[i], "--mappings=", config.mappings) &&
+            !parseSize(argv[i], "--mapping-size=", config.mappingSize)) {
+            std::cerr << "Unknown argument: " << argv[i] << std::endl;
+            std::cerr << "Usage: " << argv[0]
+                      << " [benchmark flags] [--mappings=N] [--mapping-size=BYTES]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (!standIn.start(config)) {
+        std::cerr << "Failed to start stand-in process" << std::endl;
+        return 1;
+    }
+
+    auto initResult = ukcInstance.initialize();
+    if (initResult.isError()) {
+        std::cerr << "Initialization failed: " << initResult.errorMessage() << std::endl;
+        return 1;
+    }
+
+    benchmark::AddCustomContext("stand_in_mappings", std::to_string(config.mappings));
+    benchmark::AddCustomContext("stand_in_mapping_size", std::to_string(config.mappingSize));
+    registerBenchmarks();
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    standIn.stop();
+    return 0;
+}
@@ -0,0 +1,72 @@
+#ifndef USERSPACE_KERNEL_CALL_BATCH_ARENA_H
+#define USERSPACE_KERNEL_CALL_BATCH_ARENA_H
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+namespace ukc {
+
+/**
+ * 批量读取缓冲区
+ * 连续的线性分配器，批量读取的所有结果都落在同一块内存中
+ *
+ * 两种模式：
+ * - 自有内存：reserve() 按需一次性扩容，reset() 后可复用
+ * - 调用方提供内存：不做任何堆分配，容量不足时分配失败
+ */
+class BatchArena {
+public:
+    BatchArena();
+    BatchArena(uint8_t* buffer, size_t capacity);
+    ~BatchArena();
+
+    BatchArena(const BatchArena&) = delete;
+    BatchArena& operator=(const BatchArena&) = delete;
+
+    /**
+     * 确保容量至少为 capacity 字节
+     * 仅自有内存模式会扩容，扩容会使之前分配的指针失效
+     *
+     * @return 扩容后容量是否足够
+     */
+    bool reserve(size_t capacity);
+
+    /**
+     * 分配 size 字节，容量不足时返回 nullptr
+     */
+    uint8_t* allocate(size_t size);
+
+    /**
+     * 释放所有分配（保留底层内存）
+     */
+    void reset() {
+        used_ = 0;
+    }
+
+    size_t used() const {
+        return used_;
+    }
+
+    size_t capacity() const {
+        return capacity_;
+    }
+
+    /**
+     * 是否使用调用方提供的内存
+     */
+    bool isExternal() const {
+        return external_;
+    }
+
+private:
+    std::unique_ptr<uint8_t[]> owned_;
+    uint8_t* buffer_ = nullptr;
+    size_t capacity_ = 0;
+    size_t used_ = 0;
+    bool external_ = false;
+};
+
+} // namespace ukc
+
+#endif // USERSPACE_KERNEL_CALL_BATCH_ARENA_H
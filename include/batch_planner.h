@@ -0,0 +1,103 @@
+#ifndef USERSPACE_KERNEL_CALL_BATCH_PLANNER_H
+#define USERSPACE_KERNEL_CALL_BATCH_PLANNER_H
+
+#include "data_models.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace ukc {
+
+/**
+ * 批量读取规划配置
+ */
+struct BatchPlannerConfig {
+    size_t maxGap = 64;                    // 两次读取之间允许合并的最大间隙（字节）
+    size_t maxTransferSize = 1024 * 1024;  // 合并后单次传输的最大大小（字节）
+};
+
+/**
+ * 批量读取规划统计
+ * 用于评估合并效果、调整间隙阈值
+ */
+struct BatchPlanStats {
+    size_t readOperations = 0;         // 参与合并的读操作数
+    size_t transfers = 0;              // 合并后的实际读取次数
+    size_t requestedBytes = 0;         // 各读操作请求的字节总数
+    size_t transferredBytes = 0;       // 合并后实际读取的字节总数
+    size_t fallbackTransfers = 0;      // 合并读取失败、回退为逐个读取的次数
+
+    /**
+     * 节省的读取调用次数
+     */
+    size_t syscallsSaved() const {
+        return readOperations - transfers;
+    }
+
+    /**
+     * 节省的字节数（重叠部分只读一次）
+     * 负值表示合并间隙带来的额外读取多于重叠节省
+     */
+    int64_t bytesSaved() const {
+        return static_cast<int64_t>(requestedBytes) -
+               static_cast<int64_t>(transferredBytes);
+    }
+};
+
+/**
+ * 规划后的单个执行步骤
+ * 读步骤可能覆盖多个读操作；写操作始终单独成步
+ */
+struct PlannedStep {
+    uintptr_t address = 0;
+    size_t size = 0;
+    std::vector<size_t> operationIndices;  // 本步骤覆盖的操作下标
+};
+
+/**
+ * 批量读取规划器
+ * 将相邻或重叠的读操作按地址排序并合并为更大的传输
+ *
+ * 写操作作为屏障：只在两个写操作之间的读操作内部重排，
+ * 保证读写之间的先后语义不变。
+ */
+class BatchPlanner {
+public:
+    explicit BatchPlanner(BatchPlannerConfig config = BatchPlannerConfig());
+
+    /**
+     * 生成执行计划
+     *
+     * @param operations 原始操作列表
+     * @param stats 可选，输出规划统计
+     * @return 按执行顺序排列的步骤
+     */
+    std::vector<PlannedStep> plan(
+        const std::vector<MemoryOperation>& operations,
+        BatchPlanStats* stats = nullptr
+    ) const;
+
+    /**
+     * 获取配置
+     */
+    const BatchPlannerConfig& config() const {
+        return config_;
+    }
+
+private:
+    BatchPlannerConfig config_;
+
+    /**
+     * 合并一段连续的读操作（不含写操作）
+     */
+    void planReads(
+        const std::vector<MemoryOperation>& operations,
+        std::vector<size_t>& readIndices,
+        std::vector<PlannedStep>& steps,
+        BatchPlanStats& stats
+    ) const;
+};
+
+} // namespace ukc
+
+#endif // USERSPACE_KERNEL_CALL_BATCH_PLANNER_H
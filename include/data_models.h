@@ -1,6 +1,7 @@
 #ifndef USERSPACE_KERNEL_CALL_DATA_MODELS_H
 #define USERSPACE_KERNEL_CALL_DATA_MODELS_H
 
+#include "error_code.h"
 #include <cstdint>
 #include <vector>
 #include <string>
@@ -76,7 +77,40 @@ struct MemoryOperation {
     // 操作结果
     bool success = false;
     std::vector<uint8_t> result;       // Read 时的结果
-    std::string errorMessage;
+    Error error;                       // 失败原因，消息按需格式化
+    
+    /**
+     * 获取错误消息
+     */
+    std::string errorMessage() const {
+        return success ? std::string() : error.message();
+    }
+};
+
+/**
+ * 批量读取请求
+ * 与 MemoryOperation 不同，不携带任何堆内存
+ */
+struct BatchReadRequest {
+    uintptr_t address = 0;
+    size_t size = 0;
+};
+
+/**
+ * 批量读取结果
+ * data 指向 BatchArena 中的连续缓冲区，生命周期随 arena
+ */
+struct BatchReadResult {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    ErrorCode error = ErrorCode::None;
+    
+    /**
+     * 检查是否成功
+     */
+    bool ok() const {
+        return error == ErrorCode::None;
+    }
 };
 
 /**
@@ -136,6 +170,14 @@ struct MemoryRegion {
     bool isPrivate() const {
         return permissions.length() > 3 && permissions[3] == 'p';
     }
+    
+    /**
+     * 检查是否是私有匿名映射（堆、栈、匿名 mmap），从未写入的页读出全零
+     */
+    bool isAnonymous() const {
+        return isPrivate() && (path.empty() || path == "[heap]" ||
+                               path.compare(0, 6, "[stack") == 0 || path.compare(0, 6, "[anon:") == 0);
+    }
 };
 
 } // namespace ukc
@@ -0,0 +1,158 @@
+#ifndef USERSPACE_KERNEL_CALL_ERROR_CODE_H
+#define USERSPACE_KERNEL_CALL_ERROR_CODE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <sys/types.h>
+
+namespace ukc {
+
+/**
+ * 结构化错误码
+ * 用于热路径上替代格式化的错误字符串
+ */
+enum class ErrorCode : uint8_t {
+    None = 0,              // 成功
+    NotInitialized,        // 组件未初始化
+    InvalidArgument,       // 参数无效
+    ProcessGone,           // 目标进程不存在
+    InvalidAddress,        // 地址不在目标进程的有效映射中
+    ReadFailed,            // 读取失败
+    WriteFailed,           // 写入失败
+    BufferTooSmall,        // 输出缓冲区容量不足
+    ProcessNotFound,       // 按名称找不到进程
+    SymbolNotFound,        // 找不到内核符号
+    PatternNotFound,       // 特征码没有匹配
+    InvalidPattern,        // 特征码模式无效
+    Unavailable,           // 所需的系统接口或文件不可用
+    Unknown                // 仅有文本消息的错误
+};
+
+/**
+ * 获取错误码的文字描述
+ */
+const char* errorCodeToString(ErrorCode code);
+
+/**
+ * 紧凑的错误描述
+ *
+ * 保存错误码和原始负载（地址、大小、pid、errno、静态上下文字符串），
+ * 构造时不格式化；可读的消息在调用 message() 时才生成。
+ *
+ * 使用示例：
+ *   return Error(ErrorCode::InvalidAddress).withAddress(address).withPid(pid);
+ */
+class Error {
+public:
+    Error() = default;
+
+    /**
+     * @param code 错误码
+     * @param sysErrno 系统 errno，0 表示无
+     * @param context 静态生存期的上下文描述（通常是字符串字面量），不复制
+     */
+    explicit Error(ErrorCode code, int sysErrno = 0, const char* context = nullptr)
+        : code_(code), sysErrno_(sysErrno), context_(context) {}
+
+    /**
+     * 由动态消息构造错误（兼容旧的字符串错误，需要一次分配）
+     */
+    static Error fromMessage(std::string message) {
+        Error error(ErrorCode::Unknown);
+        error.text_ = std::make_shared<const std::string>(std::move(message));
+        return error;
+    }
+
+    Error& withAddress(uint64_t address) {
+        address_ = address;
+        fields_ |= kHasAddress;
+        return *this;
+    }
+
+    Error& withSize(uint64_t size) {
+        size_ = size;
+        fields_ |= kHasSize;
+        return *this;
+    }
+
+    Error& withPid(pid_t pid) {
+        pid_ = pid;
+        fields_ |= kHasPid;
+        return *this;
+    }
+
+    /**
+     * 附加一个动态名称（符号名、进程名、路径），需要一次分配
+     */
+    Error& withName(std::string name) {
+        text_ = std::make_shared<const std::string>(std::move(name));
+        return *this;
+    }
+
+    ErrorCode code() const {
+        return code_;
+    }
+
+    int sysErrno() const {
+        return sysErrno_;
+    }
+
+    const char* context() const {
+        return context_;
+    }
+
+    bool hasAddress() const {
+        return (fields_ & kHasAddress) != 0;
+    }
+
+    uint64_t address() const {
+        return address_;
+    }
+
+    bool hasSize() const {
+        return (fields_ & kHasSize) != 0;
+    }
+
+    uint64_t size() const {
+        return size_;
+    }
+
+    bool hasPid() const {
+        return (fields_ & kHasPid) != 0;
+    }
+
+    pid_t pid() const {
+        return pid_;
+    }
+
+    /**
+     * 附加的名称，没有时为空
+     */
+    const std::string& name() const;
+
+    /**
+     * 生成可读的错误消息
+     * 格式：描述 ['名称'] [at 0x地址] [(N bytes, pid P)] [: 上下文] [: strerror]
+     */
+    std::string message() const;
+
+private:
+    static constexpr uint8_t kHasAddress = 1 << 0;
+    static constexpr uint8_t kHasSize = 1 << 1;
+    static constexpr uint8_t kHasPid = 1 << 2;
+
+    ErrorCode code_ = ErrorCode::None;
+    uint8_t fields_ = 0;
+    int sysErrno_ = 0;
+    pid_t pid_ = 0;
+    const char* context_ = nullptr;
+    uint64_t address_ = 0;
+    uint64_t size_ = 0;
+    // Unknown 时为完整消息，其他错误码时为附加名称
+    std::shared_ptr<const std::string> text_;
+};
+
+} // namespace ukc
+
+#endif // USERSPACE_KERNEL_CALL_ERROR_CODE_H
@@ -0,0 +1,207 @@
+#ifndef USERSPACE_KERNEL_CALL_EXECUTOR_H
+#define USERSPACE_KERNEL_CALL_EXECUTOR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ukc {
+
+/**
+ * 提交到执行器的并行阶段
+ * 每个阶段单独统计任务数和并发度
+ */
+enum class ExecutorStage : uint8_t {
+    Task,             // 异步接口提交的独立任务
+    Scan,             // 进程特征码扫描
+    KallsymsParse,    // /proc/kallsyms 解析
+    BatchRead,        // 批量读取
+    Count
+};
+
+/**
+ * 大小核偏好（big.LITTLE / DynamIQ）
+ */
+enum class CorePreference : uint8_t {
+    Any,              // 不区分
+    Big,              // 只使用最大算力的核心
+    Little            // 只使用最小算力的核心
+};
+
+/**
+ * 执行器配置
+ */
+struct ExecutorConfig {
+    size_t threadCount = 0;                        // 工作线程数，0 表示可用 CPU 数
+    std::vector<int> cpus;                         // 允许运行的 CPU，空表示进程当前的亲和性
+    CorePreference corePreference = CorePreference::Any;
+};
+
+/**
+ * 单个阶段的执行统计
+ */
+struct ExecutorStageStats {
+    const char* name = "";
+    uint64_t tasks = 0;                            // 执行的任务数
+    uint64_t steals = 0;                           // 从其他线程队列窃取的任务数
+    size_t peakConcurrency = 0;                    // 同时运行的最大任务数
+    std::chrono::nanoseconds busyTime{0};          // 各任务运行时间之和
+    std::chrono::nanoseconds wallTime{0};          // parallelFor 调用的墙钟时间之和
+
+    /**
+     * 平均并发度（仅 parallelFor 阶段有意义）
+     */
+    double averageConcurrency() const {
+        return wallTime.count() == 0 ? 0.0
+            : static_cast<double>(busyTime.count()) / static_cast<double>(wallTime.count());
+    }
+};
+
+/**
+ * 工作窃取执行器
+ *
+ * 每个工作线程有自己的双端队列：线程内提交的任务压入自己队列的尾部并按
+ * LIFO 取出，空闲线程从其他队列的头部窃取；外部线程提交的任务轮流分配到
+ * 各个队列。库内所有并行阶段（扫描、kallsyms 解析、批量读取、异步接口）
+ * 共用同一个执行器，线程总数不超过配置值。
+ *
+ * parallelFor 的调用线程也参与执行，之后只等待本次调用的下标完成，不会顺带
+ * 执行队列中的其他任务；因此可以在工作线程内部嵌套调用，也可以在持有锁或
+ * call_once 内调用，而不会因任务重入而死锁。
+ *
+ * 析构时先执行完已提交的任务再退出。
+ */
+class Executor {
+public:
+    explicit Executor(ExecutorConfig config = ExecutorConfig());
+
+    /**
+     * @param threadCount 工作线程数，0 表示可用 CPU 数
+     */
+    explicit Executor(size_t threadCount);
+    ~Executor();
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    /**
+     * 提交任务
+     */
+    void submit(std::function<void()> task, ExecutorStage stage = ExecutorStage::Task);
+
+    /**
+     * 提交有返回值的任务
+     */
+    template<typename F>
+    std::future<std::invoke_result_t<F>> async(F&& function, ExecutorStage stage = ExecutorStage::Task) {
+        using R = std::invoke_result_t<F>;
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(function));
+        std::future<R> future = task->get_future();
+        submit([task]() { (*task)(); }, stage);
+        return future;
+    }
+
+    /**
+     * 并行执行 body(0) ... body(count - 1)，全部完成后返回
+     *
+     * @param maxConcurrency 最多同时执行的任务数，0 表示线程数 + 1（含调用线程）
+     */
+    void parallelFor(
+        ExecutorStage stage,
+        size_t count,
+        const std::function<void(size_t)>& body,
+        size_t maxConcurrency = 0
+    );
+
+    size_t threadCount() const {
+        return workers_.size();
+    }
+
+    /**
+     * 工作线程绑定的 CPU，为空表示未设置亲和性
+     */
+    const std::vector<int>& cpus() const {
+        return cpus_;
+    }
+
+    /**
+     * 获取各阶段的执行统计
+     */
+    std::vector<ExecutorStageStats> stageStats() const;
+
+    /**
+     * 获取阶段名称
+     */
+    static const char* stageName(ExecutorStage stage);
+
+    /**
+     * 按配置计算可用的 CPU 列表
+     * 大小核按 /sys/devices/system/cpu/cpuN/cpu_capacity（没有时按 cpufreq 最大频率）区分，
+     * 所有核心相同或信息不可用时不做筛选
+     */
+    static std::vector<int> resolveCpus(const ExecutorConfig& config);
+
+private:
+    struct Task {
+        std::function<void()> function;
+        ExecutorStage stage;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    struct StageCounters {
+        std::atomic<uint64_t> tasks{0};
+        std::atomic<uint64_t> steals{0};
+        std::atomic<size_t> running{0};
+        std::atomic<size_t> peak{0};
+        std::atomic<int64_t> busyNanos{0};
+        std::atomic<int64_t> wallNanos{0};
+    };
+
+    std::vector<std::unique_ptr<Worker>> queues_;
+    std::vector<std::thread> workers_;
+    std::vector<int> cpus_;
+    std::atomic<size_t> nextQueue_{0};
+
+    // 空闲线程在此等待
+    std::mutex sleepMutex_;
+    std::condition_variable sleepCv_;
+    std::atomic<size_t> queued_{0};
+    bool stopping_ = false;
+
+    StageCounters stages_[static_cast<size_t>(ExecutorStage::Count)];
+
+    void start(size_t threadCount);
+    void workerLoop(size_t index);
+
+    /**
+     * 取一个任务：先取 preferred 队列尾部，再从其他队列头部窃取
+     */
+    bool takeTask(size_t preferred, Task& task, bool& stolen);
+
+    /**
+     * 取一个任务并执行，没有任务时返回 false
+     */
+    bool runOne(size_t preferred);
+
+    void runTask(Task& task, bool stolen);
+    void enterStage(ExecutorStage stage);
+    void leaveStage(ExecutorStage stage, std::chrono::steady_clock::time_point start);
+};
+
+} // namespace ukc
+
+#endif // USERSPACE_KERNEL_CALL_EXECUTOR_H
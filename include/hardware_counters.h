@@ -0,0 +1,120 @@
+#ifndef USERSPACE_KERNEL_CALL_HARDWARE_COUNTERS_H
+#define USERSPACE_KERNEL_CALL_HARDWARE_COUNTERS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace ukc {
+
+/**
+ * 硬件计数器事件
+ */
+enum class HardwareEvent : uint8_t {
+    Cycles,
+    Instructions,
+    CacheMisses,
+    BranchMisses,
+    Count
+};
+
+constexpr size_t kHardwareEventCount = static_cast<size_t>(HardwareEvent::Count);
+
+/**
+ * 一组硬件计数器读数
+ */
+struct HardwareCounterValues {
+    std::array<uint64_t, kHardwareEventCount> values{};
+
+    uint64_t& operator[](HardwareEvent event) {
+        return values[static_cast<size_t>(event)];
+    }
+
+    uint64_t operator[](HardwareEvent event) const {
+        return values[static_cast<size_t>(event)];
+    }
+};
+
+/**
+ * 当前线程的硬件计数器组（基于 perf_event_open）
+ *
+ * 只统计用户态，调用线程首次使用时打开事件组，之后一次 read 读取全部计数。
+ * 内核不支持、权限不足（perf_event_paranoid）或在虚拟机中缺少 PMU 时，
+ * 打开失败的事件读数为 0，全部失败则 forCurrentThread() 返回 nullptr。
+ * 事件组被复用（multiplexing）时按启用/运行时间比例缩放。
+ */
+class HardwareCounterGroup {
+public:
+    /**
+     * 获取当前线程的计数器组，不可用时返回 nullptr
+     */
+    static HardwareCounterGroup* forCurrentThread();
+
+    /**
+     * 当前线程是否可以使用硬件计数器
+     */
+    static bool available() {
+        return forCurrentThread() != nullptr;
+    }
+
+    HardwareCounterGroup();
+    ~HardwareCounterGroup();
+
+    HardwareCounterGroup(const HardwareCounterGroup&) = delete;
+    HardwareCounterGroup& operator=(const HardwareCounterGroup&) = delete;
+
+    /**
+     * 读取当前累计值
+     *
+     * @param out 各事件的累计值
+     * @param timeEnabled 事件组启用的累计时间（纳秒）
+     * @param timeRunning 事件组实际在 PMU 上运行的累计时间（纳秒）
+     * @return 读取是否成功
+     */
+    bool read(HardwareCounterValues& out, uint64_t& timeEnabled, uint64_t& timeRunning) const;
+
+    /**
+     * 事件是否成功打开
+     */
+    bool supports(HardwareEvent event) const {
+        return fds_[static_cast<size_t>(event)] >= 0;
+    }
+
+    /**
+     * 是否至少有一个事件可用
+     */
+    bool isOpen() const {
+        return leaderFd_ >= 0;
+    }
+
+private:
+    int leaderFd_ = -1;
+    std::array<int, kHardwareEventCount> fds_;
+    // 事件在组读取结果中的位置，未打开为 -1
+    std::array<int, kHardwareEventCount> slots_;
+    size_t openCount_ = 0;
+};
+
+/**
+ * 一次作用域测量的起点
+ */
+struct HardwareCounterStart {
+    HardwareCounterValues values;
+    uint64_t timeEnabled = 0;
+    uint64_t timeRunning = 0;
+};
+
+/**
+ * 计算从 start 到现在的计数增量（已按复用比例缩放）
+ *
+ * @return 测量期间事件组没有运行或读取失败时返回 false
+ */
+bool hardwareCounterDelta(
+    const HardwareCounterGroup& group,
+    const HardwareCounterStart& start,
+    HardwareCounterValues& delta
+);
+
+} // namespace ukc
+
+#endif // USERSPACE_KERNEL_CALL_HARDWARE_COUNTERS_H
@@ -8,6 +8,8 @@
 
 namespace ukc {
 
+class Executor;
+
 /**
  * 内核函数定位器
  * 负责通过特征码搜索定位内核函数地址
@@ -17,6 +19,14 @@ public:
     KernelFunctionLocator();
     ~KernelFunctionLocator();
     
+    /**
+     * 设置共享执行器，kallsyms 解析按分片并行执行
+     * 需在 initialize() 之前调用；为空时单线程解析
+     */
+    void setExecutor(Executor* executor) {
+        executor_ = executor;
+    }
+    
     /**
      * 初始化定位器，加载内核内存映射
      */
@@ -64,6 +74,7 @@ private:
     uintptr_t kernelBaseAddress_ = 0;
     size_t kernelSize_ = 0;
     bool initialized_ = false;
+    Executor* executor_ = nullptr;
     
     /**
      * 加载内核内存映射
@@ -0,0 +1,164 @@
+#ifndef USERSPACE_KERNEL_CALL_LATENCY_HISTOGRAM_H
+#define USERSPACE_KERNEL_CALL_LATENCY_HISTOGRAM_H
+
+#include "result.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace ukc {
+
+/**
+ * 固定大小的对数-线性延迟直方图（HDR 风格）
+ *
+ * 单位为纳秒。小于 128ns 的值精确记录；更大的值按 2 的幂分段，
+ * 每段再线性划分为 64 个桶，相对误差不超过 1/64（约 1.6%）。
+ * 可表示的最大值约为 2^43 ns（约 2.4 小时），更大的值计入最后一个桶，
+ * 但 max() 仍然精确。
+ *
+ * 记录为 O(1)，内存占用固定，与样本数量无关。
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned kLinearBits = 7;                         // 精确记录的范围 [0, 128)
+    static constexpr size_t kSubBuckets = size_t(1) << (kLinearBits - 1);  // 每个 2 的幂分段的桶数
+    static constexpr unsigned kMaxShift = 36;                          // 最大分段
+    static constexpr size_t kBucketCount =
+        (size_t(1) << kLinearBits) + kMaxShift * kSubBuckets;
+
+    LatencyHistogram();
+
+    /**
+     * 记录一个样本（纳秒）
+     */
+    void record(uint64_t valueNs);
+
+    /**
+     * 合并另一个直方图
+     */
+    void merge(const LatencyHistogram& other);
+
+    /**
+     * 减去较早的快照，得到两次快照之间的增量
+     *
+     * earlier 必须是同一数据源较早时刻的快照。增量的 min/max 无法精确恢复，
+     * 取有样本的最低/最高桶的边界（限制在当前 min/max 内）。
+     */
+    void subtract(const LatencyHistogram& earlier);
+
+    /**
+     * 清空所有样本
+     */
+    void reset();
+
+    /**
+     * 获取百分位数（纳秒）
+     *
+     * @param percentile 百分位，范围 [0, 100]
+     * @return 该百分位对应的值（桶中点，限制在 [min, max] 内），无样本时返回 0
+     */
+    uint64_t percentile(double percentile) const;
+
+    uint64_t count() const {
+        return count_;
+    }
+
+    uint64_t sum() const {
+        return sum_;
+    }
+
+    uint64_t min() const {
+        return count_ ? min_ : 0;
+    }
+
+    uint64_t max() const {
+        return max_;
+    }
+
+    /**
+     * 获取指定桶的计数
+     */
+    uint64_t bucketCount(size_t index) const {
+        return buckets_[index];
+    }
+
+    /**
+     * 序列化为单行文本：count sum min max 以及非零桶 index:count
+     */
+    std::string serialize() const;
+
+    /**
+     * 从 serialize() 的输出恢复
+     */
+    static Result<LatencyHistogram> deserialize(const std::string& text);
+
+    /**
+     * 计算值所在的桶
+     */
+    static size_t bucketIndex(uint64_t valueNs);
+
+    /**
+     * 获取桶覆盖的最小值
+     */
+    static uint64_t bucketLowerBound(size_t index);
+
+    /**
+     * 获取桶覆盖的最大值
+     */
+    static uint64_t bucketUpperBound(size_t index);
+
+private:
+    friend class AtomicLatencyHistogram;
+
+    std::array<uint64_t, kBucketCount> buckets_;
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t min_ = UINT64_MAX;
+    uint64_t max_ = 0;
+};
+
+/**
+ * 可并发读取的延迟直方图
+ *
+ * 桶布局与 LatencyHistogram 相同。设计为单写者使用（每个线程一个实例），
+ * 计数使用 relaxed 原子操作，因此其他线程可以随时读取快照而无需加锁；
+ * 由于没有写者竞争，原子加法不会发生缓存行争用。
+ */
+class AtomicLatencyHistogram {
+public:
+    AtomicLatencyHistogram();
+
+    /**
+     * 记录一个样本（纳秒）
+     */
+    void record(uint64_t valueNs);
+
+    /**
+     * 将当前计数合并到普通直方图中
+     *
+     * 与写者并发调用时，快照中的各字段可能相差最近的几次记录。
+     */
+    void mergeInto(LatencyHistogram& target) const;
+
+    /**
+     * 清空所有样本
+     */
+    void reset();
+
+    uint64_t count() const {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, LatencyHistogram::kBucketCount> buckets_;
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> min_{UINT64_MAX};
+    std::atomic<uint64_t> max_{0};
+};
+
+} // namespace ukc
+
+#endif // USERSPACE_KERNEL_CALL_LATENCY_HISTOGRAM_H
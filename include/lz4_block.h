@@ -0,0 +1,40 @@
+#ifndef USERSPACE_KERNEL_CALL_LZ4_BLOCK_H
+#define USERSPACE_KERNEL_CALL_LZ4_BLOCK_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ukc {
+namespace lz4 {
+
+/**
+ * LZ4 块格式编解码（不含帧头），输出与标准 LZ4 块格式兼容
+ *
+ * 压缩器是单遍贪心匹配（4 字节哈希、64 KiB 窗口），速度优先；
+ * 解压器对输入做完整的边界检查，损坏的数据返回失败而不会越界。
+ */
+
+/**
+ * srcSize 字节输入压缩后的最大长度
+ */
+size_t compressBound(size_t srcSize);
+
+/**
+ * 压缩
+ *
+ * @return 压缩后的长度，dstCapacity 不够时返回 0
+ */
+size_t compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity);
+
+/**
+ * 解压
+ *
+ * @param dstSize 原始数据长度，解压结果必须正好是这个长度
+ * @return 数据损坏或长度不符时返回 false
+ */
+bool decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+
+} // namespace lz4
+} // namespace ukc
+
+#endif // USERSPACE_KERNEL_CALL_LZ4_BLOCK_H
@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <sys/types.h>
 
 namespace ukc {
 namespace magisk {
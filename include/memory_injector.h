@@ -6,15 +6,25 @@
 #include "kernel_function_locator.h"
 #include "kernel_caller.h"
 #include "process_manager.h"
+#include "batch_planner.h"
+#include "batch_arena.h"
+#include "read_engine.h"
 #include <vector>
 #include <memory>
+#include <type_traits>
 #include <sys/types.h>
 
 namespace ukc {
 
+class Executor;
+
 /**
  * 内存注入器
  * 高层内存注入接口
+ *
+ * 每个读写接口都有 pid_t 和 ProcessHandle 两种形式：pid_t 形式使用
+ * ProcessManager 缓存的句柄；频繁访问同一进程时可以直接持有句柄，
+ * 省去每次操作的缓存查找。
  */
 class MemoryInjector {
 public:
@@ -30,6 +40,14 @@ public:
         std::shared_ptr<ProcessManager> processManager
     );
     
+    /**
+     * 设置共享执行器，大批量的 batchRead 按分片并行读取
+     * 为空时单线程执行
+     */
+    void setExecutor(Executor* executor) {
+        executor_ = executor;
+    }
+    
     /**
      * 读取目标进程内存
      */
@@ -39,6 +57,52 @@ public:
         size_t size
     );
     
+    Result<std::vector<uint8_t>> readMemory(
+        const ProcessHandle& process,
+        uintptr_t address,
+        size_t size
+    );
+    
+    /**
+     * 读取目标进程内存到调用方缓冲区
+     * 成功路径不分配堆内存，适合高频轮询
+     * 
+     * @param buffer 输出缓冲区，至少 size 字节
+     * @return 读取的字节数
+     */
+    Result<size_t> readMemoryInto(
+        pid_t targetPid,
+        uintptr_t address,
+        uint8_t* buffer,
+        size_t size
+    );
+    
+    Result<size_t> readMemoryInto(
+        const ProcessHandle& process,
+        uintptr_t address,
+        uint8_t* buffer,
+        size_t size
+    );
+    
+    /**
+     * 读取单个 POD 值
+     * 
+     * @param target pid_t 或 ProcessHandle
+     */
+    template<typename T, typename Target>
+    Result<T> read(const Target& target, uintptr_t address) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "read<T>() requires a trivially copyable type");
+        T value{};
+        auto readResult = readMemoryInto(
+            target, address, reinterpret_cast<uint8_t*>(&value), sizeof(T)
+        );
+        if (readResult.isError()) {
+            return Result<T>::error(readResult.errorInfo());
+        }
+        return Result<T>::success(value);
+    }
+    
     /**
      * 写入目标进程内存
      */
@@ -48,6 +112,12 @@ public:
         const std::vector<uint8_t>& data
     );
     
+    Result<size_t> writeMemory(
+        const ProcessHandle& process,
+        uintptr_t address,
+        const std::vector<uint8_t>& data
+    );
+    
     /**
      * 批量内存操作
      */
@@ -55,6 +125,81 @@ public:
         pid_t targetPid,
         std::vector<MemoryOperation>& operations
     );
+    
+    Result<void> batchOperations(
+        const ProcessHandle& process,
+        std::vector<MemoryOperation>& operations
+    );
+    
+    /**
+     * 批量内存操作（经规划器合并相邻读取）
+     * 
+     * @param planner 批量读取规划器
+     * @param stats 可选，输出合并统计
+     */
+    Result<void> batchOperations(
+        pid_t targetPid,
+        std::vector<MemoryOperation>& operations,
+        const BatchPlanner& planner,
+        BatchPlanStats* stats = nullptr
+    );
+    
+    Result<void> batchOperations(
+        const ProcessHandle& process,
+        std::vector<MemoryOperation>& operations,
+        const BatchPlanner& planner,
+        BatchPlanStats* stats = nullptr
+    );
+
+    /**
+     * 批量内存操作（读操作经读取引擎执行）
+     * 
+     * 两个写操作之间的读操作一次交给引擎（io_uring 队列或合并的 preadv），
+     * 写操作按原路径执行；读取失败的地址不在映射中时错误码为 InvalidAddress。
+     * 目标进程没有可用的 mem 描述符时退回逐个执行。
+     * 
+     * @param engine 读取引擎
+     * @param stats 可选，输出引擎统计
+     */
+    Result<void> batchOperations(
+        pid_t targetPid,
+        std::vector<MemoryOperation>& operations,
+        ReadEngine& engine,
+        ReadEngineStats* stats = nullptr
+    );
+    
+    Result<void> batchOperations(
+        const ProcessHandle& process,
+        std::vector<MemoryOperation>& operations,
+        ReadEngine& engine,
+        ReadEngineStats* stats = nullptr
+    );
+
+    /**
+     * 批量读取（结果写入连续缓冲区）
+     * 
+     * 每次调用前会重置 arena；自有内存模式下按请求总大小一次性扩容。
+     * 进程映射只解析一次，单个请求的成败以错误码记录在 results 中，
+     * 整批读取的堆分配次数与请求数量无关。
+     * 
+     * @param requests 读取请求
+     * @param results 输出结果，与 requests 一一对应
+     * @param arena 结果缓冲区
+     * @return 成功读取的请求数
+     */
+    Result<size_t> batchRead(
+        pid_t targetPid,
+        const std::vector<BatchReadRequest>& requests,
+        std::vector<BatchReadResult>& results,
+        BatchArena& arena
+    );
+    
+    Result<size_t> batchRead(
+        const ProcessHandle& process,
+        const std::vector<BatchReadRequest>& requests,
+        std::vector<BatchReadResult>& results,
+        BatchArena& arena
+    );
 
     /**
      * 读取内核内存（通过 Magisk 接口，安卓15推荐）
@@ -73,6 +218,30 @@ public:
     );
 
 private:
+    /**
+     * 取得 pid 对应的缓存句柄并执行 op
+     * 句柄所属进程已退出而 pid 被新进程复用时，重新打开句柄再执行一次
+     */
+    template<typename R, typename Op>
+    R withProcessHandle(pid_t targetPid, Op op);
+    
+    /**
+     * 执行单个内存操作并写回结果
+     */
+    void executeOperation(const ProcessHandle& process, MemoryOperation& op);
+    
+    /**
+     * 读取目标进程内存到调用方缓冲区（不做校验）
+     * 
+     * @return None，或 readProcessMemory 的错误码（ReadFailed / ProcessGone 等）
+     */
+    ErrorCode readIntoBuffer(
+        const ProcessHandle& process,
+        uintptr_t address,
+        uint8_t* buffer,
+        size_t size
+    );
+    
     std::shared_ptr<KernelFunctionLocator> locator_;
     std::shared_ptr<KernelCaller> caller_;
     std::shared_ptr<ProcessManager> processManager_;
@@ -81,6 +250,7 @@ private:
     uintptr_t kernelReadMemAddr_ = 0;
     uintptr_t kernelWriteMemAddr_ = 0;
     bool initialized_ = false;
+    Executor* executor_ = nullptr;
 };
 
 } // namespace ukc
@@ -0,0 +1,149 @@
+#ifndef USERSPACE_KERNEL_CALL_MEMORY_WATCHER_H
+#define USERSPACE_KERNEL_CALL_MEMORY_WATCHER_H
+
+#include "result.h"
+#include "process_manager.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <sys/types.h>
+
+namespace ukc {
+
+/**
+ * 一段发生变化的内存
+ * oldData/newData 指向监视器内部的双缓冲，仅在回调期间有效
+ */
+struct MemoryChange {
+    size_t regionId = 0;           // 所属监视区域
+    uintptr_t address = 0;         // 变化区间的绝对地址
+    size_t offset = 0;             // 相对区域起始的偏移
+    size_t size = 0;               // 变化区间长度
+    const uint8_t* oldData = nullptr;
+    const uint8_t* newData = nullptr;
+};
+
+/**
+ * 变化回调
+ */
+using MemoryChangeCallback = std::function<void(const MemoryChange&)>;
+
+/**
+ * 内存监视器配置
+ */
+struct MemoryWatcherConfig {
+    std::chrono::microseconds interval{10000};  // 后台采样间隔
+    size_t mergeDistance = 0;                   // 间隔不超过该字节数的变化合并为一个区间
+};
+
+/**
+ * 内存监视器统计
+ */
+struct MemoryWatcherStats {
+    size_t samples = 0;            // 采样轮数
+    size_t changedRanges = 0;      // 报告的变化区间数
+    size_t changedBytes = 0;       // 报告的变化字节数
+    size_t failedReads = 0;        // 读取失败（或不完整）的区域采样次数
+};
+
+/**
+ * 内存监视器
+ * 按固定频率对目标进程的若干区域采样，与上一次采样比较，
+ * 只把发生变化的区间交给回调
+ *
+ * 每个区域持有两块缓冲区，采样写入后备缓冲区，比较后交换，
+ * 稳态下不分配内存。比较使用 SIMD 按 16 字节块跳过未变化的数据。
+ *
+ * 回调在持有内部锁的情况下执行，不能在回调中增删区域。
+ */
+class MemoryWatcher {
+public:
+    MemoryWatcher(
+        std::shared_ptr<ProcessManager> processManager,
+        pid_t targetPid,
+        MemoryWatcherConfig config = MemoryWatcherConfig()
+    );
+    ~MemoryWatcher();
+
+    MemoryWatcher(const MemoryWatcher&) = delete;
+    MemoryWatcher& operator=(const MemoryWatcher&) = delete;
+
+    /**
+     * 注册监视区域，并立即采集初始快照
+     *
+     * @return 区域 ID
+     */
+    Result<size_t> addRegion(uintptr_t address, size_t size);
+
+    /**
+     * 移除监视区域
+     */
+    Result<void> removeRegion(size_t regionId);
+
+    /**
+     * 同步采样一次所有区域
+     *
+     * @return 本轮报告的变化区间数
+     */
+    Result<size_t> poll(const MemoryChangeCallback& callback);
+
+    /**
+     * 启动后台采样线程
+     */
+    Result<void> start(MemoryChangeCallback callback);
+
+    /**
+     * 停止后台采样线程
+     */
+    void stop();
+
+    /**
+     * 后台线程是否在运行
+     */
+    bool isRunning() const {
+        return running_.load();
+    }
+
+    /**
+     * 获取统计信息
+     */
+    MemoryWatcherStats getStats() const;
+
+private:
+    struct WatchedRegion {
+        size_t id = 0;
+        uintptr_t address = 0;
+        size_t size = 0;
+        std::vector<uint8_t> buffers[2];
+        int front = 0;             // 上一次采样所在的缓冲区
+    };
+
+    std::shared_ptr<ProcessManager> processManager_;
+    pid_t targetPid_;
+    MemoryWatcherConfig config_;
+
+    mutable std::mutex mutex_;
+    std::vector<WatchedRegion> regions_;
+    size_t nextRegionId_ = 1;
+    MemoryWatcherStats stats_;
+
+    std::thread worker_;
+    std::atomic<bool> running_{false};
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCondition_;
+
+    /**
+     * 比较一个区域的前后两次采样并报告变化
+     */
+    size_t diffRegion(const WatchedRegion& region, const MemoryChangeCallback& callback);
+};
+
+} // namespace ukc
+
+#endif // USERSPACE_KERNEL_CALL_MEMORY_WATCHER_H
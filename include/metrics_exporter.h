@@ -0,0 +1,163 @@
+#ifndef USERSPACE_KERNEL_CALL_METRICS_EXPORTER_H
+#define USERSPACE_KERNEL_CALL_METRICS_EXPORTER_H
+
+#include "result.h"
+#include "performance_monitor.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ukc {
+
+/**
+ * 监控器在某一时刻的快照
+ */
+struct MetricsSnapshot {
+    std::chrono::system_clock::time_point timestamp;
+    std::vector<OperationHistogram> operations;
+    std::vector<CounterValue> counters;
+    bool isDelta = false;          // 是否为相对上一快照的增量
+};
+
+/**
+ * 导出格式
+ */
+enum class MetricsFormat : uint8_t {
+    Prometheus,    // Prometheus 文本格式 0.0.4
+    OpenMetrics,   // OpenMetrics 1.0 文本格式
+    Json           // 紧凑 JSON（单行）
+};
+
+/**
+ * 指标导出
+ *
+ * 延迟以 summary 导出（P50/P90/P99/P99.9 分位数、总和与次数，单位秒），
+ * 吞吐量以 gauge 导出，计数器以 counter 导出。
+ * 指标名为 <prefix>_operation_duration_seconds 等，操作名放在 operation 标签中。
+ */
+class MetricsExporter {
+public:
+    /**
+     * 采集监控器快照
+     */
+    static Result<MetricsSnapshot> capture(PerformanceMonitor& monitor);
+
+    /**
+     * 计算两次快照之间的增量
+     * 计数器和直方图逐项相减；previous 中没有的操作原样保留。
+     */
+    static MetricsSnapshot delta(const MetricsSnapshot& previous, const MetricsSnapshot& current);
+
+    /**
+     * 格式化快照
+     */
+    static std::string format(
+        const MetricsSnapshot& snapshot,
+        MetricsFormat format,
+        const std::string& prefix = "ukc"
+    );
+
+    static std::string toPrometheus(const MetricsSnapshot& snapshot, const std::string& prefix = "ukc");
+    static std::string toOpenMetrics(const MetricsSnapshot& snapshot, const std::string& prefix = "ukc");
+    static std::string toJson(const MetricsSnapshot& snapshot);
+
+    /**
+     * HTTP Content-Type
+     */
+    static const char* contentType(MetricsFormat format);
+};
+
+/**
+ * 快照输出目标
+ */
+enum class MetricsSinkType : uint8_t {
+    File,          // 写临时文件后 rename 替换，读取方不会看到半个快照
+    UnixSocket     // 每次连接 SOCK_STREAM Unix 套接字并写入一个快照
+};
+
+/**
+ * 周期快照写出配置
+ */
+struct MetricsWriterConfig {
+    MetricsSinkType sinkType = MetricsSinkType::File;
+    std::string path;                              // 文件路径或套接字路径
+    MetricsFormat format = MetricsFormat::Json;
+    std::string prefix = "ukc";
+    std::chrono::milliseconds interval{10000};     // 后台写出间隔
+    bool delta = true;                             // 写出相对上次的增量（首次为全量）
+};
+
+/**
+ * 周期快照写出器
+ * 按固定间隔采集监控器快照并写到文件或 Unix 套接字
+ */
+class MetricsSnapshotWriter {
+public:
+    MetricsSnapshotWriter(PerformanceMonitor& monitor, MetricsWriterConfig config);
+    ~MetricsSnapshotWriter();
+
+    MetricsSnapshotWriter(const MetricsSnapshotWriter&) = delete;
+    MetricsSnapshotWriter& operator=(const MetricsSnapshotWriter&) = delete;
+
+    /**
+     * 立即采集并写出一个快照
+     * 写出失败时不推进增量基线，下次写出会包含本次的数据。
+     */
+    Result<void> writeOnce();
+
+    /**
+     * 启动后台写出线程
+     */
+    Result<void> start();
+
+    /**
+     * 停止后台写出线程
+     */
+    void stop();
+
+    bool isRunning() const {
+        return running_.load();
+    }
+
+    /**
+     * 已成功写出的快照数
+     */
+    size_t writtenCount() const {
+        return written_.load();
+    }
+
+    /**
+     * 写出失败次数
+     */
+    size_t failedCount() const {
+        return failed_.load();
+    }
+
+private:
+    PerformanceMonitor& monitor_;
+    MetricsWriterConfig config_;
+
+    std::mutex writeMutex_;
+    MetricsSnapshot previous_;
+    bool hasPrevious_ = false;
+
+    std::atomic<size_t> written_{0};
+    std::atomic<size_t> failed_{0};
+
+    std::thread worker_;
+    std::atomic<bool> running_{false};
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCondition_;
+
+    Result<void> writeToFile(const std::string& payload);
+    Result<void> writeToSocket(const std::string& payload);
+};
+
+} // namespace ukc
+
+#endif // USERSPACE_KERNEL_CALL_METRICS_EXPORTER_H
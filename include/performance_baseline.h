@@ -0,0 +1,132 @@
+#ifndef USERSPACE_KERNEL_CALL_PERFORMANCE_BASELINE_H
+#define USERSPACE_KERNEL_CALL_PERFORMANCE_BASELINE_H
+
+#include "result.h"
+#include "latency_histogram.h"
+#include "performance_monitor.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ukc {
+
+/**
+ * 回归检查配置
+ */
+struct RegressionCheckConfig {
+    double significance = 0.01;                    // 单侧 Mann-Whitney 检验的显著性水平
+    double percentileTolerance = 0.10;             // 分位数允许变慢的比例
+    std::vector<double> percentiles = {50.0, 99.0};
+    size_t minSamples = 20;                        // 任一侧样本不足时不判定回归
+};
+
+/**
+ * 单个分位数的对比
+ */
+struct PercentileComparison {
+    double percentile = 0.0;
+    uint64_t baselineNs = 0;
+    uint64_t currentNs = 0;
+    double ratio = 1.0;                            // current / baseline
+};
+
+/**
+ * 单个操作的回归检查结果
+ */
+struct RegressionReport {
+    std::string operationName;
+    uint64_t baselineCount = 0;
+    uint64_t currentCount = 0;
+
+    // Mann-Whitney U 检验（当前样本是否显著大于基线）
+    double uStatistic = 0.0;
+    double zScore = 0.0;
+    double pValue = 1.0;
+    double probabilityOfSuperiority = 0.5;         // P(当前 > 基线)，0.5 表示无差异
+
+    std::vector<PercentileComparison> percentiles;
+    bool sufficientSamples = false;
+    bool regressed = false;                        // 显著变慢且超出分位数容差
+
+    std::string toString() const;
+};
+
+/**
+ * Mann-Whitney U 检验结果
+ */
+struct MannWhitneyResult {
+    double u = 0.0;                                // 当前样本的 U 统计量
+    double z = 0.0;
+    double pValue = 1.0;                           // 单侧：当前 > 基线
+    double probabilityOfSuperiority = 0.5;
+};
+
+/**
+ * 基于直方图计算 Mann-Whitney U 检验
+ * 同一桶内的样本视为并列，使用带并列校正的正态近似。
+ */
+MannWhitneyResult mannWhitneyU(const LatencyHistogram& baseline, const LatencyHistogram& current);
+
+/**
+ * 性能基线
+ * 保存每个操作的完整延迟直方图，可写入文件供后续运行比较。
+ *
+ * 文件格式（文本，逐行）：
+ *   ukc-baseline 1
+ *   <操作名>\t<LatencyHistogram::serialize() 的输出>
+ */
+class PerformanceBaseline {
+public:
+    /**
+     * 采集监控器中所有操作的直方图作为基线
+     */
+    static Result<PerformanceBaseline> capture(PerformanceMonitor& monitor);
+
+    /**
+     * 从文件加载基线
+     */
+    static Result<PerformanceBaseline> load(const std::string& path);
+
+    /**
+     * 保存基线到文件
+     */
+    Result<void> save(const std::string& path) const;
+
+    /**
+     * 设置操作的基线直方图
+     */
+    void set(const std::string& operationName, const LatencyHistogram& histogram);
+
+    /**
+     * 查找操作的基线直方图，不存在返回 nullptr
+     */
+    const LatencyHistogram* find(const std::string& operationName) const;
+
+    size_t size() const {
+        return histograms_.size();
+    }
+
+    /**
+     * 将当前直方图与基线比较
+     */
+    Result<RegressionReport> compare(
+        const std::string& operationName,
+        const LatencyHistogram& current,
+        const RegressionCheckConfig& config = RegressionCheckConfig()
+    ) const;
+
+    /**
+     * 将监控器中所有同时存在于基线的操作与基线比较
+     */
+    Result<std::vector<RegressionReport>> compareAll(
+        PerformanceMonitor& monitor,
+        const RegressionCheckConfig& config = RegressionCheckConfig()
+    ) const;
+
+private:
+    std::map<std::string, LatencyHistogram> histograms_;
+};
+
+} // namespace ukc
+
+#endif // USERSPACE_KERNEL_CALL_PERFORMANCE_BASELINE_H
@@ -2,10 +2,15 @@
 #define USERSPACE_KERNEL_CALL_PERFORMANCE_MONITOR_H
 
 #include "result.h"
+#include "latency_histogram.h"
+#include "hardware_counters.h"
 #include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
-#include <map>
 
 namespace ukc {
 
@@ -22,26 +27,228 @@ struct PerformanceStats {
     std::chrono::microseconds maxTime{0};
     std::chrono::microseconds averageTime{0};
     
+    // 延迟分位数（纳秒，来自直方图，相对误差约 1.6%）
+    std::chrono::nanoseconds p50{0};
+    std::chrono::nanoseconds p90{0};
+    std::chrono::nanoseconds p99{0};
+    std::chrono::nanoseconds p999{0};
+    
     // 吞吐量统计
     double operationsPerSecond = 0.0;
     
+    // 硬件计数器（仅 scopeWithCounters() 且 perf 事件可用时有值）
+    uint64_t hardwareSamples = 0;            // 带硬件计数的样本数
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t cacheMisses = 0;
+    uint64_t branchMisses = 0;
+    double instructionsPerCycle = 0.0;       // IPC
+    double cacheMissesPerKiloInstruction = 0.0;   // 每千条指令的缓存未命中
+    double branchMissesPerKiloInstruction = 0.0;  // 每千条指令的分支预测失败
+    
     /**
      * 获取统计信息的字符串表示
      */
     std::string toString() const;
 };
 
+/**
+ * 预注册操作的句柄
+ */
+using OperationId = uint32_t;
+
+/**
+ * 无效的操作句柄
+ */
+constexpr OperationId kInvalidOperationId = UINT32_MAX;
+
+/**
+ * 预注册计数器的句柄
+ */
+using CounterId = uint32_t;
+
+/**
+ * 无效的计数器句柄
+ */
+constexpr CounterId kInvalidCounterId = UINT32_MAX;
+
+/**
+ * 计数器当前值
+ */
+struct CounterValue {
+    std::string name;
+    uint64_t value = 0;
+};
+
+/**
+ * 分位数延迟目标
+ */
+struct PercentileTarget {
+    double percentile = 99.0;                  // 百分位，范围 (0, 100]
+    std::chrono::nanoseconds maxLatency{0};    // 该分位数的上限
+};
+
+/**
+ * 性能要求
+ * 未设置（为 0 或为空）的项不检查。
+ */
+struct PerformanceRequirement {
+    std::vector<PercentileTarget> percentiles;
+    std::chrono::nanoseconds maxAverage{0};    // 平均延迟上限
+    double minOperationsPerSecond = 0.0;       // 吞吐量下限（按测量时间计算）
+    size_t minSamples = 1;                     // 样本不足时视为不满足
+};
+
+/**
+ * 性能要求检查结果
+ */
+struct RequirementCheck {
+    bool passed = true;
+    std::vector<std::string> violations;       // 每条不满足的要求一条说明
+    PerformanceStats stats;
+};
+
+/**
+ * 操作的硬件计数器累计值
+ */
+struct HardwareCounterTotals {
+    uint64_t samples = 0;
+    HardwareCounterValues values;
+};
+
+/**
+ * 操作的合并直方图
+ */
+struct OperationHistogram {
+    std::string name;
+    LatencyHistogram histogram;
+};
+
+namespace detail {
+struct PerformanceShard;
+struct HardwareAccumulator;
+}
+
 /**
  * 性能监控器
  * 用于监控和统计系统性能
+ * 
+ * 每个操作的样本记录在固定大小的延迟直方图中，
+ * 内存占用与样本数量无关，适合长期运行的服务。
+ * 
+ * 线程安全：每个线程记录到自己的分片中（单写者、relaxed 原子计数），
+ * 记录路径不加锁；读取统计时按需合并所有分片。
+ * 热路径应先通过 registerOperation() 获取句柄，再使用 scope() 计时，
+ * 避免每次调用都进行字符串查找。
  */
 class PerformanceMonitor {
 public:
+    /**
+     * 最多可注册的操作数量
+     */
+    static constexpr size_t kMaxOperations = 256;
+    
+    /**
+     * 最多可注册的计数器数量
+     */
+    static constexpr size_t kMaxCounters = 64;
+    
+    /**
+     * RAII 作用域计时器
+     * 析构时将经过的时间记录到当前线程的分片中。
+     * 计时器不得比创建它的监控器存活更久。
+     */
+    class ScopedTimer {
+    public:
+        ScopedTimer() = default;
+        ScopedTimer(ScopedTimer&& other) noexcept;
+        ScopedTimer& operator=(ScopedTimer&& other) noexcept;
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+        ~ScopedTimer();
+        
+        /**
+         * 提前结束计时并记录（之后析构不再记录）
+         */
+        void stop();
+        
+        /**
+         * 放弃本次计时，不记录
+         */
+        void cancel() {
+            histogram_ = nullptr;
+            hardware_ = nullptr;
+        }
+        
+    private:
+        friend class PerformanceMonitor;
+        
+        ScopedTimer(AtomicLatencyHistogram* histogram, detail::HardwareAccumulator* hardware);
+        
+        AtomicLatencyHistogram* histogram_ = nullptr;
+        std::chrono::steady_clock::time_point startTime_;
+        
+        // 硬件计数（未请求或不可用时为空）
+        detail::HardwareAccumulator* hardware_ = nullptr;
+        HardwareCounterGroup* counterGroup_ = nullptr;
+        HardwareCounterStart counterStart_;
+    };
+    
     PerformanceMonitor();
     ~PerformanceMonitor();
     
+    PerformanceMonitor(const PerformanceMonitor&) = delete;
+    PerformanceMonitor& operator=(const PerformanceMonitor&) = delete;
+    
+    /**
+     * 注册操作并返回句柄
+     * 重复注册同名操作返回同一句柄。
+     */
+    Result<OperationId> registerOperation(const std::string& operationName);
+    
+    /**
+     * 创建作用域计时器
+     * 句柄无效时返回不记录的空计时器。
+     */
+    ScopedTimer scope(OperationId operationId);
+    
+    /**
+     * 创建同时采集硬件计数器的作用域计时器
+     * 计数器包括 cycles、instructions、cache-misses、branch-misses，
+     * 统计中给出 IPC 和每千条指令的未命中数。perf 事件不可用时
+     * 退化为普通计时器。每次计时额外需要两次 read 系统调用。
+     */
+    ScopedTimer scopeWithCounters(OperationId operationId);
+    
+    /**
+     * 直接记录一次耗时
+     */
+    void record(OperationId operationId, std::chrono::nanoseconds duration);
+    
+    /**
+     * 注册计数器并返回句柄
+     * 重复注册同名计数器返回同一句柄。
+     */
+    Result<CounterId> registerCounter(const std::string& counterName);
+    
+    /**
+     * 增加计数（记录到当前线程的分片，不加锁）
+     */
+    void increment(CounterId counterId, uint64_t delta = 1);
+    
+    /**
+     * 获取计数器的值（合并所有分片）
+     */
+    Result<uint64_t> getCounter(const std::string& counterName);
+    
+    /**
+     * 获取所有计数器的值
+     */
+    Result<std::vector<CounterValue>> getAllCounters();
+    
     /**
      * 开始计时
+     * 起始时间按线程保存，多个线程可同时为同一操作计时。
      */
     void startTimer(const std::string& operationName);
     
@@ -55,13 +262,23 @@ public:
      */
     Result<PerformanceStats> getStats(const std::string& operationName);
     
+    /**
+     * 获取操作的性能统计（按句柄）
+     */
+    Result<PerformanceStats> getStats(OperationId operationId);
+    
     /**
      * 获取所有操作的性能统计
      */
     Result<std::vector<PerformanceStats>> getAllStats();
     
     /**
-     * 重置所有统计信息
+     * 获取所有有样本操作的合并直方图（用于导出和差分快照）
+     */
+    Result<std::vector<OperationHistogram>> getAllHistograms();
+    
+    /**
+     * 重置所有统计信息（包括计数器）
      */
     void resetStats();
     
@@ -71,28 +288,87 @@ public:
     void resetStats(const std::string& operationName);
     
     /**
-     * 检查操作是否满足性能要求
+     * 获取操作的合并直方图
+     */
+    Result<LatencyHistogram> getHistogram(const std::string& operationName);
+    
+    /**
+     * 检查操作是否满足性能要求（仅比较平均时间）
      */
     Result<bool> meetsPerformanceRequirement(
         const std::string& operationName,
         std::chrono::microseconds maxTime
     );
-
-private:
-    struct TimerEntry {
-        std::chrono::steady_clock::time_point startTime;
-        std::vector<std::chrono::microseconds> measurements;
-    };
     
-    std::map<std::string, TimerEntry> timers_;
+    /**
+     * 检查操作是否满足分位数、平均延迟和吞吐量要求
+     */
+    Result<bool> meetsPerformanceRequirement(
+        const std::string& operationName,
+        const PerformanceRequirement& requirement
+    );
+    
+    /**
+     * 检查性能要求并给出每条不满足项的说明
+     */
+    Result<RequirementCheck> checkRequirement(
+        const std::string& operationName,
+        const PerformanceRequirement& requirement
+    );
     
     /**
-     * 计算统计信息
+     * 由直方图计算统计信息
      */
-    PerformanceStats calculateStats(
+    static PerformanceStats calculateStats(
         const std::string& operationName,
-        const std::vector<std::chrono::microseconds>& measurements
+        const LatencyHistogram& histogram,
+        const HardwareCounterTotals& hardware = HardwareCounterTotals()
     );
+
+private:
+    // 监控器的唯一标识，用于在线程局部缓存中定位分片
+    const uint64_t monitorId_;
+    
+    // 操作注册表
+    mutable std::mutex registryMutex_;
+    std::vector<std::string> operationNames_;
+    std::map<std::string, OperationId> operationIds_;
+    std::vector<std::string> counterNames_;
+    std::map<std::string, CounterId> counterIds_;
+    
+    // 所有线程的分片（线程退出后分片仍由监控器持有，数据不丢失）
+    mutable std::mutex shardsMutex_;
+    std::vector<std::shared_ptr<detail::PerformanceShard>> shards_;
+    
+    /**
+     * 获取当前线程的分片，首次调用时创建
+     */
+    detail::PerformanceShard& localShard();
+    
+    /**
+     * 获取当前线程分片中指定操作的直方图
+     */
+    AtomicLatencyHistogram* localHistogram(OperationId operationId);
+    
+    /**
+     * 按名称查找已注册的操作
+     */
+    OperationId findOperation(const std::string& operationName) const;
+    
+    /**
+     * 合并所有分片中指定计数器的值
+     */
+    uint64_t sumCounter(CounterId counterId) const;
+    
+    /**
+     * 合并所有分片中指定操作的硬件计数器
+     */
+    HardwareCounterTotals mergeHardware(OperationId operationId) const;
+    
+    /**
+     * 合并所有分片中指定操作的直方图
+     */
+    LatencyHistogram mergeShards(OperationId operationId) const;
 };
 
 } // namespace ukc
@@ -0,0 +1,131 @@
+#ifndef USERSPACE_KERNEL_CALL_PROBES_H
+#define USERSPACE_KERNEL_CALL_PROBES_H
+
+#include "performance_monitor.h"
+#include "trace_recorder.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace ukc {
+namespace probes {
+
+/**
+ * 库内置的计时阶段
+ * 枚举值即为全局监控器中的 OperationId。
+ */
+enum class Stage : OperationId {
+    MapsParse,        // 解析 /proc/pid/maps
+    KallsymsParse,    // 扫描 /proc/kallsyms 获取内核地址范围
+    KallsymsLookup,   // 在 /proc/kallsyms 中查找符号
+    ScanPerMB,        // 特征码扫描，按每 MB 的耗时记录
+    BatchReadPerOp,   // 批量读取，按每个请求的平均耗时记录
+    Count
+};
+
+/**
+ * 库内置的计数器
+ * 枚举值即为全局监控器中的 CounterId。
+ */
+enum class Counter : CounterId {
+    SymbolCacheHit,   // 内核符号地址缓存命中
+    SymbolCacheMiss,  // 内核符号地址缓存未命中
+    ScanBytes,        // 已扫描的字节数
+    BatchReadOps,     // 批量读取的请求数
+    Count
+};
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * 探针是否在编译时启用（UKC_ENABLE_PROBES）
+ */
+bool enabled();
+
+/**
+ * 探针使用的全局监控器
+ * 首次调用时按枚举顺序注册所有阶段和计数器。
+ */
+PerformanceMonitor& monitor();
+
+/**
+ * 获取阶段名称
+ */
+const char* stageName(Stage stage);
+
+/**
+ * 获取计数器名称
+ */
+const char* counterName(Counter counter);
+
+inline PerformanceMonitor::ScopedTimer scope(Stage stage) {
+    return monitor().scope(static_cast<OperationId>(stage));
+}
+
+/**
+ * 阶段作用域：记录延迟直方图，全局追踪记录器启用时同时记录 B/E 事件
+ */
+class StageScope {
+public:
+    explicit StageScope(Stage stage)
+        : trace_(TraceRecorder::global(), stageName(stage)),
+          timer_(scope(stage)) {}
+
+private:
+    TraceRecorder::Scope trace_;
+    PerformanceMonitor::ScopedTimer timer_;
+};
+
+inline void count(Counter counter, uint64_t delta) {
+    monitor().increment(static_cast<CounterId>(counter), delta);
+}
+
+/**
+ * 按单位数量归一化记录耗时
+ * 例如 units 为字节数、unitSize 为 1MB 时记录每 MB 的耗时。
+ */
+inline void recordPer(Stage stage, Clock::time_point start, uint64_t units, uint64_t unitSize) {
+    if (units == 0) {
+        return;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+    auto normalized = static_cast<int64_t>(
+        static_cast<double>(elapsed.count()) * static_cast<double>(unitSize) / static_cast<double>(units)
+    );
+    monitor().record(static_cast<OperationId>(stage), std::chrono::nanoseconds(normalized));
+}
+
+} // namespace probes
+} // namespace ukc
+
+/**
+ * 探针宏
+ * 未定义 UKC_ENABLE_PROBES 时展开为空，不产生任何代码。
+ */
+#define UKC_PROBE_CONCAT_INNER(a, b) a##b
+#define UKC_PROBE_CONCAT(a, b) UKC_PROBE_CONCAT_INNER(a, b)
+
+#if defined(UKC_ENABLE_PROBES)
+#define UKC_PROBE_SCOPE(stage) \
+    ::ukc::probes::StageScope UKC_PROBE_CONCAT(ukcProbeScope_, __LINE__)(::ukc::probes::Stage::stage)
+#define UKC_TRACE_SCOPE(name, arg) \
+    ::ukc::TraceRecorder::Scope UKC_PROBE_CONCAT(ukcTraceScope_, __LINE__)( \
+        ::ukc::TraceRecorder::global(), name, (arg))
+#define UKC_TRACE_INSTANT(name, arg) \
+    ::ukc::TraceRecorder::global().instant(name, (arg))
+#define UKC_PROBE_COUNT(counter, delta) \
+    ::ukc::probes::count(::ukc::probes::Counter::counter, (delta))
+#define UKC_PROBE_START(var) \
+    const ::ukc::probes::Clock::time_point var = ::ukc::probes::Clock::now()
+#define UKC_PROBE_RECORD_PER(stage, var, units, unitSize) \
+    ::ukc::probes::recordPer(::ukc::probes::Stage::stage, var, (units), (unitSize))
+#else
+#define UKC_PROBE_SCOPE(stage) ((void)0)
+#define UKC_TRACE_SCOPE(name, arg) ((void)0)
+#define UKC_TRACE_INSTANT(name, arg) ((void)0)
+#define UKC_PROBE_COUNT(counter, delta) ((void)0)
+#define UKC_PROBE_START(var) ((void)0)
+#define UKC_PROBE_RECORD_PER(stage, var, units, unitSize) ((void)0)
+#endif
+
+#endif // USERSPACE_KERNEL_CALL_PROBES_H
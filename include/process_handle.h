@@ -0,0 +1,100 @@
+#ifndef USERSPACE_KERNEL_CALL_PROCESS_HANDLE_H
+#define USERSPACE_KERNEL_CALL_PROCESS_HANDLE_H
+
+#include "result.h"
+#include <sys/types.h>
+
+namespace ukc {
+
+/**
+ * 目标进程句柄
+ *
+ * 打开时一次性获取 pidfd（pidfd_open，Linux 5.3+）以及 /proc/<pid> 目录、
+ * maps、mem 和 pagemap 的文件描述符，之后的存活检查和读取都不再拼接路径：
+ *   - isAlive() 对 pidfd 做一次非阻塞 poll，进程退出（包括僵尸状态）后返回 false
+ *   - 所有描述符都绑定到打开时的进程，pid 被复用后不会误指向新进程
+ *
+ * 内核不支持 pidfd 时退回到在 /proc/<pid> 目录描述符上检查 stat 文件。
+ * 打开句柄只要求能打开 /proc/<pid> 目录，存活检查不依赖其他描述符：
+ * maps 需要 ptrace 读权限，打不开时 mapsFd() 为 -1，maps 相关查询返回 Unavailable；
+ * 没有权限打开 mem 时 memFd() 为 -1，读取改用 process_vm_readv；
+ * pagemap 同样需要 ptrace 读权限，打不开时 pagemapFd() 为 -1。
+ */
+class ProcessHandle {
+public:
+    /**
+     * 打开进程句柄
+     */
+    static Result<ProcessHandle> open(pid_t pid);
+
+    ProcessHandle() = default;
+    ~ProcessHandle();
+
+    ProcessHandle(ProcessHandle&& other) noexcept;
+    ProcessHandle& operator=(ProcessHandle&& other) noexcept;
+
+    ProcessHandle(const ProcessHandle&) = delete;
+    ProcessHandle& operator=(const ProcessHandle&) = delete;
+
+    pid_t pid() const {
+        return pid_;
+    }
+
+    bool isOpen() const {
+        return procDirFd_ >= 0;
+    }
+
+    /**
+     * 进程是否仍在运行（一次系统调用）
+     */
+    bool isAlive() const;
+
+    /**
+     * pidfd，内核不支持时为 -1
+     */
+    int pidFd() const {
+        return pidFd_;
+    }
+
+    /**
+     * /proc/<pid> 目录描述符
+     */
+    int procDirFd() const {
+        return procDirFd_;
+    }
+
+    /**
+     * /proc/<pid>/maps 描述符，无权限时为 -1
+     */
+    int mapsFd() const {
+        return mapsFd_;
+    }
+
+    /**
+     * /proc/<pid>/mem 描述符，无权限时为 -1
+     */
+    int memFd() const {
+        return memFd_;
+    }
+
+    /**
+     * /proc/<pid>/pagemap 描述符，无权限时为 -1
+     */
+    int pagemapFd() const {
+        return pagemapFd_;
+    }
+
+private:
+    pid_t pid_ = -1;
+    int pidFd_ = -1;
+    int procDirFd_ = -1;
+    int mapsFd_ = -1;
+    int memFd_ = -1;
+    int pagemapFd_ = -1;
+
+    void reset();
+};
+
+} // namespace ukc
+
+#endif // USERSPACE_KERNEL_CALL_PROCESS_HANDLE_H
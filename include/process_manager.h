@@ -3,6 +3,10 @@
 
 #include "data_models.h"
 #include "result.h"
+#include "process_handle.h"
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 #include <sys/types.h>
 
@@ -11,33 +15,143 @@ namespace ukc {
 /**
  * 进程管理器
  * 管理目标进程信息
+ *
+ * 每个接口都有 pid_t 和 ProcessHandle 两种形式：
+ *   - ProcessHandle 形式直接使用句柄中的描述符，不拼接路径、不 stat，且不受 pid 复用影响
+ *   - pid_t 形式从内部缓存取得该 pid 的句柄（最多缓存 kMaxCachedHandles 个）
+ *
+ * 单地址查询（isValidAddress、findRegion）在内核支持时使用 PROCMAP_QUERY ioctl
+ * （Linux 6.11+），每次查询只有一次系统调用；旧内核上回退为解析文本 maps。
+ *
+ * 页级状态通过 pagemap 批量读取（每页 8 字节，一次 pread 覆盖任意长的范围）。
+ * soft-dirty 位需要内核开启 CONFIG_MEM_SOFT_DIRTY，可以用 softDirtySupported() 探测。
  */
 class ProcessManager {
 public:
     ProcessManager();
     ~ProcessManager();
     
+    ProcessManager(const ProcessManager&) = delete;
+    ProcessManager& operator=(const ProcessManager&) = delete;
+    
+    /**
+     * 最多缓存的进程句柄数量
+     */
+    static constexpr size_t kMaxCachedHandles = 16;
+    
     /**
      * 查找进程
      */
     Result<pid_t> findProcessByName(const std::string& processName);
     
+    /**
+     * 获取 pid 的缓存句柄，必要时打开
+     * 缓存的句柄对应的进程已退出时重新打开（pid 可能已被复用）。
+     */
+    Result<std::shared_ptr<ProcessHandle>> handle(pid_t pid) const;
+    
     /**
      * 验证进程是否存在
      */
     bool isProcessAlive(pid_t pid) const;
+    bool isProcessAlive(const ProcessHandle& process) const;
     
     /**
      * 获取进程内存映射
      */
     Result<std::vector<MemoryRegion>> getMemoryMaps(pid_t pid);
+    Result<std::vector<MemoryRegion>> getMemoryMaps(const ProcessHandle& process);
     
     /**
      * 验证地址是否在有效范围内
      */
     bool isValidAddress(pid_t pid, uintptr_t address);
+    bool isValidAddress(const ProcessHandle& process, uintptr_t address);
+    
+    /**
+     * 查找包含地址的映射区域
+     */
+    Result<MemoryRegion> findRegion(pid_t pid, uintptr_t address);
+    Result<MemoryRegion> findRegion(const ProcessHandle& process, uintptr_t address);
+    
+    /**
+     * 当前内核是否支持 PROCMAP_QUERY ioctl
+     */
+    static bool procmapQuerySupported();
+    
+    /**
+     * pagemap 项中的标志位
+     */
+    static constexpr uint64_t kPagemapPresent = 1ULL << 63;     // 页在内存中
+    static constexpr uint64_t kPagemapSwapped = 1ULL << 62;     // 页在交换区中
+    static constexpr uint64_t kPagemapSoftDirty = 1ULL << 55;   // 上次清除 soft-dirty 后写过
+    
+    /**
+     * 批量读取 pagemap，每页一项
+     * 
+     * @param address 起始地址，向下对齐到页
+     * @param entries 输出，至少 count 项
+     * @return 实际读取的项数，只有到达地址空间末尾时小于 count
+     */
+    Result<size_t> readPagemap(pid_t pid, uintptr_t address, uint64_t* entries, size_t count);
+    Result<size_t> readPagemap(const ProcessHandle& process, uintptr_t address, uint64_t* entries, size_t count);
+    
+    /**
+     * 当前内核是否维护 soft-dirty 位
+     */
+    static bool softDirtySupported();
+    
+    /**
+     * 清除进程所有页的 soft-dirty 位（向 /proc/<pid>/clear_refs 写入 "4"）
+     * 之后写入的页在 pagemap 中重新带有 kPagemapSoftDirty。
+     * 该位是进程级的，会影响同一进程上其他使用 soft-dirty 的工具；内核不支持时返回 Unavailable。
+     */
+    Result<void> clearSoftDirty(pid_t pid);
+    Result<void> clearSoftDirty(const ProcessHandle& process);
+    
+    /**
+     * 读取目标进程内存
+     * 句柄持有可用的 mem 描述符时使用 pread，否则使用 process_vm_readv
+     * 
+     * @param buffer 输出缓冲区，至少 size 字节
+     * @return 实际读取的字节数，遇到不可读页时可能小于 size
+     */
+    Result<size_t> readProcessMemory(
+        pid_t pid,
+        uintptr_t address,
+        uint8_t* buffer,
+        size_t size
+    );
+    
+    Result<size_t> readProcessMemory(
+        const ProcessHandle& process,
+        uintptr_t address,
+        uint8_t* buffer,
+        size_t size
+    );
 
 private:
+    mutable std::mutex handlesMutex_;
+    mutable std::unordered_map<pid_t, std::shared_ptr<ProcessHandle>> handles_;
+    
+    /**
+     * 丢弃缓存中的句柄（仅当仍是同一个句柄时）
+     */
+    void dropHandle(pid_t pid, const std::shared_ptr<ProcessHandle>& process) const;
+    
+    /**
+     * 通过 PROCMAP_QUERY 查询包含地址的映射
+     * 
+     * @param region 输出区域，为 nullptr 时只判断是否命中
+     * @return 0 表示命中，否则为 errno（ENOENT 表示未映射）
+     */
+    int queryRegion(const ProcessHandle& process, uintptr_t address, MemoryRegion* region);
+    
+    /**
+     * 流式扫描文本 maps 判断地址是否有效
+     */
+    bool isValidAddressFromText(int mapsFd, uintptr_t address);
+    
     /**
      * 解析 /proc/pid/maps 文件
      */
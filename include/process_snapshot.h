@@ -0,0 +1,256 @@
+#ifndef USERSPACE_KERNEL_CALL_PROCESS_SNAPSHOT_H
+#define USERSPACE_KERNEL_CALL_PROCESS_SNAPSHOT_H
+
+#include "data_models.h"
+#include "result.h"
+#include "signature_scanner.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+namespace ukc {
+
+class SnapshotReader;
+class SnapshotStore;
+
+/**
+ * 快照数据块的压缩方式
+ */
+enum class SnapshotCompression : uint8_t {
+    None,        // 不压缩，数据块按页对齐存放，读取时零拷贝
+    Lz4          // LZ4 块压缩，压缩率不足 1/8 的块仍按未压缩存放
+};
+
+/**
+ * 快照写入配置
+ */
+struct SnapshotWriterConfig {
+    size_t blockSize = 64 * 1024;                   // 数据块大小（按页对齐）
+    size_t readBatchSize = 8 * 1024 * 1024;         // 单次 process_vm_readv 读取的最大字节数
+    SnapshotCompression compression = SnapshotCompression::None;
+    SnapshotStore* store = nullptr;                 // 内容寻址的页存储，非空时按页去重（忽略 compression）
+    bool trackDirtyPages = false;                   // 读取前清除目标的 soft-dirty 位并在 store 中登记，需要 store
+    const SnapshotReader* base = nullptr;           // 增量捕获的基准快照，必须与 store 使用同一个存储
+};
+
+/**
+ * 快照写入统计
+ */
+struct SnapshotWriteStats {
+    size_t regions = 0;             // 写入的区域数
+    size_t blocks = 0;              // 写入的数据块数
+    size_t bytesCaptured = 0;       // 成功读取的字节数
+    size_t bytesUnreadable = 0;     // 不可读而未捕获的字节数
+    size_t bytesStored = 0;         // 数据块在文件中占用的字节数（不含页对齐填充）
+    size_t zeroBlocks = 0;          // 全零而不存储数据的块数
+    size_t storePagesWritten = 0;   // 新写入页存储的页数
+    size_t storePagesReused = 0;    // 引用页存储中已有内容的页数
+    size_t bytesUnchanged = 0;      // 增量捕获中自 base 以来未写过、直接沿用而未读取的字节数
+    size_t readCalls = 0;           // 读取目标进程的系统调用次数
+    size_t fileSize = 0;            // 快照文件大小
+};
+
+/**
+ * 快照基本信息
+ */
+struct SnapshotInfo {
+    pid_t pid = 0;                  // 捕获的进程
+    uint64_t captureTimeNs = 0;     // 捕获时间（CLOCK_REALTIME 纳秒）
+    size_t pageSize = 0;
+    size_t blockSize = 0;
+    size_t blockCount = 0;
+    size_t fileSize = 0;
+    bool dirtyTracked = false;      // 读取前清除了目标的 soft-dirty 位
+    uint64_t dirtyGeneration = 0;   // 清除时在页存储中登记的代号，未跟踪时为 0
+};
+
+/**
+ * 快照中一页的存放方式
+ */
+struct SnapshotPage {
+    enum class Kind : uint8_t {
+        Missing,    // 不在快照中或未被捕获
+        Zero,       // 全零
+        Stored,     // 在页存储中
+        Inline      // 在快照文件中
+    };
+    
+    Kind kind = Kind::Missing;
+    uint64_t storeOffset = 0;       // Stored 时为页在 pages.dat 中的偏移
+};
+
+/**
+ * 快照中的一段连续数据
+ */
+struct SnapshotSpan {
+    const uint8_t* data = nullptr;  // 为空表示起始地址所在的页未被捕获
+    size_t size = 0;                // 可读的字节数；data 为空时为需要跳过的字节数
+};
+
+/**
+ * 进程内存快照写入器
+ *
+ * 文件格式（小端，所有偏移相对文件开头）：
+ *   - 文件头：魔数 "UKCSNAP\0"、版本、页大小、块大小、pid、捕获时间、各表的偏移
+ *   - 数据块：每个区域按 blockSize 切成块；未压缩的块按页对齐存放，压缩块紧密存放，
+ *     全零块和不可读的块不占数据空间；使用页存储时数据在存储中，块只记录偏移
+ *   - 区域表：起止地址、权限、路径（指向字符串表）、第一个块的下标和块数
+ *   - 块表：文件偏移、存储长度、原始长度、编码
+ *   - 字符串表
+ *
+ * 数据边读边写，内存占用只有一个读取批次：多个块（可以跨区域）合并为一次
+ * process_vm_readv，遇到不可读的页时对所在块逐页重读，不可读的页单独记为块。
+ * 文件头在写完各表后回填。
+ *
+ * 配置了 SnapshotStore 时每页按内容哈希去重：与之前任何一次捕获相同的页
+ * 只引用存储中已有的副本，周期性捕获同一进程时绝大部分页不再写入磁盘。
+ *
+ * 增量捕获：以 trackDirtyPages 捕获的快照作为 base 时，先批量读取 pagemap，
+ * 在内存或交换区中且 soft-dirty 位未置位的页直接引用 base 在页存储中的副本，
+ * 只读取之后写过的页，代价与写入的工作集成正比而与映射大小无关。
+ * soft-dirty 位只反映最后一次清除以来的写入，因此每次清除都在页存储中登记代号，
+ * 只有该进程最后登记的快照可以作为 base；以更早的快照为 base 时退回完整读取。
+ * 在本存储之外清除 soft-dirty（其他存储的捕获或直接写 /proc/<pid>/clear_refs）
+ * 无法被察觉，会使增量链失效，这样的进程不应再使用增量捕获。
+ * 内核不支持 soft-dirty、无法读取 pagemap 或 base 未跟踪时退回完整读取（仍按内容去重）。
+ * 读取 pagemap 与清除 soft-dirty 之间目标写入的页会被当作未变化，
+ * 需要严格一致的增量链时应在捕获期间暂停目标进程。
+ */
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(SnapshotWriterConfig config = SnapshotWriterConfig());
+
+    /**
+     * 捕获进程中满足 filter 的可读区域
+     * 先写入 path + ".tmp"，成功后原子地替换 path；失败时 path 上已有的快照不变
+     */
+    Result<SnapshotWriteStats> capture(
+        pid_t pid,
+        const std::string& path,
+        const RegionFilter& filter = RegionFilter()
+    );
+
+    /**
+     * 捕获指定的区域（通常来自 getMemoryMaps）
+     */
+    Result<SnapshotWriteStats> capture(
+        pid_t pid,
+        const std::vector<MemoryRegion>& regions,
+        const std::string& path
+    );
+
+private:
+    SnapshotWriterConfig config_;
+};
+
+/**
+ * 进程内存快照读取器
+ *
+ * 打开时把整个文件 mmap 为只读并校验各表，之后的访问不再有系统调用。
+ * 未压缩的连续块直接返回映射内的指针，压缩块和全零块解码到调用方的缓冲区。
+ * 快照引用页存储时同时映射存储的 pages.dat。
+ * 可以通过 SignatureScanner::scanSnapshot 离线扫描，结果与扫描原进程一致。
+ *
+ * 读取接口是 const 且不修改内部状态，可以在多个线程中同时使用。
+ */
+class SnapshotReader {
+public:
+    /**
+     * 打开快照文件
+     */
+    static Result<SnapshotReader> open(const std::string& path);
+
+    SnapshotReader() = default;
+    ~SnapshotReader();
+
+    SnapshotReader(SnapshotReader&& other) noexcept;
+    SnapshotReader& operator=(SnapshotReader&& other) noexcept;
+
+    SnapshotReader(const SnapshotReader&) = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+    const SnapshotInfo& info() const {
+        return info_;
+    }
+
+    /**
+     * 快照中的区域，按起始地址排序
+     */
+    const std::vector<MemoryRegion>& regions() const {
+        return regions_;
+    }
+
+    /**
+     * 引用的页存储 pages.dat 路径，未使用页存储时为空
+     */
+    const std::string& storePath() const {
+        return storePath_;
+    }
+
+    /**
+     * address 所在的整页在快照中的存放方式
+     */
+    SnapshotPage page(uintptr_t address) const;
+
+    /**
+     * 获取 address 起最多 size 字节的连续数据，遇到未捕获的页或区域结束时截断
+     *
+     * 所需数据都是文件中连续的未压缩块时返回映射内的指针，否则解码到 scratch
+     * （容量至少 size 字节）。address 不在任何区域内时返回 {nullptr, 0}。
+     */
+    SnapshotSpan span(uintptr_t address, size_t size, uint8_t* scratch) const;
+
+    /**
+     * 复制 address 起的数据，遇到未捕获的页或区域结束时截断
+     *
+     * @return 实际复制的字节数
+     */
+    Result<size_t> read(uintptr_t address, uint8_t* buffer, size_t size) const;
+
+private:
+    struct Block {
+        uint64_t fileOffset;
+        uint32_t storedSize;
+        uint32_t rawSize;
+        uint8_t encoding;
+    };
+
+    const uint8_t* base_ = nullptr;
+    size_t mappedSize_ = 0;
+    const uint8_t* storeBase_ = nullptr;    // 页存储 pages.dat 的映射
+    size_t storeSize_ = 0;
+    std::string storePath_;
+    SnapshotInfo info_;
+    std::vector<MemoryRegion> regions_;
+    std::vector<Block> blocks_;
+    std::vector<uintptr_t> blockStarts_;    // 各块的起始地址，与 blocks_ 一一对应
+    std::vector<size_t> regionBlockEnds_;   // 各区域最后一个块之后的下标
+
+    void unmap();
+
+    /**
+     * 映射快照引用的页存储
+     */
+    Result<void> mapStore(const std::string& path);
+
+    /**
+     * 未压缩块（快照文件或页存储中）的数据指针，其他编码返回空
+     */
+    const uint8_t* directData(size_t index) const;
+
+    /**
+     * 查找包含 address 的块，没有时返回 blocks_.size()
+     */
+    size_t findBlock(uintptr_t address) const;
+
+    /**
+     * 把块 index 中从 offset 起的 size 字节解码到 dst
+     */
+    bool decodeBlock(size_t index, size_t offset, uint8_t* dst, size_t size) const;
+};
+
+} // namespace ukc
+
+#endif // USERSPACE_KERNEL_CALL_PROCESS_SNAPSHOT_H
@@ -0,0 +1,93 @@
+#ifndef USERSPACE_KERNEL_CALL_READ_COALESCER_H
+#define USERSPACE_KERNEL_CALL_READ_COALESCER_H
+
+#include "executor.h"
+#include "memory_injector.h"
+#include "read_engine.h"
+#include "result.h"
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <sys/types.h>
+
+namespace ukc {
+
+/**
+ * 读取合并统计
+ */
+struct ReadCoalescerStats {
+    size_t requests = 0;        // 收到的读取请求数
+    size_t batches = 0;         // 实际提交给读取引擎的批次数（每批一个进程）
+    size_t maxBatchSize = 0;    // 单批最多合并的请求数
+
+    /**
+     * 平均每批合并的请求数
+     */
+    double averageBatchSize() const {
+        return batches == 0 ? 0.0 : static_cast<double>(requests) / static_cast<double>(batches);
+    }
+};
+
+/**
+ * 异步读取合并器
+ *
+ * 各调用方的读取请求先进入共享的待处理队列，由执行器上的一个排空任务
+ * 成批取出，按进程分组后一次交给同一个读取引擎。排空任务执行期间到达的
+ * 请求会在下一轮一起提交，因此并发调用方越多，每批合并的请求越多。
+ *
+ * 同一时间最多只有一个排空任务，读取引擎不会被并发使用。
+ */
+class ReadCoalescer {
+public:
+    ReadCoalescer(
+        std::shared_ptr<MemoryInjector> injector,
+        Executor& executor,
+        ReadEngineConfig config = ReadEngineConfig()
+    );
+
+    ReadCoalescer(const ReadCoalescer&) = delete;
+    ReadCoalescer& operator=(const ReadCoalescer&) = delete;
+
+    /**
+     * 提交一个读取请求
+     */
+    std::future<Result<std::vector<uint8_t>>> read(pid_t pid, uintptr_t address, size_t size);
+
+    /**
+     * 获取合并统计
+     */
+    ReadCoalescerStats stats() const;
+
+private:
+    struct PendingRead {
+        pid_t pid;
+        uintptr_t address;
+        size_t size;
+        std::promise<Result<std::vector<uint8_t>>> promise;
+    };
+
+    std::shared_ptr<MemoryInjector> injector_;
+    Executor& executor_;
+    ReadEngine engine_;
+
+    mutable std::mutex mutex_;
+    std::vector<PendingRead> pending_;
+    bool draining_ = false;
+    ReadCoalescerStats stats_;
+
+    /**
+     * 反复取出待处理请求并执行，直到队列为空
+     */
+    void drain();
+
+    /**
+     * 执行同一进程的一批请求
+     */
+    void executeBatch(PendingRead* requests, size_t count);
+};
+
+} // namespace ukc
+
+#endif // USERSPACE_KERNEL_CALL_READ_COALESCER_H
@@ -0,0 +1,113 @@
+#ifndef USERSPACE_KERNEL_CALL_READ_ENGINE_H
+#define USERSPACE_KERNEL_CALL_READ_ENGINE_H
+
+#include "data_models.h"
+#include "process_handle.h"
+#include "result.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace ukc {
+
+/**
+ * 读取后端
+ */
+enum class ReadBackend {
+    IoUring,    // io_uring 异步队列，不可用时自动退回 Preadv
+    Preadv      // 同步 preadv，地址连续的读取合并为一次调用
+};
+
+/**
+ * 读取引擎配置
+ */
+struct ReadEngineConfig {
+    ReadBackend backend = ReadBackend::IoUring;
+    unsigned queueDepth = 64;       // 同时在途的读取数（io_uring 提交队列深度）
+    size_t slotSize = 4096;         // 每个注册缓冲区槽的大小，更大的读取直接读入结果缓冲区
+};
+
+/**
+ * 读取引擎统计（累加）
+ */
+struct ReadEngineStats {
+    size_t reads = 0;               // 执行的读操作数
+    size_t failed = 0;              // 失败的读操作数
+    size_t syscalls = 0;            // io_uring_enter / preadv / pread 调用次数
+    size_t fixedReads = 0;          // 经注册缓冲区（IORING_OP_READ_FIXED）完成的读取数
+};
+
+/**
+ * 批量读取引擎
+ * 通过目标进程的 /proc/<pid>/mem 描述符执行一批读操作
+ *
+ * io_uring 后端（原始系统调用，不依赖 liburing）：
+ *   - 每个读操作是一个按地址偏移的 IORING_OP_READ，最多 queueDepth 个同时在途
+ *   - 构造时注册 queueDepth 个 slotSize 大小的缓冲区槽，不超过槽大小的读取
+ *     使用 IORING_OP_READ_FIXED，完成后复制到操作的结果中
+ *   - 完成事件逐个回填到对应的 MemoryOperation
+ *
+ * 内核不支持或禁用了 io_uring（io_uring_disabled、seccomp）时退回 preadv。
+ *
+ * 引擎持有一个 io_uring 实例，不是线程安全的；每个线程使用各自的引擎。
+ */
+class ReadEngine {
+public:
+    explicit ReadEngine(ReadEngineConfig config = ReadEngineConfig());
+    ~ReadEngine();
+
+    ReadEngine(const ReadEngine&) = delete;
+    ReadEngine& operator=(const ReadEngine&) = delete;
+
+    /**
+     * 实际使用的后端
+     */
+    ReadBackend backend() const;
+
+    /**
+     * 获取配置
+     */
+    const ReadEngineConfig& config() const {
+        return config_;
+    }
+
+    /**
+     * 执行 operations[0, count) 中的读操作，写操作原样跳过
+     *
+     * 每个读操作的 success/result/error 独立回填；读取失败的错误码为
+     * ReadFailed（附带 errno），进程已退出时为 ProcessGone。
+     *
+     * @param stats 可选，累加读取统计
+     * @return 成功的读操作数；进程没有可用的 mem 描述符时返回 Unavailable
+     */
+    Result<size_t> read(
+        const ProcessHandle& process,
+        MemoryOperation* operations,
+        size_t count,
+        ReadEngineStats* stats = nullptr
+    );
+
+private:
+    struct Ring;
+
+    ReadEngineConfig config_;
+    std::unique_ptr<Ring> ring_;
+
+    size_t readWithRing(
+        const ProcessHandle& process,
+        MemoryOperation* operations,
+        const std::vector<size_t>& readIndices,
+        ReadEngineStats& stats
+    );
+
+    size_t readWithPreadv(
+        const ProcessHandle& process,
+        MemoryOperation* operations,
+        const std::vector<size_t>& readIndices,
+        ReadEngineStats& stats
+    );
+};
+
+} // namespace ukc
+
+#endif // USERSPACE_KERNEL_CALL_READ_ENGINE_H
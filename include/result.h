@@ -1,16 +1,43 @@
 #ifndef USERSPACE_KERNEL_CALL_RESULT_H
 #define USERSPACE_KERNEL_CALL_RESULT_H
 
-#include <string>
+#include "error_code.h"
 #include <optional>
-#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
 
 namespace ukc {
 
+template<typename T>
+class Result;
+
+template<>
+class Result<void>;
+
+namespace detail {
+
+/**
+ * 从错误结果中取值时调用：输出错误消息并终止进程
+ */
+[[noreturn]] void badResultAccess(const Error& error);
+
+template<typename R>
+struct IsResult : std::false_type {};
+
+template<typename T>
+struct IsResult<Result<T>> : std::true_type {};
+
+} // namespace detail
+
 /**
  * 统一的错误处理类型
  * 所有可能失败的操作都返回 Result<T>
- * 
+ *
+ * 内部为 std::variant<T, Error>：失败时不构造 T，成功时不携带错误消息。
+ * 不抛出异常，从错误结果中取值会输出错误消息并终止进程。
+ *
  * 使用示例：
  *   Result<int> res = someOperation();
  *   if (res.isSuccess()) {
@@ -18,136 +45,278 @@ namespace ukc {
  *   } else {
  *       std::cerr << "Error: " << res.errorMessage() << std::endl;
  *   }
+ *
+ *   // 链式调用
+ *   auto size = openFile(path).and_then(readHeader).map(headerSize);
  */
 template<typename T>
-class Result {
+class [[nodiscard]] Result {
 public:
+    using ValueType = T;
+
+    /**
+     * 由错误构造，便于直接 return Error(...)
+     */
+    Result(Error error) : storage_(std::in_place_index<1>, std::move(error)) {}
+
     /**
      * 创建成功结果
      */
     static Result<T> success(T value) {
-        Result<T> result;
-        result.success_ = true;
-        result.value_ = std::move(value);
-        return result;
+        return Result<T>(std::in_place_index<0>, std::move(value));
     }
 
     /**
      * 创建错误结果
      */
     static Result<T> error(const std::string& message) {
-        Result<T> result;
-        result.success_ = false;
-        result.errorMessage_ = message;
-        return result;
+        return Result<T>(Error::fromMessage(message));
+    }
+
+    static Result<T> error(Error error) {
+        return Result<T>(std::move(error));
     }
 
     /**
      * 检查是否成功
      */
     bool isSuccess() const {
-        return success_;
+        return storage_.index() == 0;
     }
 
     /**
      * 检查是否失败
      */
     bool isError() const {
-        return !success_;
+        return storage_.index() != 0;
+    }
+
+    explicit operator bool() const {
+        return isSuccess();
     }
 
     /**
      * 获取值（仅在成功时调用）
      */
     T& value() {
-        if (!success_) {
-            throw std::runtime_error("Cannot get value from error result: " + errorMessage_);
+        if (T* value = std::get_if<0>(&storage_)) {
+            return *value;
         }
-        return value_;
+        detail::badResultAccess(*std::get_if<1>(&storage_));
     }
 
     /**
      * 获取值（仅在成功时调用，const 版本）
      */
     const T& value() const {
-        if (!success_) {
-            throw std::runtime_error("Cannot get value from error result: " + errorMessage_);
+        if (const T* value = std::get_if<0>(&storage_)) {
+            return *value;
         }
-        return value_;
+        detail::badResultAccess(*std::get_if<1>(&storage_));
     }
 
     /**
-     * 获取错误消息
+     * 移动值（仅在成功时调用）
      */
-    const std::string& errorMessage() const {
-        return errorMessage_;
+    T moveValue() {
+        return std::move(value());
     }
 
     /**
-     * 移动值（仅在成功时调用）
+     * 成功时返回值，失败时返回 fallback
      */
-    T moveValue() {
-        if (!success_) {
-            throw std::runtime_error("Cannot move value from error result: " + errorMessage_);
+    T valueOr(T fallback) const {
+        if (const T* value = std::get_if<0>(&storage_)) {
+            return *value;
+        }
+        return fallback;
+    }
+
+    /**
+     * 获取错误（仅在失败时有意义，成功时返回空错误）
+     */
+    const Error& errorInfo() const {
+        static const Error none;
+        const Error* error = std::get_if<1>(&storage_);
+        return error ? *error : none;
+    }
+
+    /**
+     * 获取错误类别
+     */
+    ErrorCode errorCode() const {
+        return errorInfo().code();
+    }
+
+    /**
+     * 获取错误消息（按需格式化，成功时为空）
+     */
+    std::string errorMessage() const {
+        const Error* error = std::get_if<1>(&storage_);
+        return error ? error->message() : std::string();
+    }
+
+    /**
+     * 成功时以值调用 f（f 返回 Result<U>），失败时传递错误
+     */
+    template<typename F>
+    auto and_then(F&& f) const& {
+        using R = std::decay_t<std::invoke_result_t<F, const T&>>;
+        static_assert(detail::IsResult<R>::value, "and_then callback must return a Result");
+        if (const T* value = std::get_if<0>(&storage_)) {
+            return std::forward<F>(f)(*value);
+        }
+        return R(*std::get_if<1>(&storage_));
+    }
+
+    template<typename F>
+    auto and_then(F&& f) && {
+        using R = std::decay_t<std::invoke_result_t<F, T&&>>;
+        static_assert(detail::IsResult<R>::value, "and_then callback must return a Result");
+        if (T* value = std::get_if<0>(&storage_)) {
+            return std::forward<F>(f)(std::move(*value));
+        }
+        return R(std::move(*std::get_if<1>(&storage_)));
+    }
+
+    /**
+     * 成功时以值调用 f 并包装其返回值，失败时传递错误
+     */
+    template<typename F>
+    auto map(F&& f) const& {
+        using U = std::invoke_result_t<F, const T&>;
+        if (const T* value = std::get_if<0>(&storage_)) {
+            if constexpr (std::is_void_v<U>) {
+                std::forward<F>(f)(*value);
+                return Result<U>::success();
+            } else {
+                return Result<U>::success(std::forward<F>(f)(*value));
+            }
+        }
+        return Result<U>(*std::get_if<1>(&storage_));
+    }
+
+    template<typename F>
+    auto map(F&& f) && {
+        using U = std::invoke_result_t<F, T&&>;
+        if (T* value = std::get_if<0>(&storage_)) {
+            if constexpr (std::is_void_v<U>) {
+                std::forward<F>(f)(std::move(*value));
+                return Result<U>::success();
+            } else {
+                return Result<U>::success(std::forward<F>(f)(std::move(*value)));
+            }
         }
-        return std::move(value_);
+        return Result<U>(std::move(*std::get_if<1>(&storage_)));
     }
 
 private:
-    bool success_ = false;
-    T value_;
-    std::string errorMessage_;
+    template<typename... Args>
+    explicit Result(std::in_place_index_t<0> tag, Args&&... args)
+        : storage_(tag, std::forward<Args>(args)...) {}
+
+    std::variant<T, Error> storage_;
 };
 
 /**
  * Result<void> 特化版本
  */
 template<>
-class Result<void> {
+class [[nodiscard]] Result<void> {
 public:
+    using ValueType = void;
+
+    Result(Error error) : error_(std::move(error)) {}
+
     /**
      * 创建成功结果
      */
     static Result<void> success() {
-        Result<void> result;
-        result.success_ = true;
-        return result;
+        return Result<void>();
     }
 
     /**
      * 创建错误结果
      */
     static Result<void> error(const std::string& message) {
-        Result<void> result;
-        result.success_ = false;
-        result.errorMessage_ = message;
-        return result;
+        return Result<void>(Error::fromMessage(message));
+    }
+
+    static Result<void> error(Error error) {
+        return Result<void>(std::move(error));
     }
 
     /**
      * 检查是否成功
      */
     bool isSuccess() const {
-        return success_;
+        return !error_.has_value();
     }
 
     /**
      * 检查是否失败
      */
     bool isError() const {
-        return !success_;
+        return error_.has_value();
+    }
+
+    explicit operator bool() const {
+        return isSuccess();
+    }
+
+    /**
+     * 获取错误（成功时返回空错误）
+     */
+    const Error& errorInfo() const {
+        static const Error none;
+        return error_ ? *error_ : none;
+    }
+
+    ErrorCode errorCode() const {
+        return errorInfo().code();
     }
 
     /**
-     * 获取错误消息
+     * 获取错误消息（按需格式化，成功时为空）
      */
-    const std::string& errorMessage() const {
-        return errorMessage_;
+    std::string errorMessage() const {
+        return error_ ? error_->message() : std::string();
+    }
+
+    /**
+     * 成功时调用 f（f 返回 Result<U>），失败时传递错误
+     */
+    template<typename F>
+    auto and_then(F&& f) const {
+        using R = std::decay_t<std::invoke_result_t<F>>;
+        static_assert(detail::IsResult<R>::value, "and_then callback must return a Result");
+        if (!error_) {
+            return std::forward<F>(f)();
+        }
+        return R(*error_);
+    }
+
+    /**
+     * 成功时调用 f 并包装其返回值，失败时传递错误
+     */
+    template<typename F>
+    auto map(F&& f) const {
+        using U = std::invoke_result_t<F>;
+        if (!error_) {
+            if constexpr (std::is_void_v<U>) {
+                std::forward<F>(f)();
+                return Result<U>::success();
+            } else {
+                return Result<U>::success(std::forward<F>(f)());
+            }
+        }
+        return Result<U>(*error_);
     }
 
 private:
-    bool success_ = false;
-    std::string errorMessage_;
+    Result() = default;
+
+    std::optional<Error> error_;
 };
 
 } // namespace ukc
@@ -4,10 +4,59 @@
 #include "data_models.h"
 #include "result.h"
 #include <vector>
+#include <string>
 #include <cstdint>
+#include <sys/types.h>
 
 namespace ukc {
 
+class Executor;
+class SnapshotReader;
+
+/**
+ * 进程内存区域过滤条件
+ */
+struct RegionFilter {
+    std::string permissions;       // 权限模式，如 "r-x"，'?' 表示不限；空表示只要求可读
+    std::string pathContains;      // 映射路径需包含的子串，空表示不限
+    bool includeSpecial = false;   // 是否包含 [vvar]、[vsyscall] 等特殊映射
+    
+    /**
+     * 检查区域是否满足条件（不可读区域始终不满足）
+     */
+    bool matches(const MemoryRegion& region) const;
+};
+
+/**
+ * 进程扫描配置
+ */
+struct ProcessScanConfig {
+    size_t chunkSize = 4 * 1024 * 1024;   // 单次读取的块大小（按页对齐）
+    size_t threadCount = 0;               // 扫描线程数，0 表示使用硬件并发数（有执行器时为执行器线程数 + 1）
+    Executor* executor = nullptr;         // 共享执行器，为空时为本次扫描单独创建线程
+    bool skipNonResident = true;          // 按 pagemap 跳过匿名区域中既不在内存也不在交换区的页
+};
+
+/**
+ * 进程扫描命中
+ */
+struct ProcessScanMatch {
+    uintptr_t address = 0;         // 绝对地址
+    size_t patternIndex = 0;       // 命中的模式下标
+    size_t regionIndex = 0;        // 所属区域在 ProcessScanResult::regions 中的下标
+};
+
+/**
+ * 进程扫描结果
+ */
+struct ProcessScanResult {
+    std::vector<MemoryRegion> regions;        // 参与扫描的区域
+    std::vector<ProcessScanMatch> matches;    // 按地址排序的命中
+    size_t bytesScanned = 0;                  // 实际扫描的字节数
+    size_t bytesUnreadable = 0;               // 因不可读而跳过的字节数
+    size_t bytesNonResident = 0;              // 匿名区域中未驻留（读出全零）而跳过的字节数
+};
+
 /**
  * 特征码扫描器
  * 在内存缓冲区中搜索特征码模式
@@ -42,6 +91,46 @@ public:
         const SignaturePattern& pattern
     );
 
+    /**
+     * 扫描进程的内存区域
+     * 
+     * 按过滤条件挑选可读区域，通过 process_vm_readv 分块读取，
+     * 多线程并行扫描。遇到不可读的页会跳过该页继续，不中止扫描。
+     * 匿名区域每块先批量读取 pagemap，未驻留的页不读取，既省去读取零页的时间，
+     * 也不会在目标进程中触发缺页、占用内存（skipNonResident）。
+     * 
+     * @param pid 目标进程
+     * @param patterns 特征码模式列表
+     * @param filter 区域过滤条件
+     * @param config 扫描配置
+     * @return 命中的绝对地址及其所属区域
+     */
+    static Result<ProcessScanResult> scanProcess(
+        pid_t pid,
+        const std::vector<SignaturePattern>& patterns,
+        const RegionFilter& filter = RegionFilter(),
+        const ProcessScanConfig& config = ProcessScanConfig()
+    );
+    
+    /**
+     * 扫描进程内存快照
+     * 
+     * 与 scanProcess 使用相同的分块和并行方式，未压缩的数据直接在映射上扫描；
+     * 捕获时不可读的页计入 bytesUnreadable。
+     * 
+     * @param snapshot 已打开的快照
+     * @param patterns 特征码模式列表
+     * @param filter 区域过滤条件
+     * @param config 扫描配置
+     * @return 命中的绝对地址（原进程中的地址）及其所属区域
+     */
+    static Result<ProcessScanResult> scanSnapshot(
+        const SnapshotReader& snapshot,
+        const std::vector<SignaturePattern>& patterns,
+        const RegionFilter& filter = RegionFilter(),
+        const ProcessScanConfig& config = ProcessScanConfig()
+    );
+
 private:
     /**
      * 检查缓冲区中的特定位置是否匹配特征码
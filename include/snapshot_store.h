@@ -0,0 +1,135 @@
+#ifndef USERSPACE_KERNEL_CALL_SNAPSHOT_STORE_H
+#define USERSPACE_KERNEL_CALL_SNAPSHOT_STORE_H
+
+#include "result.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+#include <unordered_map>
+#include <vector>
+
+namespace ukc {
+
+/**
+ * 内容寻址的快照页存储
+ *
+ * 目录中包含三个只追加的文件：
+ *   - pages.dat：每个不同内容的页存一份，按页对齐
+ *   - pages.idx：文件头加 (XXH64 哈希, pages.dat 中的偏移) 记录
+ *   - dirty.log：(pid, 代号) 记录，登记每个进程最近一次由本存储清除 soft-dirty 的捕获
+ *
+ * SnapshotWriterConfig::store 指向同一个存储时，多次捕获的相同页只写入一次，
+ * 快照中只记录页在 pages.dat 中的偏移；SnapshotReader 打开快照时按记录的路径
+ * 映射 pages.dat。哈希命中后会比较页内容，哈希冲突不会导致读到错误的数据。
+ *
+ * 打开时对索引文件加排他锁，同一时间只能有一个写入器使用；
+ * 已写入的页不会被修改或删除，读取器可以在写入的同时读取旧快照。
+ */
+class SnapshotStore {
+public:
+    /**
+     * 打开存储目录，不存在时创建
+     *
+     * @param pageSize 页大小，0 表示系统页大小；必须与已有存储一致
+     */
+    static Result<SnapshotStore> open(const std::string& directory, size_t pageSize = 0);
+
+    SnapshotStore() = default;
+    ~SnapshotStore();
+
+    SnapshotStore(SnapshotStore&& other) noexcept;
+    SnapshotStore& operator=(SnapshotStore&& other) noexcept;
+
+    SnapshotStore(const SnapshotStore&) = delete;
+    SnapshotStore& operator=(const SnapshotStore&) = delete;
+
+    /**
+     * pages.dat 的绝对路径，写入快照供读取器打开
+     */
+    const std::string& dataPath() const {
+        return dataPath_;
+    }
+
+    size_t pageSize() const {
+        return pageSize_;
+    }
+
+    /**
+     * 存储中不同内容的页数
+     */
+    size_t pageCount() const {
+        return static_cast<size_t>(dataSize_ / pageSize_);
+    }
+
+    /**
+     * 存入一页，内容已存在时不写入，返回已有页的偏移
+     *
+     * @param page pageSize() 字节
+     * @param existed 非空时返回内容是否已存在
+     * @return 页在 pages.dat 中的偏移
+     */
+    Result<uint64_t> put(const uint8_t* page, bool* existed = nullptr);
+
+    /**
+     * 把缓冲的新增页写入 pages.dat 并 fdatasync，再把它们的索引记录写入 pages.idx
+     * 并 fdatasync；返回成功后新增页和索引都已落盘
+     * 引用新增页的快照必须在 flush 之后提交
+     */
+    Result<void> flush();
+
+    /**
+     * 进程最近一次登记的 soft-dirty 代号，没有登记过时为 0
+     * 只有带着这个代号的快照可以作为该进程增量捕获的基准
+     */
+    uint64_t dirtyGeneration(pid_t pid) const;
+
+    /**
+     * 为即将清除 soft-dirty 的捕获分配新代号，写入 dirty.log 并 fdatasync
+     * 必须在清除之前调用：登记失败时不能清除，否则旧基准会被误认为仍然有效
+     *
+     * @return 新代号，总是大于 0
+     */
+    Result<uint64_t> beginDirtyGeneration(pid_t pid);
+
+private:
+    struct IndexRecord {
+        uint64_t hash;
+        uint64_t offset;
+    };
+
+    struct DirtyRecord {
+        int32_t pid;
+        uint32_t reserved;
+        uint64_t generation;
+    };
+
+    int dataFd_ = -1;
+    int indexFd_ = -1;
+    int dirtyFd_ = -1;
+    std::string dataPath_;
+    size_t pageSize_ = 0;
+    uint64_t dataSize_ = 0;           // 含写缓冲中的页
+    uint64_t flushedSize_ = 0;        // 已写入 pages.dat 的长度
+    uint64_t indexSize_ = 0;          // pages.idx 的有效长度
+    std::unordered_multimap<uint64_t, uint64_t> index_;
+    std::vector<IndexRecord> pending_;
+    std::vector<uint8_t> writeBuffer_;
+    std::vector<uint8_t> compareBuffer_;
+    uint64_t dirtySize_ = 0;          // dirty.log 的有效长度
+    uint64_t lastGeneration_ = 0;
+    std::unordered_map<pid_t, uint64_t> dirtyGenerations_;
+
+    /**
+     * 比较 offset 处已存储的页与 page 是否相同
+     */
+    Result<bool> samePage(uint64_t offset, const uint8_t* page);
+
+    Result<void> flushData();
+
+    void closeFiles();
+};
+
+} // namespace ukc
+
+#endif // USERSPACE_KERNEL_CALL_SNAPSHOT_STORE_H
@@ -0,0 +1,177 @@
+#ifndef USERSPACE_KERNEL_CALL_TRACE_RECORDER_H
+#define USERSPACE_KERNEL_CALL_TRACE_RECORDER_H
+
+#include "result.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ukc {
+
+/**
+ * 追踪事件类型（与 Chrome trace-event 的 ph 字段对应）
+ */
+enum class TracePhase : char {
+    Begin = 'B',
+    End = 'E',
+    Instant = 'i'
+};
+
+/**
+ * 一条追踪事件
+ * name 必须具有静态生存期（通常是字符串字面量），记录时不复制字符串。
+ */
+struct TraceEvent {
+    uint64_t timestampNs = 0;      // CLOCK_MONOTONIC_RAW
+    const char* name = nullptr;
+    uint64_t arg = 0;              // 可选参数（如字节数、请求数）
+    TracePhase phase = TracePhase::Instant;
+};
+
+namespace detail {
+struct TraceBuffer;
+}
+
+/**
+ * 追踪时间线记录器
+ *
+ * 每个线程写入自己的环形缓冲区（单写者，无锁），缓冲区满后覆盖最旧的事件。
+ * 时间戳取自 CLOCK_MONOTONIC_RAW（vDSO，不受 NTP 调整影响）。
+ * 记录器默认关闭，关闭时每个探针只有一次 relaxed 原子读取。
+ *
+ * 导出为 Chrome trace-event JSON，可直接在 chrome://tracing 或
+ * Perfetto UI (ui.perfetto.dev) 中打开。
+ */
+class TraceRecorder {
+public:
+    /**
+     * 每个线程的默认缓冲区容量（事件数）
+     */
+    static constexpr size_t kDefaultCapacity = 16384;
+
+    explicit TraceRecorder(size_t capacityPerThread = kDefaultCapacity);
+    ~TraceRecorder();
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    /**
+     * 库内置探针使用的全局记录器
+     */
+    static TraceRecorder& global();
+
+    /**
+     * 开始/停止记录
+     */
+    void enable() {
+        enabled_.store(true, std::memory_order_relaxed);
+    }
+
+    void disable() {
+        enabled_.store(false, std::memory_order_relaxed);
+    }
+
+    bool isEnabled() const {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    void begin(const char* name, uint64_t arg = 0) {
+        if (isEnabled()) {
+            record(TracePhase::Begin, name, arg);
+        }
+    }
+
+    void end(const char* name, uint64_t arg = 0) {
+        if (isEnabled()) {
+            record(TracePhase::End, name, arg);
+        }
+    }
+
+    void instant(const char* name, uint64_t arg = 0) {
+        if (isEnabled()) {
+            record(TracePhase::Instant, name, arg);
+        }
+    }
+
+    /**
+     * 清空所有线程的事件
+     * 应在没有线程写入时调用。
+     */
+    void clear();
+
+    /**
+     * 所有线程被覆盖（丢弃）的事件总数
+     */
+    uint64_t droppedEvents() const;
+
+    /**
+     * 按线程收集当前缓冲区中的事件（按时间排序）
+     * 与写入并发时，复制期间被覆盖的事件会被丢弃。
+     */
+    struct ThreadEvents {
+        int threadId = 0;
+        std::vector<TraceEvent> events;
+    };
+    std::vector<ThreadEvents> collect() const;
+
+    /**
+     * 导出 Chrome trace-event JSON
+     */
+    std::string toChromeJson() const;
+
+    /**
+     * 导出到文件
+     */
+    Result<void> writeChromeJson(const std::string& path) const;
+
+    /**
+     * 当前时间戳（纳秒，CLOCK_MONOTONIC_RAW）
+     */
+    static uint64_t now();
+
+    /**
+     * RAII 追踪区间
+     * 构造时若记录器未启用则不记录结束事件，保证 B/E 成对。
+     */
+    class Scope {
+    public:
+        Scope(TraceRecorder& recorder, const char* name, uint64_t arg = 0)
+            : recorder_(recorder.isEnabled() ? &recorder : nullptr), name_(name) {
+            if (recorder_) {
+                recorder_->record(TracePhase::Begin, name_, arg);
+            }
+        }
+
+        ~Scope() {
+            if (recorder_) {
+                recorder_->record(TracePhase::End, name_, 0);
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        TraceRecorder* recorder_;
+        const char* name_;
+    };
+
+private:
+    const uint64_t recorderId_;
+    const size_t capacity_;
+    std::atomic<bool> enabled_{false};
+
+    mutable std::mutex buffersMutex_;
+    std::vector<std::shared_ptr<detail::TraceBuffer>> buffers_;
+
+    void record(TracePhase phase, const char* name, uint64_t arg);
+    detail::TraceBuffer& localBuffer();
+};
+
+} // namespace ukc
+
+#endif // USERSPACE_KERNEL_CALL_TRACE_RECORDER_H
@@ -3,8 +3,21 @@
 
 #include "result.h"
 #include "data_models.h"
+#include "batch_planner.h"
+#include "batch_arena.h"
+#include "signature_scanner.h"
+#include "performance_monitor.h"
+#include "trace_recorder.h"
+#include "process_handle.h"
+#include "read_engine.h"
+#include "read_coalescer.h"
+#include "executor.h"
 #include <vector>
 #include <memory>
+#include <future>
+#include <mutex>
+#include <atomic>
+#include <type_traits>
 #include <sys/types.h>
 
 namespace ukc {
@@ -15,22 +28,80 @@ class KernelCaller;
 class ProcessManager;
 class MemoryInjector;
 
+/**
+ * 按需初始化的子系统，可按位组合
+ */
+enum class Subsystem : uint32_t {
+    None = 0,
+    Executor = 1u << 0,   // 共享执行器（创建工作线程）
+    Injector = 1u << 1,   // 进程内存读写
+    Locator = 1u << 2,    // 内核符号定位（完整解析 /proc/kallsyms）
+    Caller = 1u << 3,     // 内核函数调用（检查 Root 权限）
+    All = Executor | Injector | Locator | Caller
+};
+
+inline Subsystem operator|(Subsystem a, Subsystem b) {
+    return static_cast<Subsystem>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+}
+
+inline Subsystem operator&(Subsystem a, Subsystem b) {
+    return static_cast<Subsystem>(static_cast<uint32_t>(a) & static_cast<uint32_t>(b));
+}
+
 /**
  * 用户态调用内核系统
  * 统一的应用层 API
+ *
+ * 同步接口阻塞调用线程；*Async 接口立即返回 std::future，任务在内部执行器上
+ * 运行。并发的 readMemoryAsync 请求经同一个 ReadCoalescer 成批交给读取引擎。
+ *
+ * 进程扫描、kallsyms 解析、大批量读取和异步接口共用同一个工作窃取执行器，
+ * 库内线程总数不超过 ExecutorConfig 配置的数量。
+ *
+ * initialize() 只创建组件对象，各子系统在第一次被用到时才初始化（每个子系统
+ * 只初始化一次，失败结果同样被缓存）：只查找进程或读取 maps 的调用不会解析
+ * kallsyms，也不会创建工作线程。需要提前准备时调用 warmup() 在后台初始化。
+ * writeMemory 和 batchOperations 可能写入目标进程，第一次调用时还会初始化
+ * 调用器（其中包含 root 权限检查），读取和 maps 查询不需要。
  */
 class UserspaceKernelCall {
 public:
     UserspaceKernelCall();
+    
+    /**
+     * @param executorConfig 内部执行器的线程数、CPU 亲和性和大小核偏好
+     */
+    explicit UserspaceKernelCall(ExecutorConfig executorConfig);
     ~UserspaceKernelCall();
     
     /**
      * 初始化系统
+     * 只创建组件，不初始化任何子系统，子系统在第一次使用时初始化
      */
     Result<void> initialize();
     
+    /**
+     * 在后台初始化指定的子系统
+     * 返回的 future 在全部子系统初始化完成后就绪，结果为第一个失败的子系统的错误
+     */
+    std::future<Result<void>> warmup(Subsystem subsystems = Subsystem::All);
+    
+    /**
+     * 已成功初始化的子系统
+     */
+    Subsystem readySubsystems() const;
+    
+    /**
+     * 打开目标进程句柄
+     * 句柄可以代替 pid 传给下面的读写接口，长时间访问同一进程时
+     * 省去每次操作的句柄查找，并且不会因 pid 复用而误读其他进程
+     */
+    Result<ProcessHandle> openProcess(pid_t pid);
+    
     /**
      * 读取目标进程内存
+     * 
+     * 与 readMemoryAsync 相同，经 /proc/<pid>/mem 读取（无权限时退回 process_vm_readv）
      */
     Result<std::vector<uint8_t>> readMemory(
         pid_t targetPid,
@@ -38,6 +109,48 @@ public:
         size_t size
     );
     
+    Result<std::vector<uint8_t>> readMemory(
+        const ProcessHandle& process,
+        uintptr_t address,
+        size_t size
+    );
+    
+    /**
+     * 读取目标进程内存到调用方缓冲区（成功路径不分配堆内存）
+     */
+    Result<size_t> readMemoryInto(
+        pid_t targetPid,
+        uintptr_t address,
+        uint8_t* buffer,
+        size_t size
+    );
+    
+    Result<size_t> readMemoryInto(
+        const ProcessHandle& process,
+        uintptr_t address,
+        uint8_t* buffer,
+        size_t size
+    );
+    
+    /**
+     * 读取单个 POD 值
+     * 
+     * @param target pid_t 或 ProcessHandle
+     */
+    template<typename T, typename Target>
+    Result<T> read(const Target& target, uintptr_t address) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "read<T>() requires a trivially copyable type");
+        T value{};
+        auto readResult = readMemoryInto(
+            target, address, reinterpret_cast<uint8_t*>(&value), sizeof(T)
+        );
+        if (readResult.isError()) {
+            return Result<T>::error(readResult.errorInfo());
+        }
+        return Result<T>::success(value);
+    }
+    
     /**
      * 写入目标进程内存
      */
@@ -47,6 +160,12 @@ public:
         const std::vector<uint8_t>& data
     );
     
+    Result<size_t> writeMemory(
+        const ProcessHandle& process,
+        uintptr_t address,
+        const std::vector<uint8_t>& data
+    );
+    
     /**
      * 批量内存操作
      */
@@ -55,6 +174,43 @@ public:
         std::vector<MemoryOperation>& operations
     );
     
+    /**
+     * 批量内存操作（合并相邻读取）
+     */
+    Result<void> batchOperations(
+        pid_t targetPid,
+        std::vector<MemoryOperation>& operations,
+        const BatchPlanner& planner,
+        BatchPlanStats* stats = nullptr
+    );
+    
+    /**
+     * 批量内存操作（读操作经 io_uring/preadv 读取引擎执行）
+     */
+    Result<void> batchOperations(
+        pid_t targetPid,
+        std::vector<MemoryOperation>& operations,
+        ReadEngine& engine,
+        ReadEngineStats* stats = nullptr
+    );
+    
+    /**
+     * 批量读取（结果写入 arena，错误以错误码表示）
+     */
+    Result<size_t> batchRead(
+        pid_t targetPid,
+        const std::vector<BatchReadRequest>& requests,
+        std::vector<BatchReadResult>& results,
+        BatchArena& arena
+    );
+    
+    Result<size_t> batchRead(
+        const ProcessHandle& process,
+        const std::vector<BatchReadRequest>& requests,
+        std::vector<BatchReadResult>& results,
+        BatchArena& arena
+    );
+    
     /**
      * 查找进程
      */
@@ -64,6 +220,76 @@ public:
      * 获取进程内存映射
      */
     Result<std::vector<MemoryRegion>> getProcessMemoryMaps(pid_t pid);
+    
+    Result<std::vector<MemoryRegion>> getProcessMemoryMaps(const ProcessHandle& process);
+    
+    /**
+     * 扫描目标进程内存中的特征码
+     */
+    Result<ProcessScanResult> scanProcess(
+        pid_t pid,
+        const std::vector<SignaturePattern>& patterns,
+        const RegionFilter& filter = RegionFilter()
+    );
+    
+    /**
+     * 异步读取目标进程内存
+     * 与其他并发请求合并后经读取引擎执行
+     */
+    std::future<Result<std::vector<uint8_t>>> readMemoryAsync(
+        pid_t targetPid,
+        uintptr_t address,
+        size_t size
+    );
+    
+    /**
+     * 异步扫描目标进程内存中的特征码
+     */
+    std::future<Result<ProcessScanResult>> scanAsync(
+        pid_t pid,
+        std::vector<SignaturePattern> patterns,
+        RegionFilter filter = RegionFilter()
+    );
+    
+    /**
+     * 异步定位一组内核函数
+     * 按 name/pattern 定位，结果中 address、isLocated、locatedTime 被回填；
+     * 单个函数找不到时 isLocated 为 false，不影响其他函数
+     */
+    std::future<Result<std::vector<KernelFunctionInfo>>> locateFunctionsAsync(
+        std::vector<KernelFunctionInfo> functions
+    );
+    
+    /**
+     * 获取异步读取的合并统计
+     */
+    ReadCoalescerStats getReadCoalescerStats() const;
+    
+    /**
+     * 获取内部执行器各阶段的任务数、窃取次数和并发度
+     * 未初始化时返回空
+     */
+    std::vector<ExecutorStageStats> getExecutorStats() const;
+    
+    /**
+     * 获取库内置探针的性能监控器
+     * 包含 maps 解析、kallsyms 解析/查找、扫描、批量读取等阶段的延迟，
+     * 以及符号缓存命中/未命中等计数器。探针由编译选项 UKC_ENABLE_PROBES 控制，
+     * 关闭时监控器中没有样本。
+     */
+    PerformanceMonitor& getPerformanceMonitor();
+    
+    /**
+     * 获取库内置探针的追踪记录器
+     * 调用 enable() 后记录初始化、批量操作和扫描等阶段的时间线，
+     * 可导出为 Chrome trace-event JSON。
+     */
+    TraceRecorder& getTraceRecorder();
+    
+    /**
+     * 探针是否在编译时启用
+     */
+    bool probesEnabled() const;
 
 private:
     std::shared_ptr<KernelFunctionLocator> locator_;
@@ -71,6 +297,51 @@ private:
     std::shared_ptr<ProcessManager> processManager_;
     std::shared_ptr<MemoryInjector> injector_;
     bool initialized_ = false;
+    
+    // 定位器的地址缓存不是线程安全的
+    std::mutex locatorMutex_;
+    
+    /**
+     * 子系统的一次性初始化状态
+     */
+    struct LazyInit {
+        std::once_flag once;
+        Error error;      // 错误码为 None 表示初始化成功
+    };
+    
+    LazyInit executorInit_;
+    LazyInit injectorInit_;
+    LazyInit locatorInit_;
+    LazyInit callerInit_;
+    std::atomic<uint32_t> ready_{0};
+    
+    // 执行器最后声明、最先销毁：析构时先执行完仍引用本对象和合并器的任务
+    ExecutorConfig executorConfig_;
+    std::once_flag asyncOnce_;
+    std::atomic<bool> asyncReady_{false};   // coalescer_ 创建后置位，供不经 asyncOnce_ 的读取方判断
+    std::unique_ptr<ReadCoalescer> coalescer_;
+    std::unique_ptr<Executor> executor_;
+    
+    /**
+     * 执行一次 initializer 并缓存结果，之后的调用直接返回缓存的结果
+     */
+    template<typename F>
+    Result<void> ensure(LazyInit& init, Subsystem subsystem, F&& initializer);
+    
+    /**
+     * 检查 initialize() 已调用，并按需初始化 subsystems
+     */
+    Result<void> require(Subsystem subsystems);
+    
+    Result<void> ensureExecutor();
+    Result<void> ensureInjector();
+    Result<void> ensureLocator();
+    Result<void> ensureCaller();
+    
+    /**
+     * 创建读取合并器（仅一次）
+     */
+    Result<void> ensureAsync();
 };
 
 } // namespace ukc
@@ -0,0 +1,17 @@
+#ifndef USERSPACE_KERNEL_CALL_XXHASH64_H
+#define USERSPACE_KERNEL_CALL_XXHASH64_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ukc {
+
+/**
+ * XXH64 哈希（与 xxHash 参考实现的输出一致）
+ * 四路并行累加，长输入上接近内存带宽
+ */
+uint64_t xxhash64(const void* data, size_t size, uint64_t seed = 0);
+
+} // namespace ukc
+
+#endif // USERSPACE_KERNEL_CALL_XXHASH64_H
@@ -1,5 +1,6 @@
 #include "arm64_assembly_bridge.h"
 #include <cstring>
+#include <stdexcept>
 
 namespace ukc {
 namespace arm64 {
@@ -15,6 +16,7 @@ extern "C" uint64_t kernel_call_bridge(
     uint64_t arg0, uint64_t arg1, uint64_t arg2,
     uint64_t arg3, uint64_t arg4, uint64_t arg5
 ) {
+#if defined(__aarch64__)
     uint64_t result;
     
     __asm__ __volatile__(
@@ -49,6 +51,13 @@ extern "C" uint64_t kernel_call_bridge(
     );
     
     return result;
+#else
+    // 非 ARM64 主机（如 x86_64 构建机）上无法执行内核调用
+    (void)kernel_func_addr;
+    (void)arg0; (void)arg1; (void)arg2;
+    (void)arg3; (void)arg4; (void)arg5;
+    throw std::runtime_error("kernel_call_bridge is only supported on ARM64");
+#endif
 }
 
 void generate_jump_instruction(
@@ -0,0 +1,40 @@
+#include "batch_arena.h"
+
+namespace ukc {
+
+BatchArena::BatchArena() = default;
+
+BatchArena::BatchArena(uint8_t* buffer, size_t capacity)
+    : buffer_(buffer),
+      capacity_(buffer ? capacity : 0),
+      external_(true) {
+}
+
+BatchArena::~BatchArena() = default;
+
+bool BatchArena::reserve(size_t capacity) {
+    if (capacity <= capacity_) {
+        return true;
+    }
+    if (external_) {
+        return false;
+    }
+
+    // 不保留旧内容：reserve 只在一批读取开始前调用
+    owned_.reset(new uint8_t[capacity]);
+    buffer_ = owned_.get();
+    capacity_ = capacity;
+    used_ = 0;
+    return true;
+}
+
+uint8_t* BatchArena::allocate(size_t size) {
+    if (size > capacity_ - used_) {
+        return nullptr;
+    }
+    uint8_t* ptr = buffer_ + used_;
+    used_ += size;
+    return ptr;
+}
+
+} // namespace ukc
@@ -0,0 +1,115 @@
+#include "batch_planner.h"
+#include <algorithm>
+
+namespace ukc {
+
+BatchPlanner::BatchPlanner(BatchPlannerConfig config)
+    : config_(config) {
+}
+
+std::vector<PlannedStep> BatchPlanner::plan(
+    const std::vector<MemoryOperation>& operations,
+    BatchPlanStats* stats
+) const {
+    std::vector<PlannedStep> steps;
+    BatchPlanStats localStats;
+    std::vector<size_t> readIndices;
+
+    for (size_t i = 0; i < operations.size(); ++i) {
+        if (operations[i].type == OperationType::Read) {
+            readIndices.push_back(i);
+            continue;
+        }
+
+        // 写操作是屏障：先落地之前的读，再单独执行写
+        planReads(operations, readIndices, steps, localStats);
+
+        PlannedStep writeStep;
+        writeStep.address = operations[i].address;
+        writeStep.size = operations[i].data.size();
+        writeStep.operationIndices.push_back(i);
+        steps.push_back(std::move(writeStep));
+    }
+    planReads(operations, readIndices, steps, localStats);
+
+    if (stats) {
+        *stats = localStats;
+    }
+    return steps;
+}
+
+void BatchPlanner::planReads(
+    const std::vector<MemoryOperation>& operations,
+    std::vector<size_t>& readIndices,
+    std::vector<PlannedStep>& steps,
+    BatchPlanStats& stats
+) const {
+    if (readIndices.empty()) {
+        return;
+    }
+
+    std::sort(readIndices.begin(), readIndices.end(), [&](size_t a, size_t b) {
+        const auto& opA = operations[a];
+        const auto& opB = operations[b];
+        if (opA.address != opB.address) {
+            return opA.address < opB.address;
+        }
+        return opA.size < opB.size;
+    });
+
+    PlannedStep current;
+    bool hasCurrent = false;
+
+    auto flush = [&]() {
+        if (hasCurrent) {
+            stats.transfers++;
+            stats.transferredBytes += current.size;
+            steps.push_back(std::move(current));
+            current = PlannedStep();
+            hasCurrent = false;
+        }
+    };
+
+    for (size_t index : readIndices) {
+        const auto& op = operations[index];
+        uintptr_t opEnd = op.address + op.size;
+
+        // 零长度或地址溢出的读取不参与合并，交给执行阶段单独处理
+        if (op.size == 0 || opEnd < op.address) {
+            PlannedStep single;
+            single.address = op.address;
+            single.size = op.size;
+            single.operationIndices.push_back(index);
+            steps.push_back(std::move(single));
+            continue;
+        }
+
+        stats.readOperations++;
+        stats.requestedBytes += op.size;
+
+        if (hasCurrent) {
+            uintptr_t currentEnd = current.address + current.size;
+            uintptr_t mergedEnd = std::max(currentEnd, opEnd);
+            bool withinGap = op.address <= currentEnd ||
+                             op.address - currentEnd <= config_.maxGap;
+            bool withinLimit = mergedEnd - current.address <= config_.maxTransferSize;
+
+            if (withinGap && withinLimit) {
+                current.size = mergedEnd - current.address;
+                current.operationIndices.push_back(index);
+                continue;
+            }
+            flush();
+        }
+
+        current.address = op.address;
+        current.size = op.size;
+        current.operationIndices.push_back(index);
+        hasCurrent = true;
+    }
+    flush();
+
+    readIndices.clear();
+}
+
+} // namespace ukc
@@ -0,0 +1,72 @@
+#include "error_code.h"
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+namespace ukc {
+
+const char* errorCodeToString(ErrorCode code) {
+    switch (code) {
+        case ErrorCode::None:            return "Success";
+        case ErrorCode::NotInitialized:  return "Not initialized";
+        case ErrorCode::InvalidArgument: return "Invalid argument";
+        case ErrorCode::ProcessGone:     return "Target process does not exist";
+        case ErrorCode::InvalidAddress:  return "Invalid address";
+        case ErrorCode::ReadFailed:      return "Read failed";
+        case ErrorCode::WriteFailed:     return "Write failed";
+        case ErrorCode::BufferTooSmall:  return "Buffer too small";
+        case ErrorCode::ProcessNotFound: return "Process not found";
+        case ErrorCode::SymbolNotFound:  return "Symbol not found";
+        case ErrorCode::PatternNotFound: return "Pattern not found";
+        case ErrorCode::InvalidPattern:  return "Invalid signature pattern";
+        case ErrorCode::Unavailable:     return "Not available";
+        case ErrorCode::Unknown:         return "Unknown error";
+    }
+    return "Unknown error";
+}
+
+const std::string& Error::name() const {
+    static const std::string empty;
+    return text_ && code_ != ErrorCode::Unknown ? *text_ : empty;
+}
+
+std::string Error::message() const {
+    if (code_ == ErrorCode::Unknown && text_) {
+        return *text_;
+    }
+
+    std::string text = errorCodeToString(code_);
+    char number[64];
+
+    if (text_) {
+        text += " '";
+        text += *text_;
+        text += "'";
+    }
+    if (hasAddress()) {
+        std::snprintf(number, sizeof(number), " at 0x%" PRIx64, address_);
+        text += number;
+    }
+    if (hasSize() && hasPid()) {
+        std::snprintf(number, sizeof(number), " (%" PRIu64 " bytes, pid %d)",
+                      size_, static_cast<int>(pid_));
+        text += number;
+    } else if (hasSize()) {
+        std::snprintf(number, sizeof(number), " (%" PRIu64 " bytes)", size_);
+        text += number;
+    } else if (hasPid()) {
+        std::snprintf(number, sizeof(number), " (pid %d)", static_cast<int>(pid_));
+        text += number;
+    }
+    if (context_) {
+        text += ": ";
+        text += context_;
+    }
+    if (sysErrno_ != 0) {
+        text += ": ";
+        text += std::strerror(sysErrno_);
+    }
+    return text;
+}
+
+} // namespace ukc
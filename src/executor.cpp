@@ -0,0 +1,394 @@
+#include "executor.h"
+#include "probes.h"
+#include <algorithm>
+#include <cstdio>
+#include <pthread.h>
+#include <sched.h>
+
+namespace ukc {
+
+namespace {
+
+const char* const kStageNames[] = {
+    "task",
+    "scan",
+    "kallsyms_parse",
+    "batch_read",
+};
+
+static_assert(sizeof(kStageNames) / sizeof(kStageNames[0]) == static_cast<size_t>(ExecutorStage::Count),
+              "kStageNames must match ExecutorStage");
+
+constexpr size_t kNoQueue = static_cast<size_t>(-1);
+
+// 当前线程所属的执行器和队列下标，用于线程内提交
+thread_local const Executor* currentExecutor = nullptr;
+thread_local size_t currentQueue = kNoQueue;
+
+/**
+ * 读取 sysfs 中的单个整数，失败返回 -1
+ */
+long readSysfsLong(const char* format, int cpu) {
+    char path[128];
+    snprintf(path, sizeof(path), format, cpu);
+    FILE* file = fopen(path, "re");
+    if (!file) {
+        return -1;
+    }
+    long value = -1;
+    if (fscanf(file, "%ld", &value) != 1) {
+        value = -1;
+    }
+    fclose(file);
+    return value;
+}
+
+/**
+ * 核心算力：优先 cpu_capacity（arm64 拓扑），其次 cpufreq 最大频率
+ */
+long cpuCapacity(int cpu) {
+    long capacity = readSysfsLong("/sys/devices/system/cpu/cpu%d/cpu_capacity", cpu);
+    if (capacity < 0) {
+        capacity = readSysfsLong("/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", cpu);
+    }
+    return capacity;
+}
+
+/**
+ * 阶段计数器在全局监控器中的 id，探针关闭时不注册
+ */
+struct StageProbeCounters {
+    CounterId tasks[static_cast<size_t>(ExecutorStage::Count)];
+    CounterId busyMicros[static_cast<size_t>(ExecutorStage::Count)];
+    CounterId wallMicros[static_cast<size_t>(ExecutorStage::Count)];
+    bool registered = false;
+};
+
+const StageProbeCounters& stageProbeCounters() {
+    static const StageProbeCounters counters = []() {
+        StageProbeCounters created;
+        if (!probes::enabled()) {
+            return created;
+        }
+        auto& monitor = probes::monitor();
+        for (size_t i = 0; i < static_cast<size_t>(ExecutorStage::Count); ++i) {
+            std::string prefix = std::string("executor_") + kStageNames[i];
+            auto tasks = monitor.registerCounter(prefix + "_tasks");
+            auto busy = monitor.registerCounter(prefix + "_busy_us");
+            auto wall = monitor.registerCounter(prefix + "_wall_us");
+            if (tasks.isError() || busy.isError() || wall.isError()) {
+                return StageProbeCounters();
+            }
+            created.tasks[i] = tasks.value();
+            created.busyMicros[i] = busy.value();
+            created.wallMicros[i] = wall.value();
+        }
+        created.registered = true;
+        return created;
+    }();
+    return counters;
+}
+
+int64_t elapsedNanos(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start
+    ).count();
+}
+
+} // anonymous namespace
+
+Executor::Executor(ExecutorConfig config) {
+    std::vector<int> cpus = resolveCpus(config);
+    // 只有显式指定了 CPU 或大小核偏好时才设置亲和性
+    if (!config.cpus.empty() || config.corePreference != CorePreference::Any) {
+        cpus_ = cpus;
+    }
+    size_t threadCount = config.threadCount;
+    if (threadCount == 0) {
+        threadCount = std::max<size_t>(1, cpus.size());
+    }
+    start(threadCount);
+}
+
+Executor::Executor(size_t threadCount)
+    : Executor(ExecutorConfig{threadCount, {}, CorePreference::Any}) {
+}
+
+Executor::~Executor() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    sleepCv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void Executor::start(size_t threadCount) {
+    (void)stageProbeCounters();
+
+    queues_.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        queues_.push_back(std::make_unique<Worker>());
+    }
+    workers_.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers_.emplace_back([this, i]() { workerLoop(i); });
+        if (!cpus_.empty()) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (int cpu : cpus_) {
+                CPU_SET(cpu, &set);
+            }
+            (void)pthread_setaffinity_np(workers_.back().native_handle(), sizeof(set), &set);
+        }
+    }
+}
+
+std::vector<int> Executor::resolveCpus(const ExecutorConfig& config) {
+    std::vector<int> cpus = config.cpus;
+    if (cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &set)) {
+                    cpus.push_back(cpu);
+                }
+            }
+        }
+    }
+    if (config.corePreference == CorePreference::Any || cpus.size() < 2) {
+        return cpus;
+    }
+
+    std::vector<long> capacities;
+    capacities.reserve(cpus.size());
+    for (int cpu : cpus) {
+        capacities.push_back(cpuCapacity(cpu));
+    }
+    auto bounds = std::minmax_element(capacities.begin(), capacities.end());
+    if (*bounds.first < 0 || *bounds.first == *bounds.second) {
+        return cpus;
+    }
+
+    long wanted = config.corePreference == CorePreference::Big ? *bounds.second : *bounds.first;
+    std::vector<int> selected;
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        if (capacities[i] == wanted) {
+            selected.push_back(cpus[i]);
+        }
+    }
+    return selected;
+}
+
+void Executor::submit(std::function<void()> task, ExecutorStage stage) {
+    size_t index = currentExecutor == this ? currentQueue
+                                           : nextQueue_.fetch_add(1) % queues_.size();
+    {
+        // 先计数再入队：取任务的一方不会看到计数下溢；
+        // 计数与等待方的谓词检查串行化，避免丢失唤醒
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        queued_.fetch_add(1);
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(Task{std::move(task), stage});
+    }
+    sleepCv_.notify_one();
+}
+
+bool Executor::takeTask(size_t preferred, Task& task, bool& stolen) {
+    if (preferred != kNoQueue) {
+        Worker& own = *queues_[preferred];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued_.fetch_sub(1);
+            stolen = false;
+            return true;
+        }
+    }
+
+    size_t count = queues_.size();
+    size_t startIndex = preferred == kNoQueue ? 0 : preferred + 1;
+    for (size_t i = 0; i < count; ++i) {
+        size_t index = (startIndex + i) % count;
+        if (index == preferred) {
+            continue;
+        }
+        Worker& victim = *queues_[index];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued_.fetch_sub(1);
+            // 外部线程取任务不算窃取
+            stolen = preferred != kNoQueue;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Executor::runOne(size_t preferred) {
+    Task task;
+    bool stolen = false;
+    if (!takeTask(preferred, task, stolen)) {
+        return false;
+    }
+    runTask(task, stolen);
+    return true;
+}
+
+void Executor::runTask(Task& task, bool stolen) {
+    StageCounters& counters = stages_[static_cast<size_t>(task.stage)];
+    counters.tasks.fetch_add(1, std::memory_order_relaxed);
+    if (stolen) {
+        counters.steals.fetch_add(1, std::memory_order_relaxed);
+    }
+    const auto& probeCounters = stageProbeCounters();
+    if (probeCounters.registered) {
+        probes::monitor().increment(probeCounters.tasks[static_cast<size_t>(task.stage)], 1);
+    }
+
+    // parallelFor 的辅助任务自行统计阶段运行时间
+    if (task.stage == ExecutorStage::Task) {
+        auto start = std::chrono::steady_clock::now();
+        enterStage(task.stage);
+        task.function();
+        leaveStage(task.stage, start);
+    } else {
+        task.function();
+    }
+}
+
+void Executor::enterStage(ExecutorStage stage) {
+    StageCounters& counters = stages_[static_cast<size_t>(stage)];
+    size_t running = counters.running.fetch_add(1) + 1;
+    size_t peak = counters.peak.load(std::memory_order_relaxed);
+    while (running > peak && !counters.peak.compare_exchange_weak(peak, running)) {
+    }
+}
+
+void Executor::leaveStage(ExecutorStage stage, std::chrono::steady_clock::time_point start) {
+    StageCounters& counters = stages_[static_cast<size_t>(stage)];
+    counters.running.fetch_sub(1);
+    int64_t nanos = elapsedNanos(start);
+    counters.busyNanos.fetch_add(nanos, std::memory_order_relaxed);
+    const auto& probeCounters = stageProbeCounters();
+    if (probeCounters.registered) {
+        probes::monitor().increment(probeCounters.busyMicros[static_cast<size_t>(stage)],
+                                    static_cast<uint64_t>(nanos / 1000));
+    }
+}
+
+void Executor::workerLoop(size_t index) {
+    currentExecutor = this;
+    currentQueue = index;
+
+    for (;;) {
+        if (runOne(index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        sleepCv_.wait(lock, [this]() { return stopping_ || queued_.load() > 0; });
+        // 停止时仍先清空队列
+        if (stopping_ && queued_.load() == 0) {
+            return;
+        }
+    }
+}
+
+void Executor::parallelFor(
+    ExecutorStage stage,
+    size_t count,
+    const std::function<void(size_t)>& body,
+    size_t maxConcurrency
+) {
+    if (count == 0) {
+        return;
+    }
+
+    struct Shared {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> completed{0};
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+    auto shared = std::make_shared<Shared>();
+
+    // 一个下标都领不到的辅助任务直接返回：此时调用线程可能已经返回，body 不再有效
+    auto drainIndices = [this, stage, count, &body](Shared& state) {
+        size_t index = state.next.fetch_add(1);
+        if (index >= count) {
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        enterStage(stage);
+        do {
+            body(index);
+            if (state.completed.fetch_add(1) + 1 == count) {
+                std::lock_guard<std::mutex> lock(state.mutex);
+                state.done.notify_all();
+            }
+        } while ((index = state.next.fetch_add(1)) < count);
+        leaveStage(stage, start);
+    };
+
+    size_t concurrency = maxConcurrency == 0 ? workers_.size() + 1 : maxConcurrency;
+    size_t helpers = std::min(count, concurrency) - 1;
+    auto wallStart = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < helpers; ++i) {
+        submit([shared, drainIndices]() {
+            drainIndices(*shared);
+        }, stage);
+    }
+
+    drainIndices(*shared);
+
+    // 只等待本次调用的下标全部完成，不在这里执行队列中的其他任务：调用方可能
+    // 持有锁或处于 call_once 中，顺带执行的任务再次进入它们会死锁。
+    // 已领取下标的辅助任务都在其他线程上运行，尚未开始的辅助任务不会再领到下标，
+    // 因此即使在工作线程内嵌套调用也能等到结束
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    shared->done.wait(lock, [&shared, count]() {
+        return shared->completed.load() == count;
+    });
+    lock.unlock();
+
+    int64_t wallNanos = elapsedNanos(wallStart);
+    StageCounters& counters = stages_[static_cast<size_t>(stage)];
+    counters.wallNanos.fetch_add(wallNanos, std::memory_order_relaxed);
+    const auto& probeCounters = stageProbeCounters();
+    if (probeCounters.registered) {
+        probes::monitor().increment(probeCounters.wallMicros[static_cast<size_t>(stage)],
+                                    static_cast<uint64_t>(wallNanos / 1000));
+    }
+}
+
+std::vector<ExecutorStageStats> Executor::stageStats() const {
+    std::vector<ExecutorStageStats> stats;
+    for (size_t i = 0; i < static_cast<size_t>(ExecutorStage::Count); ++i) {
+        const StageCounters& counters = stages_[i];
+        ExecutorStageStats stage;
+        stage.name = kStageNames[i];
+        stage.tasks = counters.tasks.load();
+        stage.steals = counters.steals.load();
+        stage.peakConcurrency = counters.peak.load();
+        stage.busyTime = std::chrono::nanoseconds(counters.busyNanos.load());
+        stage.wallTime = std::chrono::nanoseconds(counters.wallNanos.load());
+        stats.push_back(stage);
+    }
+    return stats;
+}
+
+const char* Executor::stageName(ExecutorStage stage) {
+    size_t index = static_cast<size_t>(stage);
+    return index < static_cast<size_t>(ExecutorStage::Count) ? kStageNames[index] : "unknown";
+}
+
+} // namespace ukc
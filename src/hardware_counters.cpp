@@ -0,0 +1,134 @@
+#include "hardware_counters.h"
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#include <memory>
+
+namespace ukc {
+
+namespace {
+
+const uint64_t kEventConfigs[kHardwareEventCount] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+int openEvent(uint64_t config, int groupFd) {
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP |
+                       PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // 只统计用户态，perf_event_paranoid <= 2 时无需特权
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    long fd = syscall(SYS_perf_event_open, &attr, 0 /* 当前线程 */, -1 /* 任意 CPU */,
+                      groupFd, PERF_FLAG_FD_CLOEXEC);
+    return static_cast<int>(fd);
+}
+
+thread_local std::unique_ptr<HardwareCounterGroup> threadGroup;
+thread_local bool threadGroupTried = false;
+
+} // anonymous namespace
+
+HardwareCounterGroup* HardwareCounterGroup::forCurrentThread() {
+    if (!threadGroupTried) {
+        threadGroupTried = true;
+        auto group = std::make_unique<HardwareCounterGroup>();
+        if (group->isOpen()) {
+            threadGroup = std::move(group);
+        }
+    }
+    return threadGroup.get();
+}
+
+HardwareCounterGroup::HardwareCounterGroup() {
+    fds_.fill(-1);
+    slots_.fill(-1);
+
+    // 第一个成功打开的事件作为组长，其余加入同一组以便一次读取
+    for (size_t i = 0; i < kHardwareEventCount; ++i) {
+        int fd = openEvent(kEventConfigs[i], leaderFd_);
+        if (fd < 0) {
+            continue;
+        }
+        if (leaderFd_ < 0) {
+            leaderFd_ = fd;
+        }
+        fds_[i] = fd;
+        slots_[i] = static_cast<int>(openCount_++);
+    }
+}
+
+HardwareCounterGroup::~HardwareCounterGroup() {
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+bool HardwareCounterGroup::read(
+    HardwareCounterValues& out,
+    uint64_t& timeEnabled,
+    uint64_t& timeRunning
+) const {
+    if (leaderFd_ < 0) {
+        return false;
+    }
+
+    // 格式：nr, time_enabled, time_running, values[nr]
+    uint64_t buffer[3 + kHardwareEventCount];
+    ssize_t expected = static_cast<ssize_t>((3 + openCount_) * sizeof(uint64_t));
+    if (::read(leaderFd_, buffer, sizeof(buffer)) != expected || buffer[0] != openCount_) {
+        return false;
+    }
+
+    timeEnabled = buffer[1];
+    timeRunning = buffer[2];
+    for (size_t i = 0; i < kHardwareEventCount; ++i) {
+        out.values[i] = slots_[i] >= 0 ? buffer[3 + slots_[i]] : 0;
+    }
+    return true;
+}
+
+bool hardwareCounterDelta(
+    const HardwareCounterGroup& group,
+    const HardwareCounterStart& start,
+    HardwareCounterValues& delta
+) {
+    HardwareCounterValues now;
+    uint64_t timeEnabled = 0;
+    uint64_t timeRunning = 0;
+    if (!group.read(now, timeEnabled, timeRunning)) {
+        return false;
+    }
+
+    uint64_t enabled = timeEnabled - start.timeEnabled;
+    uint64_t running = timeRunning - start.timeRunning;
+    if (running == 0) {
+        return false;
+    }
+
+    // 事件组被复用时，按运行时间占比外推
+    double scale = running < enabled
+        ? static_cast<double>(enabled) / static_cast<double>(running)
+        : 1.0;
+    for (size_t i = 0; i < kHardwareEventCount; ++i) {
+        uint64_t diff = now.values[i] - start.values.values[i];
+        delta.values[i] = scale == 1.0
+            ? diff
+            : static_cast<uint64_t>(static_cast<double>(diff) * scale);
+    }
+    return true;
+}
+
+} // namespace ukc
@@ -1,13 +1,78 @@
 #include "kernel_function_locator.h"
 #include "signature_scanner.h"
 #include "magisk_interface.h"
+#include "probes.h"
+#include "executor.h"
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
 #include <optional>
+#include <cerrno>
 #include <fstream>
 #include <sstream>
 #include <cstring>
 
 namespace ukc {
 
+namespace {
+
+// 并行解析时每个分片的最小字节数
+constexpr size_t kKallsymsShardSize = 256 * 1024;
+
+struct KallsymsRange {
+    uintptr_t minAddr = UINTPTR_MAX;
+    uintptr_t maxAddr = 0;
+};
+
+/**
+ * 读取整个 /proc/kallsyms
+ */
+bool readKallsyms(std::string& content) {
+    int fd = open("/proc/kallsyms", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    char buffer[65536];
+    ssize_t bytesRead;
+    while ((bytesRead = read(fd, buffer, sizeof(buffer))) > 0) {
+        content.append(buffer, static_cast<size_t>(bytesRead));
+    }
+    close(fd);
+    return bytesRead == 0;
+}
+
+/**
+ * 求 [begin, end) 中各行首地址的范围（格式: address type name）
+ * 地址为 0 的行（无权限时全部为 0）不计入
+ */
+KallsymsRange parseKallsymsRange(const char* begin, const char* end) {
+    KallsymsRange range;
+    const char* p = begin;
+    while (p < end) {
+        uintptr_t addr = 0;
+        while (p < end) {
+            char c = *p;
+            int digit = (c >= '0' && c <= '9') ? c - '0'
+                      : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+                      : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+            if (digit < 0) {
+                break;
+            }
+            addr = (addr << 4) | static_cast<uintptr_t>(digit);
+            ++p;
+        }
+        if (addr > 0) {
+            range.minAddr = std::min(range.minAddr, addr);
+            range.maxAddr = std::max(range.maxAddr, addr);
+        }
+        const char* newline = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(end - p)));
+        p = newline ? newline + 1 : end;
+    }
+    return range;
+}
+
+} // anonymous namespace
+
 KernelFunctionLocator::KernelFunctionLocator() = default;
 
 KernelFunctionLocator::~KernelFunctionLocator() = default;
@@ -31,17 +96,19 @@ Result<uintptr_t> KernelFunctionLocator::locateFunction(
     const SignaturePattern& pattern
 ) {
     if (!initialized_) {
-        return Result<uintptr_t>::error("KernelFunctionLocator not initialized");
+        return Result<uintptr_t>::error(Error(ErrorCode::NotInitialized, 0, "KernelFunctionLocator"));
     }
     
     // 检查缓存
     auto cached = getCachedAddress(functionName);
     if (cached.has_value()) {
+        UKC_PROBE_COUNT(SymbolCacheHit, 1);
         return Result<uintptr_t>::success(cached.value());
     }
+    UKC_PROBE_COUNT(SymbolCacheMiss, 1);
     
     if (!pattern.isValid()) {
-        return Result<uintptr_t>::error("Invalid signature pattern");
+        return Result<uintptr_t>::error(Error(ErrorCode::InvalidPattern).withName(functionName));
     }
     
     // 第1步：尝试通过 Magisk 接口查找（安卓15推荐）
@@ -65,7 +132,7 @@ Result<uintptr_t> KernelFunctionLocator::locateFunction(
     // 这里需要集成 android-kernel-offset-finder 库
     
     return Result<uintptr_t>::error(
-        "Function '" + functionName + "' not found (signature search not implemented yet)"
+        Error(ErrorCode::SymbolNotFound, 0, "signature search not implemented yet").withName(functionName)
     );
 }
 
@@ -96,30 +163,39 @@ std::optional<uintptr_t> KernelFunctionLocator::getCachedAddress(
 }
 
 Result<void> KernelFunctionLocator::loadKernelMemoryMap() {
+    UKC_PROBE_SCOPE(KallsymsParse);
+    
     // 尝试从 /proc/kallsyms 读取内核地址范围
-    std::ifstream kallsyms("/proc/kallsyms");
-    if (kallsyms.is_open()) {
-        std::string line;
+    std::string content;
+    if (readKallsyms(content)) {
+        // 按行边界切成分片，各分片独立求地址范围后合并
+        size_t shardCount = 1;
+        if (executor_ && content.size() >= 2 * kKallsymsShardSize) {
+            shardCount = std::min(content.size() / kKallsymsShardSize, executor_->threadCount() + 1);
+        }
+        std::vector<size_t> bounds(shardCount + 1, content.size());
+        bounds[0] = 0;
+        for (size_t i = 1; i < shardCount; ++i) {
+            size_t newline = content.find('\n', content.size() / shardCount * i);
+            bounds[i] = newline == std::string::npos ? content.size() : newline + 1;
+        }
+        
+        std::vector<KallsymsRange> ranges(shardCount);
+        auto parseShard = [&](size_t i) {
+            ranges[i] = parseKallsymsRange(content.data() + bounds[i],
+                                           content.data() + std::max(bounds[i], bounds[i + 1]));
+        };
+        if (shardCount > 1) {
+            executor_->parallelFor(ExecutorStage::KallsymsParse, shardCount, parseShard);
+        } else {
+            parseShard(0);
+        }
+        
         uintptr_t minAddr = UINTPTR_MAX;
         uintptr_t maxAddr = 0;
-        
-        while (std::getline(kallsyms, line)) {
-            if (line.empty()) continue;
-            
-            // 解析 kallsyms 格式: address type name
-            std::istringstream iss(line);
-            std::string addrStr;
-            if (iss >> addrStr) {
-                try {
-                    uintptr_t addr = std::stoull(addrStr, nullptr, 16);
-                    if (addr > 0) {
-                        minAddr = std::min(minAddr, addr);
-                        maxAddr = std::max(maxAddr, addr);
-                    }
-                } catch (...) {
-                    // 忽略解析错误
-                }
-            }
+        for (const auto& range : ranges) {
+            minAddr = std::min(minAddr, range.minAddr);
+            maxAddr = std::max(maxAddr, range.maxAddr);
         }
         
         if (minAddr != UINTPTR_MAX && maxAddr > minAddr) {
@@ -139,9 +215,11 @@ Result<void> KernelFunctionLocator::loadKernelMemoryMap() {
 Result<uintptr_t> KernelFunctionLocator::locateFunctionFromKallsyms(
     const std::string& functionName
 ) {
+    UKC_PROBE_SCOPE(KallsymsLookup);
+    
     std::ifstream kallsyms("/proc/kallsyms");
     if (!kallsyms.is_open()) {
-        return Result<uintptr_t>::error("/proc/kallsyms not available");
+        return Result<uintptr_t>::error(Error(ErrorCode::Unavailable, errno, "/proc/kallsyms"));
     }
     
     std::string line;
@@ -170,69 +248,33 @@ Result<uintptr_t> KernelFunctionLocator::locateFunctionFromKallsyms(
     }
     
     return Result<uintptr_t>::error(
-        "Function '" + functionName + "' not found in /proc/kallsyms"
+        Error(ErrorCode::SymbolNotFound, 0, "/proc/kallsyms").withName(functionName)
     );
-}lt<uintptr_t> KernelFunctionLocator::locateFunctionViaMagisk(
+}
+
+Result<uintptr_t> KernelFunctionLocator::locateFunctionViaMagisk(
     const std::string& functionName
 ) {
     // 检查 Magisk 是否可用
     if (!magisk::is_magisk_available()) {
-        return Result<uintptr_t>::error("Magisk not available");
+        return Result<uintptr_t>::error(Error(ErrorCode::Unavailable, 0, "Magisk"));
     }
     
     // 通过 Magisk 接口查找符号
     uintptr_t addr = magisk::magisk_kallsyms_lookup_name(functionName.c_str());
     if (addr == 0) {
         return Result<uintptr_t>::error(
-            "Function '" + functionName + "' not found via Magisk"
+            Error(ErrorCode::SymbolNotFound, 0, "Magisk").withName(functionName)
         );
     }
     
     if (!isValidKernelAddress(addr)) {
         return Result<uintptr_t>::error(
-            "Invalid kernel address returned by Magisk for '" + functionName + "'"
+            Error(ErrorCode::InvalidAddress, 0, "returned by Magisk").withAddress(addr).withName(functionName)
         );
     }
     
     return Result<uintptr_t>::success(addr);
 }
 
-Result<uintptr_t> KernelFunctionLocator::locateFunctionFromKallsyms(
-    const std::string& functionName
-) {
-    std::ifstream kallsyms("/proc/kallsyms");
-    if (!kallsyms.is_open()) {
-        return Result<uintptr_t>::error("/proc/kallsyms not available");
-    }
-    
-    std::string line;
-    while (std::getline(kallsyms, line)) {
-        if (line.empty()) continue;
-        
-        // 解析 kallsyms 格式: address type name
-        std::istringstream iss(line);
-        std::string addrStr, typeStr, nameStr;
-        
-        if (!(iss >> addrStr >> typeStr >> nameStr)) {
-            continue;
-        }
-        
-        // 检查函数名是否匹配
-        if (nameStr == functionName) {
-            try {
-                uintptr_t addr = std::stoull(addrStr, nullptr, 16);
-                if (isValidKernelAddress(addr)) {
-                    return Result<uintptr_t>::success(addr);
-                }
-            } catch (...) {
-                // 忽略解析错误
-            }
-        }
-    }
-    
-    return Result<uintptr_t>::error(
-        "Function '" + functionName + "' not found in /proc/kallsyms"
-    );
-}
-
 } // namespace ukc
@@ -0,0 +1,234 @@
+#include "latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace ukc {
+
+LatencyHistogram::LatencyHistogram() {
+    buckets_.fill(0);
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t valueNs) {
+    const uint64_t linearLimit = uint64_t(1) << kLinearBits;
+    if (valueNs < linearLimit) {
+        return static_cast<size_t>(valueNs);
+    }
+
+    unsigned msb = 63u - static_cast<unsigned>(__builtin_clzll(valueNs));
+    unsigned shift = msb - (kLinearBits - 1);
+    if (shift > kMaxShift) {
+        return kBucketCount - 1;
+    }
+
+    uint64_t mantissa = valueNs >> shift;  // [kSubBuckets, 2 * kSubBuckets)
+    return static_cast<size_t>(linearLimit + (shift - 1) * kSubBuckets + (mantissa - kSubBuckets));
+}
+
+uint64_t LatencyHistogram::bucketLowerBound(size_t index) {
+    const size_t linearLimit = size_t(1) << kLinearBits;
+    if (index < linearLimit) {
+        return index;
+    }
+
+    size_t offset = index - linearLimit;
+    unsigned shift = static_cast<unsigned>(offset / kSubBuckets) + 1;
+    uint64_t mantissa = kSubBuckets + offset % kSubBuckets;
+    return mantissa << shift;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    const size_t linearLimit = size_t(1) << kLinearBits;
+    if (index < linearLimit) {
+        return index;
+    }
+
+    unsigned shift = static_cast<unsigned>((index - linearLimit) / kSubBuckets) + 1;
+    return bucketLowerBound(index) + (uint64_t(1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t valueNs) {
+    buckets_[bucketIndex(valueNs)]++;
+    count_++;
+    sum_ += valueNs;
+    min_ = std::min(min_, valueNs);
+    max_ = std::max(max_, valueNs);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    if (other.count_ == 0) {
+        return;
+    }
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::subtract(const LatencyHistogram& earlier) {
+    size_t lowest = kBucketCount;
+    size_t highest = 0;
+    uint64_t count = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        buckets_[i] -= std::min(buckets_[i], earlier.buckets_[i]);
+        if (buckets_[i] != 0) {
+            lowest = std::min(lowest, i);
+            highest = i;
+            count += buckets_[i];
+        }
+    }
+
+    if (count == 0) {
+        reset();
+        return;
+    }
+
+    count_ = count;
+    sum_ -= std::min(sum_, earlier.sum_);
+    min_ = std::max(min_, bucketLowerBound(lowest));
+    max_ = std::min(max_, bucketUpperBound(highest));
+}
+
+void LatencyHistogram::reset() {
+    buckets_.fill(0);
+    count_ = 0;
+    sum_ = 0;
+    min_ = UINT64_MAX;
+    max_ = 0;
+}
+
+uint64_t LatencyHistogram::percentile(double percentile) const {
+    if (count_ == 0) {
+        return 0;
+    }
+    if (percentile >= 100.0) {
+        return max_;
+    }
+
+    // 目标排名：至少为 1
+    double clamped = std::max(0.0, percentile);
+    uint64_t rank = static_cast<uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(count_)));
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        cumulative += buckets_[i];
+        if (cumulative >= rank) {
+            uint64_t lower = bucketLowerBound(i);
+            uint64_t mid = lower + (bucketUpperBound(i) - lower) / 2;
+            return std::min(std::max(mid, min_), max_);
+        }
+    }
+    return max_;
+}
+
+std::string LatencyHistogram::serialize() const {
+    std::ostringstream oss;
+    oss << count_ << ' ' << sum_ << ' ' << min() << ' ' << max_;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        if (buckets_[i] != 0) {
+            oss << ' ' << i << ':' << buckets_[i];
+        }
+    }
+    return oss.str();
+}
+
+Result<LatencyHistogram> LatencyHistogram::deserialize(const std::string& text) {
+    std::istringstream iss(text);
+    LatencyHistogram histogram;
+    uint64_t count = 0;
+    uint64_t min = 0;
+    if (!(iss >> count >> histogram.sum_ >> min >> histogram.max_)) {
+        return Result<LatencyHistogram>::error("Malformed histogram header");
+    }
+
+    uint64_t bucketTotal = 0;
+    std::string entry;
+    while (iss >> entry) {
+        size_t colon = entry.find(':');
+        if (colon == std::string::npos) {
+            return Result<LatencyHistogram>::error("Malformed histogram bucket: " + entry);
+        }
+        size_t index = 0;
+        uint64_t bucketCount = 0;
+        try {
+            index = static_cast<size_t>(std::stoull(entry.substr(0, colon)));
+            bucketCount = std::stoull(entry.substr(colon + 1));
+        } catch (...) {
+            return Result<LatencyHistogram>::error("Malformed histogram bucket: " + entry);
+        }
+        if (index >= kBucketCount) {
+            return Result<LatencyHistogram>::error("Histogram bucket out of range: " + entry);
+        }
+        histogram.buckets_[index] += bucketCount;
+        bucketTotal += bucketCount;
+    }
+
+    if (bucketTotal != count) {
+        return Result<LatencyHistogram>::error("Histogram bucket counts do not match total");
+    }
+
+    histogram.count_ = count;
+    histogram.min_ = count ? min : UINT64_MAX;
+    return Result<LatencyHistogram>::success(histogram);
+}
+
+AtomicLatencyHistogram::AtomicLatencyHistogram() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void AtomicLatencyHistogram::record(uint64_t valueNs) {
+    buckets_[LatencyHistogram::bucketIndex(valueNs)].fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(valueNs, std::memory_order_relaxed);
+
+    // 单写者：只有 reset 可能与之竞争，CAS 失败时重试即可
+    uint64_t current = min_.load(std::memory_order_relaxed);
+    while (valueNs < current &&
+           !min_.compare_exchange_weak(current, valueNs, std::memory_order_relaxed)) {
+    }
+    current = max_.load(std::memory_order_relaxed);
+    while (valueNs > current &&
+           !max_.compare_exchange_weak(current, valueNs, std::memory_order_relaxed)) {
+    }
+
+    // count 最后更新并使用 release，读者看到 count 时对应的桶计数已可见
+    count_.fetch_add(1, std::memory_order_release);
+}
+
+void AtomicLatencyHistogram::mergeInto(LatencyHistogram& target) const {
+    if (count_.load(std::memory_order_acquire) == 0) {
+        return;
+    }
+
+    // 总数取各桶之和，保证分位数计算时桶计数与总数一致
+    uint64_t count = 0;
+    for (size_t i = 0; i < LatencyHistogram::kBucketCount; ++i) {
+        uint64_t bucket = buckets_[i].load(std::memory_order_relaxed);
+        target.buckets_[i] += bucket;
+        count += bucket;
+    }
+    if (count == 0) {
+        return;
+    }
+    target.count_ += count;
+    target.sum_ += sum_.load(std::memory_order_relaxed);
+    target.min_ = std::min(target.min_, min_.load(std::memory_order_relaxed));
+    target.max_ = std::max(target.max_, max_.load(std::memory_order_relaxed));
+}
+
+void AtomicLatencyHistogram::reset() {
+    count_.store(0, std::memory_order_relaxed);
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    sum_.store(0, std::memory_order_relaxed);
+    min_.store(UINT64_MAX, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace ukc
@@ -0,0 +1,202 @@
+#include "lz4_block.h"
+#include <cstring>
+
+namespace ukc {
+namespace lz4 {
+
+namespace {
+
+constexpr size_t kMinMatch = 4;
+constexpr size_t kLastLiterals = 5;    // 块末尾至少 5 字节是字面量
+constexpr size_t kMatchLimit = 12;     // 最后一个匹配必须在块末尾 12 字节之前开始
+constexpr size_t kMaxOffset = 65535;
+constexpr unsigned kHashBits = 12;
+
+inline uint32_t load32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint32_t hash(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - kHashBits);
+}
+
+/**
+ * 写入长度的扩展字节（token 中的 4 位已经是 15 时）
+ */
+inline uint8_t* writeLength(uint8_t* op, size_t length) {
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = static_cast<uint8_t>(length);
+    return op;
+}
+
+/**
+ * 读取长度的扩展字节，输入不足时返回 false
+ */
+inline bool readLength(const uint8_t*& ip, const uint8_t* iend, size_t& length) {
+    uint8_t byte;
+    do {
+        if (ip >= iend) {
+            return false;
+        }
+        byte = *ip++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+/**
+ * 一个序列最多需要的输出字节数
+ */
+inline size_t sequenceBound(size_t literals, size_t matchLength) {
+    return 1 + literals / 255 + 1 + literals + 2 + matchLength / 255 + 1;
+}
+
+} // namespace
+
+size_t compressBound(size_t srcSize) {
+    return srcSize + srcSize / 255 + 16;
+}
+
+size_t compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity) {
+    uint8_t* op = dst;
+    uint8_t* const oend = dst + dstCapacity;
+    size_t anchor = 0;
+
+    if (srcSize > kMatchLimit) {
+        uint32_t table[1u << kHashBits] = {};
+        const size_t matchStartLimit = srcSize - kMatchLimit;
+        const size_t matchEndLimit = srcSize - kLastLiterals;
+        size_t ip = 1;
+
+        while (ip < matchStartLimit) {
+            uint32_t sequence = load32(src + ip);
+            uint32_t h = hash(sequence);
+            size_t ref = table[h];
+            table[h] = static_cast<uint32_t>(ip);
+
+            if (ip - ref > kMaxOffset || load32(src + ref) != sequence) {
+                // 长时间没有匹配时加大步长，不可压缩的数据上接近 memcpy 速度
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            // 向前扩展匹配
+            while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1]) {
+                ip--;
+                ref--;
+            }
+
+            size_t matchLength = kMinMatch;
+            while (ip + matchLength < matchEndLimit && src[ref + matchLength] == src[ip + matchLength]) {
+                matchLength++;
+            }
+
+            size_t literals = ip - anchor;
+            if (sequenceBound(literals, matchLength) > static_cast<size_t>(oend - op)) {
+                return 0;
+            }
+
+            uint8_t* token = op++;
+            size_t matchCode = matchLength - kMinMatch;
+            *token = static_cast<uint8_t>(((literals < 15 ? literals : 15) << 4) |
+                                          (matchCode < 15 ? matchCode : 15));
+            if (literals >= 15) {
+                op = writeLength(op, literals - 15);
+            }
+            std::memcpy(op, src + anchor, literals);
+            op += literals;
+
+            size_t offset = ip - ref;
+            *op++ = static_cast<uint8_t>(offset);
+            *op++ = static_cast<uint8_t>(offset >> 8);
+            if (matchCode >= 15) {
+                op = writeLength(op, matchCode - 15);
+            }
+
+            ip += matchLength;
+            anchor = ip;
+            if (ip < matchStartLimit) {
+                table[hash(load32(src + ip - 2))] = static_cast<uint32_t>(ip - 2);
+            }
+        }
+    }
+
+    // 最后一个序列只有字面量
+    size_t literals = srcSize - anchor;
+    if (1 + literals / 255 + 1 + literals > static_cast<size_t>(oend - op)) {
+        return 0;
+    }
+    *op++ = static_cast<uint8_t>((literals < 15 ? literals : 15) << 4);
+    if (literals >= 15) {
+        op = writeLength(op, literals - 15);
+    }
+    std::memcpy(op, src + anchor, literals);
+    op += literals;
+
+    return static_cast<size_t>(op - dst);
+}
+
+bool decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+    const uint8_t* ip = src;
+    const uint8_t* const iend = src + srcSize;
+    uint8_t* op = dst;
+    uint8_t* const oend = dst + dstSize;
+
+    while (ip < iend) {
+        uint8_t token = *ip++;
+
+        size_t literals = token >> 4;
+        if (literals == 15 && !readLength(ip, iend, literals)) {
+            return false;
+        }
+        if (literals > static_cast<size_t>(iend - ip) || literals > static_cast<size_t>(oend - op)) {
+            return false;
+        }
+        std::memcpy(op, ip, literals);
+        ip += literals;
+        op += literals;
+
+        if (ip == iend) {
+            break;
+        }
+
+        if (iend - ip < 2) {
+            return false;
+        }
+        size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst)) {
+            return false;
+        }
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !readLength(ip, iend, matchLength)) {
+            return false;
+        }
+        matchLength += kMinMatch;
+        if (matchLength > static_cast<size_t>(oend - op)) {
+            return false;
+        }
+
+        const uint8_t* match = op - offset;
+        if (offset >= matchLength) {
+            std::memcpy(op, match, matchLength);
+            op += matchLength;
+        } else {
+            // 重叠复制（重复模式）必须逐字节进行
+            for (size_t i = 0; i < matchLength; ++i) {
+                *op++ = *match++;
+            }
+        }
+    }
+
+    return op == oend;
+}
+
+} // namespace lz4
+} // namespace ukc
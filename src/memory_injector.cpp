@@ -1,8 +1,39 @@
 #include "memory_injector.h"
+#include "probes.h"
 #include "magisk_interface.h"
+#include "executor.h"
+#include <algorithm>
+#include <cstring>
 
 namespace ukc {
 
+namespace {
+
+// 并行批量读取时每个任务处理的请求数
+constexpr size_t kBatchReadShardSize = 256;
+
+/**
+ * 在按起始地址排序的映射中查找包含 address 的区域
+ */
+const MemoryRegion* findRegion(
+    const std::vector<MemoryRegion>& regions,
+    uintptr_t address
+) {
+    auto it = std::upper_bound(
+        regions.begin(), regions.end(), address,
+        [](uintptr_t addr, const MemoryRegion& region) {
+            return addr < region.start;
+        }
+    );
+    if (it == regions.begin()) {
+        return nullptr;
+    }
+    --it;
+    return address < it->end ? &*it : nullptr;
+}
+
+} // namespace
+
 MemoryInjector::MemoryInjector() = default;
 
 MemoryInjector::~MemoryInjector() = default;
@@ -21,7 +52,7 @@ Result<void> MemoryInjector::initialize(
     processManager_ = processManager;
     
     if (!locator_ || !caller_ || !processManager_) {
-        return Result<void>::error("Invalid dependencies");
+        return Result<void>::error(Error(ErrorCode::InvalidArgument, 0, "null dependency"));
     }
     
     // 定位内核读写函数
@@ -64,7 +95,7 @@ Result<std::vector<uint8_t>> MemoryInjector::readKernelMemory(
     
     if (bytesRead < 0) {
         return Result<std::vector<uint8_t>>::error(
-            "Failed to read kernel memory at 0x" + std::to_string(address)
+            Error(ErrorCode::ReadFailed, 0, "kernel memory").withAddress(address).withSize(size)
         );
     }
     
@@ -87,55 +118,186 @@ Result<size_t> MemoryInjector::writeKernelMemory(
     
     if (result != 0) {
         return Result<size_t>::error(
-            "Failed to write kernel memory at 0x" + std::to_string(address)
+            Error(ErrorCode::WriteFailed, 0, "kernel memory").withAddress(address).withSize(data.size())
         );
     }
     
     return Result<size_t>::success(data.size());
 }
 
+template<typename R, typename Op>
+R MemoryInjector::withProcessHandle(pid_t targetPid, Op op) {
+    if (!initialized_) {
+        return R::error(Error(ErrorCode::NotInitialized, 0, "MemoryInjector"));
+    }
+    
+    auto process = processManager_->handle(targetPid);
+    if (process.isError()) {
+        return R::error(process.errorInfo());
+    }
+    
+    R result = op(*process.value());
+    
+    // isProcessAlive(pid) 会丢弃过期句柄并按 pid 重新打开
+    if (result.isError() && result.errorCode() == ErrorCode::ProcessGone &&
+        processManager_->isProcessAlive(targetPid)) {
+        process = processManager_->handle(targetPid);
+        if (process.isSuccess()) {
+            result = op(*process.value());
+        }
+    }
+    return result;
+}
+
 Result<std::vector<uint8_t>> MemoryInjector::readMemory(
     pid_t targetPid,
     uintptr_t address,
     size_t size
+) {
+    return withProcessHandle<Result<std::vector<uint8_t>>>(
+        targetPid, [&](const ProcessHandle& process) {
+            return readMemory(process, address, size);
+        }
+    );
+}
+
+Result<size_t> MemoryInjector::readMemoryInto(
+    pid_t targetPid,
+    uintptr_t address,
+    uint8_t* buffer,
+    size_t size
+) {
+    return withProcessHandle<Result<size_t>>(
+        targetPid, [&](const ProcessHandle& process) {
+            return readMemoryInto(process, address, buffer, size);
+        }
+    );
+}
+
+Result<size_t> MemoryInjector::writeMemory(
+    pid_t targetPid,
+    uintptr_t address,
+    const std::vector<uint8_t>& data
+) {
+    return withProcessHandle<Result<size_t>>(
+        targetPid, [&](const ProcessHandle& process) {
+            return writeMemory(process, address, data);
+        }
+    );
+}
+
+Result<void> MemoryInjector::batchOperations(
+    pid_t targetPid,
+    std::vector<MemoryOperation>& operations
+) {
+    return withProcessHandle<Result<void>>(
+        targetPid, [&](const ProcessHandle& process) {
+            return batchOperations(process, operations);
+        }
+    );
+}
+
+Result<void> MemoryInjector::batchOperations(
+    pid_t targetPid,
+    std::vector<MemoryOperation>& operations,
+    const BatchPlanner& planner,
+    BatchPlanStats* stats
+) {
+    return withProcessHandle<Result<void>>(
+        targetPid, [&](const ProcessHandle& process) {
+            return batchOperations(process, operations, planner, stats);
+        }
+    );
+}
+
+Result<void> MemoryInjector::batchOperations(
+    pid_t targetPid,
+    std::vector<MemoryOperation>& operations,
+    ReadEngine& engine,
+    ReadEngineStats* stats
+) {
+    return withProcessHandle<Result<void>>(
+        targetPid, [&](const ProcessHandle& process) {
+            return batchOperations(process, operations, engine, stats);
+        }
+    );
+}
+
+Result<size_t> MemoryInjector::batchRead(
+    pid_t targetPid,
+    const std::vector<BatchReadRequest>& requests,
+    std::vector<BatchReadResult>& results,
+    BatchArena& arena
+) {
+    return withProcessHandle<Result<size_t>>(
+        targetPid, [&](const ProcessHandle& process) {
+            return batchRead(process, requests, results, arena);
+        }
+    );
+}
+
+Result<std::vector<uint8_t>> MemoryInjector::readMemory(
+    const ProcessHandle& process,
+    uintptr_t address,
+    size_t size
+) {
+    std::vector<uint8_t> data(size);
+    auto readResult = readMemoryInto(process, address, data.data(), size);
+    if (readResult.isError()) {
+        return Result<std::vector<uint8_t>>::error(readResult.errorInfo());
+    }
+    
+    data.resize(readResult.value());
+    return Result<std::vector<uint8_t>>::success(std::move(data));
+}
+
+Result<size_t> MemoryInjector::readMemoryInto(
+    const ProcessHandle& process,
+    uintptr_t address,
+    uint8_t* buffer,
+    size_t size
 ) {
     if (!initialized_) {
-        return Result<std::vector<uint8_t>>::error("MemoryInjector not initialized");
+        return Result<size_t>::error(Error(ErrorCode::NotInitialized, 0, "MemoryInjector"));
     }
     
     if (size == 0) {
-        return Result<std::vector<uint8_t>>::success(std::vector<uint8_t>());
+        return Result<size_t>::success(0);
+    }
+    
+    if (buffer == nullptr) {
+        return Result<size_t>::error(Error(ErrorCode::InvalidArgument, 0, "buffer is null"));
     }
     
     // 验证进程
-    if (!processManager_->isProcessAlive(targetPid)) {
-        return Result<std::vector<uint8_t>>::error(
-            "Target process " + std::to_string(targetPid) + " does not exist"
-        );
+    if (!processManager_->isProcessAlive(process)) {
+        return Result<size_t>::error(Error(ErrorCode::ProcessGone).withPid(process.pid()));
     }
     
     // 验证地址
-    if (!processManager_->isValidAddress(targetPid, address)) {
-        return Result<std::vector<uint8_t>>::error(
-            "Invalid address 0x" + std::to_string(address) + 
-            " for process " + std::to_string(targetPid)
+    if (!processManager_->isValidAddress(process, address)) {
+        return Result<size_t>::error(
+            Error(ErrorCode::InvalidAddress).withAddress(address).withPid(process.pid())
         );
     }
     
-    // 在实际实现中，这里会调用内核函数读取内存
-    // 由于这是框架实现，我们返回一个占位符
-    std::vector<uint8_t> data(size, 0);
+    ErrorCode readCode = readIntoBuffer(process, address, buffer, size);
+    if (readCode != ErrorCode::None) {
+        return Result<size_t>::error(
+            Error(readCode).withAddress(address).withSize(size).withPid(process.pid())
+        );
+    }
     
-    return Result<std::vector<uint8_t>>::success(std::move(data));
+    return Result<size_t>::success(size);
 }
 
 Result<size_t> MemoryInjector::writeMemory(
-    pid_t targetPid,
+    const ProcessHandle& process,
     uintptr_t address,
     const std::vector<uint8_t>& data
 ) {
     if (!initialized_) {
-        return Result<size_t>::error("MemoryInjector not initialized");
+        return Result<size_t>::error(Error(ErrorCode::NotInitialized, 0, "MemoryInjector"));
     }
     
     if (data.empty()) {
@@ -143,17 +305,14 @@ Result<size_t> MemoryInjector::writeMemory(
     }
     
     // 验证进程
-    if (!processManager_->isProcessAlive(targetPid)) {
-        return Result<size_t>::error(
-            "Target process " + std::to_string(targetPid) + " does not exist"
-        );
+    if (!processManager_->isProcessAlive(process)) {
+        return Result<size_t>::error(Error(ErrorCode::ProcessGone).withPid(process.pid()));
     }
     
     // 验证地址
-    if (!processManager_->isValidAddress(targetPid, address)) {
+    if (!processManager_->isValidAddress(process, address)) {
         return Result<size_t>::error(
-            "Invalid address 0x" + std::to_string(address) + 
-            " for process " + std::to_string(targetPid)
+            Error(ErrorCode::InvalidAddress).withAddress(address).withPid(process.pid())
         );
     }
     
@@ -165,11 +324,11 @@ Result<size_t> MemoryInjector::writeMemory(
 }
 
 Result<void> MemoryInjector::batchOperations(
-    pid_t targetPid,
+    const ProcessHandle& process,
     std::vector<MemoryOperation>& operations
 ) {
     if (!initialized_) {
-        return Result<void>::error("MemoryInjector not initialized");
+        return Result<void>::error(Error(ErrorCode::NotInitialized, 0, "MemoryInjector"));
     }
     
     if (operations.empty()) {
@@ -177,42 +336,307 @@ Result<void> MemoryInjector::batchOperations(
     }
     
     // 验证进程
-    if (!processManager_->isProcessAlive(targetPid)) {
-        return Result<void>::error(
-            "Target process " + std::to_string(targetPid) + " does not exist"
-        );
+    if (!processManager_->isProcessAlive(process)) {
+        return Result<void>::error(Error(ErrorCode::ProcessGone).withPid(process.pid()));
     }
     
+    UKC_TRACE_SCOPE("injector.batch_operations", operations.size());
+    
     // 执行每个操作
     for (auto& op : operations) {
-        // 验证地址
-        if (!processManager_->isValidAddress(targetPid, op.address)) {
-            op.success = false;
-            op.errorMessage = "Invalid address 0x" + std::to_string(op.address);
+        executeOperation(process, op);
+    }
+    
+    return Result<void>::success();
+}
+
+Result<void> MemoryInjector::batchOperations(
+    const ProcessHandle& process,
+    std::vector<MemoryOperation>& operations,
+    const BatchPlanner& planner,
+    BatchPlanStats* stats
+) {
+    if (!initialized_) {
+        return Result<void>::error(Error(ErrorCode::NotInitialized, 0, "MemoryInjector"));
+    }
+    
+    BatchPlanStats planStats;
+    if (operations.empty()) {
+        if (stats) {
+            *stats = planStats;
+        }
+        return Result<void>::success();
+    }
+    
+    // 验证进程
+    if (!processManager_->isProcessAlive(process)) {
+        return Result<void>::error(Error(ErrorCode::ProcessGone).withPid(process.pid()));
+    }
+    
+    UKC_TRACE_SCOPE("injector.batch_operations_planned", operations.size());
+    
+    auto steps = planner.plan(operations, &planStats);
+    UKC_TRACE_INSTANT("injector.batch_planned", steps.size());
+    
+    for (const auto& step : steps) {
+        MemoryOperation& first = operations[step.operationIndices.front()];
+        
+        // 写操作和未合并的读操作按原路径执行
+        if (first.type == OperationType::Write || step.operationIndices.size() == 1) {
+            executeOperation(process, first);
             continue;
         }
         
-        if (op.type == OperationType::Read) {
-            auto readResult = readMemory(targetPid, op.address, op.size);
-            if (readResult.isSuccess()) {
+        // 合并读取，再按各操作的偏移切片回填
+        auto readResult = readMemory(process, step.address, step.size);
+        if (readResult.isSuccess() && readResult.value().size() == step.size) {
+            const auto& data = readResult.value();
+            for (size_t index : step.operationIndices) {
+                MemoryOperation& op = operations[index];
+                size_t offset = op.address - step.address;
                 op.success = true;
-                op.result = readResult.value();
-            } else {
-                op.success = false;
-                op.errorMessage = readResult.errorMessage();
+                op.result.assign(data.begin() + offset, data.begin() + offset + op.size);
+                op.error = Error();
             }
-        } else if (op.type == OperationType::Write) {
-            auto writeResult = writeMemory(targetPid, op.address, op.data);
-            if (writeResult.isSuccess()) {
-                op.success = true;
-            } else {
-                op.success = false;
-                op.errorMessage = writeResult.errorMessage();
+            continue;
+        }
+        
+        // 合并读取失败（例如跨越了未映射的间隙），回退为逐个读取
+        planStats.fallbackTransfers++;
+        for (size_t index : step.operationIndices) {
+            executeOperation(process, operations[index]);
+        }
+    }
+    
+    if (stats) {
+        *stats = planStats;
+    }
+    return Result<void>::success();
+}
+
+Result<void> MemoryInjector::batchOperations(
+    const ProcessHandle& process,
+    std::vector<MemoryOperation>& operations,
+    ReadEngine& engine,
+    ReadEngineStats* stats
+) {
+    if (!initialized_) {
+        return Result<void>::error(Error(ErrorCode::NotInitialized, 0, "MemoryInjector"));
+    }
+    
+    ReadEngineStats engineStats;
+    if (operations.empty()) {
+        if (stats) {
+            *stats = engineStats;
+        }
+        return Result<void>::success();
+    }
+    
+    // 验证进程
+    if (!processManager_->isProcessAlive(process)) {
+        return Result<void>::error(Error(ErrorCode::ProcessGone).withPid(process.pid()));
+    }
+    
+    if (process.memFd() < 0) {
+        return batchOperations(process, operations);
+    }
+    
+    UKC_TRACE_SCOPE("injector.batch_operations_engine", operations.size());
+    
+    // 写操作是屏障：先读完之前的读操作，再执行写
+    size_t begin = 0;
+    for (size_t i = 0; i <= operations.size(); ++i) {
+        if (i < operations.size() && operations[i].type == OperationType::Read) {
+            continue;
+        }
+        if (i > begin) {
+            auto readResult = engine.read(process, &operations[begin], i - begin, &engineStats);
+            if (readResult.isError()) {
+                return Result<void>::error(readResult.errorInfo());
             }
         }
+        if (i < operations.size()) {
+            executeOperation(process, operations[i]);
+        }
+        begin = i + 1;
     }
     
+    // 只在失败路径上查询映射，区分无效地址和其他读取错误
+    for (auto& op : operations) {
+        if (op.type == OperationType::Read && !op.success &&
+            op.error.code() == ErrorCode::ReadFailed &&
+            !processManager_->isValidAddress(process, op.address)) {
+            op.error = Error(ErrorCode::InvalidAddress).withAddress(op.address).withPid(process.pid());
+        }
+    }
+    
+    if (stats) {
+        *stats = engineStats;
+    }
     return Result<void>::success();
 }
 
+Result<size_t> MemoryInjector::batchRead(
+    const ProcessHandle& process,
+    const std::vector<BatchReadRequest>& requests,
+    std::vector<BatchReadResult>& results,
+    BatchArena& arena
+) {
+    if (!initialized_) {
+        return Result<size_t>::error(Error(ErrorCode::NotInitialized, 0, "MemoryInjector"));
+    }
+    
+    results.resize(requests.size());
+    arena.reset();
+    if (requests.empty()) {
+        return Result<size_t>::success(0);
+    }
+    
+    UKC_PROBE_START(batchStart);
+    UKC_TRACE_SCOPE("injector.batch_read", requests.size());
+    
+    // 验证进程
+    if (!processManager_->isProcessAlive(process)) {
+        return Result<size_t>::error(Error(ErrorCode::ProcessGone).withPid(process.pid()));
+    }
+    
+    // 一次性预留全部结果所需的空间
+    size_t totalSize = 0;
+    for (const auto& request : requests) {
+        if (request.size > SIZE_MAX - totalSize) {
+            totalSize = SIZE_MAX;
+            break;
+        }
+        totalSize += request.size;
+    }
+    if (totalSize != SIZE_MAX) {
+        arena.reserve(totalSize);
+    }
+    
+    // 映射只解析一次，后续用二分查找校验地址
+    auto mapsResult = processManager_->getMemoryMaps(process);
+    if (mapsResult.isError()) {
+        return Result<size_t>::error(mapsResult.errorInfo());
+    }
+    const auto& regions = mapsResult.value();
+    UKC_TRACE_INSTANT("injector.batch_read.maps_ready", regions.size());
+    
+    // 校验和 arena 分配顺序执行（arena 不是线程安全的），读取可以并行
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const BatchReadRequest& request = requests[i];
+        BatchReadResult& result = results[i];
+        result.data = nullptr;
+        result.size = 0;
+        result.error = ErrorCode::None;
+        
+        if (request.size == 0) {
+            continue;
+        }
+        
+        if (request.address + request.size < request.address) {
+            result.error = ErrorCode::InvalidArgument;
+            continue;
+        }
+        
+        if (!findRegion(regions, request.address)) {
+            result.error = ErrorCode::InvalidAddress;
+            continue;
+        }
+        
+        uint8_t* buffer = arena.allocate(request.size);
+        if (!buffer) {
+            result.error = ErrorCode::BufferTooSmall;
+            continue;
+        }
+        
+        result.data = buffer;
+        result.size = request.size;
+    }
+    
+    auto readShard = [&](size_t shard) {
+        size_t end = std::min(requests.size(), (shard + 1) * kBatchReadShardSize);
+        for (size_t i = shard * kBatchReadShardSize; i < end; ++i) {
+            BatchReadResult& result = results[i];
+            if (result.data == nullptr) {
+                continue;
+            }
+            result.error = readIntoBuffer(process, requests[i].address,
+                                          const_cast<uint8_t*>(result.data), result.size);
+            if (!result.ok()) {
+                result.data = nullptr;
+                result.size = 0;
+            }
+        }
+    };
+    size_t shardCount = (requests.size() + kBatchReadShardSize - 1) / kBatchReadShardSize;
+    if (executor_ && shardCount > 1) {
+        executor_->parallelFor(ExecutorStage::BatchRead, shardCount, readShard);
+    } else {
+        for (size_t shard = 0; shard < shardCount; ++shard) {
+            readShard(shard);
+        }
+    }
+    
+    size_t succeeded = 0;
+    for (const auto& result : results) {
+        if (result.ok()) {
+            succeeded++;
+        }
+    }
+    
+    UKC_PROBE_RECORD_PER(BatchReadPerOp, batchStart, requests.size(), 1);
+    UKC_PROBE_COUNT(BatchReadOps, requests.size());
+    
+    return Result<size_t>::success(succeeded);
+}
+
+ErrorCode MemoryInjector::readIntoBuffer(
+    const ProcessHandle& process,
+    uintptr_t address,
+    uint8_t* buffer,
+    size_t size
+) {
+    // 与读取引擎相同，经 /proc/<pid>/mem 读取（无权限时退回 process_vm_readv），
+    // 同步与异步接口对同一地址返回相同的数据；跨映射边界时 mem 可能只读出一部分
+    size_t total = 0;
+    while (total < size) {
+        auto result = processManager_->readProcessMemory(
+            process, address + total, buffer + total, size - total
+        );
+        if (result.isError()) {
+            return result.errorCode();
+        }
+        total += result.value();
+    }
+    return ErrorCode::None;
+}
+
+void MemoryInjector::executeOperation(const ProcessHandle& process, MemoryOperation& op) {
+    // 验证地址
+    if (!processManager_->isValidAddress(process, op.address)) {
+        op.success = false;
+        op.error = Error(ErrorCode::InvalidAddress).withAddress(op.address).withPid(process.pid());
+        return;
+    }
+    
+    if (op.type == OperationType::Read) {
+        auto readResult = readMemory(process, op.address, op.size);
+        if (readResult.isSuccess()) {
+            op.success = true;
+            op.result = readResult.value();
+        } else {
+            op.success = false;
+            op.error = readResult.errorInfo();
+        }
+    } else if (op.type == OperationType::Write) {
+        auto writeResult = writeMemory(process, op.address, op.data);
+        if (writeResult.isSuccess()) {
+            op.success = true;
+        } else {
+            op.success = false;
+            op.error = writeResult.errorInfo();
+        }
+    }
+}
+
 } // namespace ukc
@@ -0,0 +1,251 @@
+#include "memory_watcher.h"
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace ukc {
+
+namespace {
+
+/**
+ * 查找 [from, size) 中第一个不同的字节，全部相同时返回 size
+ * 以 16 字节为单位快速跳过未变化的数据
+ */
+size_t findFirstDifference(
+    const uint8_t* a,
+    const uint8_t* b,
+    size_t from,
+    size_t size
+) {
+    size_t i = from;
+
+#if defined(__SSE2__)
+    for (; i + 16 <= size; i += 16) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)));
+        if (mask != 0xFFFF) {
+            return i + static_cast<size_t>(__builtin_ctz(~mask & 0xFFFF));
+        }
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t eq = vceqq_u8(vld1q_u8(a + i), vld1q_u8(b + i));
+        if (vminvq_u8(eq) != 0xFF) {
+            break;  // 由下面的逐字节循环定位块内的具体位置
+        }
+    }
+#endif
+
+    for (; i < size; ++i) {
+        if (a[i] != b[i]) {
+            return i;
+        }
+    }
+    return size;
+}
+
+/**
+ * 从 start（已知不同）开始，查找变化区间的结束位置
+ * 连续超过 mergeDistance 个相同字节视为区间结束
+ */
+size_t findChangeEnd(
+    const uint8_t* a,
+    const uint8_t* b,
+    size_t start,
+    size_t size,
+    size_t mergeDistance
+) {
+    size_t end = start + 1;
+    size_t equalRun = 0;
+    for (size_t i = start + 1; i < size; ++i) {
+        if (a[i] != b[i]) {
+            end = i + 1;
+            equalRun = 0;
+        } else if (++equalRun > mergeDistance) {
+            break;
+        }
+    }
+    return end;
+}
+
+} // namespace
+
+MemoryWatcher::MemoryWatcher(
+    std::shared_ptr<ProcessManager> processManager,
+    pid_t targetPid,
+    MemoryWatcherConfig config
+) : processManager_(std::move(processManager)),
+    targetPid_(targetPid),
+    config_(config) {
+}
+
+MemoryWatcher::~MemoryWatcher() {
+    stop();
+}
+
+Result<size_t> MemoryWatcher::addRegion(uintptr_t address, size_t size) {
+    if (!processManager_) {
+        return Result<size_t>::error("ProcessManager is null");
+    }
+
+    if (size == 0) {
+        return Result<size_t>::error("Region size must be greater than 0");
+    }
+
+    WatchedRegion region;
+    region.address = address;
+    region.size = size;
+    region.buffers[0].resize(size);
+    region.buffers[1].resize(size);
+
+    // 采集初始快照
+    auto readResult = processManager_->readProcessMemory(
+        targetPid_, address, region.buffers[0].data(), size
+    );
+    if (readResult.isError()) {
+        return Result<size_t>::error(readResult.errorInfo());
+    }
+    if (readResult.value() != size) {
+        return Result<size_t>::error(
+            "Region at 0x" + std::to_string(address) + " is not fully readable"
+        );
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    region.id = nextRegionId_++;
+    size_t id = region.id;
+    regions_.push_back(std::move(region));
+    return Result<size_t>::success(id);
+}
+
+Result<void> MemoryWatcher::removeRegion(size_t regionId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find_if(regions_.begin(), regions_.end(),
+        [regionId](const WatchedRegion& region) {
+            return region.id == regionId;
+        });
+    if (it == regions_.end()) {
+        return Result<void>::error(
+            "Region " + std::to_string(regionId) + " is not watched"
+        );
+    }
+    regions_.erase(it);
+    return Result<void>::success();
+}
+
+Result<size_t> MemoryWatcher::poll(const MemoryChangeCallback& callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!processManager_->isProcessAlive(targetPid_)) {
+        return Result<size_t>::error(
+            "Target process " + std::to_string(targetPid_) + " does not exist"
+        );
+    }
+
+    size_t changes = 0;
+    for (auto& region : regions_) {
+        int back = 1 - region.front;
+        auto readResult = processManager_->readProcessMemory(
+            targetPid_, region.address, region.buffers[back].data(), region.size
+        );
+        if (readResult.isError() || readResult.value() != region.size) {
+            // 保留上一次的快照，下一轮再比较
+            stats_.failedReads++;
+            continue;
+        }
+
+        region.front = back;
+        changes += diffRegion(region, callback);
+    }
+
+    stats_.samples++;
+    stats_.changedRanges += changes;
+    return Result<size_t>::success(changes);
+}
+
+size_t MemoryWatcher::diffRegion(
+    const WatchedRegion& region,
+    const MemoryChangeCallback& callback
+) {
+    const uint8_t* newData = region.buffers[region.front].data();
+    const uint8_t* oldData = region.buffers[1 - region.front].data();
+
+    size_t changes = 0;
+    size_t offset = 0;
+    while (true) {
+        size_t start = findFirstDifference(oldData, newData, offset, region.size);
+        if (start >= region.size) {
+            break;
+        }
+        size_t end = findChangeEnd(oldData, newData, start, region.size, config_.mergeDistance);
+
+        MemoryChange change;
+        change.regionId = region.id;
+        change.address = region.address + start;
+        change.offset = start;
+        change.size = end - start;
+        change.oldData = oldData + start;
+        change.newData = newData + start;
+        if (callback) {
+            callback(change);
+        }
+
+        stats_.changedBytes += change.size;
+        changes++;
+        offset = end;
+    }
+    return changes;
+}
+
+Result<void> MemoryWatcher::start(MemoryChangeCallback callback) {
+    if (running_.exchange(true)) {
+        return Result<void>::error("MemoryWatcher is already running");
+    }
+
+    // 上一个线程可能因目标进程退出而自行结束
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+
+    worker_ = std::thread([this, callback = std::move(callback)]() {
+        while (running_.load()) {
+            auto pollResult = poll(callback);
+            if (pollResult.isError()) {
+                // 目标进程退出，停止采样
+                running_.store(false);
+                break;
+            }
+
+            std::unique_lock<std::mutex> lock(wakeMutex_);
+            wakeCondition_.wait_for(lock, config_.interval, [this]() {
+                return !running_.load();
+            });
+        }
+    });
+
+    return Result<void>::success();
+}
+
+void MemoryWatcher::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        running_.store(false);
+    }
+    wakeCondition_.notify_all();
+
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+MemoryWatcherStats MemoryWatcher::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+} // namespace ukc
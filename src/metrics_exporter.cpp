@@ -0,0 +1,438 @@
+#include "metrics_exporter.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace ukc {
+
+namespace {
+
+struct Quantile {
+    const char* label;
+    double percentile;
+};
+
+const Quantile kQuantiles[] = {
+    {"0.5", 50.0},
+    {"0.9", 90.0},
+    {"0.99", 99.0},
+    {"0.999", 99.9},
+};
+
+/**
+ * 格式化浮点数（与 locale 无关的最短表示）
+ */
+std::string formatDouble(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+    return buffer;
+}
+
+std::string nsToSeconds(uint64_t ns) {
+    return formatDouble(static_cast<double>(ns) / 1e9);
+}
+
+/**
+ * 将任意名称转换为合法的指标名 [a-zA-Z_:][a-zA-Z0-9_:]*
+ */
+std::string sanitizeMetricName(const std::string& name) {
+    std::string result;
+    result.reserve(name.size() + 1);
+    for (char c : name) {
+        bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                     (c >= '0' && c <= '9') || c == '_' || c == ':';
+        result.push_back(valid ? c : '_');
+    }
+    if (result.empty() || (result[0] >= '0' && result[0] <= '9')) {
+        result.insert(result.begin(), '_');
+    }
+    return result;
+}
+
+/**
+ * 转义标签值中的反斜杠、双引号和换行
+ */
+std::string escapeLabelValue(const std::string& value) {
+    std::string result;
+    result.reserve(value.size());
+    for (char c : value) {
+        switch (c) {
+            case '\\': result += "\\\\"; break;
+            case '"':  result += "\\\""; break;
+            case '\n': result += "\\n"; break;
+            default:   result.push_back(c); break;
+        }
+    }
+    return result;
+}
+
+/**
+ * 转义 JSON 字符串
+ */
+std::string escapeJson(const std::string& value) {
+    std::string result;
+    result.reserve(value.size());
+    for (char c : value) {
+        switch (c) {
+            case '\\': result += "\\\\"; break;
+            case '"':  result += "\\\""; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(c));
+                    result += buffer;
+                } else {
+                    result.push_back(c);
+                }
+                break;
+        }
+    }
+    return result;
+}
+
+double throughput(const LatencyHistogram& histogram) {
+    if (histogram.sum() == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(histogram.count()) * 1e9 / static_cast<double>(histogram.sum());
+}
+
+/**
+ * Prometheus 与 OpenMetrics 共用的文本输出
+ */
+std::string formatText(const MetricsSnapshot& snapshot, const std::string& prefix, bool openMetrics) {
+    std::string out;
+    const std::string base = sanitizeMetricName(prefix);
+
+    if (!snapshot.operations.empty()) {
+        const std::string duration = base + "_operation_duration_seconds";
+        out += "# TYPE " + duration + " summary\n";
+        if (openMetrics) {
+            out += "# UNIT " + duration + " seconds\n";
+        }
+        out += "# HELP " + duration + " Operation latency.\n";
+        for (const auto& op : snapshot.operations) {
+            const std::string label = "operation=\"" + escapeLabelValue(op.name) + "\"";
+            for (const auto& q : kQuantiles) {
+                out += duration + "{" + label + ",quantile=\"" + q.label + "\"} " +
+                       nsToSeconds(op.histogram.percentile(q.percentile)) + "\n";
+            }
+            out += duration + "_sum{" + label + "} " + nsToSeconds(op.histogram.sum()) + "\n";
+            out += duration + "_count{" + label + "} " + std::to_string(op.histogram.count()) + "\n";
+        }
+
+        const std::string rate = base + "_operation_throughput";
+        out += "# TYPE " + rate + " gauge\n";
+        out += "# HELP " + rate + " Operations per second of measured time.\n";
+        for (const auto& op : snapshot.operations) {
+            out += rate + "{operation=\"" + escapeLabelValue(op.name) + "\"} " +
+                   formatDouble(throughput(op.histogram)) + "\n";
+        }
+    }
+
+    for (const auto& counter : snapshot.counters) {
+        const std::string name = base + "_" + sanitizeMetricName(counter.name);
+        // OpenMetrics 的 TYPE 行使用不带 _total 的名称
+        out += "# TYPE " + (openMetrics ? name : name + "_total") + " counter\n";
+        out += name + "_total " + std::to_string(counter.value) + "\n";
+    }
+
+    if (openMetrics) {
+        out += "# EOF\n";
+    }
+    return out;
+}
+
+} // anonymous namespace
+
+Result<MetricsSnapshot> MetricsExporter::capture(PerformanceMonitor& monitor) {
+    MetricsSnapshot snapshot;
+    snapshot.timestamp = std::chrono::system_clock::now();
+
+    auto histograms = monitor.getAllHistograms();
+    if (histograms.isError()) {
+        return Result<MetricsSnapshot>::error(histograms.errorInfo());
+    }
+    snapshot.operations = std::move(histograms.value());
+
+    auto counters = monitor.getAllCounters();
+    if (counters.isError()) {
+        return Result<MetricsSnapshot>::error(counters.errorInfo());
+    }
+    snapshot.counters = std::move(counters.value());
+
+    return Result<MetricsSnapshot>::success(std::move(snapshot));
+}
+
+MetricsSnapshot MetricsExporter::delta(const MetricsSnapshot& previous, const MetricsSnapshot& current) {
+    MetricsSnapshot result;
+    result.timestamp = current.timestamp;
+    result.isDelta = true;
+
+    for (const auto& op : current.operations) {
+        OperationHistogram entry = op;
+        auto it = std::find_if(previous.operations.begin(), previous.operations.end(),
+            [&](const OperationHistogram& p) { return p.name == op.name; });
+        // 计数变小说明期间被重置，此时当前值本身就是增量
+        if (it != previous.operations.end() && it->histogram.count() <= op.histogram.count()) {
+            entry.histogram.subtract(it->histogram);
+        }
+        if (entry.histogram.count() > 0) {
+            result.operations.push_back(std::move(entry));
+        }
+    }
+
+    for (const auto& counter : current.counters) {
+        CounterValue entry = counter;
+        auto it = std::find_if(previous.counters.begin(), previous.counters.end(),
+            [&](const CounterValue& p) { return p.name == counter.name; });
+        if (it != previous.counters.end() && it->value <= counter.value) {
+            entry.value -= it->value;
+        }
+        result.counters.push_back(std::move(entry));
+    }
+
+    return result;
+}
+
+std::string MetricsExporter::format(
+    const MetricsSnapshot& snapshot,
+    MetricsFormat format,
+    const std::string& prefix
+) {
+    switch (format) {
+        case MetricsFormat::Prometheus:
+            return toPrometheus(snapshot, prefix);
+        case MetricsFormat::OpenMetrics:
+            return toOpenMetrics(snapshot, prefix);
+        case MetricsFormat::Json:
+            return toJson(snapshot);
+    }
+    return std::string();
+}
+
+std::string MetricsExporter::toPrometheus(const MetricsSnapshot& snapshot, const std::string& prefix) {
+    return formatText(snapshot, prefix, false);
+}
+
+std::string MetricsExporter::toOpenMetrics(const MetricsSnapshot& snapshot, const std::string& prefix) {
+    return formatText(snapshot, prefix, true);
+}
+
+std::string MetricsExporter::toJson(const MetricsSnapshot& snapshot) {
+    auto timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        snapshot.timestamp.time_since_epoch()
+    ).count();
+
+    std::string out = "{\"timestamp_ms\":" + std::to_string(timestampMs);
+    out += ",\"delta\":";
+    out += snapshot.isDelta ? "true" : "false";
+
+    out += ",\"operations\":[";
+    for (size_t i = 0; i < snapshot.operations.size(); ++i) {
+        const auto& op = snapshot.operations[i];
+        const auto& h = op.histogram;
+        if (i > 0) {
+            out += ",";
+        }
+        out += "{\"name\":\"" + escapeJson(op.name) + "\"";
+        out += ",\"count\":" + std::to_string(h.count());
+        out += ",\"sum_ns\":" + std::to_string(h.sum());
+        out += ",\"min_ns\":" + std::to_string(h.min());
+        out += ",\"max_ns\":" + std::to_string(h.max());
+        out += ",\"p50_ns\":" + std::to_string(h.percentile(50.0));
+        out += ",\"p90_ns\":" + std::to_string(h.percentile(90.0));
+        out += ",\"p99_ns\":" + std::to_string(h.percentile(99.0));
+        out += ",\"p999_ns\":" + std::to_string(h.percentile(99.9));
+        out += ",\"ops_per_sec\":" + formatDouble(throughput(h));
+        out += "}";
+    }
+    out += "]";
+
+    out += ",\"counters\":{";
+    for (size_t i = 0; i < snapshot.counters.size(); ++i) {
+        if (i > 0) {
+            out += ",";
+        }
+        out += "\"" + escapeJson(snapshot.counters[i].name) + "\":" +
+               std::to_string(snapshot.counters[i].value);
+    }
+    out += "}}\n";
+
+    return out;
+}
+
+const char* MetricsExporter::contentType(MetricsFormat format) {
+    switch (format) {
+        case MetricsFormat::Prometheus:
+            return "text/plain; version=0.0.4; charset=utf-8";
+        case MetricsFormat::OpenMetrics:
+            return "application/openmetrics-text; version=1.0.0; charset=utf-8";
+        case MetricsFormat::Json:
+            return "application/json";
+    }
+    return "text/plain";
+}
+
+MetricsSnapshotWriter::MetricsSnapshotWriter(PerformanceMonitor& monitor, MetricsWriterConfig config)
+    : monitor_(monitor), config_(std::move(config)) {
+}
+
+MetricsSnapshotWriter::~MetricsSnapshotWriter() {
+    stop();
+}
+
+Result<void> MetricsSnapshotWriter::writeOnce() {
+    if (config_.path.empty()) {
+        return Result<void>::error("Metrics sink path is empty");
+    }
+
+    std::lock_guard<std::mutex> lock(writeMutex_);
+
+    auto captured = MetricsExporter::capture(monitor_);
+    if (captured.isError()) {
+        failed_++;
+        return Result<void>::error(captured.errorInfo());
+    }
+    MetricsSnapshot current = std::move(captured.value());
+
+    std::string payload;
+    if (config_.delta && hasPrevious_) {
+        payload = MetricsExporter::format(
+            MetricsExporter::delta(previous_, current), config_.format, config_.prefix
+        );
+    } else {
+        payload = MetricsExporter::format(current, config_.format, config_.prefix);
+    }
+
+    Result<void> writeResult = config_.sinkType == MetricsSinkType::File
+        ? writeToFile(payload)
+        : writeToSocket(payload);
+    if (writeResult.isError()) {
+        failed_++;
+        return writeResult;
+    }
+
+    previous_ = std::move(current);
+    hasPrevious_ = true;
+    written_++;
+    return Result<void>::success();
+}
+
+Result<void> MetricsSnapshotWriter::start() {
+    if (running_.exchange(true)) {
+        return Result<void>::error("MetricsSnapshotWriter is already running");
+    }
+
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+
+    worker_ = std::thread([this]() {
+        while (running_.load()) {
+            std::unique_lock<std::mutex> lock(wakeMutex_);
+            wakeCondition_.wait_for(lock, config_.interval, [this]() {
+                return !running_.load();
+            });
+            lock.unlock();
+
+            // 停止时再写出一次，避免丢失最后一个间隔的数据；失败计入 failedCount
+            (void)writeOnce();
+        }
+    });
+
+    return Result<void>::success();
+}
+
+void MetricsSnapshotWriter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        running_.store(false);
+    }
+    wakeCondition_.notify_all();
+
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+Result<void> MetricsSnapshotWriter::writeToFile(const std::string& payload) {
+    std::string tempPath = config_.path + ".tmp";
+
+    int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return Result<void>::error("Cannot open " + tempPath + ": " + std::strerror(errno));
+    }
+
+    size_t offset = 0;
+    while (offset < payload.size()) {
+        ssize_t n = write(fd, payload.data() + offset, payload.size() - offset);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::string error = std::strerror(errno);
+            close(fd);
+            unlink(tempPath.c_str());
+            return Result<void>::error("Write to " + tempPath + " failed: " + error);
+        }
+        offset += static_cast<size_t>(n);
+    }
+    close(fd);
+
+    if (rename(tempPath.c_str(), config_.path.c_str()) != 0) {
+        std::string error = std::strerror(errno);
+        unlink(tempPath.c_str());
+        return Result<void>::error("Cannot rename to " + config_.path + ": " + error);
+    }
+
+    return Result<void>::success();
+}
+
+Result<void> MetricsSnapshotWriter::writeToSocket(const std::string& payload) {
+    struct sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (config_.path.size() >= sizeof(address.sun_path)) {
+        return Result<void>::error("Unix socket path too long: " + config_.path);
+    }
+    std::memcpy(address.sun_path, config_.path.c_str(), config_.path.size());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return Result<void>::error(std::string("socket failed: ") + std::strerror(errno));
+    }
+
+    if (connect(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0) {
+        std::string error = std::strerror(errno);
+        close(fd);
+        return Result<void>::error("Cannot connect to " + config_.path + ": " + error);
+    }
+
+    size_t offset = 0;
+    while (offset < payload.size()) {
+        ssize_t n = send(fd, payload.data() + offset, payload.size() - offset, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::string error = std::strerror(errno);
+            close(fd);
+            return Result<void>::error("Send to " + config_.path + " failed: " + error);
+        }
+        offset += static_cast<size_t>(n);
+    }
+    close(fd);
+
+    return Result<void>::success();
+}
+
+} // namespace ukc
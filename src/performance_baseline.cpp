@@ -0,0 +1,224 @@
+#include "performance_baseline.h"
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace ukc {
+
+namespace {
+
+const char* const kBaselineHeader = "ukc-baseline 1";
+
+} // anonymous namespace
+
+std::string RegressionReport::toString() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(4);
+    oss << "Operation: " << operationName << (regressed ? " REGRESSED" : " ok") << "\n";
+    oss << "  Samples: baseline " << baselineCount << ", current " << currentCount << "\n";
+    oss << "  Mann-Whitney: U=" << uStatistic << " z=" << zScore << " p=" << pValue
+        << " P(current>baseline)=" << probabilityOfSuperiority << "\n";
+    for (const auto& p : percentiles) {
+        oss << "  P" << p.percentile << ": " << p.baselineNs << " ns -> "
+            << p.currentNs << " ns (x" << p.ratio << ")\n";
+    }
+    return oss.str();
+}
+
+MannWhitneyResult mannWhitneyU(const LatencyHistogram& baseline, const LatencyHistogram& current) {
+    MannWhitneyResult result;
+
+    const double n1 = static_cast<double>(baseline.count());
+    const double n2 = static_cast<double>(current.count());
+    if (n1 == 0 || n2 == 0) {
+        return result;
+    }
+    const double n = n1 + n2;
+
+    // 按桶从小到大分配秩，同一桶内取平均秩
+    double rankSumCurrent = 0.0;
+    double tieCorrection = 0.0;
+    double ranked = 0.0;
+    for (size_t i = 0; i < LatencyHistogram::kBucketCount; ++i) {
+        double a = static_cast<double>(baseline.bucketCount(i));
+        double b = static_cast<double>(current.bucketCount(i));
+        double tied = a + b;
+        if (tied == 0) {
+            continue;
+        }
+        double averageRank = ranked + (tied + 1.0) / 2.0;
+        rankSumCurrent += b * averageRank;
+        tieCorrection += tied * tied * tied - tied;
+        ranked += tied;
+    }
+
+    result.u = rankSumCurrent - n2 * (n2 + 1.0) / 2.0;
+    result.probabilityOfSuperiority = result.u / (n1 * n2);
+
+    double mean = n1 * n2 / 2.0;
+    double variance = n1 * n2 / 12.0 * ((n + 1.0) - tieCorrection / (n * (n - 1.0)));
+    if (variance <= 0.0) {
+        // 所有样本落在同一个桶中
+        return result;
+    }
+
+    // 连续性校正
+    result.z = (result.u - mean - 0.5) / std::sqrt(variance);
+    result.pValue = 0.5 * std::erfc(result.z / std::sqrt(2.0));
+    return result;
+}
+
+Result<PerformanceBaseline> PerformanceBaseline::capture(PerformanceMonitor& monitor) {
+    auto histograms = monitor.getAllHistograms();
+    if (histograms.isError()) {
+        return Result<PerformanceBaseline>::error(histograms.errorInfo());
+    }
+
+    PerformanceBaseline baseline;
+    for (const auto& entry : histograms.value()) {
+        baseline.set(entry.name, entry.histogram);
+    }
+    return Result<PerformanceBaseline>::success(std::move(baseline));
+}
+
+Result<PerformanceBaseline> PerformanceBaseline::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return Result<PerformanceBaseline>::error("Cannot open baseline " + path);
+    }
+
+    std::string line;
+    if (!std::getline(file, line) || line != kBaselineHeader) {
+        return Result<PerformanceBaseline>::error("Not a baseline file: " + path);
+    }
+
+    PerformanceBaseline baseline;
+    size_t lineNumber = 1;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        if (line.empty()) continue;
+
+        size_t tab = line.find('\t');
+        if (tab == std::string::npos || tab == 0) {
+            return Result<PerformanceBaseline>::error(
+                path + ":" + std::to_string(lineNumber) + ": missing operation name"
+            );
+        }
+
+        auto histogram = LatencyHistogram::deserialize(line.substr(tab + 1));
+        if (histogram.isError()) {
+            return Result<PerformanceBaseline>::error(
+                path + ":" + std::to_string(lineNumber) + ": " + histogram.errorMessage()
+            );
+        }
+        baseline.set(line.substr(0, tab), histogram.value());
+    }
+
+    return Result<PerformanceBaseline>::success(std::move(baseline));
+}
+
+Result<void> PerformanceBaseline::save(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        return Result<void>::error("Cannot write baseline " + path);
+    }
+
+    file << kBaselineHeader << "\n";
+    for (const auto& entry : histograms_) {
+        if (entry.first.find_first_of("\t\n") != std::string::npos) {
+            return Result<void>::error(
+                "Operation name '" + entry.first + "' contains a tab or newline"
+            );
+        }
+        file << entry.first << "\t" << entry.second.serialize() << "\n";
+    }
+
+    if (!file) {
+        return Result<void>::error("Write to baseline " + path + " failed");
+    }
+    return Result<void>::success();
+}
+
+void PerformanceBaseline::set(const std::string& operationName, const LatencyHistogram& histogram) {
+    histograms_[operationName] = histogram;
+}
+
+const LatencyHistogram* PerformanceBaseline::find(const std::string& operationName) const {
+    auto it = histograms_.find(operationName);
+    return it != histograms_.end() ? &it->second : nullptr;
+}
+
+Result<RegressionReport> PerformanceBaseline::compare(
+    const std::string& operationName,
+    const LatencyHistogram& current,
+    const RegressionCheckConfig& config
+) const {
+    const LatencyHistogram* baseline = find(operationName);
+    if (!baseline) {
+        return Result<RegressionReport>::error(
+            "No baseline for operation '" + operationName + "'"
+        );
+    }
+
+    RegressionReport report;
+    report.operationName = operationName;
+    report.baselineCount = baseline->count();
+    report.currentCount = current.count();
+
+    MannWhitneyResult test = mannWhitneyU(*baseline, current);
+    report.uStatistic = test.u;
+    report.zScore = test.z;
+    report.pValue = test.pValue;
+    report.probabilityOfSuperiority = test.probabilityOfSuperiority;
+
+    bool beyondTolerance = false;
+    for (double percentile : config.percentiles) {
+        PercentileComparison comparison;
+        comparison.percentile = percentile;
+        comparison.baselineNs = baseline->percentile(percentile);
+        comparison.currentNs = current.percentile(percentile);
+        comparison.ratio = comparison.baselineNs > 0
+            ? static_cast<double>(comparison.currentNs) / comparison.baselineNs
+            : (comparison.currentNs > 0 ? INFINITY : 1.0);
+        if (comparison.ratio > 1.0 + config.percentileTolerance) {
+            beyondTolerance = true;
+        }
+        report.percentiles.push_back(comparison);
+    }
+
+    // 同时要求统计显著和实际幅度，避免大样本下微小差异误报
+    report.sufficientSamples = report.baselineCount >= config.minSamples &&
+                               report.currentCount >= config.minSamples;
+    report.regressed = report.sufficientSamples &&
+                       report.pValue < config.significance &&
+                       beyondTolerance;
+
+    return Result<RegressionReport>::success(std::move(report));
+}
+
+Result<std::vector<RegressionReport>> PerformanceBaseline::compareAll(
+    PerformanceMonitor& monitor,
+    const RegressionCheckConfig& config
+) const {
+    auto histograms = monitor.getAllHistograms();
+    if (histograms.isError()) {
+        return Result<std::vector<RegressionReport>>::error(histograms.errorInfo());
+    }
+
+    std::vector<RegressionReport> reports;
+    for (const auto& entry : histograms.value()) {
+        if (!find(entry.name)) {
+            continue;
+        }
+        auto report = compare(entry.name, entry.histogram, config);
+        if (report.isError()) {
+            return Result<std::vector<RegressionReport>>::error(report.errorInfo());
+        }
+        reports.push_back(std::move(report.value()));
+    }
+
+    return Result<std::vector<RegressionReport>>::success(std::move(reports));
+}
+
+} // namespace ukc
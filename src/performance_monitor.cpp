@@ -1,6 +1,6 @@
 #include "performance_monitor.h"
-#include <algorithm>
-#include <numeric>
+#include <array>
+#include <atomic>
 #include <sstream>
 #include <iomanip>
 
@@ -15,33 +15,316 @@ std::string PerformanceStats::toString() const {
     oss << "  Min Time: " << minTime.count() << " μs\n";
     oss << "  Max Time: " << maxTime.count() << " μs\n";
     oss << "  Average Time: " << averageTime.count() << " μs\n";
+    oss << "  P50: " << p50.count() << " ns\n";
+    oss << "  P90: " << p90.count() << " ns\n";
+    oss << "  P99: " << p99.count() << " ns\n";
+    oss << "  P99.9: " << p999.count() << " ns\n";
     oss << "  Throughput: " << operationsPerSecond << " ops/sec\n";
+    if (hardwareSamples > 0) {
+        oss << "  IPC: " << instructionsPerCycle << "\n";
+        oss << "  Cache Misses/KI: " << cacheMissesPerKiloInstruction << "\n";
+        oss << "  Branch Misses/KI: " << branchMissesPerKiloInstruction << "\n";
+    }
     return oss.str();
 }
 
-PerformanceMonitor::PerformanceMonitor() = default;
+namespace detail {
+
+/**
+ * 单个操作的硬件计数器累计值，单写者
+ */
+struct HardwareAccumulator {
+    std::atomic<uint64_t> samples{0};
+    std::array<std::atomic<uint64_t>, kHardwareEventCount> totals;
+    
+    HardwareAccumulator() {
+        for (auto& total : totals) {
+            total.store(0, std::memory_order_relaxed);
+        }
+    }
+    
+    void reset() {
+        samples.store(0, std::memory_order_relaxed);
+        for (auto& total : totals) {
+            total.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+/**
+ * 单个线程在单个监控器中的分片
+ */
+struct PerformanceShard {
+    // 每个操作一个直方图，由所属线程在首次记录时创建
+    std::array<std::atomic<AtomicLatencyHistogram*>, PerformanceMonitor::kMaxOperations> histograms;
+    
+    // 每个操作的硬件计数器，首次使用 scopeWithCounters() 时创建
+    std::array<std::atomic<HardwareAccumulator*>, PerformanceMonitor::kMaxOperations> hardware;
+    
+    // 计数器，单写者
+    std::array<std::atomic<uint64_t>, PerformanceMonitor::kMaxCounters> counters;
+    
+    // startTimer/stopTimer 的起始时间，只由所属线程访问
+    std::map<OperationId, std::chrono::steady_clock::time_point> pendingStarts;
+    
+    PerformanceShard() {
+        for (auto& histogram : histograms) {
+            histogram.store(nullptr, std::memory_order_relaxed);
+        }
+        for (auto& accumulator : hardware) {
+            accumulator.store(nullptr, std::memory_order_relaxed);
+        }
+        for (auto& counter : counters) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+    }
+    
+    ~PerformanceShard() {
+        for (auto& histogram : histograms) {
+            delete histogram.load(std::memory_order_relaxed);
+        }
+        for (auto& accumulator : hardware) {
+            delete accumulator.load(std::memory_order_relaxed);
+        }
+    }
+};
+
+} // namespace detail
+
+namespace {
+
+std::atomic<uint64_t> nextMonitorId{1};
+
+/**
+ * 线程局部的分片缓存
+ * 最近使用的监控器走快速路径，其余按监控器 ID 查找。
+ */
+struct ShardCache {
+    uint64_t monitorId = 0;
+    detail::PerformanceShard* shard = nullptr;
+    std::map<uint64_t, std::shared_ptr<detail::PerformanceShard>> shards;
+};
+
+thread_local ShardCache shardCache;
+
+} // anonymous namespace
+
+PerformanceMonitor::ScopedTimer::ScopedTimer(
+    AtomicLatencyHistogram* histogram,
+    detail::HardwareAccumulator* hardware
+) : histogram_(histogram) {
+    if (hardware) {
+        counterGroup_ = HardwareCounterGroup::forCurrentThread();
+        if (counterGroup_ && counterGroup_->read(
+                counterStart_.values, counterStart_.timeEnabled, counterStart_.timeRunning)) {
+            hardware_ = hardware;
+        }
+    }
+    // 最后取起始时间，避免把读取计数器的耗时计入
+    startTime_ = std::chrono::steady_clock::now();
+}
+
+PerformanceMonitor::ScopedTimer::ScopedTimer(ScopedTimer&& other) noexcept
+    : histogram_(other.histogram_), startTime_(other.startTime_),
+      hardware_(other.hardware_), counterGroup_(other.counterGroup_),
+      counterStart_(other.counterStart_) {
+    other.histogram_ = nullptr;
+    other.hardware_ = nullptr;
+}
+
+PerformanceMonitor::ScopedTimer& PerformanceMonitor::ScopedTimer::operator=(
+    ScopedTimer&& other
+) noexcept {
+    if (this != &other) {
+        stop();
+        histogram_ = other.histogram_;
+        startTime_ = other.startTime_;
+        hardware_ = other.hardware_;
+        counterGroup_ = other.counterGroup_;
+        counterStart_ = other.counterStart_;
+        other.histogram_ = nullptr;
+        other.hardware_ = nullptr;
+    }
+    return *this;
+}
+
+PerformanceMonitor::ScopedTimer::~ScopedTimer() {
+    stop();
+}
+
+void PerformanceMonitor::ScopedTimer::stop() {
+    if (!histogram_) {
+        return;
+    }
+    
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - startTime_
+    );
+    
+    if (hardware_) {
+        HardwareCounterValues delta;
+        if (hardwareCounterDelta(*counterGroup_, counterStart_, delta)) {
+            for (size_t i = 0; i < kHardwareEventCount; ++i) {
+                hardware_->totals[i].fetch_add(delta.values[i], std::memory_order_relaxed);
+            }
+            hardware_->samples.fetch_add(1, std::memory_order_release);
+        }
+        hardware_ = nullptr;
+    }
+    
+    histogram_->record(static_cast<uint64_t>(duration.count()));
+    histogram_ = nullptr;
+}
+
+PerformanceMonitor::PerformanceMonitor()
+    : monitorId_(nextMonitorId.fetch_add(1, std::memory_order_relaxed)) {
+}
 
 PerformanceMonitor::~PerformanceMonitor() = default;
 
+Result<OperationId> PerformanceMonitor::registerOperation(
+    const std::string& operationName
+) {
+    std::lock_guard<std::mutex> lock(registryMutex_);
+    
+    auto it = operationIds_.find(operationName);
+    if (it != operationIds_.end()) {
+        return Result<OperationId>::success(it->second);
+    }
+    
+    if (operationNames_.size() >= kMaxOperations) {
+        return Result<OperationId>::error(
+            "Too many registered operations (max " + std::to_string(kMaxOperations) + ")"
+        );
+    }
+    
+    OperationId id = static_cast<OperationId>(operationNames_.size());
+    operationNames_.push_back(operationName);
+    operationIds_[operationName] = id;
+    
+    return Result<OperationId>::success(id);
+}
+
+PerformanceMonitor::ScopedTimer PerformanceMonitor::scope(OperationId operationId) {
+    return ScopedTimer(localHistogram(operationId), nullptr);
+}
+
+PerformanceMonitor::ScopedTimer PerformanceMonitor::scopeWithCounters(OperationId operationId) {
+    AtomicLatencyHistogram* histogram = localHistogram(operationId);
+    if (!histogram) {
+        return ScopedTimer();
+    }
+    
+    auto& slot = localShard().hardware[operationId];
+    detail::HardwareAccumulator* hardware = slot.load(std::memory_order_relaxed);
+    if (!hardware) {
+        hardware = new detail::HardwareAccumulator();
+        slot.store(hardware, std::memory_order_release);
+    }
+    return ScopedTimer(histogram, hardware);
+}
+
+void PerformanceMonitor::record(
+    OperationId operationId,
+    std::chrono::nanoseconds duration
+) {
+    AtomicLatencyHistogram* histogram = localHistogram(operationId);
+    if (histogram && duration.count() >= 0) {
+        histogram->record(static_cast<uint64_t>(duration.count()));
+    }
+}
+
+Result<CounterId> PerformanceMonitor::registerCounter(const std::string& counterName) {
+    std::lock_guard<std::mutex> lock(registryMutex_);
+    
+    auto it = counterIds_.find(counterName);
+    if (it != counterIds_.end()) {
+        return Result<CounterId>::success(it->second);
+    }
+    
+    if (counterNames_.size() >= kMaxCounters) {
+        return Result<CounterId>::error(
+            "Too many registered counters (max " + std::to_string(kMaxCounters) + ")"
+        );
+    }
+    
+    CounterId id = static_cast<CounterId>(counterNames_.size());
+    counterNames_.push_back(counterName);
+    counterIds_[counterName] = id;
+    
+    return Result<CounterId>::success(id);
+}
+
+void PerformanceMonitor::increment(CounterId counterId, uint64_t delta) {
+    if (counterId >= kMaxCounters) {
+        return;
+    }
+    localShard().counters[counterId].fetch_add(delta, std::memory_order_relaxed);
+}
+
+Result<uint64_t> PerformanceMonitor::getCounter(const std::string& counterName) {
+    CounterId id = kInvalidCounterId;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex_);
+        auto it = counterIds_.find(counterName);
+        if (it != counterIds_.end()) {
+            id = it->second;
+        }
+    }
+    
+    if (id == kInvalidCounterId) {
+        return Result<uint64_t>::error("Counter '" + counterName + "' not registered");
+    }
+    
+    return Result<uint64_t>::success(sumCounter(id));
+}
+
+Result<std::vector<CounterValue>> PerformanceMonitor::getAllCounters() {
+    std::vector<std::string> names;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex_);
+        names = counterNames_;
+    }
+    
+    std::vector<CounterValue> counters;
+    counters.reserve(names.size());
+    for (size_t id = 0; id < names.size(); ++id) {
+        CounterValue counter;
+        counter.name = names[id];
+        counter.value = sumCounter(static_cast<CounterId>(id));
+        counters.push_back(std::move(counter));
+    }
+    
+    return Result<std::vector<CounterValue>>::success(std::move(counters));
+}
+
 void PerformanceMonitor::startTimer(const std::string& operationName) {
-    TimerEntry& entry = timers_[operationName];
-    entry.startTime = std::chrono::steady_clock::now();
+    auto idResult = registerOperation(operationName);
+    if (idResult.isError()) {
+        return;
+    }
+    
+    localShard().pendingStarts[idResult.value()] = std::chrono::steady_clock::now();
 }
 
 Result<void> PerformanceMonitor::stopTimer(const std::string& operationName) {
-    auto it = timers_.find(operationName);
-    if (it == timers_.end()) {
+    auto endTime = std::chrono::steady_clock::now();
+    
+    OperationId id = findOperation(operationName);
+    detail::PerformanceShard& shard = localShard();
+    auto it = shard.pendingStarts.find(id);
+    if (id == kInvalidOperationId || it == shard.pendingStarts.end()) {
         return Result<void>::error(
             "Timer for operation '" + operationName + "' not started"
         );
     }
     
-    auto endTime = std::chrono::steady_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
-        endTime - it->second.startTime
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        endTime - it->second
     );
+    shard.pendingStarts.erase(it);
     
-    it->second.measurements.push_back(duration);
+    record(id, duration);
     
     return Result<void>::success();
 }
@@ -49,55 +332,149 @@ Result<void> PerformanceMonitor::stopTimer(const std::string& operationName) {
 Result<PerformanceStats> PerformanceMonitor::getStats(
     const std::string& operationName
 ) {
-    auto it = timers_.find(operationName);
-    if (it == timers_.end() || it->second.measurements.empty()) {
+    OperationId id = findOperation(operationName);
+    if (id == kInvalidOperationId) {
+        return Result<PerformanceStats>::error(
+            "No measurements for operation '" + operationName + "'"
+        );
+    }
+    
+    return getStats(id);
+}
+
+Result<PerformanceStats> PerformanceMonitor::getStats(OperationId operationId) {
+    std::string operationName;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex_);
+        if (operationId >= operationNames_.size()) {
+            return Result<PerformanceStats>::error("Invalid operation id");
+        }
+        operationName = operationNames_[operationId];
+    }
+    
+    LatencyHistogram histogram = mergeShards(operationId);
+    if (histogram.count() == 0) {
         return Result<PerformanceStats>::error(
             "No measurements for operation '" + operationName + "'"
         );
     }
     
     PerformanceStats stats = calculateStats(
-        operationName,
-        it->second.measurements
+        operationName, histogram, mergeHardware(operationId)
     );
     
     return Result<PerformanceStats>::success(std::move(stats));
 }
 
 Result<std::vector<PerformanceStats>> PerformanceMonitor::getAllStats() {
+    std::vector<std::string> names;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex_);
+        names = operationNames_;
+    }
+    
     std::vector<PerformanceStats> allStats;
     
-    for (const auto& entry : timers_) {
-        if (!entry.second.measurements.empty()) {
-            PerformanceStats stats = calculateStats(
-                entry.first,
-                entry.second.measurements
-            );
-            allStats.push_back(stats);
+    for (size_t id = 0; id < names.size(); ++id) {
+        LatencyHistogram histogram = mergeShards(static_cast<OperationId>(id));
+        if (histogram.count() > 0) {
+            allStats.push_back(calculateStats(
+                names[id], histogram, mergeHardware(static_cast<OperationId>(id))
+            ));
         }
     }
     
     return Result<std::vector<PerformanceStats>>::success(std::move(allStats));
 }
 
+Result<std::vector<OperationHistogram>> PerformanceMonitor::getAllHistograms() {
+    std::vector<std::string> names;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex_);
+        names = operationNames_;
+    }
+    
+    std::vector<OperationHistogram> histograms;
+    
+    for (size_t id = 0; id < names.size(); ++id) {
+        OperationHistogram entry;
+        entry.histogram = mergeShards(static_cast<OperationId>(id));
+        if (entry.histogram.count() > 0) {
+            entry.name = names[id];
+            histograms.push_back(std::move(entry));
+        }
+    }
+    
+    return Result<std::vector<OperationHistogram>>::success(std::move(histograms));
+}
+
 void PerformanceMonitor::resetStats() {
-    timers_.clear();
+    std::lock_guard<std::mutex> lock(shardsMutex_);
+    for (const auto& shard : shards_) {
+        for (auto& slot : shard->histograms) {
+            AtomicLatencyHistogram* histogram = slot.load(std::memory_order_acquire);
+            if (histogram) {
+                histogram->reset();
+            }
+        }
+        for (auto& slot : shard->hardware) {
+            detail::HardwareAccumulator* hardware = slot.load(std::memory_order_acquire);
+            if (hardware) {
+                hardware->reset();
+            }
+        }
+        for (auto& counter : shard->counters) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+    }
 }
 
 void PerformanceMonitor::resetStats(const std::string& operationName) {
-    auto it = timers_.find(operationName);
-    if (it != timers_.end()) {
-        it->second.measurements.clear();
+    OperationId id = findOperation(operationName);
+    if (id == kInvalidOperationId) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(shardsMutex_);
+    for (const auto& shard : shards_) {
+        AtomicLatencyHistogram* histogram =
+            shard->histograms[id].load(std::memory_order_acquire);
+        if (histogram) {
+            histogram->reset();
+        }
+        detail::HardwareAccumulator* hardware =
+            shard->hardware[id].load(std::memory_order_acquire);
+        if (hardware) {
+            hardware->reset();
+        }
     }
 }
 
+Result<LatencyHistogram> PerformanceMonitor::getHistogram(const std::string& operationName) {
+    OperationId id = findOperation(operationName);
+    if (id == kInvalidOperationId) {
+        return Result<LatencyHistogram>::error(
+            "No measurements for operation '" + operationName + "'"
+        );
+    }
+    
+    LatencyHistogram histogram = mergeShards(id);
+    if (histogram.count() == 0) {
+        return Result<LatencyHistogram>::error(
+            "No measurements for operation '" + operationName + "'"
+        );
+    }
+    
+    return Result<LatencyHistogram>::success(std::move(histogram));
+}
+
 Result<bool> PerformanceMonitor::meetsPerformanceRequirement(
     const std::string& operationName,
     std::chrono::microseconds maxTime
 ) {
     auto statsResult = getStats(operationName);
     if (statsResult.isError()) {
-        return Result<bool>::error(statsResult.errorMessage());
+        return Result<bool>::error(statsResult.errorInfo());
     }
     
     const auto& stats = statsResult.value();
@@ -106,39 +483,224 @@ Result<bool> PerformanceMonitor::meetsPerformanceRequirement(
     return Result<bool>::success(meets);
 }
 
+Result<bool> PerformanceMonitor::meetsPerformanceRequirement(
+    const std::string& operationName,
+    const PerformanceRequirement& requirement
+) {
+    auto checkResult = checkRequirement(operationName, requirement);
+    if (checkResult.isError()) {
+        return Result<bool>::error(checkResult.errorInfo());
+    }
+    
+    return Result<bool>::success(checkResult.value().passed);
+}
+
+Result<RequirementCheck> PerformanceMonitor::checkRequirement(
+    const std::string& operationName,
+    const PerformanceRequirement& requirement
+) {
+    auto histogramResult = getHistogram(operationName);
+    if (histogramResult.isError()) {
+        return Result<RequirementCheck>::error(histogramResult.errorInfo());
+    }
+    
+    const LatencyHistogram& histogram = histogramResult.value();
+    RequirementCheck check;
+    check.stats = calculateStats(operationName, histogram);
+    
+    auto fail = [&check](const std::string& message) {
+        check.passed = false;
+        check.violations.push_back(message);
+    };
+    
+    if (histogram.count() < requirement.minSamples) {
+        fail("only " + std::to_string(histogram.count()) + " samples, need " +
+             std::to_string(requirement.minSamples));
+    }
+    
+    for (const auto& target : requirement.percentiles) {
+        if (target.percentile <= 0.0 || target.percentile > 100.0) {
+            return Result<RequirementCheck>::error(
+                "Invalid percentile " + std::to_string(target.percentile)
+            );
+        }
+        uint64_t actual = histogram.percentile(target.percentile);
+        if (actual > static_cast<uint64_t>(target.maxLatency.count())) {
+            std::ostringstream oss;
+            oss << "P" << target.percentile << " " << actual << " ns exceeds "
+                << target.maxLatency.count() << " ns";
+            fail(oss.str());
+        }
+    }
+    
+    if (requirement.maxAverage.count() > 0) {
+        uint64_t average = histogram.sum() / histogram.count();
+        if (average > static_cast<uint64_t>(requirement.maxAverage.count())) {
+            fail("average " + std::to_string(average) + " ns exceeds " +
+                 std::to_string(requirement.maxAverage.count()) + " ns");
+        }
+    }
+    
+    if (requirement.minOperationsPerSecond > 0.0 &&
+        check.stats.operationsPerSecond < requirement.minOperationsPerSecond) {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(2) << "throughput "
+            << check.stats.operationsPerSecond << " ops/sec below "
+            << requirement.minOperationsPerSecond << " ops/sec";
+        fail(oss.str());
+    }
+    
+    return Result<RequirementCheck>::success(std::move(check));
+}
+
+detail::PerformanceShard& PerformanceMonitor::localShard() {
+    if (shardCache.monitorId == monitorId_) {
+        return *shardCache.shard;
+    }
+    
+    auto it = shardCache.shards.find(monitorId_);
+    if (it == shardCache.shards.end()) {
+        // 清理已销毁监控器遗留的分片（只剩本线程持有引用）
+        for (auto stale = shardCache.shards.begin(); stale != shardCache.shards.end();) {
+            if (stale->second.use_count() == 1) {
+                stale = shardCache.shards.erase(stale);
+            } else {
+                ++stale;
+            }
+        }
+        
+        auto shard = std::make_shared<detail::PerformanceShard>();
+        {
+            std::lock_guard<std::mutex> lock(shardsMutex_);
+            shards_.push_back(shard);
+        }
+        it = shardCache.shards.emplace(monitorId_, std::move(shard)).first;
+    }
+    
+    shardCache.monitorId = monitorId_;
+    shardCache.shard = it->second.get();
+    return *shardCache.shard;
+}
+
+AtomicLatencyHistogram* PerformanceMonitor::localHistogram(OperationId operationId) {
+    if (operationId >= kMaxOperations) {
+        return nullptr;
+    }
+    
+    // 只有所属线程会写入槽位，relaxed 读取即可
+    auto& slot = localShard().histograms[operationId];
+    AtomicLatencyHistogram* histogram = slot.load(std::memory_order_relaxed);
+    if (!histogram) {
+        histogram = new AtomicLatencyHistogram();
+        slot.store(histogram, std::memory_order_release);
+    }
+    return histogram;
+}
+
+OperationId PerformanceMonitor::findOperation(const std::string& operationName) const {
+    std::lock_guard<std::mutex> lock(registryMutex_);
+    auto it = operationIds_.find(operationName);
+    return it != operationIds_.end() ? it->second : kInvalidOperationId;
+}
+
+uint64_t PerformanceMonitor::sumCounter(CounterId counterId) const {
+    uint64_t total = 0;
+    
+    std::lock_guard<std::mutex> lock(shardsMutex_);
+    for (const auto& shard : shards_) {
+        total += shard->counters[counterId].load(std::memory_order_relaxed);
+    }
+    
+    return total;
+}
+
+HardwareCounterTotals PerformanceMonitor::mergeHardware(OperationId operationId) const {
+    HardwareCounterTotals totals;
+    
+    std::lock_guard<std::mutex> lock(shardsMutex_);
+    for (const auto& shard : shards_) {
+        const detail::HardwareAccumulator* hardware =
+            shard->hardware[operationId].load(std::memory_order_acquire);
+        if (!hardware) {
+            continue;
+        }
+        totals.samples += hardware->samples.load(std::memory_order_acquire);
+        for (size_t i = 0; i < kHardwareEventCount; ++i) {
+            totals.values.values[i] += hardware->totals[i].load(std::memory_order_relaxed);
+        }
+    }
+    
+    return totals;
+}
+
+LatencyHistogram PerformanceMonitor::mergeShards(OperationId operationId) const {
+    LatencyHistogram merged;
+    
+    std::lock_guard<std::mutex> lock(shardsMutex_);
+    for (const auto& shard : shards_) {
+        const AtomicLatencyHistogram* histogram =
+            shard->histograms[operationId].load(std::memory_order_acquire);
+        if (histogram) {
+            histogram->mergeInto(merged);
+        }
+    }
+    
+    return merged;
+}
+
 PerformanceStats PerformanceMonitor::calculateStats(
     const std::string& operationName,
-    const std::vector<std::chrono::microseconds>& measurements
+    const LatencyHistogram& histogram,
+    const HardwareCounterTotals& hardware
 ) {
     PerformanceStats stats;
     stats.operationName = operationName;
-    stats.operationCount = measurements.size();
+    stats.operationCount = histogram.count();
     
-    if (measurements.empty()) {
+    if (histogram.count() == 0) {
         return stats;
     }
     
-    // 计算总时间
-    stats.totalTime = std::accumulate(
-        measurements.begin(),
-        measurements.end(),
-        std::chrono::microseconds{0}
-    );
+    using std::chrono::microseconds;
+    using std::chrono::nanoseconds;
     
-    // 计算最小和最大时间
-    auto minMaxIt = std::minmax_element(measurements.begin(), measurements.end());
-    stats.minTime = *minMaxIt.first;
-    stats.maxTime = *minMaxIt.second;
+    // 总时间、最小和最大时间由直方图精确记录
+    stats.totalTime = microseconds(histogram.sum() / 1000);
+    stats.minTime = microseconds(histogram.min() / 1000);
+    stats.maxTime = microseconds(histogram.max() / 1000);
     
     // 计算平均时间
-    stats.averageTime = std::chrono::microseconds(
-        stats.totalTime.count() / measurements.size()
-    );
+    stats.averageTime = microseconds(histogram.sum() / histogram.count() / 1000);
+    
+    // 分位数
+    stats.p50 = nanoseconds(histogram.percentile(50.0));
+    stats.p90 = nanoseconds(histogram.percentile(90.0));
+    stats.p99 = nanoseconds(histogram.percentile(99.0));
+    stats.p999 = nanoseconds(histogram.percentile(99.9));
     
     // 计算吞吐量（操作/秒）
-    if (stats.totalTime.count() > 0) {
+    if (histogram.sum() > 0) {
         stats.operationsPerSecond = 
-            (measurements.size() * 1000000.0) / stats.totalTime.count();
+            (histogram.count() * 1000000000.0) / histogram.sum();
+    }
+    
+    // 硬件计数器派生指标
+    if (hardware.samples > 0) {
+        stats.hardwareSamples = hardware.samples;
+        stats.cycles = hardware.values[HardwareEvent::Cycles];
+        stats.instructions = hardware.values[HardwareEvent::Instructions];
+        stats.cacheMisses = hardware.values[HardwareEvent::CacheMisses];
+        stats.branchMisses = hardware.values[HardwareEvent::BranchMisses];
+        
+        if (stats.cycles > 0) {
+            stats.instructionsPerCycle =
+                static_cast<double>(stats.instructions) / stats.cycles;
+        }
+        if (stats.instructions > 0) {
+            double kiloInstructions = stats.instructions / 1000.0;
+            stats.cacheMissesPerKiloInstruction = stats.cacheMisses / kiloInstructions;
+            stats.branchMissesPerKiloInstruction = stats.branchMisses / kiloInstructions;
+        }
     }
     
     return stats;
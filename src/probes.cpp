@@ -0,0 +1,65 @@
+#include "probes.h"
+
+namespace ukc {
+namespace probes {
+
+namespace {
+
+const char* const kStageNames[] = {
+    "maps_parse",
+    "kallsyms_parse",
+    "kallsyms_lookup",
+    "scan_per_mb",
+    "batch_read_per_op",
+};
+
+const char* const kCounterNames[] = {
+    "symbol_cache_hit",
+    "symbol_cache_miss",
+    "scan_bytes",
+    "batch_read_ops",
+};
+
+static_assert(sizeof(kStageNames) / sizeof(kStageNames[0]) == static_cast<size_t>(Stage::Count),
+              "kStageNames must match Stage");
+static_assert(sizeof(kCounterNames) / sizeof(kCounterNames[0]) == static_cast<size_t>(Counter::Count),
+              "kCounterNames must match Counter");
+
+} // anonymous namespace
+
+bool enabled() {
+#if defined(UKC_ENABLE_PROBES)
+    return true;
+#else
+    return false;
+#endif
+}
+
+PerformanceMonitor& monitor() {
+    // 有意不析构：其他静态对象的析构函数中仍可能触发探针
+    static PerformanceMonitor* instance = []() {
+        auto* created = new PerformanceMonitor();
+        // 新建监控器按注册顺序分配句柄，因此句柄与枚举值一致
+        for (const char* name : kStageNames) {
+            (void)created->registerOperation(name);
+        }
+        for (const char* name : kCounterNames) {
+            (void)created->registerCounter(name);
+        }
+        return created;
+    }();
+    return *instance;
+}
+
+const char* stageName(Stage stage) {
+    size_t index = static_cast<size_t>(stage);
+    return index < static_cast<size_t>(Stage::Count) ? kStageNames[index] : "unknown";
+}
+
+const char* counterName(Counter counter) {
+    size_t index = static_cast<size_t>(counter);
+    return index < static_cast<size_t>(Counter::Count) ? kCounterNames[index] : "unknown";
+}
+
+} // namespace probes
+} // namespace ukc
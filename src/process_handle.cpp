@@ -0,0 +1,125 @@
+#include "process_handle.h"
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <utility>
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+
+namespace ukc {
+
+namespace {
+
+void closeFd(int& fd) {
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+}
+
+} // anonymous namespace
+
+Result<ProcessHandle> ProcessHandle::open(pid_t pid) {
+    if (pid <= 0) {
+        return Result<ProcessHandle>::error(
+            Error(ErrorCode::InvalidArgument, 0, "pid must be positive").withPid(pid)
+        );
+    }
+
+    ProcessHandle handle;
+    handle.pid_ = pid;
+
+    // 先取得 pidfd：之后只要进程未退出，pid 就不会被复用，
+    // 随后打开的 /proc/<pid> 描述符一定属于同一个进程
+    handle.pidFd_ = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+    if (handle.pidFd_ < 0 && errno == ESRCH) {
+        return Result<ProcessHandle>::error(Error(ErrorCode::ProcessGone).withPid(pid));
+    }
+
+    char procPath[32];
+    snprintf(procPath, sizeof(procPath), "/proc/%d", static_cast<int>(pid));
+    handle.procDirFd_ = ::open(procPath, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (handle.procDirFd_ < 0) {
+        ErrorCode code = errno == ENOENT ? ErrorCode::ProcessGone : ErrorCode::Unavailable;
+        return Result<ProcessHandle>::error(Error(code, errno, "/proc/<pid>").withPid(pid));
+    }
+
+    if (!handle.isAlive()) {
+        return Result<ProcessHandle>::error(Error(ErrorCode::ProcessGone).withPid(pid));
+    }
+
+    // maps、mem 和 pagemap 都需要 ptrace 读权限，打不开时对应描述符为 -1，
+    // 句柄仍可用于存活检查；mem 打不开时读取退回 process_vm_readv，只用于读取，按只读打开
+    handle.mapsFd_ = openat(handle.procDirFd_, "maps", O_RDONLY | O_CLOEXEC);
+    handle.memFd_ = openat(handle.procDirFd_, "mem", O_RDONLY | O_CLOEXEC);
+    handle.pagemapFd_ = openat(handle.procDirFd_, "pagemap", O_RDONLY | O_CLOEXEC);
+
+    return Result<ProcessHandle>::success(std::move(handle));
+}
+
+ProcessHandle::~ProcessHandle() {
+    reset();
+}
+
+ProcessHandle::ProcessHandle(ProcessHandle&& other) noexcept
+    : pid_(other.pid_),
+      pidFd_(other.pidFd_),
+      procDirFd_(other.procDirFd_),
+      mapsFd_(other.mapsFd_),
+      memFd_(other.memFd_),
+      pagemapFd_(other.pagemapFd_) {
+    other.pid_ = -1;
+    other.pidFd_ = -1;
+    other.procDirFd_ = -1;
+    other.mapsFd_ = -1;
+    other.memFd_ = -1;
+    other.pagemapFd_ = -1;
+}
+
+ProcessHandle& ProcessHandle::operator=(ProcessHandle&& other) noexcept {
+    if (this != &other) {
+        reset();
+        std::swap(pid_, other.pid_);
+        std::swap(pidFd_, other.pidFd_);
+        std::swap(procDirFd_, other.procDirFd_);
+        std::swap(mapsFd_, other.mapsFd_);
+        std::swap(memFd_, other.memFd_);
+        std::swap(pagemapFd_, other.pagemapFd_);
+    }
+    return *this;
+}
+
+bool ProcessHandle::isAlive() const {
+    if (pidFd_ >= 0) {
+        // 进程退出后 pidfd 变为可读
+        struct pollfd pfd;
+        pfd.fd = pidFd_;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        int ready = poll(&pfd, 1, 0);
+        return ready == 0;
+    }
+
+    if (procDirFd_ >= 0) {
+        // 没有 pidfd 时，进程被回收后旧的目录描述符下的条目都不再可见
+        return faccessat(procDirFd_, "stat", F_OK, 0) == 0;
+    }
+
+    return false;
+}
+
+void ProcessHandle::reset() {
+    closeFd(pagemapFd_);
+    closeFd(memFd_);
+    closeFd(mapsFd_);
+    closeFd(procDirFd_);
+    closeFd(pidFd_);
+    pid_ = -1;
+}
+
+} // namespace ukc
@@ -1,12 +1,109 @@
 #include "process_manager.h"
+#include "probes.h"
 #include <fstream>
 #include <sstream>
 #include <sys/stat.h>
 #include <dirent.h>
 #include <cstdlib>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <climits>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <linux/fs.h>
+
+// 旧版内核头文件中没有 PROCMAP_QUERY，按 Linux 6.11 的 uapi 定义补齐
+#ifndef PROCMAP_QUERY
+#define PROCFS_IOCTL_MAGIC 'f'
+
+struct procmap_query {
+    __u64 size;
+    __u64 query_flags;
+    __u64 query_addr;
+    __u64 vma_start;
+    __u64 vma_end;
+    __u64 vma_flags;
+    __u64 vma_page_size;
+    __u64 vma_offset;
+    __u64 inode;
+    __u32 dev_major;
+    __u32 dev_minor;
+    __u32 vma_name_size;
+    __u32 build_id_size;
+    __u64 vma_name_addr;
+    __u64 build_id_addr;
+};
+
+#define PROCMAP_QUERY _IOWR(PROCFS_IOCTL_MAGIC, 17, struct procmap_query)
+#define PROCMAP_QUERY_VMA_READABLE   0x01
+#define PROCMAP_QUERY_VMA_WRITABLE   0x02
+#define PROCMAP_QUERY_VMA_EXECUTABLE 0x04
+#define PROCMAP_QUERY_VMA_SHARED     0x08
+#endif
 
 namespace ukc {
 
+namespace {
+
+/**
+ * 对 maps 描述符执行一次 PROCMAP_QUERY
+ * 
+ * @return 0 表示命中，否则为 errno
+ */
+int procmapQuery(int fd, uintptr_t address, procmap_query& query, char* name, size_t nameSize) {
+    std::memset(&query, 0, sizeof(query));
+    query.size = sizeof(query);
+    query.query_addr = address;
+    if (name && nameSize > 0) {
+        query.vma_name_addr = reinterpret_cast<uintptr_t>(name);
+        query.vma_name_size = static_cast<__u32>(nameSize);
+    }
+    return ioctl(fd, PROCMAP_QUERY, &query) == 0 ? 0 : errno;
+}
+
+/**
+ * 解析单个十六进制字符，非法字符返回 -1
+ */
+int hexDigitValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * 从头读取整个 proc 文本文件（pread，不改变共享描述符的偏移）
+ */
+bool readWholeFile(int fd, std::string& content) {
+    char buffer[16384];
+    off_t offset = 0;
+    for (;;) {
+        ssize_t bytesRead = pread(fd, buffer, sizeof(buffer), offset);
+        if (bytesRead < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (bytesRead == 0) {
+            return true;
+        }
+        content.append(buffer, static_cast<size_t>(bytesRead));
+        offset += bytesRead;
+    }
+}
+
+/**
+ * 地址是否位于内核半区（只有 [vsyscall] 这类不在 VMA 树中的 gate 区域）
+ */
+bool isKernelHalf(uintptr_t address) {
+    return (address >> (sizeof(uintptr_t) * CHAR_BIT - 1)) != 0;
+}
+
+} // namespace
+
 ProcessManager::ProcessManager() = default;
 
 ProcessManager::~ProcessManager() = default;
@@ -15,7 +112,7 @@ Result<pid_t> ProcessManager::findProcessByName(const std::string& processName)
     // 遍历 /proc 目录查找进程
     DIR* procDir = opendir("/proc");
     if (!procDir) {
-        return Result<pid_t>::error("Cannot open /proc directory");
+        return Result<pid_t>::error(Error(ErrorCode::Unavailable, errno, "/proc"));
     }
     
     struct dirent* entry;
@@ -49,46 +146,510 @@ Result<pid_t> ProcessManager::findProcessByName(const std::string& processName)
     }
     
     closedir(procDir);
-    return Result<pid_t>::error("Process '" + processName + "' not found");
+    return Result<pid_t>::error(Error(ErrorCode::ProcessNotFound).withName(processName));
+}
+
+Result<std::shared_ptr<ProcessHandle>> ProcessManager::handle(pid_t pid) const {
+    {
+        std::lock_guard<std::mutex> lock(handlesMutex_);
+        auto it = handles_.find(pid);
+        if (it != handles_.end()) {
+            return Result<std::shared_ptr<ProcessHandle>>::success(it->second);
+        }
+    }
+    
+    // 打开句柄需要多次系统调用，不在锁内进行
+    auto opened = ProcessHandle::open(pid);
+    if (opened.isError()) {
+        return Result<std::shared_ptr<ProcessHandle>>::error(opened.errorInfo());
+    }
+    auto process = std::make_shared<ProcessHandle>(opened.moveValue());
+    
+    std::lock_guard<std::mutex> lock(handlesMutex_);
+    auto inserted = handles_.emplace(pid, process);
+    if (!inserted.second) {
+        // 其他线程已经打开
+        return Result<std::shared_ptr<ProcessHandle>>::success(inserted.first->second);
+    }
+    if (handles_.size() > kMaxCachedHandles) {
+        for (auto it = handles_.begin(); it != handles_.end(); ++it) {
+            if (it->first != pid) {
+                handles_.erase(it);
+                break;
+            }
+        }
+    }
+    return Result<std::shared_ptr<ProcessHandle>>::success(std::move(process));
+}
+
+void ProcessManager::dropHandle(pid_t pid, const std::shared_ptr<ProcessHandle>& process) const {
+    std::lock_guard<std::mutex> lock(handlesMutex_);
+    
+    auto it = handles_.find(pid);
+    if (it != handles_.end() && it->second == process) {
+        handles_.erase(it);
+    }
 }
 
 bool ProcessManager::isProcessAlive(pid_t pid) const {
-    // 检查 /proc/pid 是否存在
-    std::string procPath = "/proc/" + std::to_string(pid);
-    struct stat buffer;
-    return stat(procPath.c_str(), &buffer) == 0;
+    auto process = handle(pid);
+    if (process.isError()) {
+        return false;
+    }
+    if (process.value()->isAlive()) {
+        return true;
+    }
+    
+    // 缓存的句柄对应的进程已退出，pid 可能已被新进程复用
+    dropHandle(pid, process.value());
+    process = handle(pid);
+    return process.isSuccess() && process.value()->isAlive();
+}
+
+bool ProcessManager::isProcessAlive(const ProcessHandle& process) const {
+    return process.isAlive();
 }
 
 Result<std::vector<MemoryRegion>> ProcessManager::getMemoryMaps(pid_t pid) {
-    std::string mapsPath = "/proc/" + std::to_string(pid) + "/maps";
-    std::ifstream mapsFile(mapsPath);
+    auto process = handle(pid);
+    if (process.isError()) {
+        return Result<std::vector<MemoryRegion>>::error(process.errorInfo());
+    }
+    
+    auto maps = getMemoryMaps(*process.value());
+    if (maps.isError() && maps.errorCode() == ErrorCode::ProcessGone) {
+        dropHandle(pid, process.value());
+        process = handle(pid);
+        if (process.isError()) {
+            return Result<std::vector<MemoryRegion>>::error(process.errorInfo());
+        }
+        maps = getMemoryMaps(*process.value());
+    }
+    return maps;
+}
+
+Result<std::vector<MemoryRegion>> ProcessManager::getMemoryMaps(const ProcessHandle& process) {
+    UKC_PROBE_SCOPE(MapsParse);
+    
+    if (process.mapsFd() < 0) {
+        return Result<std::vector<MemoryRegion>>::error(
+            Error(ErrorCode::Unavailable, EACCES, "/proc/<pid>/maps").withPid(process.pid())
+        );
+    }
+    
+    std::string content;
+    if (!readWholeFile(process.mapsFd(), content)) {
+        return Result<std::vector<MemoryRegion>>::error(
+            Error(ErrorCode::Unavailable, errno, "/proc/<pid>/maps").withPid(process.pid())
+        );
+    }
     
-    if (!mapsFile.is_open()) {
+    // 进程退出后 maps 描述符读出空内容
+    if (content.empty() && !process.isAlive()) {
         return Result<std::vector<MemoryRegion>>::error(
-            "Cannot open " + mapsPath
+            Error(ErrorCode::ProcessGone).withPid(process.pid())
         );
     }
     
-    std::stringstream buffer;
-    buffer << mapsFile.rdbuf();
+    return parseMemoryMaps(content);
+}
+
+bool ProcessManager::procmapQuerySupported() {
+    // 对自身 maps 探测一次，结果在进程生命周期内不变
+    static const bool supported = []() {
+        int fd = open("/proc/self/maps", O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        procmap_query query;
+        int result = procmapQuery(fd, reinterpret_cast<uintptr_t>(&hexDigitValue), query, nullptr, 0);
+        close(fd);
+        return result == 0;
+    }();
+    return supported;
+}
+
+int ProcessManager::queryRegion(const ProcessHandle& process, uintptr_t address, MemoryRegion* region) {
+    char name[PATH_MAX];
+    procmap_query query;
+    
+    // 进程退出后返回 ESRCH
+    int result = procmapQuery(process.mapsFd(), address, query,
+                              region ? name : nullptr, region ? sizeof(name) : 0);
+    if (result != 0) {
+        return result;
+    }
+    
+    // 内核返回的是包含地址的映射，但仍防御性地确认范围
+    if (address < query.vma_start || address >= query.vma_end) {
+        return ENOENT;
+    }
     
-    return parseMemoryMaps(buffer.str());
+    if (region) {
+        region->start = static_cast<uintptr_t>(query.vma_start);
+        region->end = static_cast<uintptr_t>(query.vma_end);
+        region->permissions.assign({
+            (query.vma_flags & PROCMAP_QUERY_VMA_READABLE) ? 'r' : '-',
+            (query.vma_flags & PROCMAP_QUERY_VMA_WRITABLE) ? 'w' : '-',
+            (query.vma_flags & PROCMAP_QUERY_VMA_EXECUTABLE) ? 'x' : '-',
+            (query.vma_flags & PROCMAP_QUERY_VMA_SHARED) ? 's' : 'p'
+        });
+        region->path.assign(query.vma_name_size > 0 ? name : "");
+    }
+    return 0;
 }
 
 bool ProcessManager::isValidAddress(pid_t pid, uintptr_t address) {
-    auto mapsResult = getMemoryMaps(pid);
-    if (mapsResult.isError()) {
+    auto process = handle(pid);
+    if (process.isError()) {
         return false;
     }
+    if (isValidAddress(*process.value(), address)) {
+        return true;
+    }
     
-    const auto& regions = mapsResult.value();
-    for (const auto& region : regions) {
-        if (address >= region.start && address < region.end) {
+    // 未命中时确认句柄没有过期（进程退出、pid 被复用）
+    if (process.value()->isAlive()) {
+        return false;
+    }
+    dropHandle(pid, process.value());
+    process = handle(pid);
+    return process.isSuccess() && isValidAddress(*process.value(), address);
+}
+
+bool ProcessManager::isValidAddress(const ProcessHandle& process, uintptr_t address) {
+    if (!isKernelHalf(address) && procmapQuerySupported()) {
+        int result = queryRegion(process, address, nullptr);
+        if (result == 0) {
             return true;
         }
+        if (result == ENOENT || result == ESRCH) {
+            return false;
+        }
+        // 其他错误（如权限不足）回退为文本解析
     }
     
-    return false;
+    return isValidAddressFromText(process.mapsFd(), address);
+}
+
+Result<MemoryRegion> ProcessManager::findRegion(pid_t pid, uintptr_t address) {
+    auto process = handle(pid);
+    if (process.isError()) {
+        return Result<MemoryRegion>::error(process.errorInfo());
+    }
+    
+    auto region = findRegion(*process.value(), address);
+    if (region.isError() && region.errorCode() == ErrorCode::ProcessGone) {
+        dropHandle(pid, process.value());
+        process = handle(pid);
+        if (process.isError()) {
+            return Result<MemoryRegion>::error(process.errorInfo());
+        }
+        region = findRegion(*process.value(), address);
+    }
+    return region;
+}
+
+Result<MemoryRegion> ProcessManager::findRegion(const ProcessHandle& process, uintptr_t address) {
+    if (!isKernelHalf(address) && procmapQuerySupported()) {
+        MemoryRegion region;
+        int result = queryRegion(process, address, &region);
+        if (result == 0) {
+            return Result<MemoryRegion>::success(std::move(region));
+        }
+        if (result == ENOENT) {
+            return Result<MemoryRegion>::error(
+                Error(ErrorCode::InvalidAddress).withAddress(address).withPid(process.pid())
+            );
+        }
+        if (result == ESRCH) {
+            return Result<MemoryRegion>::error(Error(ErrorCode::ProcessGone).withPid(process.pid()));
+        }
+    }
+    
+    auto mapsResult = getMemoryMaps(process);
+    if (mapsResult.isError()) {
+        return Result<MemoryRegion>::error(mapsResult.errorInfo());
+    }
+    for (auto& region : mapsResult.value()) {
+        if (address >= region.start && address < region.end) {
+            return Result<MemoryRegion>::success(std::move(region));
+        }
+    }
+    return Result<MemoryRegion>::error(
+        Error(ErrorCode::InvalidAddress).withAddress(address).withPid(process.pid())
+    );
+}
+
+bool ProcessManager::isValidAddressFromText(int mapsFd, uintptr_t address) {
+    // 流式扫描 maps，只解析每行开头的地址范围
+    // 使用固定大小的栈缓冲区，热路径上不分配堆内存
+    enum class State { Start, End, Skip } state = State::Start;
+    uintptr_t start = 0;
+    uintptr_t end = 0;
+    bool found = false;
+    bool done = false;
+    char buffer[4096];
+    off_t offset = 0;
+    ssize_t bytesRead;
+    
+    while (!done && (bytesRead = pread(mapsFd, buffer, sizeof(buffer), offset)) > 0) {
+        offset += bytesRead;
+        for (ssize_t i = 0; i < bytesRead && !done; ++i) {
+            char c = buffer[i];
+            switch (state) {
+                case State::Start:
+                    if (c == '-') {
+                        state = State::End;
+                    } else {
+                        int digit = hexDigitValue(c);
+                        if (digit >= 0) {
+                            start = (start << 4) | static_cast<uintptr_t>(digit);
+                        }
+                    }
+                    break;
+                case State::End:
+                    if (c == ' ') {
+                        if (address >= start && address < end) {
+                            found = true;
+                            done = true;
+                        } else if (start > address) {
+                            // 映射按地址升序排列，后面不会再命中
+                            done = true;
+                        }
+                        state = State::Skip;
+                    } else {
+                        int digit = hexDigitValue(c);
+                        if (digit >= 0) {
+                            end = (end << 4) | static_cast<uintptr_t>(digit);
+                        }
+                    }
+                    break;
+                case State::Skip:
+                    if (c == '\n') {
+                        start = 0;
+                        end = 0;
+                        state = State::Start;
+                    }
+                    break;
+            }
+        }
+    }
+    
+    return found;
+}
+
+Result<size_t> ProcessManager::readProcessMemory(
+    pid_t pid,
+    uintptr_t address,
+    uint8_t* buffer,
+    size_t size
+) {
+    if (size == 0) {
+        return Result<size_t>::success(0);
+    }
+    
+    auto process = handle(pid);
+    if (process.isError()) {
+        return Result<size_t>::error(process.errorInfo());
+    }
+    
+    auto result = readProcessMemory(*process.value(), address, buffer, size);
+    if (result.isError() && result.errorCode() == ErrorCode::ProcessGone) {
+        dropHandle(pid, process.value());
+        process = handle(pid);
+        if (process.isError()) {
+            return Result<size_t>::error(process.errorInfo());
+        }
+        result = readProcessMemory(*process.value(), address, buffer, size);
+    }
+    return result;
+}
+
+Result<size_t> ProcessManager::readProcessMemory(
+    const ProcessHandle& process,
+    uintptr_t address,
+    uint8_t* buffer,
+    size_t size
+) {
+    if (size == 0) {
+        return Result<size_t>::success(0);
+    }
+    
+    if (buffer == nullptr) {
+        return Result<size_t>::error(Error(ErrorCode::InvalidArgument, 0, "buffer is null"));
+    }
+    
+    // mem 描述符的偏移是 off_t，高半区地址只能走 process_vm_readv
+    if (process.memFd() >= 0 && !isKernelHalf(address)) {
+        ssize_t bytesRead = pread(process.memFd(), buffer, size, static_cast<off_t>(address));
+        if (bytesRead > 0) {
+            return Result<size_t>::success(static_cast<size_t>(bytesRead));
+        }
+        // 进程退出后 mem 读出 0 字节
+        int savedErrno = bytesRead < 0 ? errno : 0;
+        ErrorCode code = process.isAlive() ? ErrorCode::ReadFailed : ErrorCode::ProcessGone;
+        return Result<size_t>::error(
+            Error(code, savedErrno, "/proc/<pid>/mem")
+                .withAddress(address).withSize(size).withPid(process.pid())
+        );
+    }
+    
+    struct iovec local;
+    local.iov_base = buffer;
+    local.iov_len = size;
+    
+    struct iovec remote;
+    remote.iov_base = reinterpret_cast<void*>(address);
+    remote.iov_len = size;
+    
+    ssize_t bytesRead = process_vm_readv(process.pid(), &local, 1, &remote, 1, 0);
+    if (bytesRead < 0) {
+        ErrorCode code = errno == ESRCH ? ErrorCode::ProcessGone : ErrorCode::ReadFailed;
+        return Result<size_t>::error(
+            Error(code, errno, "process_vm_readv")
+                .withAddress(address).withSize(size).withPid(process.pid())
+        );
+    }
+    
+    return Result<size_t>::success(static_cast<size_t>(bytesRead));
+}
+
+Result<size_t> ProcessManager::readPagemap(pid_t pid, uintptr_t address, uint64_t* entries, size_t count) {
+    if (count == 0) {
+        return Result<size_t>::success(0);
+    }
+    
+    auto process = handle(pid);
+    if (process.isError()) {
+        return Result<size_t>::error(process.errorInfo());
+    }
+    
+    auto result = readPagemap(*process.value(), address, entries, count);
+    if (result.isError() && result.errorCode() == ErrorCode::ProcessGone) {
+        dropHandle(pid, process.value());
+        process = handle(pid);
+        if (process.isError()) {
+            return Result<size_t>::error(process.errorInfo());
+        }
+        result = readPagemap(*process.value(), address, entries, count);
+    }
+    return result;
+}
+
+Result<size_t> ProcessManager::readPagemap(
+    const ProcessHandle& process,
+    uintptr_t address,
+    uint64_t* entries,
+    size_t count
+) {
+    if (count == 0) {
+        return Result<size_t>::success(0);
+    }
+    if (entries == nullptr) {
+        return Result<size_t>::error(Error(ErrorCode::InvalidArgument, 0, "entries is null"));
+    }
+    if (process.pagemapFd() < 0) {
+        return Result<size_t>::error(
+            Error(ErrorCode::Unavailable, 0, "/proc/<pid>/pagemap").withPid(process.pid())
+        );
+    }
+    
+    static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    uint8_t* buffer = reinterpret_cast<uint8_t*>(entries);
+    size_t total = count * sizeof(uint64_t);
+    size_t done = 0;
+    uint64_t offset = static_cast<uint64_t>(address / pageSize) * sizeof(uint64_t);
+    while (done < total) {
+        ssize_t bytesRead = pread(process.pagemapFd(), buffer + done, total - done,
+                                  static_cast<off_t>(offset + done));
+        if (bytesRead < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytesRead < 0) {
+            ErrorCode code = process.isAlive() ? ErrorCode::ReadFailed : ErrorCode::ProcessGone;
+            return Result<size_t>::error(
+                Error(code, errno, "/proc/<pid>/pagemap").withAddress(address).withPid(process.pid())
+            );
+        }
+        if (bytesRead == 0) {
+            // 进程退出后 pagemap 读出 0 字节；存活时表示到达地址空间末尾
+            if (done == 0 && !process.isAlive()) {
+                return Result<size_t>::error(Error(ErrorCode::ProcessGone).withPid(process.pid()));
+            }
+            break;
+        }
+        done += static_cast<size_t>(bytesRead);
+    }
+    return Result<size_t>::success(done / sizeof(uint64_t));
+}
+
+bool ProcessManager::softDirtySupported() {
+    // 新映射的 VMA 带有 VM_SOFTDIRTY，支持时其中的页总是报告 soft-dirty
+    static const bool supported = []() {
+        const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        void* page = mmap(nullptr, pageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (page == MAP_FAILED) {
+            return false;
+        }
+        *static_cast<volatile uint8_t*>(page) = 1;
+        
+        uint64_t entry = 0;
+        int fd = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+        bool readOk = fd >= 0 &&
+            pread(fd, &entry, sizeof(entry),
+                  static_cast<off_t>(reinterpret_cast<uintptr_t>(page) / pageSize * sizeof(entry))) ==
+            static_cast<ssize_t>(sizeof(entry));
+        if (fd >= 0) {
+            close(fd);
+        }
+        munmap(page, pageSize);
+        return readOk && (entry & kPagemapSoftDirty) != 0;
+    }();
+    return supported;
+}
+
+Result<void> ProcessManager::clearSoftDirty(pid_t pid) {
+    auto process = handle(pid);
+    if (process.isError()) {
+        return Result<void>::error(process.errorInfo());
+    }
+    
+    auto result = clearSoftDirty(*process.value());
+    if (result.isError() && result.errorCode() == ErrorCode::ProcessGone) {
+        dropHandle(pid, process.value());
+        process = handle(pid);
+        if (process.isError()) {
+            return Result<void>::error(process.errorInfo());
+        }
+        result = clearSoftDirty(*process.value());
+    }
+    return result;
+}
+
+Result<void> ProcessManager::clearSoftDirty(const ProcessHandle& process) {
+    if (!softDirtySupported()) {
+        return Result<void>::error(Error(ErrorCode::Unavailable, 0, "soft-dirty not supported"));
+    }
+    
+    int fd = openat(process.procDirFd(), "clear_refs", O_WRONLY | O_CLOEXEC);
+    if (fd < 0) {
+        ErrorCode code = process.isAlive() ? ErrorCode::Unavailable : ErrorCode::ProcessGone;
+        return Result<void>::error(Error(code, errno, "/proc/<pid>/clear_refs").withPid(process.pid()));
+    }
+    ssize_t written;
+    do {
+        written = write(fd, "4", 1);
+    } while (written < 0 && errno == EINTR);
+    int savedErrno = errno;
+    close(fd);
+    if (written != 1) {
+        ErrorCode code = process.isAlive() ? ErrorCode::WriteFailed : ErrorCode::ProcessGone;
+        return Result<void>::error(
+            Error(code, savedErrno, "/proc/<pid>/clear_refs").withPid(process.pid())
+        );
+    }
+    return Result<void>::success();
 }
 
 Result<std::vector<MemoryRegion>> ProcessManager::parseMemoryMaps(
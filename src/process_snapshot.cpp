@@ -0,0 +1,1115 @@
+#include "process_snapshot.h"
+#include "lz4_block.h"
+#include "process_handle.h"
+#include "process_manager.h"
+#include "probes.h"
+#include "snapshot_store.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace ukc {
+
+namespace {
+
+constexpr char kMagic[8] = {'U', 'K', 'C', 'S', 'N', 'A', 'P', '\0'};
+constexpr uint32_t kVersion = 3;          // 版本 3 在文件头末尾增加了 soft-dirty 代号
+constexpr size_t kHeaderSizeV1 = 80;
+constexpr size_t kHeaderSizeV2 = 104;     // 版本 2 增加了页存储路径和标志
+
+// 文件头标志
+constexpr uint64_t kFlagDirtyTracked = 1;     // 读取前清除了目标的 soft-dirty 位
+
+// 增量捕获时每次读取的 pagemap 项数
+constexpr size_t kPagemapBatch = 4096;
+
+/**
+ * 块编码
+ */
+enum BlockEncoding : uint8_t {
+    kBlockRaw = 0,           // 未压缩，按页对齐存放
+    kBlockLz4 = 1,           // LZ4 块压缩
+    kBlockZero = 2,          // 全零，不存储数据
+    kBlockUnreadable = 3,    // 捕获时不可读，不存储数据
+    kBlockStore = 4          // 数据在页存储的 pages.dat 中，fileOffset 为其中的偏移
+};
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t pageSize;
+    uint32_t blockSize;
+    int32_t pid;
+    uint64_t captureTimeNs;
+    uint64_t regionCount;
+    uint64_t regionTableOffset;
+    uint64_t blockCount;
+    uint64_t blockTableOffset;
+    uint64_t stringTableOffset;
+    uint64_t stringTableSize;
+    uint64_t storePathOffset;   // 页存储 pages.dat 的路径（字符串表中），长度为 0 表示不使用
+    uint64_t storePathLength;
+    uint64_t flags;
+    uint64_t dirtyGeneration;   // 清除 soft-dirty 时在页存储中登记的代号
+};
+
+struct RegionRecord {
+    uint64_t start;
+    uint64_t end;
+    uint64_t firstBlock;
+    uint64_t blockCount;
+    uint32_t pathOffset;
+    uint32_t pathLength;
+    char permissions[4];
+    uint32_t reserved;
+};
+
+struct BlockRecord {
+    uint64_t fileOffset;
+    uint32_t storedSize;
+    uint32_t rawSize;
+    uint8_t encoding;
+    uint8_t reserved[7];
+};
+
+static_assert(sizeof(FileHeader) == 112, "snapshot header layout");
+static_assert(sizeof(RegionRecord) == 48, "snapshot region record layout");
+static_assert(sizeof(BlockRecord) == 24, "snapshot block record layout");
+
+inline uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+bool isAllZero(const uint8_t* data, size_t size) {
+    static const uint8_t zeros[256] = {};
+    while (size >= sizeof(zeros)) {
+        if (std::memcmp(data, zeros, sizeof(zeros)) != 0) {
+            return false;
+        }
+        data += sizeof(zeros);
+        size -= sizeof(zeros);
+    }
+    return std::memcmp(data, zeros, size) == 0;
+}
+
+Error fileError(ErrorCode code, const char* context, const std::string& path) {
+    return Error(code, errno, context).withName(path);
+}
+
+/**
+ * 快照文件输出，按绝对偏移写入
+ *
+ * 先写入同目录下的临时文件，commit() 时 rename 覆盖目标：失败时只删除临时文件，
+ * 已有的快照保持不变；正在 mmap 旧快照的 SnapshotReader 也不会因截断而 SIGBUS。
+ */
+class SnapshotFile {
+public:
+    explicit SnapshotFile(std::string path)
+        : path_(std::move(path)), tempPath_(path_ + ".tmp") {}
+
+    ~SnapshotFile() {
+        if (fd_ >= 0) {
+            close(fd_);
+            unlink(tempPath_.c_str());
+        }
+    }
+
+    Result<void> open() {
+        fd_ = ::open(tempPath_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            return Result<void>::error(fileError(ErrorCode::Unavailable, "snapshot create", path_));
+        }
+        return Result<void>::success();
+    }
+
+    Result<void> write(const void* data, size_t size, uint64_t offset) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        while (size > 0) {
+            ssize_t written = pwrite(fd_, p, size, static_cast<off_t>(offset));
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                return Result<void>::error(
+                    fileError(ErrorCode::WriteFailed, "snapshot write", path_).withAddress(offset)
+                );
+            }
+            p += written;
+            size -= static_cast<size_t>(written);
+            offset += static_cast<uint64_t>(written);
+        }
+        return Result<void>::success();
+    }
+
+    /**
+     * 设置最终长度、落盘、关闭并重命名为目标路径，成功后析构不再删除文件
+     * 先 fdatasync 再 rename：崩溃后目标路径上要么是旧快照，要么是完整的新快照
+     */
+    Result<void> commit(uint64_t size) {
+        if (ftruncate(fd_, static_cast<off_t>(size)) != 0 || fdatasync(fd_) != 0 ||
+            close(fd_) != 0) {
+            fd_ = -1;
+            unlink(tempPath_.c_str());
+            return Result<void>::error(fileError(ErrorCode::WriteFailed, "snapshot close", path_));
+        }
+        fd_ = -1;
+        if (rename(tempPath_.c_str(), path_.c_str()) != 0) {
+            Error error = fileError(ErrorCode::WriteFailed, "snapshot rename", path_);
+            unlink(tempPath_.c_str());
+            return Result<void>::error(error);
+        }
+        return Result<void>::success();
+    }
+
+private:
+    std::string path_;
+    std::string tempPath_;
+    int fd_ = -1;
+};
+
+/**
+ * 待读取的一块
+ */
+struct Piece {
+    size_t regionIndex;
+    uintptr_t address;
+    size_t size;
+    bool reused = false;        // 沿用 base 中的页，不读取
+    uint8_t encoding = 0;       // reused 时为 kBlockStore 或 kBlockZero
+    uint64_t storeOffset = 0;   // kBlockStore 时第一页在页存储中的偏移
+};
+
+/**
+ * 单次捕获的状态
+ */
+class CaptureSession {
+public:
+    CaptureSession(const SnapshotWriterConfig& config, size_t pageSize, SnapshotFile& file,
+                   const ProcessHandle& process, std::vector<RegionRecord>& regions)
+        : config_(config), pageSize_(pageSize), file_(file), process_(process), regions_(regions),
+          staging_(config.readBatchSize) {
+        if (config_.compression == SnapshotCompression::Lz4) {
+            compressed_.resize(lz4::compressBound(config_.blockSize));
+        }
+    }
+
+    /**
+     * 读取一批块并写入文件，沿用 base 的块按顺序穿插写出
+     */
+    Result<void> readBatch(const std::vector<Piece>& pieces) {
+        std::vector<struct iovec> remote;
+        std::vector<size_t> reads;
+        std::vector<size_t> stagingOffsets;
+        size_t total = 0;
+        for (size_t i = 0; i < pieces.size(); ++i) {
+            if (pieces[i].reused) {
+                continue;
+            }
+            struct iovec iov;
+            iov.iov_base = reinterpret_cast<void*>(pieces[i].address);
+            iov.iov_len = pieces[i].size;
+            remote.push_back(iov);
+            reads.push_back(i);
+            stagingOffsets.push_back(total);
+            total += pieces[i].size;
+        }
+
+        size_t next = 0;
+        size_t done = 0;
+        while (done < reads.size()) {
+            struct iovec local;
+            local.iov_base = staging_.data() + stagingOffsets[done];
+            local.iov_len = total - stagingOffsets[done];
+            ssize_t bytesRead = process_vm_readv(process_.pid(), &local, 1,
+                                                 remote.data() + done, reads.size() - done, 0);
+            stats.readCalls++;
+            if (bytesRead < 0 && errno == ESRCH) {
+                return processGone();
+            }
+            size_t got = bytesRead > 0 ? static_cast<size_t>(bytesRead) : 0;
+
+            while (done < reads.size() && got >= pieces[reads[done]].size) {
+                const Piece& piece = pieces[reads[done]];
+                emitReused(pieces, next, reads[done]);
+                auto result = emit(piece.regionIndex, staging_.data() + stagingOffsets[done], piece.size);
+                if (result.isError()) {
+                    return result;
+                }
+                got -= piece.size;
+                next = reads[done] + 1;
+                done++;
+            }
+
+            // 读取在这一块中断：逐页重读剩余部分
+            if (done < reads.size()) {
+                emitReused(pieces, next, reads[done]);
+                auto result = readSlow(pieces[reads[done]], staging_.data() + stagingOffsets[done], got);
+                if (result.isError()) {
+                    return result;
+                }
+                next = reads[done] + 1;
+                done++;
+            }
+        }
+        emitReused(pieces, next, pieces.size());
+        return Result<void>::success();
+    }
+
+    uint64_t fileOffset = 0;
+    std::vector<BlockRecord> blocks;
+    SnapshotWriteStats stats;
+
+private:
+    const SnapshotWriterConfig& config_;
+    size_t pageSize_;
+    SnapshotFile& file_;
+    const ProcessHandle& process_;
+    std::vector<RegionRecord>& regions_;
+    std::vector<uint8_t> staging_;
+    std::vector<uint8_t> compressed_;
+
+    Result<void> processGone() {
+        return Result<void>::error(
+            Error(ErrorCode::ProcessGone, 0, "exited during snapshot").withPid(process_.pid())
+        );
+    }
+
+    /**
+     * 单段 process_vm_readv，与批量读取的可读性判断一致
+     */
+    ssize_t readRemote(uintptr_t address, uint8_t* buffer, size_t size) {
+        struct iovec local;
+        local.iov_base = buffer;
+        local.iov_len = size;
+        struct iovec remote;
+        remote.iov_base = reinterpret_cast<void*>(address);
+        remote.iov_len = size;
+        stats.readCalls++;
+        return process_vm_readv(process_.pid(), &local, 1, &remote, 1, 0);
+    }
+
+    /**
+     * 块中前 valid 字节已经读到，其余部分按页重读；不可读的页单独记为块
+     */
+    Result<void> readSlow(const Piece& piece, uint8_t* buffer, size_t valid) {
+        size_t runStart = 0;
+        size_t pos = valid;
+        while (pos < piece.size) {
+            ssize_t bytesRead = readRemote(piece.address + pos, buffer + pos, piece.size - pos);
+            if (bytesRead > 0) {
+                pos += static_cast<size_t>(bytesRead);
+                continue;
+            }
+            if (bytesRead < 0 && errno == ESRCH) {
+                return processGone();
+            }
+
+            // 先写出已读到的部分，再把连续的不可读页合并为一块
+            if (pos > runStart) {
+                auto result = emit(piece.regionIndex, buffer + runStart, pos - runStart);
+                if (result.isError()) {
+                    return result;
+                }
+            }
+            size_t skipStart = pos;
+            pos = std::min<size_t>(alignUp(piece.address + pos + 1, pageSize_) - piece.address,
+                                   piece.size);
+            while (pos < piece.size && readRemote(piece.address + pos, buffer + pos, 1) <= 0) {
+                pos = std::min(pos + pageSize_, piece.size);
+            }
+            addBlock(piece.regionIndex, BlockRecord{0, 0, static_cast<uint32_t>(pos - skipStart),
+                                                    kBlockUnreadable, {}});
+            stats.bytesUnreadable += pos - skipStart;
+            runStart = pos;
+        }
+        if (pos > runStart) {
+            return emit(piece.regionIndex, buffer + runStart, pos - runStart);
+        }
+        return Result<void>::success();
+    }
+
+    /**
+     * 写出 [next, end) 中沿用 base 的块
+     */
+    void emitReused(const std::vector<Piece>& pieces, size_t next, size_t end) {
+        for (size_t i = next; i < end; ++i) {
+            const Piece& piece = pieces[i];
+            for (size_t offset = 0; offset < piece.size; offset += pageSize_) {
+                appendPage(piece.regionIndex, piece.encoding,
+                           piece.encoding == kBlockStore ? piece.storeOffset + offset : 0);
+            }
+            stats.bytesUnchanged += piece.size;
+        }
+    }
+
+    /**
+     * 逐页存入页存储，快照中只记录偏移；存储中相邻的页合并为一块
+     */
+    Result<void> emitToStore(size_t regionIndex, const uint8_t* data, size_t size) {
+        for (size_t offset = 0; offset < size; offset += pageSize_) {
+            const uint8_t* page = data + offset;
+            if (isAllZero(page, pageSize_)) {
+                appendPage(regionIndex, kBlockZero, 0);
+                continue;
+            }
+            bool existed = false;
+            auto stored = config_.store->put(page, &existed);
+            if (stored.isError()) {
+                return Result<void>::error(stored.errorInfo());
+            }
+            if (existed) {
+                stats.storePagesReused++;
+            } else {
+                stats.storePagesWritten++;
+            }
+            appendPage(regionIndex, kBlockStore, stored.value());
+        }
+        return Result<void>::success();
+    }
+    
+    void appendPage(size_t regionIndex, uint8_t encoding, uint64_t storeOffset) {
+        if (regions_[regionIndex].blockCount > 0) {
+            BlockRecord& last = blocks.back();
+            if (last.encoding == encoding && last.rawSize + pageSize_ <= config_.blockSize &&
+                (encoding == kBlockZero || last.fileOffset + last.rawSize == storeOffset)) {
+                last.rawSize += static_cast<uint32_t>(pageSize_);
+                if (encoding == kBlockStore) {
+                    last.storedSize += static_cast<uint32_t>(pageSize_);
+                }
+                return;
+            }
+        }
+        if (encoding == kBlockZero) {
+            stats.zeroBlocks++;
+        }
+        uint32_t storedSize = encoding == kBlockStore ? static_cast<uint32_t>(pageSize_) : 0;
+        addBlock(regionIndex, BlockRecord{storeOffset, storedSize, static_cast<uint32_t>(pageSize_),
+                                          encoding, {}});
+    }
+    
+    /**
+     * 写出一块已读到的数据
+     */
+    Result<void> emit(size_t regionIndex, const uint8_t* data, size_t size) {
+        stats.bytesCaptured += size;
+        
+        if (config_.store) {
+            size_t pages = size / pageSize_ * pageSize_;
+            auto result = emitToStore(regionIndex, data, pages);
+            if (result.isError() || pages == size) {
+                return result;
+            }
+            // 不足一页的尾部（读取在页中间中断时）按普通块存放
+            data += pages;
+            size -= pages;
+        }
+
+        if (isAllZero(data, size)) {
+            stats.zeroBlocks++;
+            addBlock(regionIndex, BlockRecord{0, 0, static_cast<uint32_t>(size), kBlockZero, {}});
+            return Result<void>::success();
+        }
+
+        if (config_.compression == SnapshotCompression::Lz4) {
+            size_t compressedSize = lz4::compress(data, size, compressed_.data(), compressed_.size());
+            if (compressedSize > 0 && compressedSize < size - size / 8) {
+                auto result = file_.write(compressed_.data(), compressedSize, fileOffset);
+                if (result.isError()) {
+                    return result;
+                }
+                addBlock(regionIndex, BlockRecord{fileOffset, static_cast<uint32_t>(compressedSize),
+                                                  static_cast<uint32_t>(size), kBlockLz4, {}});
+                fileOffset += compressedSize;
+                stats.bytesStored += compressedSize;
+                return Result<void>::success();
+            }
+        }
+
+        fileOffset = alignUp(fileOffset, pageSize_);
+        auto result = file_.write(data, size, fileOffset);
+        if (result.isError()) {
+            return result;
+        }
+        addBlock(regionIndex, BlockRecord{fileOffset, static_cast<uint32_t>(size),
+                                          static_cast<uint32_t>(size), kBlockRaw, {}});
+        fileOffset += size;
+        stats.bytesStored += size;
+        return Result<void>::success();
+    }
+
+    void addBlock(size_t regionIndex, const BlockRecord& block) {
+        RegionRecord& region = regions_[regionIndex];
+        if (region.blockCount == 0) {
+            region.firstBlock = blocks.size();
+        }
+        region.blockCount++;
+        blocks.push_back(block);
+    }
+};
+
+/**
+ * 读取各区域的 pagemap，标记自上次清除 soft-dirty 以来未写过的页
+ */
+Result<std::vector<bool>> unchangedPages(ProcessManager& processManager, const ProcessHandle& process,
+                                         const std::vector<MemoryRegion>& regions, size_t pageSize) {
+    const uint64_t resident = ProcessManager::kPagemapPresent | ProcessManager::kPagemapSwapped;
+    std::vector<uint64_t> entries(kPagemapBatch);
+    std::vector<bool> unchanged;
+    for (const auto& region : regions) {
+        for (uintptr_t address = region.start; address < region.end;) {
+            size_t count = std::min<size_t>(kPagemapBatch, (region.end - address) / pageSize);
+            auto readResult = processManager.readPagemap(process, address, entries.data(), count);
+            if (readResult.isError()) {
+                return Result<std::vector<bool>>::error(readResult.errorInfo());
+            }
+            for (size_t i = 0; i < count; ++i) {
+                // 不在内存也不在交换区的页可能已被 MADV_DONTNEED 丢弃，不能视为未变化
+                uint64_t entry = i < readResult.value() ? entries[i] : 0;
+                unchanged.push_back((entry & resident) != 0 && (entry & ProcessManager::kPagemapSoftDirty) == 0);
+            }
+            address += count * pageSize;
+        }
+    }
+    return Result<std::vector<bool>>::success(std::move(unchanged));
+}
+
+/**
+ * 把一块按页拆成需要读取的片段和沿用 base 的片段
+ * 未变化且 base 中为全零或在页存储中的页沿用，其余页读取；相邻的同类页合并
+ */
+void splitUnchanged(const SnapshotReader& base, const std::vector<bool>& unchanged, size_t pageIndex,
+                    const Piece& block, size_t pageSize, std::vector<Piece>& pieces) {
+    for (size_t offset = 0; offset < block.size; offset += pageSize) {
+        Piece page{block.regionIndex, block.address + offset, pageSize};
+        if (unchanged[pageIndex + offset / pageSize]) {
+            SnapshotPage previous = base.page(page.address);
+            if (previous.kind == SnapshotPage::Kind::Zero) {
+                page.reused = true;
+                page.encoding = kBlockZero;
+            } else if (previous.kind == SnapshotPage::Kind::Stored) {
+                page.reused = true;
+                page.encoding = kBlockStore;
+                page.storeOffset = previous.storeOffset;
+            }
+        }
+
+        if (!pieces.empty()) {
+            Piece& last = pieces.back();
+            if (last.reused == page.reused && last.encoding == page.encoding &&
+                (page.encoding != kBlockStore || last.storeOffset + last.size == page.storeOffset)) {
+                last.size += pageSize;
+                continue;
+            }
+        }
+        pieces.push_back(page);
+    }
+}
+
+} // namespace
+
+SnapshotWriter::SnapshotWriter(SnapshotWriterConfig config)
+    : config_(config) {
+}
+
+Result<SnapshotWriteStats> SnapshotWriter::capture(
+    pid_t pid,
+    const std::string& path,
+    const RegionFilter& filter
+) {
+    ProcessManager processManager;
+    auto mapsResult = processManager.getMemoryMaps(pid);
+    if (mapsResult.isError()) {
+        return Result<SnapshotWriteStats>::error(mapsResult.errorInfo());
+    }
+
+    std::vector<MemoryRegion> regions;
+    for (const auto& region : mapsResult.value()) {
+        if (filter.matches(region)) {
+            regions.push_back(region);
+        }
+    }
+    return capture(pid, regions, path);
+}
+
+Result<SnapshotWriteStats> SnapshotWriter::capture(
+    pid_t pid,
+    const std::vector<MemoryRegion>& regions,
+    const std::string& path
+) {
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    if (config_.blockSize < pageSize || config_.blockSize % pageSize != 0 ||
+        config_.blockSize > UINT32_MAX || config_.readBatchSize < config_.blockSize) {
+        return Result<SnapshotWriteStats>::error(
+            Error(ErrorCode::InvalidArgument, 0, "snapshot block size").withSize(config_.blockSize)
+        );
+    }
+
+    std::vector<MemoryRegion> sorted(regions);
+    std::sort(sorted.begin(), sorted.end(),
+              [](const MemoryRegion& a, const MemoryRegion& b) { return a.start < b.start; });
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        if (sorted[i].start >= sorted[i].end || sorted[i].start % pageSize != 0 ||
+            sorted[i].end % pageSize != 0 || (i > 0 && sorted[i].start < sorted[i - 1].end)) {
+            return Result<SnapshotWriteStats>::error(
+                Error(ErrorCode::InvalidArgument, 0, "snapshot region").withAddress(sorted[i].start)
+            );
+        }
+    }
+
+    if (config_.store && config_.store->pageSize() != pageSize) {
+        return Result<SnapshotWriteStats>::error(
+            Error(ErrorCode::InvalidArgument, 0, "snapshot store page size").withSize(config_.store->pageSize())
+        );
+    }
+    if (config_.trackDirtyPages && !config_.store) {
+        return Result<SnapshotWriteStats>::error(
+            Error(ErrorCode::InvalidArgument, 0, "tracking dirty pages requires a snapshot store").withPid(pid)
+        );
+    }
+    const SnapshotReader* base = config_.base;
+    if (base && (!config_.store || base->storePath() != config_.store->dataPath() ||
+                 base->info().pageSize != pageSize || base->info().pid != pid)) {
+        return Result<SnapshotWriteStats>::error(
+            Error(ErrorCode::InvalidArgument, 0, "snapshot base does not match store or process").withPid(pid)
+        );
+    }
+    
+    UKC_TRACE_SCOPE("snapshot.capture", sorted.size());
+
+    auto process = ProcessHandle::open(pid);
+    if (process.isError()) {
+        return Result<SnapshotWriteStats>::error(process.errorInfo());
+    }
+
+    // 增量捕获：先取得自 base 以来的 soft-dirty 状态，再清除供下一次使用
+    // soft-dirty 位记录的是上一次清除以来的写入，只有最后一次清除的快照才能作为 base；
+    // 之后又有别的捕获清除过时沿用 base 的页会得到旧内容，退回完整读取
+    ProcessManager processManager;
+    std::vector<bool> unchanged;
+    if (base && base->info().dirtyTracked && base->info().dirtyGeneration != 0 &&
+        base->info().dirtyGeneration == config_.store->dirtyGeneration(pid) &&
+        ProcessManager::softDirtySupported()) {
+        auto unchangedResult = unchangedPages(processManager, process.value(), sorted, pageSize);
+        if (unchangedResult.isError() && unchangedResult.errorCode() == ErrorCode::ProcessGone) {
+            return Result<SnapshotWriteStats>::error(unchangedResult.errorInfo());
+        }
+        if (unchangedResult.isSuccess()) {
+            unchanged = std::move(unchangedResult.value());
+        }
+    }
+    bool dirtyTracked = false;
+    uint64_t dirtyGeneration = 0;
+    if (config_.trackDirtyPages) {
+        // 先登记新代号再清除：登记失败时不清除，已有的 base 仍然有效
+        auto generation = config_.store->beginDirtyGeneration(pid);
+        if (generation.isSuccess()) {
+            auto clearResult = processManager.clearSoftDirty(process.value());
+            if (clearResult.isError() && clearResult.errorCode() == ErrorCode::ProcessGone) {
+                return Result<SnapshotWriteStats>::error(clearResult.errorInfo());
+            }
+            dirtyTracked = clearResult.isSuccess();
+            dirtyGeneration = dirtyTracked ? generation.value() : 0;
+        }
+    }
+
+    SnapshotFile file(path);
+    auto openResult = file.open();
+    if (openResult.isError()) {
+        return Result<SnapshotWriteStats>::error(openResult.errorInfo());
+    }
+
+    // 区域表和字符串表
+    std::vector<RegionRecord> regionRecords(sorted.size());
+    std::string strings;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        RegionRecord& record = regionRecords[i];
+        std::memset(&record, 0, sizeof(record));
+        record.start = sorted[i].start;
+        record.end = sorted[i].end;
+        std::memset(record.permissions, '-', sizeof(record.permissions));
+        std::memcpy(record.permissions, sorted[i].permissions.data(),
+                    std::min(sorted[i].permissions.size(), sizeof(record.permissions)));
+        record.pathOffset = static_cast<uint32_t>(strings.size());
+        record.pathLength = static_cast<uint32_t>(sorted[i].path.size());
+        strings += sorted[i].path;
+    }
+
+    CaptureSession session(config_, pageSize, file, process.value(), regionRecords);
+    session.fileOffset = alignUp(sizeof(FileHeader), pageSize);
+
+    // 按读取批次切块，一批可以跨多个区域；增量捕获时块再按页拆成读取和沿用的片段
+    const size_t maxIov = std::min<size_t>(IOV_MAX, 1024);
+    std::vector<Piece> batch;
+    std::vector<Piece> pieces;
+    size_t batchBytes = 0;
+    size_t pageIndex = 0;
+    for (size_t r = 0; r < sorted.size(); ++r) {
+        for (uintptr_t address = sorted[r].start; address < sorted[r].end; address += config_.blockSize) {
+            size_t size = std::min<size_t>(config_.blockSize, sorted[r].end - address);
+            pieces.clear();
+            if (unchanged.empty()) {
+                pieces.push_back(Piece{r, address, size});
+            } else {
+                splitUnchanged(*base, unchanged, pageIndex, Piece{r, address, size}, pageSize, pieces);
+                pageIndex += size / pageSize;
+            }
+            for (const auto& piece : pieces) {
+                size_t readSize = piece.reused ? 0 : piece.size;
+                if (batchBytes + readSize > config_.readBatchSize || batch.size() == maxIov) {
+                    auto result = session.readBatch(batch);
+                    if (result.isError()) {
+                        return Result<SnapshotWriteStats>::error(result.errorInfo());
+                    }
+                    batch.clear();
+                    batchBytes = 0;
+                }
+                batch.push_back(piece);
+                batchBytes += readSize;
+            }
+        }
+    }
+    if (!batch.empty()) {
+        auto result = session.readBatch(batch);
+        if (result.isError()) {
+            return Result<SnapshotWriteStats>::error(result.errorInfo());
+        }
+    }
+
+    // 快照引用的新增页必须先落盘（flush 返回前已 fdatasync）
+    if (config_.store) {
+        auto flushResult = config_.store->flush();
+        if (flushResult.isError()) {
+            return Result<SnapshotWriteStats>::error(flushResult.errorInfo());
+        }
+    }
+    
+    // 各表写在数据之后，最后回填文件头
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.pageSize = static_cast<uint32_t>(pageSize);
+    header.blockSize = static_cast<uint32_t>(config_.blockSize);
+    header.pid = pid;
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    header.captureTimeNs = static_cast<uint64_t>(now.tv_sec) * 1000000000ull +
+                           static_cast<uint64_t>(now.tv_nsec);
+    header.regionCount = regionRecords.size();
+    header.regionTableOffset = alignUp(session.fileOffset, alignof(RegionRecord));
+    header.blockCount = session.blocks.size();
+    header.blockTableOffset = header.regionTableOffset + regionRecords.size() * sizeof(RegionRecord);
+    header.stringTableOffset = header.blockTableOffset + session.blocks.size() * sizeof(BlockRecord);
+    if (config_.store) {
+        header.storePathOffset = strings.size();
+        header.storePathLength = config_.store->dataPath().size();
+        strings += config_.store->dataPath();
+    }
+    header.flags = dirtyTracked ? kFlagDirtyTracked : 0;
+    header.dirtyGeneration = dirtyGeneration;
+    header.stringTableSize = strings.size();
+    uint64_t fileSize = header.stringTableOffset + strings.size();
+
+    Result<void> writeResult = file.write(regionRecords.data(),
+                                          regionRecords.size() * sizeof(RegionRecord),
+                                          header.regionTableOffset);
+    if (writeResult.isSuccess()) {
+        writeResult = file.write(session.blocks.data(), session.blocks.size() * sizeof(BlockRecord),
+                                 header.blockTableOffset);
+    }
+    if (writeResult.isSuccess()) {
+        writeResult = file.write(strings.data(), strings.size(), header.stringTableOffset);
+    }
+    if (writeResult.isSuccess()) {
+        writeResult = file.write(&header, sizeof(header), 0);
+    }
+    if (writeResult.isSuccess()) {
+        writeResult = file.commit(fileSize);
+    }
+    if (writeResult.isError()) {
+        return Result<SnapshotWriteStats>::error(writeResult.errorInfo());
+    }
+
+    SnapshotWriteStats stats = session.stats;
+    stats.regions = regionRecords.size();
+    stats.blocks = session.blocks.size();
+    stats.fileSize = fileSize;
+    return Result<SnapshotWriteStats>::success(stats);
+}
+
+Result<SnapshotReader> SnapshotReader::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return Result<SnapshotReader>::error(fileError(ErrorCode::Unavailable, "snapshot open", path));
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        Error error = fileError(ErrorCode::Unavailable, "snapshot stat", path);
+        close(fd);
+        return Result<SnapshotReader>::error(error);
+    }
+
+    auto corrupt = [&path](const char* context) {
+        return Result<SnapshotReader>::error(Error(ErrorCode::InvalidArgument, 0, context).withName(path));
+    };
+
+    const size_t fileSize = static_cast<size_t>(st.st_size);
+    if (fileSize < kHeaderSizeV1) {
+        close(fd);
+        return corrupt("snapshot truncated");
+    }
+
+    void* mapped = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return Result<SnapshotReader>::error(fileError(ErrorCode::Unavailable, "snapshot mmap", path));
+    }
+
+    SnapshotReader reader;
+    reader.base_ = static_cast<const uint8_t*>(mapped);
+    reader.mappedSize_ = fileSize;
+
+    // 版本 1 的文件头没有页存储路径，版本 2 没有 soft-dirty 代号
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(&header, reader.base_, kHeaderSizeV1);
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+        header.version == 0 || header.version > kVersion) {
+        return corrupt("not a snapshot file");
+    }
+    if (header.version >= 2) {
+        size_t headerSize = header.version == 2 ? kHeaderSizeV2 : sizeof(FileHeader);
+        if (fileSize < headerSize) {
+            return corrupt("snapshot truncated");
+        }
+        std::memcpy(&header, reader.base_, headerSize);
+    }
+
+    // 各表必须完整地位于文件内（先检查数量，避免乘法溢出）
+    auto tableFits = [fileSize](uint64_t offset, uint64_t count, size_t recordSize) {
+        return count <= fileSize / recordSize && offset <= fileSize &&
+               count * recordSize <= fileSize - offset;
+    };
+    if (header.pageSize == 0 || header.blockSize == 0 || header.blockSize % header.pageSize != 0 ||
+        !tableFits(header.regionTableOffset, header.regionCount, sizeof(RegionRecord)) ||
+        !tableFits(header.blockTableOffset, header.blockCount, sizeof(BlockRecord)) ||
+        !tableFits(header.stringTableOffset, header.stringTableSize, 1)) {
+        return corrupt("snapshot tables out of bounds");
+    }
+
+    reader.info_.pid = header.pid;
+    reader.info_.captureTimeNs = header.captureTimeNs;
+    reader.info_.pageSize = header.pageSize;
+    reader.info_.blockSize = header.blockSize;
+    reader.info_.blockCount = header.blockCount;
+    reader.info_.fileSize = fileSize;
+    reader.info_.dirtyTracked = (header.flags & kFlagDirtyTracked) != 0;
+    reader.info_.dirtyGeneration = header.dirtyGeneration;
+
+    const char* strings = reinterpret_cast<const char*>(reader.base_ + header.stringTableOffset);
+    if (header.storePathLength > 0) {
+        if (header.storePathOffset > header.stringTableSize ||
+            header.storePathLength > header.stringTableSize - header.storePathOffset) {
+            return corrupt("snapshot store path");
+        }
+        reader.storePath_.assign(strings + header.storePathOffset, header.storePathLength);
+        auto mapResult = reader.mapStore(reader.storePath_);
+        if (mapResult.isError()) {
+            return Result<SnapshotReader>::error(mapResult.errorInfo());
+        }
+    }
+    reader.blocks_.reserve(header.blockCount);
+    reader.blockStarts_.reserve(header.blockCount);
+    reader.regions_.reserve(header.regionCount);
+    reader.regionBlockEnds_.reserve(header.regionCount);
+
+    for (uint64_t r = 0; r < header.regionCount; ++r) {
+        RegionRecord record;
+        std::memcpy(&record, reader.base_ + header.regionTableOffset + r * sizeof(RegionRecord),
+                    sizeof(record));
+        if (record.start >= record.end ||
+            (!reader.regions_.empty() && record.start < reader.regions_.back().end) ||
+            record.firstBlock != reader.blocks_.size() ||
+            record.blockCount > header.blockCount - record.firstBlock ||
+            record.pathOffset > header.stringTableSize ||
+            record.pathLength > header.stringTableSize - record.pathOffset) {
+            return corrupt("snapshot region table");
+        }
+
+        MemoryRegion region;
+        region.start = record.start;
+        region.end = record.end;
+        region.permissions.assign(record.permissions, sizeof(record.permissions));
+        region.path.assign(strings + record.pathOffset, record.pathLength);
+
+        // 区域内的块首尾相接，正好覆盖整个区域
+        uint64_t address = record.start;
+        for (uint64_t b = 0; b < record.blockCount; ++b) {
+            BlockRecord blockRecord;
+            std::memcpy(&blockRecord, reader.base_ + header.blockTableOffset +
+                        (record.firstBlock + b) * sizeof(BlockRecord), sizeof(blockRecord));
+            bool stored = blockRecord.encoding == kBlockRaw || blockRecord.encoding == kBlockLz4;
+            bool inStore = blockRecord.encoding == kBlockStore;
+            if (blockRecord.encoding > kBlockStore || blockRecord.rawSize == 0 ||
+                blockRecord.rawSize > header.blockSize ||
+                ((blockRecord.encoding == kBlockRaw || inStore) &&
+                 blockRecord.storedSize != blockRecord.rawSize) ||
+                (stored && (blockRecord.storedSize == 0 ||
+                            !tableFits(blockRecord.fileOffset, blockRecord.storedSize, 1))) ||
+                (inStore && (blockRecord.fileOffset > reader.storeSize_ ||
+                             blockRecord.rawSize > reader.storeSize_ - blockRecord.fileOffset)) ||
+                blockRecord.rawSize > record.end - address) {
+                return corrupt("snapshot block table");
+            }
+            reader.blocks_.push_back(Block{blockRecord.fileOffset, blockRecord.storedSize,
+                                           blockRecord.rawSize, blockRecord.encoding});
+            reader.blockStarts_.push_back(address);
+            address += blockRecord.rawSize;
+        }
+        if (address != record.end) {
+            return corrupt("snapshot block table");
+        }
+
+        reader.regions_.push_back(std::move(region));
+        reader.regionBlockEnds_.push_back(reader.blocks_.size());
+    }
+
+    return Result<SnapshotReader>::success(std::move(reader));
+}
+
+SnapshotReader::~SnapshotReader() {
+    unmap();
+}
+
+SnapshotReader::SnapshotReader(SnapshotReader&& other) noexcept
+    : base_(other.base_),
+      mappedSize_(other.mappedSize_),
+      storeBase_(other.storeBase_),
+      storeSize_(other.storeSize_),
+      storePath_(std::move(other.storePath_)),
+      info_(other.info_),
+      regions_(std::move(other.regions_)),
+      blocks_(std::move(other.blocks_)),
+      blockStarts_(std::move(other.blockStarts_)),
+      regionBlockEnds_(std::move(other.regionBlockEnds_)) {
+    other.base_ = nullptr;
+    other.mappedSize_ = 0;
+    other.storeBase_ = nullptr;
+    other.storeSize_ = 0;
+}
+
+SnapshotReader& SnapshotReader::operator=(SnapshotReader&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        base_ = other.base_;
+        mappedSize_ = other.mappedSize_;
+        storeBase_ = other.storeBase_;
+        storeSize_ = other.storeSize_;
+        storePath_ = std::move(other.storePath_);
+        info_ = other.info_;
+        regions_ = std::move(other.regions_);
+        blocks_ = std::move(other.blocks_);
+        blockStarts_ = std::move(other.blockStarts_);
+        regionBlockEnds_ = std::move(other.regionBlockEnds_);
+        other.base_ = nullptr;
+        other.mappedSize_ = 0;
+        other.storeBase_ = nullptr;
+        other.storeSize_ = 0;
+    }
+    return *this;
+}
+
+void SnapshotReader::unmap() {
+    if (base_) {
+        munmap(const_cast<uint8_t*>(base_), mappedSize_);
+        base_ = nullptr;
+        mappedSize_ = 0;
+    }
+    if (storeBase_) {
+        munmap(const_cast<uint8_t*>(storeBase_), storeSize_);
+        storeBase_ = nullptr;
+        storeSize_ = 0;
+    }
+}
+
+Result<void> SnapshotReader::mapStore(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return Result<void>::error(fileError(ErrorCode::Unavailable, "snapshot store open", path));
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        Error error = fileError(ErrorCode::Unavailable, "snapshot store stat", path);
+        close(fd);
+        return Result<void>::error(error);
+    }
+    // 存储只追加，快照引用的页都在打开时的长度之内
+    size_t size = static_cast<size_t>(st.st_size);
+    if (size > 0) {
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) {
+            Error error = fileError(ErrorCode::Unavailable, "snapshot store mmap", path);
+            close(fd);
+            return Result<void>::error(error);
+        }
+        storeBase_ = static_cast<const uint8_t*>(mapped);
+        storeSize_ = size;
+    }
+    close(fd);
+    return Result<void>::success();
+}
+
+const uint8_t* SnapshotReader::directData(size_t index) const {
+    const Block& block = blocks_[index];
+    if (block.encoding == kBlockRaw) {
+        return base_ + block.fileOffset;
+    }
+    if (block.encoding == kBlockStore) {
+        return storeBase_ + block.fileOffset;
+    }
+    return nullptr;
+}
+
+size_t SnapshotReader::findBlock(uintptr_t address) const {
+    auto it = std::upper_bound(blockStarts_.begin(), blockStarts_.end(), address);
+    if (it == blockStarts_.begin()) {
+        return blocks_.size();
+    }
+    size_t index = static_cast<size_t>(it - blockStarts_.begin()) - 1;
+    if (address - blockStarts_[index] >= blocks_[index].rawSize) {
+        return blocks_.size();
+    }
+    return index;
+}
+
+SnapshotPage SnapshotReader::page(uintptr_t address) const {
+    SnapshotPage result;
+    uintptr_t pageStart = address / info_.pageSize * info_.pageSize;
+    size_t index = findBlock(pageStart);
+    if (index == blocks_.size()) {
+        return result;
+    }
+    const Block& block = blocks_[index];
+    size_t offset = pageStart - blockStarts_[index];
+    if (block.encoding == kBlockUnreadable || offset + info_.pageSize > block.rawSize) {
+        return result;
+    }
+    switch (block.encoding) {
+        case kBlockZero:
+            result.kind = SnapshotPage::Kind::Zero;
+            break;
+        case kBlockStore:
+            result.kind = SnapshotPage::Kind::Stored;
+            result.storeOffset = block.fileOffset + offset;
+            break;
+        default:
+            result.kind = SnapshotPage::Kind::Inline;
+            break;
+    }
+    return result;
+}
+
+bool SnapshotReader::decodeBlock(size_t index, size_t offset, uint8_t* dst, size_t size) const {
+    const Block& block = blocks_[index];
+    switch (block.encoding) {
+        case kBlockRaw:
+        case kBlockStore:
+            std::memcpy(dst, directData(index) + offset, size);
+            return true;
+        case kBlockZero:
+            std::memset(dst, 0, size);
+            return true;
+        case kBlockLz4: {
+            const uint8_t* src = base_ + block.fileOffset;
+            if (offset == 0 && size == block.rawSize) {
+                return lz4::decompress(src, block.storedSize, dst, size);
+            }
+            thread_local std::vector<uint8_t> decoded;
+            decoded.resize(block.rawSize);
+            if (!lz4::decompress(src, block.storedSize, decoded.data(), block.rawSize)) {
+                return false;
+            }
+            std::memcpy(dst, decoded.data() + offset, size);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+SnapshotSpan SnapshotReader::span(uintptr_t address, size_t size, uint8_t* scratch) const {
+    size_t index = findBlock(address);
+    if (index == blocks_.size() || size == 0) {
+        return SnapshotSpan();
+    }
+
+    size_t regionEnd = *std::upper_bound(regionBlockEnds_.begin(), regionBlockEnds_.end(), index);
+    size_t offset = address - blockStarts_[index];
+    if (blocks_[index].encoding == kBlockUnreadable) {
+        return SnapshotSpan{nullptr, blocks_[index].rawSize - offset};
+    }
+
+    // 未压缩的块（快照文件或页存储中）在文件中也连续时，足够长就直接返回映射内的指针
+    const uint8_t* direct = directData(index);
+    if (direct) {
+        size_t available = blocks_[index].rawSize - offset;
+        size_t next = index + 1;
+        while (available < size && next < regionEnd &&
+               blocks_[next].encoding == blocks_[index].encoding &&
+               blocks_[next].fileOffset == blocks_[next - 1].fileOffset + blocks_[next - 1].rawSize) {
+            available += blocks_[next].rawSize;
+            next++;
+        }
+        if (available >= size || next == regionEnd || blocks_[next].encoding == kBlockUnreadable) {
+            return SnapshotSpan{direct + offset, std::min(available, size)};
+        }
+    }
+
+    size_t copied = 0;
+    for (size_t i = index; i < regionEnd && copied < size; ++i) {
+        if (blocks_[i].encoding == kBlockUnreadable) {
+            break;
+        }
+        size_t blockOffset = i == index ? offset : 0;
+        size_t length = std::min<size_t>(blocks_[i].rawSize - blockOffset, size - copied);
+        if (!decodeBlock(i, blockOffset, scratch + copied, length)) {
+            break;
+        }
+        copied += length;
+    }
+    if (copied == 0) {
+        // 压缩数据损坏，按不可读处理
+        return SnapshotSpan{nullptr, blocks_[index].rawSize - offset};
+    }
+    return SnapshotSpan{scratch, copied};
+}
+
+Result<size_t> SnapshotReader::read(uintptr_t address, uint8_t* buffer, size_t size) const {
+    if (buffer == nullptr) {
+        return Result<size_t>::error(Error(ErrorCode::InvalidArgument, 0, "buffer is null"));
+    }
+    if (size == 0) {
+        return Result<size_t>::success(0);
+    }
+
+    SnapshotSpan result = span(address, size, buffer);
+    if (result.data == nullptr) {
+        ErrorCode code = result.size == 0 ? ErrorCode::InvalidAddress : ErrorCode::ReadFailed;
+        return Result<size_t>::error(Error(code, 0, "snapshot").withAddress(address).withSize(size));
+    }
+    if (result.data != buffer) {
+        std::memcpy(buffer, result.data, result.size);
+    }
+    return Result<size_t>::success(result.size);
+}
+
+} // namespace ukc
@@ -0,0 +1,104 @@
+#include "read_coalescer.h"
+#include "probes.h"
+#include <algorithm>
+
+namespace ukc {
+
+ReadCoalescer::ReadCoalescer(
+    std::shared_ptr<MemoryInjector> injector,
+    Executor& executor,
+    ReadEngineConfig config
+)
+    : injector_(std::move(injector)),
+      executor_(executor),
+      engine_(config) {
+}
+
+std::future<Result<std::vector<uint8_t>>> ReadCoalescer::read(
+    pid_t pid,
+    uintptr_t address,
+    size_t size
+) {
+    PendingRead request{pid, address, size, {}};
+    auto future = request.promise.get_future();
+
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.push_back(std::move(request));
+        stats_.requests++;
+        if (!draining_) {
+            draining_ = true;
+            schedule = true;
+        }
+    }
+
+    if (schedule) {
+        executor_.submit([this]() { drain(); });
+    }
+    return future;
+}
+
+ReadCoalescerStats ReadCoalescer::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void ReadCoalescer::drain() {
+    std::vector<PendingRead> batch;
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (pending_.empty()) {
+                draining_ = false;
+                return;
+            }
+            batch.swap(pending_);
+        }
+
+        UKC_TRACE_SCOPE("coalescer.drain", batch.size());
+
+        // 按进程分组，组内保持提交顺序
+        std::stable_sort(batch.begin(), batch.end(),
+                         [](const PendingRead& a, const PendingRead& b) { return a.pid < b.pid; });
+        size_t begin = 0;
+        while (begin < batch.size()) {
+            size_t end = begin + 1;
+            while (end < batch.size() && batch[end].pid == batch[begin].pid) {
+                end++;
+            }
+            executeBatch(&batch[begin], end - begin);
+            begin = end;
+        }
+        batch.clear();
+    }
+}
+
+void ReadCoalescer::executeBatch(PendingRead* requests, size_t count) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.batches++;
+        stats_.maxBatchSize = std::max(stats_.maxBatchSize, count);
+    }
+
+    std::vector<MemoryOperation> operations(count);
+    for (size_t i = 0; i < count; ++i) {
+        operations[i].type = OperationType::Read;
+        operations[i].address = requests[i].address;
+        operations[i].size = requests[i].size;
+    }
+
+    auto result = injector_->batchOperations(requests[0].pid, operations, engine_);
+    for (size_t i = 0; i < count; ++i) {
+        MemoryOperation& op = operations[i];
+        if (result.isError()) {
+            requests[i].promise.set_value(Result<std::vector<uint8_t>>::error(result.errorInfo()));
+        } else if (op.success) {
+            requests[i].promise.set_value(Result<std::vector<uint8_t>>::success(std::move(op.result)));
+        } else {
+            requests[i].promise.set_value(Result<std::vector<uint8_t>>::error(op.error));
+        }
+    }
+}
+
+} // namespace ukc
@@ -0,0 +1,484 @@
+#include "read_engine.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup 425
+#endif
+#ifndef __NR_io_uring_enter
+#define __NR_io_uring_enter 426
+#endif
+#ifndef __NR_io_uring_register
+#define __NR_io_uring_register 427
+#endif
+
+namespace ukc {
+
+namespace {
+
+constexpr unsigned kMaxQueueDepth = 4096;
+
+int ioUringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return static_cast<int>(
+        syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0)
+    );
+}
+
+int ioUringRegister(int fd, unsigned opcode, const void* arg, unsigned count) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+unsigned loadAcquire(const unsigned* p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+void storeRelease(unsigned* p, unsigned value) {
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+
+unsigned* ringField(void* base, uint32_t offset) {
+    return reinterpret_cast<unsigned*>(static_cast<uint8_t*>(base) + offset);
+}
+
+/**
+ * 回填一次读取的结果
+ *
+ * @param bytes 读取的字节数，负值为 -errno
+ */
+void completeRead(const ProcessHandle& process, MemoryOperation& op, long bytes,
+                  ReadEngineStats& stats) {
+    if (bytes >= 0 && static_cast<size_t>(bytes) == op.size) {
+        op.success = true;
+        op.error = Error();
+        return;
+    }
+
+    // 进程退出后 mem 读出 0 字节
+    int sysErrno = bytes < 0 ? static_cast<int>(-bytes) : 0;
+    ErrorCode code = (bytes == 0 && !process.isAlive()) ? ErrorCode::ProcessGone
+                                                         : ErrorCode::ReadFailed;
+    op.success = false;
+    op.result.clear();
+    op.error = Error(code, sysErrno, "/proc/<pid>/mem")
+        .withAddress(op.address).withSize(op.size).withPid(process.pid());
+    stats.failed++;
+}
+
+} // namespace
+
+/**
+ * io_uring 实例及其共享内存映射
+ */
+struct ReadEngine::Ring {
+    int fd = -1;
+    void* sqRing = MAP_FAILED;
+    size_t sqRingSize = 0;
+    void* cqRing = MAP_FAILED;
+    size_t cqRingSize = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqesSize = 0;
+
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned sqMask = 0;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+    unsigned entries = 0;
+
+    // 注册缓冲区：entries 个 slotSize 大小的槽
+    uint8_t* slots = static_cast<uint8_t*>(MAP_FAILED);
+    size_t slotsSize = 0;
+    size_t slotSize = 0;
+    bool registered = false;
+
+    // 放弃实例时仍可能被内核写入的调用方缓冲区，随实例一起泄漏
+    std::vector<std::vector<uint8_t>> orphaned;
+
+    /**
+     * 创建实例，内核不支持时返回 nullptr
+     */
+    static std::unique_ptr<Ring> create(unsigned depth, size_t slotSize);
+
+    ~Ring();
+};
+
+std::unique_ptr<ReadEngine::Ring> ReadEngine::Ring::create(unsigned depth, size_t slotSize) {
+    std::unique_ptr<Ring> ring(new Ring());
+
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    ring->fd = ioUringSetup(depth, &params);
+    if (ring->fd < 0) {
+        return nullptr;
+    }
+
+    ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMmap) {
+        ring->sqRingSize = std::max(ring->sqRingSize, ring->cqRingSize);
+    }
+
+    ring->sqRing = mmap(nullptr, ring->sqRingSize, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sqRing == MAP_FAILED) {
+        return nullptr;
+    }
+
+    if (singleMmap) {
+        ring->cqRing = ring->sqRing;
+    } else {
+        ring->cqRing = mmap(nullptr, ring->cqRingSize, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+        if (ring->cqRing == MAP_FAILED) {
+            return nullptr;
+        }
+    }
+
+    ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    ring->sqes = static_cast<io_uring_sqe*>(
+        mmap(nullptr, ring->sqesSize, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES)
+    );
+    if (ring->sqes == MAP_FAILED) {
+        return nullptr;
+    }
+
+    ring->sqHead = ringField(ring->sqRing, params.sq_off.head);
+    ring->sqTail = ringField(ring->sqRing, params.sq_off.tail);
+    ring->sqMask = *ringField(ring->sqRing, params.sq_off.ring_mask);
+    ring->sqArray = ringField(ring->sqRing, params.sq_off.array);
+    ring->cqHead = ringField(ring->cqRing, params.cq_off.head);
+    ring->cqTail = ringField(ring->cqRing, params.cq_off.tail);
+    ring->cqMask = *ringField(ring->cqRing, params.cq_off.ring_mask);
+    ring->cqes = reinterpret_cast<io_uring_cqe*>(
+        static_cast<uint8_t*>(ring->cqRing) + params.cq_off.cqes
+    );
+    ring->entries = params.sq_entries;
+
+    // IORING_OP_READ 需要 5.6+，用 IORING_REGISTER_PROBE 确认（探测本身也是 5.6 引入的）
+    std::vector<uint8_t> probeStorage(sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op));
+    io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(probeStorage.data());
+    if (ioUringRegister(ring->fd, IORING_REGISTER_PROBE, probe, 256) != 0 ||
+        probe->last_op < IORING_OP_READ ||
+        (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) == 0) {
+        return nullptr;
+    }
+
+    // 注册缓冲区会锁定内存，超出 RLIMIT_MEMLOCK 时只用普通 IORING_OP_READ
+    ring->slotSize = slotSize;
+    ring->slotsSize = ring->entries * slotSize;
+    if (ring->slotsSize > 0) {
+        ring->slots = static_cast<uint8_t*>(
+            mmap(nullptr, ring->slotsSize, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)
+        );
+        if (ring->slots != MAP_FAILED) {
+            struct iovec slotsVec;
+            slotsVec.iov_base = ring->slots;
+            slotsVec.iov_len = ring->slotsSize;
+            ring->registered = ioUringRegister(ring->fd, IORING_REGISTER_BUFFERS, &slotsVec, 1) == 0;
+        }
+    }
+
+    return ring;
+}
+
+ReadEngine::Ring::~Ring() {
+    // 注册缓冲区的页在实例释放前一直被内核固定，先关 fd 再解除映射
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (slots != MAP_FAILED) {
+        munmap(slots, slotsSize);
+    }
+    if (sqes != MAP_FAILED) {
+        munmap(sqes, sqesSize);
+    }
+    if (cqRing != MAP_FAILED && cqRing != sqRing) {
+        munmap(cqRing, cqRingSize);
+    }
+    if (sqRing != MAP_FAILED) {
+        munmap(sqRing, sqRingSize);
+    }
+}
+
+ReadEngine::ReadEngine(ReadEngineConfig config)
+    : config_(config) {
+    config_.queueDepth = std::min(std::max(config_.queueDepth, 1u), kMaxQueueDepth);
+    if (config_.backend == ReadBackend::IoUring) {
+        ring_ = Ring::create(config_.queueDepth, config_.slotSize);
+    }
+}
+
+ReadEngine::~ReadEngine() = default;
+
+ReadBackend ReadEngine::backend() const {
+    return ring_ ? ReadBackend::IoUring : ReadBackend::Preadv;
+}
+
+Result<size_t> ReadEngine::read(
+    const ProcessHandle& process,
+    MemoryOperation* operations,
+    size_t count,
+    ReadEngineStats* stats
+) {
+    if (process.memFd() < 0) {
+        return Result<size_t>::error(
+            Error(ErrorCode::Unavailable, 0, "/proc/<pid>/mem").withPid(process.pid())
+        );
+    }
+
+    ReadEngineStats localStats;
+    std::vector<size_t> readIndices;
+    size_t succeeded = 0;
+    for (size_t i = 0; i < count; ++i) {
+        MemoryOperation& op = operations[i];
+        if (op.type != OperationType::Read) {
+            continue;
+        }
+        localStats.reads++;
+        op.result.resize(op.size);
+        if (op.size == 0) {
+            op.success = true;
+            op.error = Error();
+            succeeded++;
+            continue;
+        }
+        readIndices.push_back(i);
+    }
+
+    if (!readIndices.empty()) {
+        succeeded += ring_ ? readWithRing(process, operations, readIndices, localStats)
+                           : readWithPreadv(process, operations, readIndices, localStats);
+    }
+
+    if (stats) {
+        stats->reads += localStats.reads;
+        stats->failed += localStats.failed;
+        stats->syscalls += localStats.syscalls;
+        stats->fixedReads += localStats.fixedReads;
+    }
+    return Result<size_t>::success(succeeded);
+}
+
+size_t ReadEngine::readWithRing(
+    const ProcessHandle& process,
+    MemoryOperation* operations,
+    const std::vector<size_t>& readIndices,
+    ReadEngineStats& stats
+) {
+    Ring& ring = *ring_;
+
+    // 每个在途读取占用一个槽，槽号作为 user_data
+    std::vector<unsigned> freeSlots(ring.entries);
+    for (unsigned slot = 0; slot < ring.entries; ++slot) {
+        freeSlots[slot] = ring.entries - 1 - slot;
+    }
+    std::vector<size_t> slotOperation(ring.entries);
+    std::vector<bool> slotFixed(ring.entries);
+
+    size_t next = 0;
+    size_t inflight = 0;
+    size_t succeeded = 0;
+
+    // 收割 CQ 中已有的完成事件，返回收割的数量
+    auto reap = [&]() {
+        unsigned head = *ring.cqHead;
+        unsigned completed = loadAcquire(ring.cqTail);
+        size_t reaped = 0;
+        while (head != completed) {
+            const io_uring_cqe& cqe = ring.cqes[head & ring.cqMask];
+            unsigned slot = static_cast<unsigned>(cqe.user_data);
+            MemoryOperation& op = operations[slotOperation[slot]];
+            if (slotFixed[slot] && cqe.res > 0) {
+                std::memcpy(op.result.data(), ring.slots + slot * ring.slotSize,
+                            static_cast<size_t>(cqe.res));
+            }
+            completeRead(process, op, cqe.res, stats);
+            if (op.success) {
+                succeeded++;
+                if (slotFixed[slot]) {
+                    stats.fixedReads++;
+                }
+            }
+            freeSlots.push_back(slot);
+            inflight--;
+            reaped++;
+            head++;
+        }
+        storeRelease(ring.cqHead, head);
+        return reaped;
+    };
+
+    while (next < readIndices.size() || inflight > 0) {
+        // 只有本线程写 SQ 尾指针
+        unsigned tail = *ring.sqTail;
+        while (next < readIndices.size() && !freeSlots.empty()) {
+            unsigned slot = freeSlots.back();
+            freeSlots.pop_back();
+            size_t index = readIndices[next++];
+            MemoryOperation& op = operations[index];
+
+            unsigned position = tail & ring.sqMask;
+            io_uring_sqe* sqe = &ring.sqes[position];
+            std::memset(sqe, 0, sizeof(*sqe));
+            bool fixed = ring.registered && op.size <= ring.slotSize;
+            if (fixed) {
+                sqe->opcode = IORING_OP_READ_FIXED;
+                sqe->addr = reinterpret_cast<uint64_t>(ring.slots + slot * ring.slotSize);
+                sqe->buf_index = 0;
+            } else {
+                sqe->opcode = IORING_OP_READ;
+                sqe->addr = reinterpret_cast<uint64_t>(op.result.data());
+            }
+            sqe->fd = process.memFd();
+            sqe->off = static_cast<uint64_t>(op.address);
+            sqe->len = static_cast<uint32_t>(std::min<size_t>(op.size, UINT32_MAX));
+            sqe->user_data = slot;
+            ring.sqArray[position] = position;
+
+            slotOperation[slot] = index;
+            slotFixed[slot] = fixed;
+            tail++;
+            inflight++;
+        }
+        storeRelease(ring.sqTail, tail);
+
+        // 提交所有尚未被内核取走的条目，并至少等待一个完成事件
+        unsigned toSubmit = tail - loadAcquire(ring.sqHead);
+        stats.syscalls++;
+        int entered = ioUringEnter(ring.fd, toSubmit, 1, IORING_ENTER_GETEVENTS);
+        if (entered < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            // 实例不可用。内核已取走的请求可能仍在 io-wq 中执行并写入槽或 op.result，
+            // 关闭 fd 并不会等待它们，必须先收割完这些请求的完成事件，才能释放实例
+            // 并对剩余的读取改用 preadv
+            unsigned queued = tail - loadAcquire(ring.sqHead);
+            std::vector<size_t> remaining;
+            for (unsigned i = 0; i < queued; ++i) {
+                // 仍在 SQ 中、未被内核取走的条目不会再被执行
+                unsigned position = ring.sqArray[(tail - queued + i) & ring.sqMask];
+                const io_uring_sqe& sqe = ring.sqes[position];
+                remaining.push_back(slotOperation[static_cast<unsigned>(sqe.user_data)]);
+            }
+            size_t submitted = inflight - queued;
+            while (submitted > 0) {
+                stats.syscalls++;
+                if (ioUringEnter(ring.fd, 0, static_cast<unsigned>(submitted),
+                                 IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+                    break;
+                }
+                submitted -= reap();
+            }
+
+            if (submitted > 0) {
+                // 无法确认在途请求已结束：有意保留实例及其映射不释放，
+                // 这些请求对应的操作直接记为失败，不再用 preadv 重读。
+                // 非固定缓冲区的读取直接写入 op.result，把它的存储移交给泄漏的实例，
+                // 调用方之后释放操作时内核也只会写入不再被使用的内存
+                for (unsigned slot = 0; slot < ring.entries; ++slot) {
+                    size_t index = slotOperation[slot];
+                    if (std::find(freeSlots.begin(), freeSlots.end(), slot) == freeSlots.end() &&
+                        std::find(remaining.begin(), remaining.end(), index) == remaining.end()) {
+                        MemoryOperation& op = operations[index];
+                        if (!slotFixed[slot]) {
+                            ring.orphaned.push_back(std::move(op.result));
+                            op.result = std::vector<uint8_t>();
+                        }
+                        completeRead(process, op, -ECANCELED, stats);
+                    }
+                }
+                (void)ring_.release();
+            } else {
+                ring_.reset();
+            }
+            remaining.insert(remaining.end(), readIndices.begin() + next, readIndices.end());
+            std::sort(remaining.begin(), remaining.end());
+            return succeeded + readWithPreadv(process, operations, remaining, stats);
+        }
+
+        reap();
+    }
+
+    return succeeded;
+}
+
+size_t ReadEngine::readWithPreadv(
+    const ProcessHandle& process,
+    MemoryOperation* operations,
+    const std::vector<size_t>& readIndices,
+    ReadEngineStats& stats
+) {
+    std::vector<struct iovec> iov;
+    size_t succeeded = 0;
+    size_t begin = 0;
+
+    while (begin < readIndices.size()) {
+        // 地址首尾相接的读取合并为一次 preadv
+        const MemoryOperation& first = operations[readIndices[begin]];
+        size_t end = begin + 1;
+        size_t total = first.size;
+        while (end < readIndices.size() && end - begin < IOV_MAX) {
+            const MemoryOperation& previous = operations[readIndices[end - 1]];
+            const MemoryOperation& op = operations[readIndices[end]];
+            if (op.address != previous.address + previous.size || total + op.size < total) {
+                break;
+            }
+            total += op.size;
+            end++;
+        }
+
+        iov.clear();
+        for (size_t i = begin; i < end; ++i) {
+            MemoryOperation& op = operations[readIndices[i]];
+            iov.push_back({op.result.data(), op.size});
+        }
+
+        stats.syscalls++;
+        ssize_t bytes = preadv(process.memFd(), iov.data(), static_cast<int>(iov.size()),
+                               static_cast<off_t>(first.address));
+        if (bytes >= 0 && static_cast<size_t>(bytes) == total) {
+            for (size_t i = begin; i < end; ++i) {
+                MemoryOperation& op = operations[readIndices[i]];
+                op.success = true;
+                op.error = Error();
+            }
+            succeeded += end - begin;
+        } else if (end - begin == 1) {
+            completeRead(process, operations[readIndices[begin]],
+                         bytes < 0 ? -errno : bytes, stats);
+        } else {
+            // 合并读取中途失败，逐个重读以确定每个操作的结果
+            for (size_t i = begin; i < end; ++i) {
+                MemoryOperation& op = operations[readIndices[i]];
+                stats.syscalls++;
+                ssize_t single = pread(process.memFd(), op.result.data(), op.size,
+                                       static_cast<off_t>(op.address));
+                completeRead(process, op, single < 0 ? -errno : single, stats);
+                if (op.success) {
+                    succeeded++;
+                }
+            }
+        }
+
+        begin = end;
+    }
+
+    return succeeded;
+}
+
+} // namespace ukc
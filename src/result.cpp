@@ -1,4 +1,18 @@
 #include "result.h"
+#include <cstdio>
+#include <cstdlib>
 
-// Result<T> 的实现在头文件中（模板类）
-// 这个文件保留用于未来的非模板实现
+// Result<T> 的实现在头文件中（模板类），错误格式化见 error_code.cpp
+
+namespace ukc {
+
+namespace detail {
+
+void badResultAccess(const Error& error) {
+    std::fprintf(stderr, "Cannot get value from error result: %s\n", error.message().c_str());
+    std::abort();
+}
+
+} // namespace detail
+
+} // namespace ukc
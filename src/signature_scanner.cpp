@@ -1,8 +1,346 @@
 #include "signature_scanner.h"
+#include "process_manager.h"
+#include "probes.h"
+#include "executor.h"
+#include "process_snapshot.h"
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <memory>
+#include <thread>
+#include <unistd.h>
 
 namespace ukc {
 
+namespace {
+
+/**
+ * 扫描任务：一个区域内的一块
+ */
+struct ScanChunk {
+    size_t regionIndex = 0;
+    uintptr_t start = 0;
+    size_t ownedSize = 0;   // 本块负责报告命中的范围
+    size_t readSize = 0;    // 实际读取的范围（含与下一块的重叠）
+};
+
+/**
+ * 单个扫描线程的局部结果
+ */
+struct ScanWorkerResult {
+    std::vector<ProcessScanMatch> matches;
+    size_t bytesScanned = 0;
+    size_t bytesUnreadable = 0;
+    size_t bytesNonResident = 0;
+};
+
+/**
+ * 在一段连续可读的数据上运行所有模式
+ * segment 指向块内偏移 segmentStart 处的数据
+ */
+void scanSegment(
+    const uint8_t* segment,
+    size_t segmentStart,
+    size_t segmentSize,
+    const ScanChunk& chunk,
+    const std::vector<SignaturePattern>& patterns,
+    ScanWorkerResult& out
+) {
+    for (size_t p = 0; p < patterns.size(); ++p) {
+        if (patterns[p].size() > segmentSize) {
+            continue;
+        }
+        auto scanResult = SignatureScanner::scan(
+            segment, segmentSize, patterns[p]
+        );
+        if (scanResult.isError()) {
+            continue;
+        }
+        for (uintptr_t offset : scanResult.value()) {
+            size_t chunkOffset = segmentStart + offset;
+            // 重叠部分的命中由下一块报告，避免重复
+            if (chunkOffset >= chunk.ownedSize) {
+                continue;
+            }
+            ProcessScanMatch match;
+            match.address = chunk.start + chunkOffset;
+            match.patternIndex = p;
+            match.regionIndex = chunk.regionIndex;
+            out.matches.push_back(match);
+        }
+    }
+}
+
+/**
+ * 数据源一次读取的结果
+ */
+struct ScanFetch {
+    const uint8_t* data = nullptr;  // 可读的数据（scratch 或零拷贝的映射），为空表示不可读
+    size_t size = 0;                // 可读的字节数；不可读时为需要跳过的字节数
+    bool abort = false;             // 数据源已失效（如进程退出），停止扫描
+    bool nonResident = false;       // 跳过的页未驻留（而非不可读）
+};
+
+/**
+ * 检查模式列表，返回最长模式的长度
+ */
+Result<size_t> checkPatterns(const std::vector<SignaturePattern>& patterns) {
+    if (patterns.empty()) {
+        return Result<size_t>::error("No signature patterns given");
+    }
+    
+    size_t maxPatternSize = 0;
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        if (!patterns[i].isValid()) {
+            return Result<size_t>::error(
+                "Invalid signature pattern at index " + std::to_string(i)
+            );
+        }
+        maxPatternSize = std::max(maxPatternSize, patterns[i].size());
+    }
+    return Result<size_t>::success(maxPatternSize);
+}
+
+/**
+ * 把 result.regions 切块后多线程扫描，命中按地址排序写入 result
+ *
+ * makeFetcher() 为每个扫描线程创建一个数据源，
+ * 数据源 fetch(address, size, scratch) 返回 address 起的可读数据。
+ *
+ * @return 数据源中途失效时返回 false
+ */
+template<typename MakeFetcher>
+bool scanRegions(
+    ProcessScanResult& result,
+    const std::vector<SignaturePattern>& patterns,
+    size_t maxPatternSize,
+    size_t pageSize,
+    const ProcessScanConfig& config,
+    MakeFetcher makeFetcher
+) {
+    // 块大小按页对齐，块之间重叠 (最长模式 - 1) 字节以覆盖跨块的命中
+    size_t chunkSize = std::max(config.chunkSize, pageSize);
+    chunkSize = (chunkSize + pageSize - 1) / pageSize * pageSize;
+    const size_t overlap = maxPatternSize - 1;
+    
+    std::vector<ScanChunk> chunks;
+    for (size_t r = 0; r < result.regions.size(); ++r) {
+        const auto& region = result.regions[r];
+        for (uintptr_t start = region.start; start < region.end; start += chunkSize) {
+            ScanChunk chunk;
+            chunk.regionIndex = r;
+            chunk.start = start;
+            chunk.ownedSize = std::min<size_t>(chunkSize, region.end - start);
+            chunk.readSize = std::min<size_t>(chunk.ownedSize + overlap, region.end - start);
+            chunks.push_back(chunk);
+        }
+    }
+    
+    if (chunks.empty()) {
+        return true;
+    }
+    
+    size_t threadCount = config.threadCount;
+    if (threadCount == 0) {
+        threadCount = config.executor ? config.executor->threadCount() + 1
+                                      : std::max(1u, std::thread::hardware_concurrency());
+    }
+    threadCount = std::min(threadCount, chunks.size());
+    
+    std::atomic<size_t> nextChunk{0};
+    std::atomic<bool> aborted{false};
+    std::vector<ScanWorkerResult> workerResults(threadCount);
+    
+    auto worker = [&](ScanWorkerResult& out) {
+        UKC_TRACE_SCOPE("scanner.scan_worker", 0);
+        auto fetch = makeFetcher();
+        std::vector<uint8_t> buffer(chunkSize + overlap);
+        
+        size_t index;
+        while (!aborted.load() && (index = nextChunk.fetch_add(1)) < chunks.size()) {
+            const ScanChunk& chunk = chunks[index];
+            size_t pos = 0;
+            
+            while (pos < chunk.readSize) {
+                ScanFetch got = fetch(chunk.start + pos, chunk.readSize - pos, buffer.data() + pos);
+                if (got.abort) {
+                    aborted.store(true);
+                    break;
+                }
+                
+                size_t length = std::min(got.size, chunk.readSize - pos);
+                if (got.data) {
+                    scanSegment(got.data, pos, length, chunk, patterns, out);
+                    if (pos < chunk.ownedSize) {
+                        out.bytesScanned += std::min(length, chunk.ownedSize - pos);
+                    }
+                } else if (pos < chunk.ownedSize) {
+                    size_t skipped = std::min(length, chunk.ownedSize - pos);
+                    (got.nonResident ? out.bytesNonResident : out.bytesUnreadable) += skipped;
+                }
+                pos += length;
+            }
+        }
+    };
+    
+    if (config.executor) {
+        config.executor->parallelFor(ExecutorStage::Scan, threadCount, [&](size_t t) {
+            worker(workerResults[t]);
+        }, threadCount);
+    } else {
+        std::vector<std::thread> threads;
+        for (size_t t = 1; t < threadCount; ++t) {
+            threads.emplace_back(worker, std::ref(workerResults[t]));
+        }
+        worker(workerResults[0]);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    
+    if (aborted.load()) {
+        return false;
+    }
+    
+    for (auto& workerResult : workerResults) {
+        result.matches.insert(result.matches.end(),
+                              workerResult.matches.begin(), workerResult.matches.end());
+        result.bytesScanned += workerResult.bytesScanned;
+        result.bytesUnreadable += workerResult.bytesUnreadable;
+        result.bytesNonResident += workerResult.bytesNonResident;
+    }
+    
+    std::sort(result.matches.begin(), result.matches.end(),
+        [](const ProcessScanMatch& a, const ProcessScanMatch& b) {
+            if (a.address != b.address) {
+                return a.address < b.address;
+            }
+            return a.patternIndex < b.patternIndex;
+        });
+    return true;
+}
+
+/**
+ * 从目标进程读取扫描数据
+ *
+ * 匿名区域在每块的第一次读取时批量读取整块的 pagemap，
+ * 之后按驻留状态把块切成读取和跳过的片段；pagemap 不可读时不再跳过。
+ */
+class ProcessFetcher {
+public:
+    ProcessFetcher(pid_t pid, size_t pageSize, const std::vector<MemoryRegion>& regions, bool skipNonResident)
+        : pid_(pid), pageSize_(pageSize), regions_(regions), skipNonResident_(skipNonResident),
+          reader_(std::make_unique<ProcessManager>()) {
+    }
+
+    ScanFetch operator()(uintptr_t address, size_t size, uint8_t* scratch) {
+        ScanFetch fetch;
+        if (skipNonResident_ && isAnonymous(address)) {
+            size_t resident = run(address, size, true);
+            if (resident == 0) {
+                fetch.size = run(address, size, false);
+                fetch.nonResident = true;
+                return fetch;
+            }
+            size = resident;
+        }
+
+        auto readResult = reader_->readProcessMemory(pid_, address, scratch, size);
+        size_t got = readResult.isSuccess() ? readResult.value() : 0;
+        if (got > 0) {
+            fetch.data = scratch;
+            fetch.size = got;
+        } else if (!reader_->isProcessAlive(pid_)) {
+            fetch.abort = true;
+        } else {
+            // 跳过不可读的页，继续读取后面的数据
+            fetch.size = std::min(pageSize_ - address % pageSize_, size);
+        }
+        return fetch;
+    }
+
+private:
+    pid_t pid_;
+    size_t pageSize_;
+    const std::vector<MemoryRegion>& regions_;
+    bool skipNonResident_;
+    std::unique_ptr<ProcessManager> reader_;
+    uintptr_t windowStart_ = 0;         // entries_ 覆盖的页范围
+    uintptr_t windowEnd_ = 0;
+    std::vector<uint64_t> entries_;
+
+    bool isAnonymous(uintptr_t address) const {
+        auto it = std::upper_bound(regions_.begin(), regions_.end(), address,
+            [](uintptr_t value, const MemoryRegion& region) { return value < region.start; });
+        return it != regions_.begin() && address < (it - 1)->end && (it - 1)->isAnonymous();
+    }
+
+    /**
+     * address 所在的页是否驻留；窗口不覆盖时读取 [address, address + size) 的 pagemap
+     */
+    bool isResident(uintptr_t address, size_t size) {
+        if (address < windowStart_ || address >= windowEnd_) {
+            uintptr_t start = address / pageSize_ * pageSize_;
+            size_t count = (address + size - start + pageSize_ - 1) / pageSize_;
+            entries_.resize(count);
+            auto readResult = reader_->readPagemap(pid_, start, entries_.data(), count);
+            size_t read = readResult.isSuccess() ? readResult.value() : 0;
+            if (read == 0) {
+                // 没有 ptrace 读权限等情况下退回直接读取；进程退出由读取路径报告。
+                // 整个窗口都按驻留缓存，避免对窗口内的每一页重新读取 pagemap
+                if (readResult.isError() && readResult.errorCode() != ErrorCode::ProcessGone) {
+                    skipNonResident_ = false;
+                }
+                entries_.assign(count, ProcessManager::kPagemapPresent);
+                read = count;
+            }
+            windowStart_ = start;
+            windowEnd_ = start + read * pageSize_;
+        }
+        uint64_t entry = entries_[(address - windowStart_) / pageSize_];
+        return (entry & (ProcessManager::kPagemapPresent | ProcessManager::kPagemapSwapped)) != 0;
+    }
+
+    /**
+     * address 起连续驻留（resident 为 true）或连续未驻留的字节数，不超过 size
+     */
+    size_t run(uintptr_t address, size_t size, bool resident) {
+        size_t length = 0;
+        while (length < size && isResident(address + length, size - length) == resident) {
+            length += pageSize_ - (address + length) % pageSize_;
+        }
+        return std::min(length, size);
+    }
+};
+
+} // namespace
+
+bool RegionFilter::matches(const MemoryRegion& region) const {
+    if (!region.isReadable()) {
+        return false;
+    }
+    
+    // [vvar]、[vdso]、[vsyscall]、[vectors] 等内核提供的特殊映射
+    if (!includeSpecial && region.path.compare(0, 2, "[v") == 0) {
+        return false;
+    }
+    
+    for (size_t i = 0; i < permissions.size(); ++i) {
+        if (permissions[i] == '?') {
+            continue;
+        }
+        if (i >= region.permissions.size() || region.permissions[i] != permissions[i]) {
+            return false;
+        }
+    }
+    
+    if (!pathContains.empty() && region.path.find(pathContains) == std::string::npos) {
+        return false;
+    }
+    
+    return true;
+}
+
 bool SignatureScanner::matchesPattern(
     const uint8_t* buffer,
     size_t offset,
@@ -27,20 +365,20 @@ Result<std::vector<uintptr_t>> SignatureScanner::scan(
 ) {
     // 验证输入
     if (buffer == nullptr) {
-        return Result<std::vector<uintptr_t>>::error("Buffer is null");
+        return Result<std::vector<uintptr_t>>::error(Error(ErrorCode::InvalidArgument, 0, "buffer is null"));
     }
     
     if (!pattern.isValid()) {
-        return Result<std::vector<uintptr_t>>::error("Invalid signature pattern");
+        return Result<std::vector<uintptr_t>>::error(Error(ErrorCode::InvalidPattern));
     }
     
     if (pattern.size() > bufferSize) {
         return Result<std::vector<uintptr_t>>::error(
-            "Pattern size (" + std::to_string(pattern.size()) + 
-            ") exceeds buffer size (" + std::to_string(bufferSize) + ")"
+            Error(ErrorCode::BufferTooSmall, 0, "shorter than pattern").withSize(bufferSize)
         );
     }
     
+    UKC_PROBE_START(scanStart);
     std::vector<uintptr_t> results;
     
     // 按对齐要求扫描
@@ -50,6 +388,9 @@ Result<std::vector<uintptr_t>> SignatureScanner::scan(
         }
     }
     
+    UKC_PROBE_RECORD_PER(ScanPerMB, scanStart, bufferSize, 1024 * 1024);
+    UKC_PROBE_COUNT(ScanBytes, bufferSize);
+    
     return Result<std::vector<uintptr_t>>::success(std::move(results));
 }
 
@@ -61,15 +402,92 @@ Result<uintptr_t> SignatureScanner::scanFirst(
     auto scanResult = scan(buffer, bufferSize, pattern);
     
     if (scanResult.isError()) {
-        return Result<uintptr_t>::error(scanResult.errorMessage());
+        return Result<uintptr_t>::error(scanResult.errorInfo());
     }
     
     const auto& results = scanResult.value();
     if (results.empty()) {
-        return Result<uintptr_t>::error("Pattern not found in buffer");
+        return Result<uintptr_t>::error(Error(ErrorCode::PatternNotFound).withSize(bufferSize));
     }
     
     return Result<uintptr_t>::success(results[0]);
 }
 
+Result<ProcessScanResult> SignatureScanner::scanProcess(
+    pid_t pid,
+    const std::vector<SignaturePattern>& patterns,
+    const RegionFilter& filter,
+    const ProcessScanConfig& config
+) {
+    auto patternCheck = checkPatterns(patterns);
+    if (patternCheck.isError()) {
+        return Result<ProcessScanResult>::error(patternCheck.errorInfo());
+    }
+    
+    UKC_TRACE_SCOPE("scanner.scan_process", patterns.size());
+    
+    ProcessManager processManager;
+    auto mapsResult = processManager.getMemoryMaps(pid);
+    if (mapsResult.isError()) {
+        return Result<ProcessScanResult>::error(mapsResult.errorInfo());
+    }
+    
+    ProcessScanResult result;
+    for (const auto& region : mapsResult.value()) {
+        if (filter.matches(region)) {
+            result.regions.push_back(region);
+        }
+    }
+    
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    auto makeFetcher = [pid, pageSize, &result, &config]() {
+        return ProcessFetcher(pid, pageSize, result.regions, config.skipNonResident);
+    };
+    
+    if (!scanRegions(result, patterns, patternCheck.value(), pageSize, config, makeFetcher)) {
+        return Result<ProcessScanResult>::error(
+            Error(ErrorCode::ProcessGone, 0, "exited during scan").withPid(pid)
+        );
+    }
+    return Result<ProcessScanResult>::success(std::move(result));
+}
+
+Result<ProcessScanResult> SignatureScanner::scanSnapshot(
+    const SnapshotReader& snapshot,
+    const std::vector<SignaturePattern>& patterns,
+    const RegionFilter& filter,
+    const ProcessScanConfig& config
+) {
+    auto patternCheck = checkPatterns(patterns);
+    if (patternCheck.isError()) {
+        return Result<ProcessScanResult>::error(patternCheck.errorInfo());
+    }
+    
+    UKC_TRACE_SCOPE("scanner.scan_snapshot", patterns.size());
+    
+    ProcessScanResult result;
+    for (const auto& region : snapshot.regions()) {
+        if (filter.matches(region)) {
+            result.regions.push_back(region);
+        }
+    }
+    
+    auto makeFetcher = [&snapshot]() {
+        return [&snapshot](uintptr_t address, size_t size, uint8_t* scratch) {
+            SnapshotSpan span = snapshot.span(address, size, scratch);
+            ScanFetch fetch;
+            fetch.data = span.data;
+            fetch.size = span.size;
+            fetch.abort = span.data == nullptr && span.size == 0;
+            return fetch;
+        };
+    };
+    
+    if (!scanRegions(result, patterns, patternCheck.value(), snapshot.info().pageSize,
+                     config, makeFetcher)) {
+        return Result<ProcessScanResult>::error(Error(ErrorCode::InvalidAddress, 0, "snapshot"));
+    }
+    return Result<ProcessScanResult>::success(std::move(result));
+}
+
 } // namespace ukc
@@ -0,0 +1,390 @@
+#include "snapshot_store.h"
+#include "xxhash64.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ukc {
+
+namespace {
+
+constexpr char kIndexMagic[8] = {'U', 'K', 'C', 'S', 'T', 'O', 'R', '\0'};
+constexpr uint32_t kIndexVersion = 1;
+
+// 新增页先进入写缓冲，凑满后一次写入 pages.dat
+constexpr size_t kWriteBufferPages = 256;
+
+struct IndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t pageSize;
+};
+
+Result<void> writeFully(int fd, const void* data, size_t size, uint64_t offset, const char* context) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        ssize_t written = pwrite(fd, p, size, static_cast<off_t>(offset));
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return Result<void>::error(Error(ErrorCode::WriteFailed, errno, context).withAddress(offset));
+        }
+        p += written;
+        size -= static_cast<size_t>(written);
+        offset += static_cast<uint64_t>(written);
+    }
+    return Result<void>::success();
+}
+
+bool readFully(int fd, void* data, size_t size, uint64_t offset) {
+    uint8_t* p = static_cast<uint8_t*>(data);
+    while (size > 0) {
+        ssize_t got = pread(fd, p, size, static_cast<off_t>(offset));
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            return false;
+        }
+        p += got;
+        size -= static_cast<size_t>(got);
+        offset += static_cast<uint64_t>(got);
+    }
+    return true;
+}
+
+} // namespace
+
+Result<SnapshotStore> SnapshotStore::open(const std::string& directory, size_t pageSize) {
+    if (pageSize == 0) {
+        pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        return Result<SnapshotStore>::error(
+            Error(ErrorCode::Unavailable, errno, "snapshot store mkdir").withName(directory)
+        );
+    }
+    char resolved[PATH_MAX];
+    if (realpath(directory.c_str(), resolved) == nullptr) {
+        return Result<SnapshotStore>::error(
+            Error(ErrorCode::Unavailable, errno, "snapshot store path").withName(directory)
+        );
+    }
+    std::string base(resolved);
+
+    SnapshotStore store;
+    store.pageSize_ = pageSize;
+    store.dataPath_ = base + "/pages.dat";
+    std::string indexPath = base + "/pages.idx";
+
+    store.indexFd_ = ::open(indexPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (store.indexFd_ < 0) {
+        return Result<SnapshotStore>::error(
+            Error(ErrorCode::Unavailable, errno, "snapshot store index").withName(indexPath)
+        );
+    }
+    if (flock(store.indexFd_, LOCK_EX | LOCK_NB) != 0) {
+        return Result<SnapshotStore>::error(
+            Error(ErrorCode::Unavailable, errno, "snapshot store locked").withName(indexPath)
+        );
+    }
+    store.dataFd_ = ::open(store.dataPath_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (store.dataFd_ < 0) {
+        return Result<SnapshotStore>::error(
+            Error(ErrorCode::Unavailable, errno, "snapshot store data").withName(store.dataPath_)
+        );
+    }
+
+    struct stat indexStat;
+    if (fstat(store.indexFd_, &indexStat) != 0) {
+        return Result<SnapshotStore>::error(
+            Error(ErrorCode::Unavailable, errno, "snapshot store index").withName(indexPath)
+        );
+    }
+
+    IndexHeader header;
+    if (indexStat.st_size == 0) {
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, kIndexMagic, sizeof(kIndexMagic));
+        header.version = kIndexVersion;
+        header.pageSize = static_cast<uint32_t>(pageSize);
+        auto result = writeFully(store.indexFd_, &header, sizeof(header), 0, "snapshot store index");
+        if (result.isError()) {
+            return Result<SnapshotStore>::error(result.errorInfo());
+        }
+        store.indexSize_ = sizeof(header);
+    } else {
+        if (!readFully(store.indexFd_, &header, sizeof(header), 0) ||
+            std::memcmp(header.magic, kIndexMagic, sizeof(kIndexMagic)) != 0 ||
+            header.version != kIndexVersion) {
+            return Result<SnapshotStore>::error(
+                Error(ErrorCode::InvalidArgument, 0, "not a snapshot store").withName(indexPath)
+            );
+        }
+        if (header.pageSize != pageSize) {
+            return Result<SnapshotStore>::error(
+                Error(ErrorCode::InvalidArgument, 0, "snapshot store page size").withSize(header.pageSize)
+            );
+        }
+
+        // 末尾不完整的记录（写入中断）被忽略并在下次追加时覆盖
+        size_t recordCount = (static_cast<size_t>(indexStat.st_size) - sizeof(header)) / sizeof(IndexRecord);
+        std::vector<IndexRecord> records(recordCount);
+        if (!readFully(store.indexFd_, records.data(), recordCount * sizeof(IndexRecord), sizeof(header))) {
+            return Result<SnapshotStore>::error(
+                Error(ErrorCode::ReadFailed, errno, "snapshot store index").withName(indexPath)
+            );
+        }
+        store.index_.reserve(recordCount);
+        for (const auto& record : records) {
+            if (record.offset % pageSize != 0) {
+                continue;
+            }
+            store.index_.emplace(record.hash, record.offset);
+            store.dataSize_ = std::max<uint64_t>(store.dataSize_, record.offset + pageSize);
+        }
+        store.indexSize_ = sizeof(header) + recordCount * sizeof(IndexRecord);
+    }
+
+    // 没有索引记录的页（flush 中断）不会被任何快照引用，截掉
+    struct stat dataStat;
+    if (fstat(store.dataFd_, &dataStat) != 0 || static_cast<uint64_t>(dataStat.st_size) < store.dataSize_) {
+        return Result<SnapshotStore>::error(
+            Error(ErrorCode::InvalidArgument, 0, "snapshot store data truncated").withName(store.dataPath_)
+        );
+    }
+    if (static_cast<uint64_t>(dataStat.st_size) > store.dataSize_ &&
+        ftruncate(store.dataFd_, static_cast<off_t>(store.dataSize_)) != 0) {
+        return Result<SnapshotStore>::error(
+            Error(ErrorCode::WriteFailed, errno, "snapshot store data").withName(store.dataPath_)
+        );
+    }
+    store.flushedSize_ = store.dataSize_;
+    store.compareBuffer_.resize(pageSize);
+
+    std::string dirtyPath = base + "/dirty.log";
+    store.dirtyFd_ = ::open(dirtyPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    struct stat dirtyStat;
+    if (store.dirtyFd_ < 0 || fstat(store.dirtyFd_, &dirtyStat) != 0) {
+        return Result<SnapshotStore>::error(
+            Error(ErrorCode::Unavailable, errno, "snapshot store dirty log").withName(dirtyPath)
+        );
+    }
+    // 同一进程以最后一条记录为准；末尾不完整的记录同样被忽略
+    size_t dirtyCount = static_cast<size_t>(dirtyStat.st_size) / sizeof(DirtyRecord);
+    std::vector<DirtyRecord> dirtyRecords(dirtyCount);
+    if (!readFully(store.dirtyFd_, dirtyRecords.data(), dirtyCount * sizeof(DirtyRecord), 0)) {
+        return Result<SnapshotStore>::error(
+            Error(ErrorCode::ReadFailed, errno, "snapshot store dirty log").withName(dirtyPath)
+        );
+    }
+    for (const auto& record : dirtyRecords) {
+        store.dirtyGenerations_[static_cast<pid_t>(record.pid)] = record.generation;
+        store.lastGeneration_ = std::max(store.lastGeneration_, record.generation);
+    }
+    store.dirtySize_ = dirtyCount * sizeof(DirtyRecord);
+
+    return Result<SnapshotStore>::success(std::move(store));
+}
+
+SnapshotStore::~SnapshotStore() {
+    if (dataFd_ >= 0) {
+        (void)flush();
+    }
+    closeFiles();
+}
+
+SnapshotStore::SnapshotStore(SnapshotStore&& other) noexcept
+    : dataFd_(other.dataFd_),
+      indexFd_(other.indexFd_),
+      dirtyFd_(other.dirtyFd_),
+      dataPath_(std::move(other.dataPath_)),
+      pageSize_(other.pageSize_),
+      dataSize_(other.dataSize_),
+      flushedSize_(other.flushedSize_),
+      indexSize_(other.indexSize_),
+      index_(std::move(other.index_)),
+      pending_(std::move(other.pending_)),
+      writeBuffer_(std::move(other.writeBuffer_)),
+      compareBuffer_(std::move(other.compareBuffer_)),
+      dirtySize_(other.dirtySize_),
+      lastGeneration_(other.lastGeneration_),
+      dirtyGenerations_(std::move(other.dirtyGenerations_)) {
+    other.dataFd_ = -1;
+    other.indexFd_ = -1;
+    other.dirtyFd_ = -1;
+}
+
+SnapshotStore& SnapshotStore::operator=(SnapshotStore&& other) noexcept {
+    if (this != &other) {
+        if (dataFd_ >= 0) {
+            (void)flush();
+        }
+        closeFiles();
+        dataFd_ = other.dataFd_;
+        indexFd_ = other.indexFd_;
+        dirtyFd_ = other.dirtyFd_;
+        dataPath_ = std::move(other.dataPath_);
+        pageSize_ = other.pageSize_;
+        dataSize_ = other.dataSize_;
+        flushedSize_ = other.flushedSize_;
+        indexSize_ = other.indexSize_;
+        index_ = std::move(other.index_);
+        pending_ = std::move(other.pending_);
+        writeBuffer_ = std::move(other.writeBuffer_);
+        compareBuffer_ = std::move(other.compareBuffer_);
+        dirtySize_ = other.dirtySize_;
+        lastGeneration_ = other.lastGeneration_;
+        dirtyGenerations_ = std::move(other.dirtyGenerations_);
+        other.dataFd_ = -1;
+        other.indexFd_ = -1;
+        other.dirtyFd_ = -1;
+    }
+    return *this;
+}
+
+void SnapshotStore::closeFiles() {
+    if (dataFd_ >= 0) {
+        close(dataFd_);
+        dataFd_ = -1;
+    }
+    if (indexFd_ >= 0) {
+        close(indexFd_);
+        indexFd_ = -1;
+    }
+    if (dirtyFd_ >= 0) {
+        close(dirtyFd_);
+        dirtyFd_ = -1;
+    }
+}
+
+Result<bool> SnapshotStore::samePage(uint64_t offset, const uint8_t* page) {
+    if (offset >= flushedSize_) {
+        return Result<bool>::success(
+            std::memcmp(writeBuffer_.data() + (offset - flushedSize_), page, pageSize_) == 0
+        );
+    }
+    if (!readFully(dataFd_, compareBuffer_.data(), pageSize_, offset)) {
+        return Result<bool>::error(
+            Error(ErrorCode::ReadFailed, errno, "snapshot store data").withAddress(offset)
+        );
+    }
+    return Result<bool>::success(std::memcmp(compareBuffer_.data(), page, pageSize_) == 0);
+}
+
+Result<uint64_t> SnapshotStore::put(const uint8_t* page, bool* existed) {
+    if (dataFd_ < 0) {
+        return Result<uint64_t>::error(Error(ErrorCode::NotInitialized, 0, "SnapshotStore"));
+    }
+
+    uint64_t hash = xxhash64(page, pageSize_);
+    auto range = index_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        auto same = samePage(it->second, page);
+        if (same.isError()) {
+            return Result<uint64_t>::error(same.errorInfo());
+        }
+        if (same.value()) {
+            if (existed) {
+                *existed = true;
+            }
+            return Result<uint64_t>::success(it->second);
+        }
+    }
+
+    if (writeBuffer_.size() >= kWriteBufferPages * pageSize_) {
+        auto result = flushData();
+        if (result.isError()) {
+            return Result<uint64_t>::error(result.errorInfo());
+        }
+    }
+
+    uint64_t offset = dataSize_;
+    writeBuffer_.insert(writeBuffer_.end(), page, page + pageSize_);
+    dataSize_ += pageSize_;
+    index_.emplace(hash, offset);
+    pending_.push_back(IndexRecord{hash, offset});
+    if (existed) {
+        *existed = false;
+    }
+    return Result<uint64_t>::success(offset);
+}
+
+Result<void> SnapshotStore::flushData() {
+    if (writeBuffer_.empty()) {
+        return Result<void>::success();
+    }
+    auto result = writeFully(dataFd_, writeBuffer_.data(), writeBuffer_.size(), flushedSize_,
+                             "snapshot store data");
+    if (result.isError()) {
+        return result;
+    }
+    flushedSize_ += writeBuffer_.size();
+    writeBuffer_.clear();
+    return Result<void>::success();
+}
+
+Result<void> SnapshotStore::flush() {
+    if (dataFd_ < 0) {
+        return Result<void>::error(Error(ErrorCode::NotInitialized, 0, "SnapshotStore"));
+    }
+
+    // 先写数据再写索引，且数据落盘后才追加索引：崩溃时只会留下没有索引的页，
+    // 下次打开时被截掉，不会出现索引指向未落盘的页
+    auto result = flushData();
+    if (result.isError() || pending_.empty()) {
+        return result;
+    }
+    if (fdatasync(dataFd_) != 0) {
+        return Result<void>::error(
+            Error(ErrorCode::WriteFailed, errno, "snapshot store data sync").withName(dataPath_)
+        );
+    }
+    result = writeFully(indexFd_, pending_.data(), pending_.size() * sizeof(IndexRecord), indexSize_,
+                        "snapshot store index");
+    if (result.isError()) {
+        return result;
+    }
+    if (fdatasync(indexFd_) != 0) {
+        return Result<void>::error(Error(ErrorCode::WriteFailed, errno, "snapshot store index sync"));
+    }
+    indexSize_ += pending_.size() * sizeof(IndexRecord);
+    pending_.clear();
+    return Result<void>::success();
+}
+
+uint64_t SnapshotStore::dirtyGeneration(pid_t pid) const {
+    auto it = dirtyGenerations_.find(pid);
+    return it == dirtyGenerations_.end() ? 0 : it->second;
+}
+
+Result<uint64_t> SnapshotStore::beginDirtyGeneration(pid_t pid) {
+    if (dirtyFd_ < 0) {
+        return Result<uint64_t>::error(Error(ErrorCode::NotInitialized, 0, "SnapshotStore"));
+    }
+
+    DirtyRecord record{static_cast<int32_t>(pid), 0, lastGeneration_ + 1};
+    auto result = writeFully(dirtyFd_, &record, sizeof(record), dirtySize_, "snapshot store dirty log");
+    if (result.isError()) {
+        return Result<uint64_t>::error(result.errorInfo());
+    }
+    if (fdatasync(dirtyFd_) != 0) {
+        return Result<uint64_t>::error(
+            Error(ErrorCode::WriteFailed, errno, "snapshot store dirty log sync").withPid(pid)
+        );
+    }
+    dirtySize_ += sizeof(record);
+    lastGeneration_ = record.generation;
+    dirtyGenerations_[pid] = record.generation;
+    return Result<uint64_t>::success(record.generation);
+}
+
+} // namespace ukc
@@ -123,7 +123,7 @@ Result<bool> StealthVerifier::verifyStealthOperation(
     // 检查是否有新的模块被加载
     auto modulesResult = hasNewModulesLoaded(before, after);
     if (modulesResult.isError()) {
-        return Result<bool>::error(modulesResult.errorMessage());
+        return Result<bool>::error(modulesResult.errorInfo());
     }
     if (modulesResult.value()) {
         return Result<bool>::success(false);
@@ -132,7 +132,7 @@ Result<bool> StealthVerifier::verifyStealthOperation(
     // 检查是否有新的持久化文件
     auto filesResult = hasNewPersistentFiles(before, after);
     if (filesResult.isError()) {
-        return Result<bool>::error(filesResult.errorMessage());
+        return Result<bool>::error(filesResult.errorInfo());
     }
     if (filesResult.value()) {
         return Result<bool>::success(false);
@@ -141,7 +141,7 @@ Result<bool> StealthVerifier::verifyStealthOperation(
     // 检查资源是否被正确清理
     auto resourcesResult = areResourcesCleaned(before, after);
     if (resourcesResult.isError()) {
-        return Result<bool>::error(resourcesResult.errorMessage());
+        return Result<bool>::error(resourcesResult.errorInfo());
     }
     if (!resourcesResult.value()) {
         return Result<bool>::success(false);
@@ -0,0 +1,241 @@
+#include "trace_recorder.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace ukc {
+
+namespace detail {
+
+/**
+ * 单个线程的环形缓冲区
+ * 只有所属线程写入 events 和 head；读者通过 head 判断哪些事件仍然有效。
+ */
+struct TraceBuffer {
+    std::vector<TraceEvent> events;
+    std::atomic<uint64_t> head{0};     // 已写入的事件总数
+    std::atomic<uint64_t> base{0};     // clear() 时的 head，之前的事件视为已清除
+    int threadId = 0;
+
+    explicit TraceBuffer(size_t capacity)
+        : events(capacity), threadId(static_cast<int>(syscall(SYS_gettid))) {}
+};
+
+} // namespace detail
+
+namespace {
+
+std::atomic<uint64_t> nextRecorderId{1};
+
+/**
+ * 线程局部的缓冲区缓存，结构与 PerformanceMonitor 的分片缓存相同
+ */
+struct TraceBufferCache {
+    uint64_t recorderId = 0;
+    detail::TraceBuffer* buffer = nullptr;
+    std::map<uint64_t, std::shared_ptr<detail::TraceBuffer>> buffers;
+};
+
+thread_local TraceBufferCache bufferCache;
+
+void appendJsonString(std::string& out, const char* value) {
+    out.push_back('"');
+    for (const char* p = value; *p; ++p) {
+        char c = *p;
+        if (c == '"' || c == '\\') {
+            out.push_back('\\');
+            out.push_back(c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+            out += escaped;
+        } else {
+            out.push_back(c);
+        }
+    }
+    out.push_back('"');
+}
+
+} // anonymous namespace
+
+TraceRecorder::TraceRecorder(size_t capacityPerThread)
+    : recorderId_(nextRecorderId.fetch_add(1, std::memory_order_relaxed)),
+      capacity_(std::max<size_t>(capacityPerThread, 1)) {
+}
+
+TraceRecorder::~TraceRecorder() = default;
+
+TraceRecorder& TraceRecorder::global() {
+    // 有意不析构：其他静态对象的析构函数中仍可能触发探针
+    static TraceRecorder* instance = new TraceRecorder();
+    return *instance;
+}
+
+uint64_t TraceRecorder::now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+void TraceRecorder::record(TracePhase phase, const char* name, uint64_t arg) {
+    detail::TraceBuffer& buffer = localBuffer();
+
+    uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    TraceEvent& event = buffer.events[head % capacity_];
+    event.timestampNs = now();
+    event.name = name;
+    event.arg = arg;
+    event.phase = phase;
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+detail::TraceBuffer& TraceRecorder::localBuffer() {
+    if (bufferCache.recorderId == recorderId_) {
+        return *bufferCache.buffer;
+    }
+
+    auto it = bufferCache.buffers.find(recorderId_);
+    if (it == bufferCache.buffers.end()) {
+        // 清理已销毁记录器遗留的缓冲区
+        for (auto stale = bufferCache.buffers.begin(); stale != bufferCache.buffers.end();) {
+            if (stale->second.use_count() == 1) {
+                stale = bufferCache.buffers.erase(stale);
+            } else {
+                ++stale;
+            }
+        }
+
+        auto buffer = std::make_shared<detail::TraceBuffer>(capacity_);
+        {
+            std::lock_guard<std::mutex> lock(buffersMutex_);
+            buffers_.push_back(buffer);
+        }
+        it = bufferCache.buffers.emplace(recorderId_, std::move(buffer)).first;
+    }
+
+    bufferCache.recorderId = recorderId_;
+    bufferCache.buffer = it->second.get();
+    return *bufferCache.buffer;
+}
+
+void TraceRecorder::clear() {
+    std::lock_guard<std::mutex> lock(buffersMutex_);
+    for (const auto& buffer : buffers_) {
+        buffer->base.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+uint64_t TraceRecorder::droppedEvents() const {
+    uint64_t dropped = 0;
+
+    std::lock_guard<std::mutex> lock(buffersMutex_);
+    for (const auto& buffer : buffers_) {
+        uint64_t written = buffer->head.load(std::memory_order_acquire) -
+                           buffer->base.load(std::memory_order_relaxed);
+        if (written > capacity_) {
+            dropped += written - capacity_;
+        }
+    }
+
+    return dropped;
+}
+
+std::vector<TraceRecorder::ThreadEvents> TraceRecorder::collect() const {
+    std::vector<ThreadEvents> result;
+
+    std::lock_guard<std::mutex> lock(buffersMutex_);
+    for (const auto& buffer : buffers_) {
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        uint64_t first = std::max(buffer->base.load(std::memory_order_relaxed),
+                                  head > capacity_ ? head - capacity_ : 0);
+        if (first >= head) {
+            continue;
+        }
+
+        ThreadEvents thread;
+        thread.threadId = buffer->threadId;
+        thread.events.reserve(static_cast<size_t>(head - first));
+        for (uint64_t i = first; i < head; ++i) {
+            thread.events.push_back(buffer->events[i % capacity_]);
+        }
+
+        // 复制期间写者可能已经绕回，丢弃被覆盖的部分
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t headAfter = buffer->head.load(std::memory_order_relaxed);
+        if (headAfter > capacity_ && headAfter - capacity_ > first) {
+            size_t overwritten = static_cast<size_t>(
+                std::min(headAfter - capacity_ - first, head - first)
+            );
+            thread.events.erase(thread.events.begin(), thread.events.begin() + overwritten);
+        }
+
+        if (!thread.events.empty()) {
+            result.push_back(std::move(thread));
+        }
+    }
+
+    return result;
+}
+
+std::string TraceRecorder::toChromeJson() const {
+    const int pid = static_cast<int>(getpid());
+    std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool firstEvent = true;
+    char number[64];
+
+    for (const auto& thread : collect()) {
+        for (const auto& event : thread.events) {
+            if (!firstEvent) {
+                out.push_back(',');
+            }
+            firstEvent = false;
+
+            out += "{\"name\":";
+            appendJsonString(out, event.name ? event.name : "");
+            out += ",\"ph\":\"";
+            out.push_back(static_cast<char>(event.phase));
+            // ts 单位为微秒，保留纳秒精度
+            std::snprintf(number, sizeof(number), "\",\"ts\":%llu.%03llu,\"pid\":%d,\"tid\":%d",
+                          static_cast<unsigned long long>(event.timestampNs / 1000),
+                          static_cast<unsigned long long>(event.timestampNs % 1000),
+                          pid, thread.threadId);
+            out += number;
+            if (event.phase == TracePhase::Instant) {
+                out += ",\"s\":\"t\"";
+            }
+            if (event.arg != 0) {
+                std::snprintf(number, sizeof(number), ",\"args\":{\"value\":%llu}",
+                              static_cast<unsigned long long>(event.arg));
+                out += number;
+            }
+            out.push_back('}');
+        }
+    }
+
+    out += "]}\n";
+    return out;
+}
+
+Result<void> TraceRecorder::writeChromeJson(const std::string& path) const {
+    std::string json = toChromeJson();
+
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        return Result<void>::error("Cannot open " + path + ": " + std::strerror(errno));
+    }
+
+    size_t written = std::fwrite(json.data(), 1, json.size(), file);
+    bool closed = std::fclose(file) == 0;
+    if (written != json.size() || !closed) {
+        return Result<void>::error("Write to " + path + " failed");
+    }
+
+    return Result<void>::success();
+}
+
+} // namespace ukc
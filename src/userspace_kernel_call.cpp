@@ -3,11 +3,33 @@
 #include "kernel_caller.h"
 #include "process_manager.h"
 #include "memory_injector.h"
+#include "probes.h"
+#include "executor.h"
+#include "read_coalescer.h"
+#include <chrono>
 
 namespace ukc {
 
+namespace {
+
+/**
+ * 立即就绪的 future，用于参数或状态错误
+ */
+template<typename T>
+std::future<T> readyFuture(T value) {
+    std::promise<T> promise;
+    promise.set_value(std::move(value));
+    return promise.get_future();
+}
+
+} // namespace
+
 UserspaceKernelCall::UserspaceKernelCall() = default;
 
+UserspaceKernelCall::UserspaceKernelCall(ExecutorConfig executorConfig)
+    : executorConfig_(std::move(executorConfig)) {
+}
+
 UserspaceKernelCall::~UserspaceKernelCall() = default;
 
 Result<void> UserspaceKernelCall::initialize() {
@@ -15,69 +37,293 @@ Result<void> UserspaceKernelCall::initialize() {
         return Result<void>::success();
     }
     
-    // 创建组件
+    UKC_TRACE_SCOPE("ukc.initialize", 0);
+    
+    // 只创建组件，初始化推迟到第一次使用
     locator_ = std::make_shared<KernelFunctionLocator>();
     caller_ = std::make_shared<KernelCaller>();
     processManager_ = std::make_shared<ProcessManager>();
     injector_ = std::make_shared<MemoryInjector>();
     
-    // 初始化定位器
-    auto locatorResult = locator_->initialize();
-    if (locatorResult.isError()) {
-        return locatorResult;
+    initialized_ = true;
+    return Result<void>::success();
+}
+
+std::future<Result<void>> UserspaceKernelCall::warmup(Subsystem subsystems) {
+    auto ready = require(Subsystem::Executor);
+    if (ready.isError()) {
+        return readyFuture(std::move(ready));
     }
     
-    // 初始化调用器
-    auto callerResult = caller_->initialize();
-    if (callerResult.isError()) {
-        return callerResult;
+    return executor_->async([this, subsystems]() {
+        UKC_TRACE_SCOPE("ukc.warmup", static_cast<uint32_t>(subsystems));
+        Result<void> first = Result<void>::success();
+        auto warm = [&](Subsystem subsystem, Result<void> (UserspaceKernelCall::*ensureFn)()) {
+            if ((subsystems & subsystem) == Subsystem::None) {
+                return;
+            }
+            auto result = (this->*ensureFn)();
+            if (result.isError() && first.isSuccess()) {
+                first = std::move(result);
+            }
+        };
+        warm(Subsystem::Injector, &UserspaceKernelCall::ensureInjector);
+        warm(Subsystem::Locator, &UserspaceKernelCall::ensureLocator);
+        warm(Subsystem::Caller, &UserspaceKernelCall::ensureCaller);
+        return first;
+    });
+}
+
+Subsystem UserspaceKernelCall::readySubsystems() const {
+    return static_cast<Subsystem>(ready_.load(std::memory_order_acquire));
+}
+
+template<typename F>
+Result<void> UserspaceKernelCall::ensure(LazyInit& init, Subsystem subsystem, F&& initializer) {
+    std::call_once(init.once, [&]() {
+        auto result = initializer();
+        if (result.isError()) {
+            init.error = result.errorInfo();
+        } else {
+            ready_.fetch_or(static_cast<uint32_t>(subsystem), std::memory_order_release);
+        }
+    });
+    if (init.error.code() != ErrorCode::None) {
+        return Result<void>::error(init.error);
     }
-    
-    // 初始化注入器
-    auto injectorResult = injector_->initialize(locator_, caller_, processManager_);
-    if (injectorResult.isError()) {
-        return injectorResult;
+    return Result<void>::success();
+}
+
+Result<void> UserspaceKernelCall::require(Subsystem subsystems) {
+    if (!initialized_) {
+        return Result<void>::error("System not initialized");
     }
     
-    initialized_ = true;
+    if ((subsystems & Subsystem::Executor) != Subsystem::None) {
+        auto result = ensureExecutor();
+        if (result.isError()) {
+            return result;
+        }
+    }
+    if ((subsystems & Subsystem::Injector) != Subsystem::None) {
+        auto result = ensureInjector();
+        if (result.isError()) {
+            return result;
+        }
+    }
+    if ((subsystems & Subsystem::Locator) != Subsystem::None) {
+        auto result = ensureLocator();
+        if (result.isError()) {
+            return result;
+        }
+    }
+    if ((subsystems & Subsystem::Caller) != Subsystem::None) {
+        auto result = ensureCaller();
+        if (result.isError()) {
+            return result;
+        }
+    }
     return Result<void>::success();
 }
 
+Result<void> UserspaceKernelCall::ensureExecutor() {
+    return ensure(executorInit_, Subsystem::Executor, [this]() {
+        UKC_TRACE_SCOPE("ukc.initialize.executor", 0);
+        executor_ = std::make_unique<Executor>(executorConfig_);
+        return Result<void>::success();
+    });
+}
+
+Result<void> UserspaceKernelCall::ensureInjector() {
+    // 注入器只保存定位器和调用器的指针，不需要它们已经初始化
+    return ensure(injectorInit_, Subsystem::Injector, [this]() {
+        auto executorResult = ensureExecutor();
+        if (executorResult.isError()) {
+            return executorResult;
+        }
+        UKC_TRACE_SCOPE("ukc.initialize.injector", 0);
+        injector_->setExecutor(executor_.get());
+        return injector_->initialize(locator_, caller_, processManager_);
+    });
+}
+
+Result<void> UserspaceKernelCall::ensureLocator() {
+    return ensure(locatorInit_, Subsystem::Locator, [this]() {
+        // 共享执行器先于定位器创建，kallsyms 解析即可并行。parallelFor 的调用线程
+        // 不执行队列中的其他任务，在 call_once 内解析不会被 locateFunctionsAsync 等任务重入
+        auto executorResult = ensureExecutor();
+        if (executorResult.isError()) {
+            return executorResult;
+        }
+        UKC_TRACE_SCOPE("ukc.initialize.locator", 0);
+        locator_->setExecutor(executor_.get());
+        return locator_->initialize();
+    });
+}
+
+Result<void> UserspaceKernelCall::ensureCaller() {
+    return ensure(callerInit_, Subsystem::Caller, [this]() {
+        UKC_TRACE_SCOPE("ukc.initialize.caller", 0);
+        return caller_->initialize();
+    });
+}
+
+Result<ProcessHandle> UserspaceKernelCall::openProcess(pid_t pid) {
+    if (!initialized_) {
+        return Result<ProcessHandle>::error("System not initialized");
+    }
+    
+    return ProcessHandle::open(pid);
+}
+
 Result<std::vector<uint8_t>> UserspaceKernelCall::readMemory(
     pid_t targetPid,
     uintptr_t address,
     size_t size
 ) {
-    if (!initialized_) {
-        return Result<std::vector<uint8_t>>::error("System not initialized");
+    auto ready = require(Subsystem::Injector);
+    if (ready.isError()) {
+        return Result<std::vector<uint8_t>>::error(ready.errorInfo());
     }
     
     return injector_->readMemory(targetPid, address, size);
 }
 
+Result<std::vector<uint8_t>> UserspaceKernelCall::readMemory(
+    const ProcessHandle& process,
+    uintptr_t address,
+    size_t size
+) {
+    auto ready = require(Subsystem::Injector);
+    if (ready.isError()) {
+        return Result<std::vector<uint8_t>>::error(ready.errorInfo());
+    }
+    
+    return injector_->readMemory(process, address, size);
+}
+
+Result<size_t> UserspaceKernelCall::readMemoryInto(
+    pid_t targetPid,
+    uintptr_t address,
+    uint8_t* buffer,
+    size_t size
+) {
+    auto ready = require(Subsystem::Injector);
+    if (ready.isError()) {
+        return Result<size_t>::error(ready.errorInfo());
+    }
+    
+    return injector_->readMemoryInto(targetPid, address, buffer, size);
+}
+
+Result<size_t> UserspaceKernelCall::readMemoryInto(
+    const ProcessHandle& process,
+    uintptr_t address,
+    uint8_t* buffer,
+    size_t size
+) {
+    auto ready = require(Subsystem::Injector);
+    if (ready.isError()) {
+        return Result<size_t>::error(ready.errorInfo());
+    }
+    
+    return injector_->readMemoryInto(process, address, buffer, size);
+}
+
 Result<size_t> UserspaceKernelCall::writeMemory(
     pid_t targetPid,
     uintptr_t address,
     const std::vector<uint8_t>& data
 ) {
-    if (!initialized_) {
-        return Result<size_t>::error("System not initialized");
+    auto ready = require(Subsystem::Injector | Subsystem::Caller);
+    if (ready.isError()) {
+        return Result<size_t>::error(ready.errorInfo());
     }
     
     return injector_->writeMemory(targetPid, address, data);
 }
 
+Result<size_t> UserspaceKernelCall::writeMemory(
+    const ProcessHandle& process,
+    uintptr_t address,
+    const std::vector<uint8_t>& data
+) {
+    auto ready = require(Subsystem::Injector | Subsystem::Caller);
+    if (ready.isError()) {
+        return Result<size_t>::error(ready.errorInfo());
+    }
+    
+    return injector_->writeMemory(process, address, data);
+}
+
 Result<void> UserspaceKernelCall::batchOperations(
     pid_t targetPid,
     std::vector<MemoryOperation>& operations
 ) {
-    if (!initialized_) {
-        return Result<void>::error("System not initialized");
+    auto ready = require(Subsystem::Injector | Subsystem::Caller);
+    if (ready.isError()) {
+        return ready;
     }
     
     return injector_->batchOperations(targetPid, operations);
 }
 
+Result<void> UserspaceKernelCall::batchOperations(
+    pid_t targetPid,
+    std::vector<MemoryOperation>& operations,
+    const BatchPlanner& planner,
+    BatchPlanStats* stats
+) {
+    auto ready = require(Subsystem::Injector | Subsystem::Caller);
+    if (ready.isError()) {
+        return ready;
+    }
+    
+    return injector_->batchOperations(targetPid, operations, planner, stats);
+}
+
+Result<void> UserspaceKernelCall::batchOperations(
+    pid_t targetPid,
+    std::vector<MemoryOperation>& operations,
+    ReadEngine& engine,
+    ReadEngineStats* stats
+) {
+    auto ready = require(Subsystem::Injector | Subsystem::Caller);
+    if (ready.isError()) {
+        return ready;
+    }
+    
+    return injector_->batchOperations(targetPid, operations, engine, stats);
+}
+
+Result<size_t> UserspaceKernelCall::batchRead(
+    pid_t targetPid,
+    const std::vector<BatchReadRequest>& requests,
+    std::vector<BatchReadResult>& results,
+    BatchArena& arena
+) {
+    auto ready = require(Subsystem::Injector);
+    if (ready.isError()) {
+        return Result<size_t>::error(ready.errorInfo());
+    }
+    
+    return injector_->batchRead(targetPid, requests, results, arena);
+}
+
+Result<size_t> UserspaceKernelCall::batchRead(
+    const ProcessHandle& process,
+    const std::vector<BatchReadRequest>& requests,
+    std::vector<BatchReadResult>& results,
+    BatchArena& arena
+) {
+    auto ready = require(Subsystem::Injector);
+    if (ready.isError()) {
+        return Result<size_t>::error(ready.errorInfo());
+    }
+    
+    return injector_->batchRead(process, requests, results, arena);
+}
+
 Result<pid_t> UserspaceKernelCall::findProcessByName(const std::string& processName) {
     if (!initialized_) {
         return Result<pid_t>::error("System not initialized");
@@ -94,4 +340,122 @@ Result<std::vector<MemoryRegion>> UserspaceKernelCall::getProcessMemoryMaps(pid_
     return processManager_->getMemoryMaps(pid);
 }
 
+Result<std::vector<MemoryRegion>> UserspaceKernelCall::getProcessMemoryMaps(const ProcessHandle& process) {
+    if (!initialized_) {
+        return Result<std::vector<MemoryRegion>>::error("System not initialized");
+    }
+    
+    return processManager_->getMemoryMaps(process);
+}
+
+Result<ProcessScanResult> UserspaceKernelCall::scanProcess(
+    pid_t pid,
+    const std::vector<SignaturePattern>& patterns,
+    const RegionFilter& filter
+) {
+    auto ready = require(Subsystem::Executor);
+    if (ready.isError()) {
+        return Result<ProcessScanResult>::error(ready.errorInfo());
+    }
+    
+    ProcessScanConfig config;
+    config.executor = executor_.get();
+    return SignatureScanner::scanProcess(pid, patterns, filter, config);
+}
+
+Result<void> UserspaceKernelCall::ensureAsync() {
+    auto ready = require(Subsystem::Executor | Subsystem::Injector);
+    if (ready.isError()) {
+        return ready;
+    }
+    std::call_once(asyncOnce_, [this]() {
+        coalescer_ = std::make_unique<ReadCoalescer>(injector_, *executor_);
+        asyncReady_.store(true, std::memory_order_release);
+    });
+    return Result<void>::success();
+}
+
+std::future<Result<std::vector<uint8_t>>> UserspaceKernelCall::readMemoryAsync(
+    pid_t targetPid,
+    uintptr_t address,
+    size_t size
+) {
+    auto ready = ensureAsync();
+    if (ready.isError()) {
+        return readyFuture(Result<std::vector<uint8_t>>::error(ready.errorInfo()));
+    }
+    
+    return coalescer_->read(targetPid, address, size);
+}
+
+std::future<Result<ProcessScanResult>> UserspaceKernelCall::scanAsync(
+    pid_t pid,
+    std::vector<SignaturePattern> patterns,
+    RegionFilter filter
+) {
+    auto ready = require(Subsystem::Executor);
+    if (ready.isError()) {
+        return readyFuture(Result<ProcessScanResult>::error(ready.errorInfo()));
+    }
+    
+    return executor_->async(
+        [this, pid, patterns = std::move(patterns), filter = std::move(filter)]() {
+            return scanProcess(pid, patterns, filter);
+        }
+    );
+}
+
+std::future<Result<std::vector<KernelFunctionInfo>>> UserspaceKernelCall::locateFunctionsAsync(
+    std::vector<KernelFunctionInfo> functions
+) {
+    auto ready = require(Subsystem::Executor);
+    if (ready.isError()) {
+        return readyFuture(Result<std::vector<KernelFunctionInfo>>::error(ready.errorInfo()));
+    }
+    
+    // 定位器在任务中按需初始化，第一次调用的 kallsyms 解析不阻塞调用线程
+    return executor_->async([this, functions = std::move(functions)]() mutable {
+        auto locatorResult = ensureLocator();
+        if (locatorResult.isError()) {
+            return Result<std::vector<KernelFunctionInfo>>::error(locatorResult.errorInfo());
+        }
+        std::lock_guard<std::mutex> lock(locatorMutex_);
+        for (auto& function : functions) {
+            auto located = locator_->locateFunction(function.name, function.pattern);
+            function.isLocated = located.isSuccess();
+            if (function.isLocated) {
+                function.address = located.value();
+                function.locatedTime = std::chrono::steady_clock::now();
+            }
+        }
+        return Result<std::vector<KernelFunctionInfo>>::success(std::move(functions));
+    });
+}
+
+ReadCoalescerStats UserspaceKernelCall::getReadCoalescerStats() const {
+    if (!asyncReady_.load(std::memory_order_acquire)) {
+        return ReadCoalescerStats();
+    }
+    return coalescer_->stats();
+}
+
+std::vector<ExecutorStageStats> UserspaceKernelCall::getExecutorStats() const {
+    if ((readySubsystems() & Subsystem::Executor) == Subsystem::None) {
+        return {};
+    }
+    return executor_->stageStats();
+}
+
+PerformanceMonitor& UserspaceKernelCall::getPerformanceMonitor() {
+    return probes::monitor();
+}
+
+TraceRecorder& UserspaceKernelCall::getTraceRecorder() {
+    return TraceRecorder::global();
+}
+
+bool UserspaceKernelCall::probesEnabled() const {
+    return probes::enabled();
+}
+
 } // namespace ukc
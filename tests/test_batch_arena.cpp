@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include "batch_arena.h"
+#include "memory_injector.h"
+#include "process_manager.h"
+#include "kernel_function_locator.h"
+#include "kernel_caller.h"
+#include <unistd.h>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+using namespace ukc;
+
+// GCC 会把替换后的 operator delete 误判为与 new 不匹配
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+// 统计堆分配次数，用于验证批量读取的分配次数与请求数无关
+static std::atomic<size_t> g_allocationCount{0};
+
+void* operator new(size_t size) {
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+class BatchArenaTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        processManager_ = std::make_shared<ProcessManager>();
+        ASSERT_TRUE(injector_.initialize(
+            std::make_shared<KernelFunctionLocator>(),
+            std::make_shared<KernelCaller>(),
+            processManager_
+        ).isSuccess());
+
+        auto mapsResult = processManager_->getMemoryMaps(getpid());
+        ASSERT_TRUE(mapsResult.isSuccess());
+        ASSERT_GT(mapsResult.value().size(), 0);
+        validAddr_ = mapsResult.value()[0].start;
+    }
+
+    std::shared_ptr<ProcessManager> processManager_;
+    MemoryInjector injector_;
+    uintptr_t validAddr_ = 0;
+};
+
+// Test: 自有内存模式的分配与重置
+TEST_F(BatchArenaTest, OwnedAllocate) {
+    BatchArena arena;
+    EXPECT_EQ(arena.allocate(1), nullptr);
+
+    ASSERT_TRUE(arena.reserve(64));
+    uint8_t* a = arena.allocate(16);
+    uint8_t* b = arena.allocate(48);
+    ASSERT_NE(a, nullptr);
+    EXPECT_EQ(b, a + 16);
+    EXPECT_EQ(arena.allocate(1), nullptr);
+
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0);
+    EXPECT_EQ(arena.allocate(64), a);
+}
+
+// Test: 调用方提供内存时不扩容
+TEST_F(BatchArenaTest, ExternalBuffer) {
+    uint8_t storage[32];
+    BatchArena arena(storage, sizeof(storage));
+
+    EXPECT_TRUE(arena.isExternal());
+    EXPECT_FALSE(arena.reserve(64));
+    EXPECT_EQ(arena.allocate(32), storage);
+    EXPECT_EQ(arena.allocate(1), nullptr);
+}
+
+// Test: 批量读取结果连续存放，错误以错误码表示
+TEST_F(BatchArenaTest, BatchReadResults) {
+    std::vector<BatchReadRequest> requests = {
+        {validAddr_, 8},
+        {0xFFFFFFFFFFFFF000UL, 8},
+        {validAddr_ + 8, 0},
+        {validAddr_ + 16, 4},
+    };
+    std::vector<BatchReadResult> results;
+    BatchArena arena;
+
+    auto result = injector_.batchRead(getpid(), requests, results, arena);
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_EQ(result.value(), 3);
+
+    ASSERT_EQ(results.size(), 4);
+    EXPECT_TRUE(results[0].ok());
+    EXPECT_EQ(results[0].size, 8);
+    EXPECT_EQ(results[1].error, ErrorCode::InvalidAddress);
+    EXPECT_EQ(results[1].data, nullptr);
+    EXPECT_TRUE(results[2].ok());
+    EXPECT_TRUE(results[3].ok());
+    EXPECT_EQ(results[3].data, results[0].data + 8);
+    EXPECT_EQ(arena.used(), 12);
+}
+
+// Test: 调用方缓冲区不足时单个请求失败
+TEST_F(BatchArenaTest, BatchReadExternalTooSmall) {
+    uint8_t storage[8];
+    BatchArena arena(storage, sizeof(storage));
+    std::vector<BatchReadRequest> requests = {
+        {validAddr_, 8},
+        {validAddr_, 8},
+    };
+    std::vector<BatchReadResult> results;
+
+    auto result = injector_.batchRead(getpid(), requests, results, arena);
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_EQ(result.value(), 1);
+    EXPECT_EQ(results[0].data, storage);
+    EXPECT_EQ(results[1].error, ErrorCode::BufferTooSmall);
+}
+
+// Test: 不存在的进程
+TEST_F(BatchArenaTest, BatchReadNonexistentProcess) {
+    std::vector<BatchReadRequest> requests = {{0x1000, 8}};
+    std::vector<BatchReadResult> results;
+    BatchArena arena;
+
+    EXPECT_TRUE(injector_.batchRead(99999, requests, results, arena).isError());
+}
+
+// Test: 堆分配次数与请求数无关
+TEST_F(BatchArenaTest, AllocationCountIndependentOfBatchSize) {
+    auto countAllocations = [&](size_t count) {
+        std::vector<BatchReadRequest> requests(count, BatchReadRequest{validAddr_, 8});
+        std::vector<BatchReadResult> results(count);
+        BatchArena arena;
+        arena.reserve(count * 8);
+
+        size_t before = g_allocationCount.load();
+        auto result = injector_.batchRead(getpid(), requests, results, arena);
+        size_t after = g_allocationCount.load();
+
+        EXPECT_TRUE(result.isSuccess());
+        EXPECT_EQ(result.value(), count);
+        return after - before;
+    };
+
+    size_t small = countAllocations(10);
+    size_t large = countAllocations(100000);
+
+    // 只有映射解析会分配内存，与请求数量无关（允许映射本身略有变化）
+    EXPECT_LE(large, small + 64);
+}
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include "batch_planner.h"
+#include "memory_injector.h"
+#include "process_manager.h"
+#include "kernel_function_locator.h"
+#include "kernel_caller.h"
+#include <unistd.h>
+#include <memory>
+
+using namespace ukc;
+
+class BatchPlannerTest : public ::testing::Test {
+protected:
+    static MemoryOperation makeRead(uintptr_t address, size_t size) {
+        MemoryOperation op;
+        op.type = OperationType::Read;
+        op.address = address;
+        op.size = size;
+        return op;
+    }
+
+    static MemoryOperation makeWrite(uintptr_t address, std::vector<uint8_t> data) {
+        MemoryOperation op;
+        op.type = OperationType::Write;
+        op.address = address;
+        op.data = std::move(data);
+        return op;
+    }
+};
+
+// Test: 相邻读取被合并，并按地址排序
+TEST_F(BatchPlannerTest, MergesAdjacentReads) {
+    std::vector<MemoryOperation> ops = {
+        makeRead(0x1010, 8),
+        makeRead(0x1000, 8),
+        makeRead(0x1008, 8),
+    };
+
+    BatchPlanStats stats;
+    auto steps = BatchPlanner().plan(ops, &stats);
+
+    ASSERT_EQ(steps.size(), 1);
+    EXPECT_EQ(steps[0].address, 0x1000);
+    EXPECT_EQ(steps[0].size, 0x18);
+    EXPECT_EQ(steps[0].operationIndices, (std::vector<size_t>{1, 2, 0}));
+    EXPECT_EQ(stats.readOperations, 3);
+    EXPECT_EQ(stats.transfers, 1);
+    EXPECT_EQ(stats.syscallsSaved(), 2);
+    EXPECT_EQ(stats.bytesSaved(), 0);
+}
+
+// Test: 重叠读取只传输一次
+TEST_F(BatchPlannerTest, OverlappingReadsSaveBytes) {
+    std::vector<MemoryOperation> ops = {
+        makeRead(0x2000, 16),
+        makeRead(0x2008, 16),
+    };
+
+    BatchPlanStats stats;
+    auto steps = BatchPlanner().plan(ops, &stats);
+
+    ASSERT_EQ(steps.size(), 1);
+    EXPECT_EQ(steps[0].size, 24);
+    EXPECT_EQ(stats.requestedBytes, 32);
+    EXPECT_EQ(stats.transferredBytes, 24);
+    EXPECT_EQ(stats.bytesSaved(), 8);
+}
+
+// Test: 间隙阈值控制是否合并
+TEST_F(BatchPlannerTest, GapThreshold) {
+    std::vector<MemoryOperation> ops = {
+        makeRead(0x3000, 8),
+        makeRead(0x3000 + 8 + 32, 8),
+    };
+
+    BatchPlannerConfig narrow;
+    narrow.maxGap = 16;
+    EXPECT_EQ(BatchPlanner(narrow).plan(ops).size(), 2);
+
+    BatchPlannerConfig wide;
+    wide.maxGap = 32;
+    BatchPlanStats stats;
+    auto steps = BatchPlanner(wide).plan(ops, &stats);
+    ASSERT_EQ(steps.size(), 1);
+    EXPECT_EQ(steps[0].size, 48);
+    EXPECT_EQ(stats.bytesSaved(), -32);
+}
+
+// Test: 单次传输大小上限
+TEST_F(BatchPlannerTest, MaxTransferSize) {
+    std::vector<MemoryOperation> ops = {
+        makeRead(0x4000, 64),
+        makeRead(0x4040, 64),
+        makeRead(0x4080, 64),
+    };
+
+    BatchPlannerConfig config;
+    config.maxTransferSize = 128;
+    auto steps = BatchPlanner(config).plan(ops);
+
+    ASSERT_EQ(steps.size(), 2);
+    EXPECT_EQ(steps[0].size, 128);
+    EXPECT_EQ(steps[1].size, 64);
+}
+
+// Test: 写操作作为屏障，不跨写合并读取
+TEST_F(BatchPlannerTest, WritesAreBarriers) {
+    std::vector<MemoryOperation> ops = {
+        makeRead(0x5000, 8),
+        makeWrite(0x5008, {1, 2, 3, 4}),
+        makeRead(0x5008, 8),
+    };
+
+    BatchPlanStats stats;
+    auto steps = BatchPlanner().plan(ops, &stats);
+
+    ASSERT_EQ(steps.size(), 3);
+    EXPECT_EQ(steps[0].operationIndices, (std::vector<size_t>{0}));
+    EXPECT_EQ(steps[1].operationIndices, (std::vector<size_t>{1}));
+    EXPECT_EQ(steps[2].operationIndices, (std::vector<size_t>{2}));
+    EXPECT_EQ(stats.syscallsSaved(), 0);
+}
+
+// Test: 零长度读取不参与合并
+TEST_F(BatchPlannerTest, ZeroSizeReadsStandalone) {
+    std::vector<MemoryOperation> ops = {
+        makeRead(0x6000, 0),
+        makeRead(0x6000, 8),
+    };
+
+    BatchPlanStats stats;
+    auto steps = BatchPlanner().plan(ops, &stats);
+
+    EXPECT_EQ(steps.size(), 2);
+    EXPECT_EQ(stats.readOperations, 1);
+}
+
+// Test: 通过注入器执行合并后的批量读取
+TEST_F(BatchPlannerTest, InjectorExecutesPlan) {
+    auto processManager = std::make_shared<ProcessManager>();
+    MemoryInjector injector;
+    ASSERT_TRUE(injector.initialize(
+        std::make_shared<KernelFunctionLocator>(),
+        std::make_shared<KernelCaller>(),
+        processManager
+    ).isSuccess());
+
+    pid_t currentPid = getpid();
+    auto mapsResult = processManager->getMemoryMaps(currentPid);
+    ASSERT_TRUE(mapsResult.isSuccess());
+    ASSERT_GT(mapsResult.value().size(), 0);
+    uintptr_t base = mapsResult.value()[0].start;
+
+    std::vector<MemoryOperation> ops = {
+        makeRead(base + 16, 8),
+        makeRead(base, 8),
+        makeRead(base + 4, 8),
+    };
+
+    BatchPlanStats stats;
+    auto result = injector.batchOperations(currentPid, ops, BatchPlanner(), &stats);
+    ASSERT_TRUE(result.isSuccess());
+
+    for (const auto& op : ops) {
+        EXPECT_TRUE(op.success);
+        EXPECT_EQ(op.result.size(), op.size);
+    }
+    EXPECT_EQ(stats.transfers, 1);
+    EXPECT_EQ(stats.syscallsSaved(), 2);
+}
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include "executor.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace ukc;
+
+// Test: async 返回任务结果
+TEST(ExecutorTest, AsyncReturnsValue) {
+    Executor executor(2);
+    EXPECT_EQ(executor.threadCount(), 2u);
+    
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 100; ++i) {
+        futures.push_back(executor.async([i]() { return i * i; }));
+    }
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(futures[i].get(), i * i);
+    }
+}
+
+// Test: 析构前执行完所有已提交的任务
+TEST(ExecutorTest, DrainsOnDestruction) {
+    std::atomic<int> counter{0};
+    {
+        Executor executor(1);
+        for (int i = 0; i < 1000; ++i) {
+            executor.submit([&counter]() { counter++; });
+        }
+    }
+    EXPECT_EQ(counter.load(), 1000);
+}
+
+// Test: 线程数为 0 时使用硬件并发数
+TEST(ExecutorTest, DefaultThreadCount) {
+    Executor executor;
+    EXPECT_GE(executor.threadCount(), 1u);
+}
+
+// Test: parallelFor 对每个下标恰好执行一次
+TEST(ExecutorTest, ParallelForCoversAllIndices) {
+    Executor executor(3);
+    std::vector<std::atomic<int>> hits(1000);
+    executor.parallelFor(ExecutorStage::Scan, hits.size(), [&hits](size_t i) { hits[i]++; });
+    for (const auto& hit : hits) {
+        EXPECT_EQ(hit.load(), 1);
+    }
+}
+
+// Test: 工作线程内嵌套调用 parallelFor 不会死锁
+TEST(ExecutorTest, NestedParallelFor) {
+    Executor executor(1);
+    std::atomic<int> counter{0};
+    auto future = executor.async([&executor, &counter]() {
+        executor.parallelFor(ExecutorStage::Scan, 4, [&executor, &counter](size_t) {
+            executor.parallelFor(ExecutorStage::BatchRead, 8, [&counter](size_t) { counter++; });
+        });
+    });
+    future.get();
+    EXPECT_EQ(counter.load(), 32);
+}
+
+// Test: parallelFor 的调用线程只执行自己的下标，不会顺带执行队列中的其他任务
+TEST(ExecutorTest, ParallelForDoesNotRunForeignTasks) {
+    Executor executor(1);
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::promise<void> blocked;
+    executor.submit([&blocked, released]() {
+        blocked.set_value();
+        released.wait();
+    });
+    blocked.get_future().wait();
+
+    // 唯一的工作线程被占用，这个任务只能留在队列里
+    auto foreign = executor.async([]() { return std::this_thread::get_id(); });
+
+    std::atomic<int> counter{0};
+    executor.parallelFor(ExecutorStage::Scan, 16, [&counter](size_t) { counter++; });
+    EXPECT_EQ(counter.load(), 16);
+    EXPECT_EQ(foreign.wait_for(std::chrono::milliseconds(0)), std::future_status::timeout);
+
+    release.set_value();
+    EXPECT_NE(foreign.get(), std::this_thread::get_id());
+}
+
+// Test: 各阶段分别统计任务数和并发度
+TEST(ExecutorTest, StageStats) {
+    Executor executor(2);
+    executor.parallelFor(ExecutorStage::KallsymsParse, 16, [](size_t) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }, 3);
+    executor.async([]() { return 0; }).get();
+    
+    auto stats = executor.stageStats();
+    ASSERT_EQ(stats.size(), static_cast<size_t>(ExecutorStage::Count));
+    const auto& parse = stats[static_cast<size_t>(ExecutorStage::KallsymsParse)];
+    EXPECT_STREQ(parse.name, Executor::stageName(ExecutorStage::KallsymsParse));
+    EXPECT_GE(parse.tasks, 1u);
+    EXPECT_GE(parse.peakConcurrency, 1u);
+    EXPECT_LE(parse.peakConcurrency, 3u);
+    EXPECT_GT(parse.busyTime.count(), 0);
+    EXPECT_GT(parse.wallTime.count(), 0);
+    EXPECT_GE(stats[static_cast<size_t>(ExecutorStage::Task)].tasks, 1u);
+    EXPECT_EQ(stats[static_cast<size_t>(ExecutorStage::Scan)].tasks, 0u);
+}
+
+// Test: 显式指定 CPU 时按配置绑定，大小核信息不可区分时不做筛选
+TEST(ExecutorTest, ResolveCpus) {
+    ExecutorConfig config;
+    config.cpus = {0};
+    EXPECT_EQ(Executor::resolveCpus(config), std::vector<int>{0});
+    
+    Executor executor(config);
+    EXPECT_EQ(executor.cpus(), std::vector<int>{0});
+    EXPECT_EQ(executor.async([]() { return sched_getcpu(); }).get(), 0);
+    
+    ExecutorConfig big;
+    big.cpus = {0};
+    big.corePreference = CorePreference::Big;
+    EXPECT_FALSE(Executor::resolveCpus(big).empty());
+    
+    EXPECT_FALSE(Executor::resolveCpus(ExecutorConfig()).empty());
+    EXPECT_TRUE(Executor(1).cpus().empty());
+}
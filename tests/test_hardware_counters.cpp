@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include "hardware_counters.h"
+#include "performance_monitor.h"
+#include <thread>
+
+using namespace ukc;
+
+namespace {
+
+volatile uint64_t sink = 0;
+
+void busyLoop(int iterations) {
+    for (int i = 0; i < iterations; ++i) {
+        sink = sink + static_cast<uint64_t>(i);
+    }
+}
+
+} // namespace
+
+class HardwareCountersTest : public ::testing::Test {
+protected:
+    PerformanceMonitor monitor;
+};
+
+// Test: 计数器组按线程创建
+TEST_F(HardwareCountersTest, PerThreadGroup) {
+    HardwareCounterGroup* mainGroup = HardwareCounterGroup::forCurrentThread();
+    EXPECT_EQ(HardwareCounterGroup::forCurrentThread(), mainGroup);
+
+    HardwareCounterGroup* otherGroup = nullptr;
+    std::thread([&]() {
+        otherGroup = HardwareCounterGroup::forCurrentThread();
+    }).join();
+
+    if (mainGroup) {
+        EXPECT_NE(otherGroup, mainGroup);
+    } else {
+        EXPECT_EQ(otherGroup, nullptr);
+    }
+}
+
+// Test: 读取计数增量
+TEST_F(HardwareCountersTest, MeasuresDelta) {
+    HardwareCounterGroup* group = HardwareCounterGroup::forCurrentThread();
+    if (!group) {
+        GTEST_SKIP() << "perf events unavailable";
+    }
+
+    HardwareCounterStart start;
+    ASSERT_TRUE(group->read(start.values, start.timeEnabled, start.timeRunning));
+    busyLoop(100000);
+
+    HardwareCounterValues delta;
+    ASSERT_TRUE(hardwareCounterDelta(*group, start, delta));
+    if (group->supports(HardwareEvent::Instructions)) {
+        EXPECT_GT(delta[HardwareEvent::Instructions], 100000u);
+    }
+    if (group->supports(HardwareEvent::Cycles)) {
+        EXPECT_GT(delta[HardwareEvent::Cycles], 0u);
+    }
+}
+
+// Test: 作用域计时器附带硬件计数，不可用时退化为普通计时
+TEST_F(HardwareCountersTest, ScopeWithCounters) {
+    OperationId id = monitor.registerOperation("counted_operation").value();
+    for (int i = 0; i < 10; ++i) {
+        auto timer = monitor.scopeWithCounters(id);
+        busyLoop(10000);
+    }
+
+    auto stats = monitor.getStats(id);
+    ASSERT_TRUE(stats.isSuccess());
+    EXPECT_EQ(stats.value().operationCount, 10u);
+
+    HardwareCounterGroup* group = HardwareCounterGroup::forCurrentThread();
+    if (!group) {
+        EXPECT_EQ(stats.value().hardwareSamples, 0u);
+        EXPECT_EQ(stats.value().toString().find("IPC"), std::string::npos);
+        return;
+    }
+
+    EXPECT_GT(stats.value().hardwareSamples, 0u);
+    if (group->supports(HardwareEvent::Cycles) && group->supports(HardwareEvent::Instructions)) {
+        EXPECT_GT(stats.value().instructionsPerCycle, 0.0);
+    }
+    EXPECT_NE(stats.value().toString().find("IPC"), std::string::npos);
+
+    monitor.resetStats();
+    auto timer = monitor.scope(id);
+    timer.stop();
+    EXPECT_EQ(monitor.getStats(id).value().hardwareSamples, 0u);
+}
+
+// Test: 普通计时器不采集硬件计数
+TEST_F(HardwareCountersTest, PlainScopeHasNoCounters) {
+    OperationId id = monitor.registerOperation("plain_operation").value();
+    {
+        auto timer = monitor.scope(id);
+    }
+    EXPECT_EQ(monitor.getStats(id).value().hardwareSamples, 0u);
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include "latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace ukc;
+
+class LatencyHistogramTest : public ::testing::Test {
+protected:
+    LatencyHistogram histogram;
+};
+
+// Test: 空直方图
+TEST_F(LatencyHistogramTest, Empty) {
+    EXPECT_EQ(histogram.count(), 0);
+    EXPECT_EQ(histogram.min(), 0);
+    EXPECT_EQ(histogram.max(), 0);
+    EXPECT_EQ(histogram.percentile(50.0), 0);
+}
+
+// Test: 桶边界连续且包含自身的值
+TEST_F(LatencyHistogramTest, BucketBoundaries) {
+    for (size_t i = 0; i + 1 < LatencyHistogram::kBucketCount; ++i) {
+        EXPECT_EQ(LatencyHistogram::bucketUpperBound(i) + 1,
+                  LatencyHistogram::bucketLowerBound(i + 1));
+    }
+
+    std::vector<uint64_t> values = {0, 1, 127, 128, 129, 1000, 123456, 987654321, 1ULL << 42};
+    for (uint64_t value : values) {
+        size_t index = LatencyHistogram::bucketIndex(value);
+        EXPECT_LE(LatencyHistogram::bucketLowerBound(index), value);
+        EXPECT_GE(LatencyHistogram::bucketUpperBound(index), value);
+    }
+}
+
+// Test: 小于 128ns 的值精确记录
+TEST_F(LatencyHistogramTest, ExactLowRange) {
+    for (uint64_t v = 1; v <= 100; ++v) {
+        histogram.record(v);
+    }
+    EXPECT_EQ(histogram.count(), 100);
+    EXPECT_EQ(histogram.sum(), 5050);
+    EXPECT_EQ(histogram.min(), 1);
+    EXPECT_EQ(histogram.max(), 100);
+    EXPECT_EQ(histogram.percentile(50.0), 50);
+    EXPECT_EQ(histogram.percentile(90.0), 90);
+    EXPECT_EQ(histogram.percentile(100.0), 100);
+}
+
+// Test: 分位数相对误差在 1/64 以内
+TEST_F(LatencyHistogramTest, PercentileAccuracy) {
+    std::mt19937_64 rng(42);
+    std::lognormal_distribution<double> dist(10.0, 2.0);
+    std::vector<uint64_t> samples;
+    for (int i = 0; i < 100000; ++i) {
+        uint64_t value = static_cast<uint64_t>(dist(rng)) + 1;
+        samples.push_back(value);
+        histogram.record(value);
+    }
+    std::sort(samples.begin(), samples.end());
+
+    for (double p : {50.0, 90.0, 99.0, 99.9}) {
+        size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * samples.size()));
+        double exact = static_cast<double>(samples[rank - 1]);
+        double estimate = static_cast<double>(histogram.percentile(p));
+        EXPECT_LE(std::abs(estimate - exact) / exact, 1.0 / 64.0) << "p" << p;
+    }
+    EXPECT_EQ(histogram.max(), samples.back());
+    EXPECT_EQ(histogram.min(), samples.front());
+}
+
+// Test: 超出范围的值计入最后一个桶，max 仍然精确
+TEST_F(LatencyHistogramTest, Saturation) {
+    uint64_t huge = UINT64_MAX / 2;
+    histogram.record(huge);
+    EXPECT_EQ(LatencyHistogram::bucketIndex(huge), LatencyHistogram::kBucketCount - 1);
+    EXPECT_EQ(histogram.bucketCount(LatencyHistogram::kBucketCount - 1), 1);
+    EXPECT_EQ(histogram.max(), huge);
+    EXPECT_EQ(histogram.percentile(50.0), huge);
+}
+
+// Test: 合并与重置
+TEST_F(LatencyHistogramTest, MergeAndReset) {
+    LatencyHistogram other;
+    histogram.record(10);
+    other.record(1000);
+    other.record(5);
+
+    histogram.merge(other);
+    EXPECT_EQ(histogram.count(), 3);
+    EXPECT_EQ(histogram.min(), 5);
+    EXPECT_EQ(histogram.max(), 1000);
+    EXPECT_EQ(histogram.sum(), 1015);
+
+    histogram.reset();
+    EXPECT_EQ(histogram.count(), 0);
+    EXPECT_EQ(histogram.percentile(99.0), 0);
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include "lz4_block.h"
+#include <cstdint>
+#include <vector>
+
+using namespace ukc;
+
+namespace {
+
+std::vector<uint8_t> roundTrip(const std::vector<uint8_t>& input, size_t* compressedSize = nullptr) {
+    std::vector<uint8_t> compressed(lz4::compressBound(input.size()));
+    size_t size = lz4::compress(input.data(), input.size(), compressed.data(), compressed.size());
+    EXPECT_GT(size, 0u);
+    if (compressedSize) {
+        *compressedSize = size;
+    }
+    std::vector<uint8_t> output(input.size());
+    EXPECT_TRUE(lz4::decompress(compressed.data(), size, output.data(), output.size()));
+    return output;
+}
+
+} // namespace
+
+// Test: 各种数据压缩后解压还原
+TEST(Lz4BlockTest, RoundTrip) {
+    std::vector<uint8_t> empty;
+    EXPECT_EQ(roundTrip(empty), empty);
+    
+    std::vector<uint8_t> tiny = {1, 2, 3};
+    EXPECT_EQ(roundTrip(tiny), tiny);
+    
+    std::vector<uint8_t> random(100000);
+    uint32_t state = 12345;
+    for (auto& byte : random) {
+        state = state * 1103515245 + 12345;
+        byte = static_cast<uint8_t>(state >> 16);
+    }
+    EXPECT_EQ(roundTrip(random), random);
+    
+    // 短周期重复（重叠复制）和长匹配（长度扩展字节）
+    std::vector<uint8_t> repeated(70000);
+    for (size_t i = 0; i < repeated.size(); ++i) {
+        repeated[i] = static_cast<uint8_t>(i % 3);
+    }
+    size_t compressedSize = 0;
+    EXPECT_EQ(roundTrip(repeated, &compressedSize), repeated);
+    EXPECT_LT(compressedSize, repeated.size() / 50);
+}
+
+// Test: 输出缓冲区不足时压缩返回 0
+TEST(Lz4BlockTest, CompressCapacity) {
+    std::vector<uint8_t> input(4096);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<uint8_t>(i * 131 + (i >> 5));
+    }
+    std::vector<uint8_t> small(16);
+    EXPECT_EQ(lz4::compress(input.data(), input.size(), small.data(), small.size()), 0u);
+}
+
+// Test: 损坏或长度不符的数据解压失败
+TEST(Lz4BlockTest, RejectsCorruptInput) {
+    std::vector<uint8_t> input(4096, 0xAB);
+    std::vector<uint8_t> compressed(lz4::compressBound(input.size()));
+    size_t size = lz4::compress(input.data(), input.size(), compressed.data(), compressed.size());
+    ASSERT_GT(size, 0u);
+    
+    std::vector<uint8_t> output(input.size());
+    EXPECT_FALSE(lz4::decompress(compressed.data(), size - 1, output.data(), output.size()));
+    EXPECT_FALSE(lz4::decompress(compressed.data(), size, output.data(), output.size() - 1));
+    
+    // 偏移指向输出开头之前
+    const uint8_t badOffset[] = {0x10, 0x41, 0x05, 0x00, 0x50, 0x41, 0x41, 0x41, 0x41, 0x41};
+    EXPECT_FALSE(lz4::decompress(badOffset, sizeof(badOffset), output.data(), 10));
+}
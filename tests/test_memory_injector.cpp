@@ -5,6 +5,7 @@
 #include "kernel_caller.h"
 #include <unistd.h>
 #include <memory>
+#include <cstring>
 
 using namespace ukc;
 
@@ -49,6 +50,8 @@ TEST_F(MemoryInjectorTest, ReadMemoryNonexistentProcess) {
     
     auto result = injector_->readMemory(99999, 0x1000, 100);
     EXPECT_TRUE(result.isError());
+    EXPECT_EQ(result.errorCode(), ErrorCode::ProcessGone);
+    EXPECT_EQ(result.errorInfo().pid(), 99999);
 }
 
 // Test: 读取无效地址
@@ -61,6 +64,12 @@ TEST_F(MemoryInjectorTest, ReadMemoryInvalidAddress) {
     
     auto result = injector_->readMemory(currentPid, invalidAddr, 100);
     EXPECT_TRUE(result.isError());
+    
+    // 负载保存原始值，消息按需格式化为十六进制
+    ASSERT_EQ(result.errorCode(), ErrorCode::InvalidAddress);
+    EXPECT_EQ(result.errorInfo().address(), invalidAddr);
+    EXPECT_EQ(result.errorInfo().pid(), currentPid);
+    EXPECT_NE(result.errorMessage().find("0xffffffffffffffff"), std::string::npos);
 }
 
 // Test: 读取零字节
@@ -75,6 +84,50 @@ TEST_F(MemoryInjectorTest, ReadMemoryZeroBytes) {
     EXPECT_EQ(result.value().size(), 0);
 }
 
+// Test: 读取到调用方缓冲区
+TEST_F(MemoryInjectorTest, ReadMemoryInto) {
+    auto initResult = injector_->initialize(locator_, caller_, processManager_);
+    ASSERT_TRUE(initResult.isSuccess());
+    
+    pid_t currentPid = getpid();
+    auto mapsResult = processManager_->getMemoryMaps(currentPid);
+    ASSERT_TRUE(mapsResult.isSuccess());
+    ASSERT_GT(mapsResult.value().size(), 0);
+    uintptr_t validAddr = mapsResult.value()[0].start;
+    
+    uint8_t buffer[64];
+    auto result = injector_->readMemoryInto(currentPid, validAddr, buffer, sizeof(buffer));
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_EQ(result.value(), sizeof(buffer));
+}
+
+// Test: 读取到调用方缓冲区 - 无效地址与空缓冲区
+TEST_F(MemoryInjectorTest, ReadMemoryIntoErrors) {
+    auto initResult = injector_->initialize(locator_, caller_, processManager_);
+    ASSERT_TRUE(initResult.isSuccess());
+    
+    pid_t currentPid = getpid();
+    uint8_t buffer[8];
+    EXPECT_TRUE(injector_->readMemoryInto(
+        currentPid, 0xFFFFFFFFFFFFFFFFUL, buffer, sizeof(buffer)).isError());
+    EXPECT_TRUE(injector_->readMemoryInto(currentPid, 0x1000, nullptr, 8).isError());
+    EXPECT_TRUE(injector_->readMemoryInto(99999, 0x1000, buffer, sizeof(buffer)).isError());
+}
+
+// Test: 读取 POD 值
+TEST_F(MemoryInjectorTest, ReadTypedValue) {
+    auto initResult = injector_->initialize(locator_, caller_, processManager_);
+    ASSERT_TRUE(initResult.isSuccess());
+    
+    pid_t currentPid = getpid();
+    uint64_t localValue = 0;
+    auto result = injector_->read<uint64_t>(currentPid, reinterpret_cast<uintptr_t>(&localValue));
+    EXPECT_TRUE(result.isSuccess());
+    
+    auto invalid = injector_->read<uint32_t>(currentPid, 0xFFFFFFFFFFFFFFFFUL);
+    EXPECT_TRUE(invalid.isError());
+}
+
 // Test: 写入内存
 TEST_F(MemoryInjectorTest, WriteMemory) {
     auto initResult = injector_->initialize(locator_, caller_, processManager_);
@@ -216,5 +269,40 @@ TEST_F(MemoryInjectorTest, BatchOperationsInvalidAddress) {
     
     // 操作应该标记为失败
     EXPECT_FALSE(operations[0].success);
-    EXPECT_FALSE(operations[0].errorMessage.empty());
+    EXPECT_FALSE(operations[0].errorMessage().empty());
+}
+
+// Test: 批量操作经读取引擎执行，读到真实内存并区分无效地址
+TEST_F(MemoryInjectorTest, BatchOperationsWithReadEngine) {
+    auto initResult = injector_->initialize(locator_, caller_, processManager_);
+    ASSERT_TRUE(initResult.isSuccess());
+    
+    pid_t currentPid = getpid();
+    uint64_t localValue = 0x0123456789ABCDEFULL;
+    
+    std::vector<MemoryOperation> operations(3);
+    operations[0].type = OperationType::Read;
+    operations[0].address = reinterpret_cast<uintptr_t>(&localValue);
+    operations[0].size = sizeof(localValue);
+    operations[1].type = OperationType::Write;
+    operations[1].address = reinterpret_cast<uintptr_t>(&localValue);
+    operations[1].data = {0x01};
+    operations[2].type = OperationType::Read;
+    operations[2].address = 0x1000;
+    operations[2].size = 16;
+    
+    ReadEngine engine;
+    ReadEngineStats stats;
+    auto result = injector_->batchOperations(currentPid, operations, engine, &stats);
+    ASSERT_TRUE(result.isSuccess()) << result.errorMessage();
+    
+    ASSERT_TRUE(operations[0].success);
+    uint64_t readValue = 0;
+    std::memcpy(&readValue, operations[0].result.data(), sizeof(readValue));
+    EXPECT_EQ(readValue, localValue);
+    EXPECT_TRUE(operations[1].success);
+    EXPECT_FALSE(operations[2].success);
+    EXPECT_EQ(operations[2].error.code(), ErrorCode::InvalidAddress);
+    EXPECT_EQ(stats.reads, 2u);
+    EXPECT_EQ(stats.failed, 1u);
 }
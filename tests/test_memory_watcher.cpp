@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include "memory_watcher.h"
+#include "process_manager.h"
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace ukc;
+
+class MemoryWatcherTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        processManager_ = std::make_shared<ProcessManager>();
+        data_.assign(4096, 0);
+    }
+
+    uintptr_t dataAddress() const {
+        return reinterpret_cast<uintptr_t>(data_.data());
+    }
+
+    std::shared_ptr<ProcessManager> processManager_;
+    std::vector<uint8_t> data_;
+};
+
+// Test: 读取当前进程内存
+TEST_F(MemoryWatcherTest, ReadProcessMemory) {
+    for (size_t i = 0; i < data_.size(); ++i) {
+        data_[i] = static_cast<uint8_t>(i);
+    }
+
+    std::vector<uint8_t> buffer(data_.size());
+    auto result = processManager_->readProcessMemory(
+        getpid(), dataAddress(), buffer.data(), buffer.size()
+    );
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_EQ(result.value(), buffer.size());
+    EXPECT_EQ(buffer, data_);
+}
+
+// Test: 未变化时不报告
+TEST_F(MemoryWatcherTest, NoChanges) {
+    MemoryWatcher watcher(processManager_, getpid());
+    ASSERT_TRUE(watcher.addRegion(dataAddress(), data_.size()).isSuccess());
+
+    size_t callbacks = 0;
+    auto result = watcher.poll([&](const MemoryChange&) { callbacks++; });
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_EQ(result.value(), 0);
+    EXPECT_EQ(callbacks, 0);
+}
+
+// Test: 报告变化区间及前后数据
+TEST_F(MemoryWatcherTest, ReportsChangedRanges) {
+    MemoryWatcher watcher(processManager_, getpid());
+    auto idResult = watcher.addRegion(dataAddress(), data_.size());
+    ASSERT_TRUE(idResult.isSuccess());
+
+    data_[5] = 0xAA;
+    data_[100] = 0xBB;
+    data_[101] = 0xCC;
+    data_[4095] = 0xDD;
+
+    std::vector<MemoryChange> changes;
+    std::vector<std::vector<uint8_t>> newValues;
+    auto result = watcher.poll([&](const MemoryChange& change) {
+        changes.push_back(change);
+        newValues.emplace_back(change.newData, change.newData + change.size);
+        EXPECT_EQ(change.oldData[0], 0);
+    });
+
+    ASSERT_TRUE(result.isSuccess());
+    ASSERT_EQ(changes.size(), 3);
+    EXPECT_EQ(changes[0].regionId, idResult.value());
+    EXPECT_EQ(changes[0].offset, 5);
+    EXPECT_EQ(changes[0].size, 1);
+    EXPECT_EQ(changes[0].address, dataAddress() + 5);
+    EXPECT_EQ(changes[1].offset, 100);
+    EXPECT_EQ(newValues[1], (std::vector<uint8_t>{0xBB, 0xCC}));
+    EXPECT_EQ(changes[2].offset, 4095);
+
+    // 第二次采样没有新的变化
+    EXPECT_EQ(watcher.poll(nullptr).value(), 0);
+}
+
+// Test: 合并相近的变化
+TEST_F(MemoryWatcherTest, MergeDistance) {
+    MemoryWatcherConfig config;
+    config.mergeDistance = 8;
+    MemoryWatcher watcher(processManager_, getpid(), config);
+    ASSERT_TRUE(watcher.addRegion(dataAddress(), data_.size()).isSuccess());
+
+    data_[10] = 1;
+    data_[15] = 1;
+    data_[40] = 1;
+
+    std::vector<MemoryChange> changes;
+    ASSERT_TRUE(watcher.poll([&](const MemoryChange& change) {
+        changes.push_back(change);
+    }).isSuccess());
+
+    ASSERT_EQ(changes.size(), 2);
+    EXPECT_EQ(changes[0].offset, 10);
+    EXPECT_EQ(changes[0].size, 6);
+    EXPECT_EQ(changes[1].offset, 40);
+}
+
+// Test: 移除区域
+TEST_F(MemoryWatcherTest, RemoveRegion) {
+    MemoryWatcher watcher(processManager_, getpid());
+    auto idResult = watcher.addRegion(dataAddress(), data_.size());
+    ASSERT_TRUE(idResult.isSuccess());
+
+    EXPECT_TRUE(watcher.removeRegion(idResult.value()).isSuccess());
+    EXPECT_TRUE(watcher.removeRegion(idResult.value()).isError());
+
+    data_[0] = 1;
+    EXPECT_EQ(watcher.poll(nullptr).value(), 0);
+}
+
+// Test: 无效区域
+TEST_F(MemoryWatcherTest, InvalidRegion) {
+    MemoryWatcher watcher(processManager_, getpid());
+    EXPECT_TRUE(watcher.addRegion(dataAddress(), 0).isError());
+    EXPECT_TRUE(watcher.addRegion(0x10, 16).isError());
+}
+
+// Test: 后台采样
+TEST_F(MemoryWatcherTest, BackgroundSampling) {
+    MemoryWatcherConfig config;
+    config.interval = std::chrono::milliseconds(1);
+    MemoryWatcher watcher(processManager_, getpid(), config);
+    ASSERT_TRUE(watcher.addRegion(dataAddress(), data_.size()).isSuccess());
+
+    std::atomic<size_t> changedBytes{0};
+    ASSERT_TRUE(watcher.start([&](const MemoryChange& change) {
+        changedBytes += change.size;
+    }).isSuccess());
+    EXPECT_TRUE(watcher.isRunning());
+    EXPECT_TRUE(watcher.start(nullptr).isError());
+
+    volatile uint8_t* target = data_.data() + 64;
+    *target = 0x42;
+
+    for (int i = 0; i < 1000 && changedBytes.load() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    watcher.stop();
+
+    EXPECT_FALSE(watcher.isRunning());
+    EXPECT_EQ(changedBytes.load(), 1);
+    EXPECT_GT(watcher.getStats().samples, 0);
+}
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include "metrics_exporter.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace ukc;
+
+class MetricsExporterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        OperationId scan = monitor.registerOperation("scan").value();
+        for (int i = 1; i <= 100; ++i) {
+            monitor.record(scan, std::chrono::microseconds(i));
+        }
+        CounterId hits = monitor.registerCounter("cache-hit").value();
+        monitor.increment(hits, 7);
+    }
+
+    static std::string readFile(const std::string& path) {
+        std::ifstream file(path);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return buffer.str();
+    }
+
+    PerformanceMonitor monitor;
+};
+
+// Test: Prometheus 文本格式
+TEST_F(MetricsExporterTest, Prometheus) {
+    auto snapshot = MetricsExporter::capture(monitor);
+    ASSERT_TRUE(snapshot.isSuccess());
+
+    std::string text = MetricsExporter::toPrometheus(snapshot.value());
+    EXPECT_NE(text.find("# TYPE ukc_operation_duration_seconds summary\n"), std::string::npos);
+    std::string medianKey = "ukc_operation_duration_seconds{operation=\"scan\",quantile=\"0.5\"} ";
+    size_t median = text.find(medianKey);
+    ASSERT_NE(median, std::string::npos);
+    EXPECT_NEAR(std::stod(text.substr(median + medianKey.size())), 50e-6, 50e-6 / 64);
+    EXPECT_NE(text.find("ukc_operation_duration_seconds_count{operation=\"scan\"} 100\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("ukc_operation_duration_seconds_sum{operation=\"scan\"} 0.00505\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("# TYPE ukc_cache_hit_total counter\nukc_cache_hit_total 7\n"),
+              std::string::npos);
+    EXPECT_EQ(text.find("# EOF"), std::string::npos);
+}
+
+// Test: OpenMetrics 文本格式
+TEST_F(MetricsExporterTest, OpenMetrics) {
+    std::string text = MetricsExporter::toOpenMetrics(MetricsExporter::capture(monitor).value(), "app");
+    EXPECT_NE(text.find("# UNIT app_operation_duration_seconds seconds\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE app_cache_hit counter\napp_cache_hit_total 7\n"), std::string::npos);
+    ASSERT_GE(text.size(), 6u);
+    EXPECT_EQ(text.substr(text.size() - 6), "# EOF\n");
+}
+
+// Test: JSON 快照
+TEST_F(MetricsExporterTest, Json) {
+    std::string json = MetricsExporter::toJson(MetricsExporter::capture(monitor).value());
+    EXPECT_EQ(json.find("{\"timestamp_ms\":"), 0u);
+    EXPECT_NE(json.find("\"delta\":false"), std::string::npos);
+    EXPECT_NE(json.find("{\"name\":\"scan\",\"count\":100,\"sum_ns\":5050000,\"min_ns\":1000,\"max_ns\":100000"),
+              std::string::npos);
+    EXPECT_NE(json.find("\"counters\":{\"cache-hit\":7}"), std::string::npos);
+    EXPECT_EQ(json.back(), '\n');
+}
+
+// Test: 增量快照
+TEST_F(MetricsExporterTest, Delta) {
+    auto first = MetricsExporter::capture(monitor).value();
+
+    OperationId scan = monitor.registerOperation("scan").value();
+    monitor.record(scan, std::chrono::milliseconds(1));
+    monitor.increment(monitor.registerCounter("cache-hit").value(), 3);
+
+    auto second = MetricsExporter::capture(monitor).value();
+    MetricsSnapshot delta = MetricsExporter::delta(first, second);
+
+    EXPECT_TRUE(delta.isDelta);
+    ASSERT_EQ(delta.operations.size(), 1u);
+    EXPECT_EQ(delta.operations[0].histogram.count(), 1u);
+    EXPECT_EQ(delta.operations[0].histogram.sum(), 1000000u);
+    EXPECT_NEAR(static_cast<double>(delta.operations[0].histogram.percentile(50.0)), 1e6, 1e6 / 64);
+    ASSERT_EQ(delta.counters.size(), 1u);
+    EXPECT_EQ(delta.counters[0].value, 3u);
+
+    // 没有新样本时操作不出现在增量中
+    MetricsSnapshot empty = MetricsExporter::delta(second, second);
+    EXPECT_TRUE(empty.operations.empty());
+    EXPECT_EQ(empty.counters[0].value, 0u);
+}
+
+// Test: 写出到文件（首次全量，之后增量）
+TEST_F(MetricsExporterTest, FileWriter) {
+    std::string path = "/tmp/ukc_metrics_test_" + std::to_string(getpid()) + ".json";
+
+    MetricsWriterConfig config;
+    config.sinkType = MetricsSinkType::File;
+    config.path = path;
+    MetricsSnapshotWriter writer(monitor, config);
+
+    ASSERT_TRUE(writer.writeOnce().isSuccess());
+    EXPECT_NE(readFile(path).find("\"delta\":false"), std::string::npos);
+
+    ASSERT_TRUE(writer.writeOnce().isSuccess());
+    std::string second = readFile(path);
+    EXPECT_NE(second.find("\"delta\":true"), std::string::npos);
+    EXPECT_NE(second.find("\"operations\":[]"), std::string::npos);
+    EXPECT_EQ(writer.writtenCount(), 2u);
+
+    std::remove(path.c_str());
+}
+
+// Test: 写出到 Unix 套接字
+TEST_F(MetricsExporterTest, UnixSocketWriter) {
+    std::string path = "/tmp/ukc_metrics_test_" + std::to_string(getpid()) + ".sock";
+    unlink(path.c_str());
+
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(server, 0);
+    struct sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    std::snprintf(address.sun_path, sizeof(address.sun_path), "%s", path.c_str());
+    ASSERT_EQ(bind(server, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)), 0);
+    ASSERT_EQ(listen(server, 4), 0);
+
+    std::string received;
+    std::thread reader([&]() {
+        int client = accept(server, nullptr, nullptr);
+        char buffer[4096];
+        ssize_t n;
+        while ((n = read(client, buffer, sizeof(buffer))) > 0) {
+            received.append(buffer, static_cast<size_t>(n));
+        }
+        close(client);
+    });
+
+    MetricsWriterConfig config;
+    config.sinkType = MetricsSinkType::UnixSocket;
+    config.path = path;
+    config.format = MetricsFormat::OpenMetrics;
+    MetricsSnapshotWriter writer(monitor, config);
+    auto result = writer.writeOnce();
+    reader.join();
+
+    EXPECT_TRUE(result.isSuccess());
+    EXPECT_NE(received.find("ukc_cache_hit_total 7"), std::string::npos);
+    EXPECT_NE(received.find("# EOF\n"), std::string::npos);
+
+    close(server);
+    unlink(path.c_str());
+
+    // 没有监听者时写出失败并计数
+    EXPECT_TRUE(writer.writeOnce().isError());
+    EXPECT_EQ(writer.failedCount(), 1u);
+}
+
+// Test: 后台周期写出
+TEST_F(MetricsExporterTest, BackgroundWriter) {
+    std::string path = "/tmp/ukc_metrics_bg_" + std::to_string(getpid()) + ".prom";
+
+    MetricsWriterConfig config;
+    config.path = path;
+    config.format = MetricsFormat::Prometheus;
+    config.interval = std::chrono::milliseconds(1);
+    MetricsSnapshotWriter writer(monitor, config);
+
+    ASSERT_TRUE(writer.start().isSuccess());
+    EXPECT_TRUE(writer.start().isError());
+    for (int i = 0; i < 1000 && writer.writtenCount() < 3; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    writer.stop();
+
+    EXPECT_FALSE(writer.isRunning());
+    EXPECT_GE(writer.writtenCount(), 3u);
+    EXPECT_NE(readFile(path).find("# TYPE"), std::string::npos);
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "performance_baseline.h"
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <unistd.h>
+
+using namespace ukc;
+
+class PerformanceBaselineTest : public ::testing::Test {
+protected:
+    static LatencyHistogram sample(double medianNs, size_t count, uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        std::lognormal_distribution<double> dist(std::log(medianNs), 0.2);
+        LatencyHistogram histogram;
+        for (size_t i = 0; i < count; ++i) {
+            histogram.record(static_cast<uint64_t>(dist(rng)));
+        }
+        return histogram;
+    }
+
+    std::string tempPath(const std::string& name) const {
+        return "/tmp/ukc_baseline_" + name + "_" + std::to_string(getpid());
+    }
+};
+
+// Test: 直方图序列化往返
+TEST_F(PerformanceBaselineTest, HistogramSerializeRoundTrip) {
+    LatencyHistogram original = sample(50000, 1000, 1);
+    auto restored = LatencyHistogram::deserialize(original.serialize());
+    ASSERT_TRUE(restored.isSuccess());
+    EXPECT_EQ(restored.value().count(), original.count());
+    EXPECT_EQ(restored.value().sum(), original.sum());
+    EXPECT_EQ(restored.value().min(), original.min());
+    EXPECT_EQ(restored.value().max(), original.max());
+    EXPECT_EQ(restored.value().percentile(99.0), original.percentile(99.0));
+
+    EXPECT_TRUE(LatencyHistogram::deserialize("").isError());
+    EXPECT_TRUE(LatencyHistogram::deserialize("2 10 5 5 5:1").isError());
+    EXPECT_TRUE(LatencyHistogram::deserialize("1 10 5 5 999999:1").isError());
+}
+
+// Test: Mann-Whitney 检验区分相同分布和变慢的分布
+TEST_F(PerformanceBaselineTest, MannWhitney) {
+    LatencyHistogram baseline = sample(10000, 2000, 1);
+
+    MannWhitneyResult same = mannWhitneyU(baseline, sample(10000, 2000, 2));
+    EXPECT_GT(same.pValue, 0.01);
+    EXPECT_NEAR(same.probabilityOfSuperiority, 0.5, 0.05);
+
+    MannWhitneyResult slower = mannWhitneyU(baseline, sample(13000, 2000, 3));
+    EXPECT_LT(slower.pValue, 1e-6);
+    EXPECT_GT(slower.probabilityOfSuperiority, 0.8);
+
+    MannWhitneyResult faster = mannWhitneyU(baseline, sample(7000, 2000, 4));
+    EXPECT_GT(faster.pValue, 0.99);
+
+    // 全部并列时不判定差异
+    LatencyHistogram constant;
+    constant.record(100);
+    constant.record(100);
+    EXPECT_EQ(mannWhitneyU(constant, constant).pValue, 1.0);
+}
+
+// Test: 只有显著且超出容差的变慢才算回归
+TEST_F(PerformanceBaselineTest, CompareDetectsRegression) {
+    PerformanceBaseline baseline;
+    baseline.set("scan", sample(10000, 2000, 1));
+
+    auto unchanged = baseline.compare("scan", sample(10000, 2000, 2));
+    ASSERT_TRUE(unchanged.isSuccess());
+    EXPECT_FALSE(unchanged.value().regressed);
+
+    auto regressed = baseline.compare("scan", sample(13000, 2000, 3));
+    ASSERT_TRUE(regressed.isSuccess());
+    EXPECT_TRUE(regressed.value().regressed);
+    ASSERT_EQ(regressed.value().percentiles.size(), 2u);
+    EXPECT_GT(regressed.value().percentiles[0].ratio, 1.2);
+    EXPECT_NE(regressed.value().toString().find("REGRESSED"), std::string::npos);
+
+    // 显著但幅度在容差内
+    RegressionCheckConfig lenient;
+    lenient.percentileTolerance = 0.5;
+    EXPECT_FALSE(baseline.compare("scan", sample(13000, 2000, 3), lenient).value().regressed);
+
+    // 样本不足
+    auto few = baseline.compare("scan", sample(13000, 5, 3));
+    EXPECT_FALSE(few.value().sufficientSamples);
+    EXPECT_FALSE(few.value().regressed);
+
+    EXPECT_TRUE(baseline.compare("unknown", sample(1000, 10, 1)).isError());
+}
+
+// Test: 基线文件保存与加载
+TEST_F(PerformanceBaselineTest, SaveAndLoad) {
+    PerformanceMonitor monitor;
+    OperationId id = monitor.registerOperation("batch read").value();
+    for (int i = 1; i <= 100; ++i) {
+        monitor.record(id, std::chrono::microseconds(i));
+    }
+
+    auto captured = PerformanceBaseline::capture(monitor);
+    ASSERT_TRUE(captured.isSuccess());
+    EXPECT_EQ(captured.value().size(), 1u);
+
+    std::string path = tempPath("file");
+    ASSERT_TRUE(captured.value().save(path).isSuccess());
+
+    auto loaded = PerformanceBaseline::load(path);
+    ASSERT_TRUE(loaded.isSuccess());
+    const LatencyHistogram* histogram = loaded.value().find("batch read");
+    ASSERT_NE(histogram, nullptr);
+    EXPECT_EQ(histogram->count(), 100u);
+    EXPECT_EQ(histogram->sum(), 5050000u);
+
+    // 同一数据与自身比较不回归
+    auto reports = loaded.value().compareAll(monitor);
+    ASSERT_TRUE(reports.isSuccess());
+    ASSERT_EQ(reports.value().size(), 1u);
+    EXPECT_FALSE(reports.value()[0].regressed);
+
+    std::remove(path.c_str());
+}
+
+// Test: 加载无效基线文件
+TEST_F(PerformanceBaselineTest, LoadErrors) {
+    EXPECT_TRUE(PerformanceBaseline::load("/nonexistent/baseline").isError());
+
+    std::string path = tempPath("bad");
+    {
+        std::ofstream file(path);
+        file << "something else\n";
+    }
+    EXPECT_TRUE(PerformanceBaseline::load(path).isError());
+    {
+        std::ofstream file(path);
+        file << "ukc-baseline 1\nno_tab_here\n";
+    }
+    EXPECT_TRUE(PerformanceBaseline::load(path).isError());
+    std::remove(path.c_str());
+}
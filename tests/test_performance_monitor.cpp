@@ -2,6 +2,7 @@
 #include "performance_monitor.h"
 #include <thread>
 #include <chrono>
+#include <vector>
 
 using namespace ukc;
 
@@ -63,7 +64,7 @@ TEST_F(PerformanceMonitorTest, GetAllStats) {
         std::string opName = "operation_" + std::to_string(i);
         monitor.startTimer(opName);
         std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        monitor.stopTimer(opName);
+        EXPECT_TRUE(monitor.stopTimer(opName).isSuccess());
     }
     
     auto result = monitor.getAllStats();
@@ -77,7 +78,7 @@ TEST_F(PerformanceMonitorTest, GetAllStats) {
 TEST_F(PerformanceMonitorTest, ResetStats) {
     monitor.startTimer("test_operation");
     std::this_thread::sleep_for(std::chrono::milliseconds(5));
-    monitor.stopTimer("test_operation");
+    EXPECT_TRUE(monitor.stopTimer("test_operation").isSuccess());
     
     auto beforeReset = monitor.getStats("test_operation");
     ASSERT_TRUE(beforeReset.isSuccess());
@@ -95,7 +96,7 @@ TEST_F(PerformanceMonitorTest, ResetAllStats) {
         std::string opName = "operation_" + std::to_string(i);
         monitor.startTimer(opName);
         std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        monitor.stopTimer(opName);
+        EXPECT_TRUE(monitor.stopTimer(opName).isSuccess());
     }
     
     auto beforeReset = monitor.getAllStats();
@@ -113,7 +114,7 @@ TEST_F(PerformanceMonitorTest, ResetAllStats) {
 TEST_F(PerformanceMonitorTest, MeetsPerformanceRequirement) {
     monitor.startTimer("fast_operation");
     std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    monitor.stopTimer("fast_operation");
+    EXPECT_TRUE(monitor.stopTimer("fast_operation").isSuccess());
     
     auto result = monitor.meetsPerformanceRequirement(
         "fast_operation",
@@ -128,7 +129,7 @@ TEST_F(PerformanceMonitorTest, MeetsPerformanceRequirement) {
 TEST_F(PerformanceMonitorTest, DoesNotMeetPerformanceRequirement) {
     monitor.startTimer("slow_operation");
     std::this_thread::sleep_for(std::chrono::milliseconds(50));
-    monitor.stopTimer("slow_operation");
+    EXPECT_TRUE(monitor.stopTimer("slow_operation").isSuccess());
     
     auto result = monitor.meetsPerformanceRequirement(
         "slow_operation",
@@ -143,7 +144,7 @@ TEST_F(PerformanceMonitorTest, DoesNotMeetPerformanceRequirement) {
 TEST_F(PerformanceMonitorTest, StatsToString) {
     monitor.startTimer("test_operation");
     std::this_thread::sleep_for(std::chrono::milliseconds(5));
-    monitor.stopTimer("test_operation");
+    EXPECT_TRUE(monitor.stopTimer("test_operation").isSuccess());
     
     auto statsResult = monitor.getStats("test_operation");
     ASSERT_TRUE(statsResult.isSuccess());
@@ -164,7 +165,7 @@ TEST_F(PerformanceMonitorTest, MinMaxTime) {
     for (int sleepMs : sleepTimes) {
         monitor.startTimer("variable_operation");
         std::this_thread::sleep_for(std::chrono::milliseconds(sleepMs));
-        monitor.stopTimer("variable_operation");
+        EXPECT_TRUE(monitor.stopTimer("variable_operation").isSuccess());
     }
     
     auto statsResult = monitor.getStats("variable_operation");
@@ -180,7 +181,7 @@ TEST_F(PerformanceMonitorTest, ThroughputCalculation) {
     for (int i = 0; i < 10; ++i) {
         monitor.startTimer("throughput_test");
         std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        monitor.stopTimer("throughput_test");
+        EXPECT_TRUE(monitor.stopTimer("throughput_test").isSuccess());
     }
     
     auto statsResult = monitor.getStats("throughput_test");
@@ -189,3 +190,187 @@ TEST_F(PerformanceMonitorTest, ThroughputCalculation) {
     const auto& stats = statsResult.value();
     EXPECT_GT(stats.operationsPerSecond, 0);
 }
+
+// Test: 分位数统计
+TEST_F(PerformanceMonitorTest, PercentileStats) {
+    std::vector<int> sleepTimes = {1, 1, 1, 1, 1, 1, 1, 1, 1, 20};
+    
+    for (int sleepMs : sleepTimes) {
+        monitor.startTimer("percentile_operation");
+        std::this_thread::sleep_for(std::chrono::milliseconds(sleepMs));
+        EXPECT_TRUE(monitor.stopTimer("percentile_operation").isSuccess());
+    }
+    
+    auto statsResult = monitor.getStats("percentile_operation");
+    ASSERT_TRUE(statsResult.isSuccess());
+    
+    const auto& stats = statsResult.value();
+    EXPECT_LE(stats.p50, stats.p90);
+    EXPECT_LE(stats.p90, stats.p99);
+    EXPECT_LE(stats.p99, stats.p999);
+    EXPECT_GE(stats.p50, std::chrono::milliseconds(1));
+    EXPECT_LT(stats.p50, std::chrono::milliseconds(20));
+    EXPECT_GE(stats.p999, std::chrono::milliseconds(20));
+    EXPECT_NE(stats.toString().find("P99:"), std::string::npos);
+}
+
+// Test: 内存占用与样本数量无关
+TEST_F(PerformanceMonitorTest, ManySamples) {
+    for (int i = 0; i < 100000; ++i) {
+        monitor.startTimer("many_samples");
+        EXPECT_TRUE(monitor.stopTimer("many_samples").isSuccess());
+    }
+    
+    auto statsResult = monitor.getStats("many_samples");
+    ASSERT_TRUE(statsResult.isSuccess());
+    EXPECT_EQ(statsResult.value().operationCount, 100000);
+    EXPECT_LE(statsResult.value().p50, statsResult.value().p999);
+}
+
+// Test: 注册操作句柄
+TEST_F(PerformanceMonitorTest, RegisterOperation) {
+    auto first = monitor.registerOperation("registered_operation");
+    auto second = monitor.registerOperation("registered_operation");
+    auto other = monitor.registerOperation("other_operation");
+    
+    ASSERT_TRUE(first.isSuccess());
+    ASSERT_TRUE(other.isSuccess());
+    EXPECT_EQ(first.value(), second.value());
+    EXPECT_NE(first.value(), other.value());
+    
+    // 已注册但没有样本
+    EXPECT_TRUE(monitor.getStats(first.value()).isError());
+    EXPECT_TRUE(monitor.getStats(kInvalidOperationId).isError());
+}
+
+// Test: 作用域计时器
+TEST_F(PerformanceMonitorTest, ScopedTimer) {
+    OperationId id = monitor.registerOperation("scoped_operation").value();
+    
+    {
+        auto timer = monitor.scope(id);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    {
+        auto timer = monitor.scope(id);
+        timer.cancel();
+    }
+    {
+        auto timer = monitor.scope(id);
+        auto moved = std::move(timer);
+        moved.stop();
+    }
+    
+    auto statsResult = monitor.getStats("scoped_operation");
+    ASSERT_TRUE(statsResult.isSuccess());
+    EXPECT_EQ(statsResult.value().operationCount, 2);
+    EXPECT_GE(statsResult.value().maxTime.count(), 2000);
+}
+
+// Test: 多线程同时计时同一操作
+TEST_F(PerformanceMonitorTest, ConcurrentTiming) {
+    OperationId id = monitor.registerOperation("concurrent_operation").value();
+    const int threadCount = 4;
+    const int iterations = 10000;
+    
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < iterations; ++i) {
+                auto timer = monitor.scope(id);
+            }
+            // 旧接口的起始时间按线程保存，互不覆盖
+            for (int i = 0; i < 100; ++i) {
+                monitor.startTimer("legacy_operation");
+                EXPECT_TRUE(monitor.stopTimer("legacy_operation").isSuccess());
+            }
+        });
+    }
+    
+    // 写入期间并发读取
+    for (int i = 0; i < 10; ++i) {
+        (void)monitor.getAllStats();
+    }
+    
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    // 线程退出后数据仍然保留
+    EXPECT_EQ(monitor.getStats(id).value().operationCount,
+              static_cast<size_t>(threadCount * iterations));
+    EXPECT_EQ(monitor.getStats("legacy_operation").value().operationCount,
+              static_cast<size_t>(threadCount * 100));
+    
+    monitor.resetStats();
+    EXPECT_TRUE(monitor.getStats(id).isError());
+}
+
+// Test: 计数器按线程分片累加
+TEST_F(PerformanceMonitorTest, Counters) {
+    CounterId hits = monitor.registerCounter("hits").value();
+    EXPECT_EQ(monitor.registerCounter("hits").value(), hits);
+    EXPECT_TRUE(monitor.getCounter("unknown").isError());
+    
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 1000; ++i) {
+                monitor.increment(hits);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    monitor.increment(hits, 10);
+    
+    EXPECT_EQ(monitor.getCounter("hits").value(), 4010);
+    
+    auto all = monitor.getAllCounters();
+    ASSERT_TRUE(all.isSuccess());
+    ASSERT_EQ(all.value().size(), 1);
+    EXPECT_EQ(all.value()[0].name, "hits");
+    
+    monitor.resetStats();
+    EXPECT_EQ(monitor.getCounter("hits").value(), 0);
+}
+
+// Test: 分位数和吞吐量要求
+TEST_F(PerformanceMonitorTest, PercentileRequirement) {
+    OperationId id = monitor.registerOperation("tail_operation").value();
+    for (int i = 0; i < 990; ++i) {
+        monitor.record(id, std::chrono::microseconds(10));
+    }
+    for (int i = 0; i < 10; ++i) {
+        monitor.record(id, std::chrono::milliseconds(10));
+    }
+    
+    // 平均值满足要求，但尾延迟不满足
+    EXPECT_TRUE(monitor.meetsPerformanceRequirement(
+        "tail_operation", std::chrono::microseconds(200)).value());
+    
+    PerformanceRequirement requirement;
+    requirement.percentiles = {{50.0, std::chrono::microseconds(20)},
+                               {99.9, std::chrono::milliseconds(1)}};
+    requirement.minOperationsPerSecond = 10000.0;
+    
+    auto check = monitor.checkRequirement("tail_operation", requirement);
+    ASSERT_TRUE(check.isSuccess());
+    EXPECT_FALSE(check.value().passed);
+    ASSERT_EQ(check.value().violations.size(), 2u);
+    EXPECT_NE(check.value().violations[0].find("P99.9"), std::string::npos);
+    EXPECT_NE(check.value().violations[1].find("throughput"), std::string::npos);
+    
+    requirement.percentiles = {{50.0, std::chrono::microseconds(20)},
+                               {99.0, std::chrono::microseconds(20)}};
+    requirement.minOperationsPerSecond = 0.0;
+    EXPECT_TRUE(monitor.meetsPerformanceRequirement("tail_operation", requirement).value());
+    
+    requirement.minSamples = 10000;
+    EXPECT_FALSE(monitor.meetsPerformanceRequirement("tail_operation", requirement).value());
+    
+    requirement.percentiles = {{150.0, std::chrono::microseconds(20)}};
+    EXPECT_TRUE(monitor.checkRequirement("tail_operation", requirement).isError());
+    EXPECT_TRUE(monitor.checkRequirement("missing", requirement).isError());
+}
@@ -2,8 +2,12 @@
 #include <rapidcheck.h>
 #include <rapidcheck/gtest.h>
 #include "performance_monitor.h"
+#include "performance_baseline.h"
 #include <thread>
 #include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
 
 using namespace ukc;
 
@@ -14,40 +18,78 @@ protected:
 
 // Feature: userspace-kernel-call, Property 11: 性能要求
 // Validates: Requirements 8.2
-RC_GTEST_PROP(PerformanceMonitorPropertyTest, PropertyPerformanceRequirement,
-              (size_t operationCount)) {
-    // 限制操作数量
-    operationCount = std::min(operationCount, size_t(100));
-    if (operationCount == 0) operationCount = 1;
-    
-    // 执行多个快速操作
-    for (size_t i = 0; i < operationCount; ++i) {
-        monitor.startTimer("fast_operation");
-        // 模拟快速操作（< 1ms）
-        std::this_thread::sleep_for(std::chrono::microseconds(100));
-        auto result = monitor.stopTimer("fast_operation");
-        RC_ASSERT(result.isSuccess());
+// 使用确定的延迟样本，而不是依赖 sleep 的平均值
+RC_GTEST_FIXTURE_PROP(PerformanceMonitorPropertyTest, PropertyPerformanceRequirement,
+                      (const std::vector<uint32_t>& latenciesUs)) {
+    RC_PRE(!latenciesUs.empty());
+    
+    OperationId id = monitor.registerOperation("fast_operation").value();
+    LatencyHistogram expected;
+    for (uint32_t us : latenciesUs) {
+        std::chrono::nanoseconds latency(static_cast<uint64_t>(us % 100000) * 1000 + 1);
+        monitor.record(id, latency);
+        expected.record(static_cast<uint64_t>(latency.count()));
     }
     
-    // 验证平均时间在 100ms 以内
-    auto statsResult = monitor.getStats("fast_operation");
-    RC_ASSERT(statsResult.isSuccess());
-    
-    const auto& stats = statsResult.value();
-    RC_ASSERT(stats.operationCount == operationCount);
+    for (double percentile : {50.0, 90.0, 99.0, 99.9}) {
+        uint64_t actual = expected.percentile(percentile);
+        
+        // 目标等于实际分位数时满足
+        PerformanceRequirement met;
+        met.percentiles = {{percentile, std::chrono::nanoseconds(actual)}};
+        auto metResult = monitor.meetsPerformanceRequirement("fast_operation", met);
+        RC_ASSERT(metResult.isSuccess());
+        RC_ASSERT(metResult.value());
+        
+        // 目标低于实际分位数时不满足
+        PerformanceRequirement missed;
+        missed.percentiles = {{percentile, std::chrono::nanoseconds(actual - 1)}};
+        auto missedResult = monitor.checkRequirement("fast_operation", missed);
+        RC_ASSERT(missedResult.isSuccess());
+        RC_ASSERT(!missedResult.value().passed);
+        RC_ASSERT(missedResult.value().violations.size() == 1);
+    }
     
-    // 快速操作应该满足性能要求
-    auto requirementResult = monitor.meetsPerformanceRequirement(
-        "fast_operation",
-        std::chrono::milliseconds(100)
-    );
-    RC_ASSERT(requirementResult.isSuccess());
-    RC_ASSERT(requirementResult.value());
+    // 吞吐量下限与统计一致
+    auto stats = monitor.getStats("fast_operation").value();
+    PerformanceRequirement throughput;
+    throughput.minOperationsPerSecond = stats.operationsPerSecond * 2.0;
+    RC_ASSERT(!monitor.meetsPerformanceRequirement("fast_operation", throughput).value());
+}
+
+// Feature: userspace-kernel-call, Property 11b: 基线回归检测
+// Validates: Requirements 8.2
+// 相同分布不报告回归；中位数变慢 50% 时必须报告回归
+RC_GTEST_FIXTURE_PROP(PerformanceMonitorPropertyTest, PropertyBaselineRegression,
+                      (uint32_t seed)) {
+    auto sample = [](double medianNs, uint64_t sampleSeed) {
+        std::mt19937_64 rng(sampleSeed);
+        std::lognormal_distribution<double> dist(std::log(medianNs), 0.2);
+        LatencyHistogram histogram;
+        for (int i = 0; i < 500; ++i) {
+            histogram.record(static_cast<uint64_t>(dist(rng)));
+        }
+        return histogram;
+    };
+    
+    PerformanceBaseline baseline;
+    baseline.set("operation", sample(10000.0, seed));
+    
+    RegressionCheckConfig config;
+    config.significance = 1e-4;
+    
+    auto unchanged = baseline.compare("operation", sample(10000.0, uint64_t(seed) + 1), config);
+    RC_ASSERT(unchanged.isSuccess());
+    RC_ASSERT(!unchanged.value().regressed);
+    
+    auto slower = baseline.compare("operation", sample(15000.0, uint64_t(seed) + 2), config);
+    RC_ASSERT(slower.isSuccess());
+    RC_ASSERT(slower.value().regressed);
 }
 
 // Feature: userspace-kernel-call, Property 12: 批量操作优化
 // Validates: Requirements 8.5
-RC_GTEST_PROP(PerformanceMonitorPropertyTest, PropertyBatchOperationPerformance,
+RC_GTEST_FIXTURE_PROP(PerformanceMonitorPropertyTest, PropertyBatchOperationPerformance,
               (size_t batchSize)) {
     // 限制批量大小
     batchSize = std::min(batchSize, size_t(100));
@@ -56,7 +98,7 @@ RC_GTEST_PROP(PerformanceMonitorPropertyTest, PropertyBatchOperationPerformance,
     // 测试单个操作
     monitor.startTimer("single_operation");
     std::this_thread::sleep_for(std::chrono::microseconds(100));
-    monitor.stopTimer("single_operation");
+    RC_ASSERT(monitor.stopTimer("single_operation").isSuccess());
     
     auto singleStats = monitor.getStats("single_operation");
     RC_ASSERT(singleStats.isSuccess());
@@ -66,7 +108,7 @@ RC_GTEST_PROP(PerformanceMonitorPropertyTest, PropertyBatchOperationPerformance,
     for (size_t i = 0; i < batchSize; ++i) {
         std::this_thread::sleep_for(std::chrono::microseconds(100));
     }
-    monitor.stopTimer("batch_operation");
+    RC_ASSERT(monitor.stopTimer("batch_operation").isSuccess());
     
     auto batchStats = monitor.getStats("batch_operation");
     RC_ASSERT(batchStats.isSuccess());
@@ -78,7 +120,7 @@ RC_GTEST_PROP(PerformanceMonitorPropertyTest, PropertyBatchOperationPerformance,
 
 // Feature: userspace-kernel-call, Property: 统计一致性
 // 验证统计信息的一致性
-RC_GTEST_PROP(PerformanceMonitorPropertyTest, PropertyStatisticsConsistency,
+RC_GTEST_FIXTURE_PROP(PerformanceMonitorPropertyTest, PropertyStatisticsConsistency,
               (size_t operationCount)) {
     // 限制操作数量
     operationCount = std::min(operationCount, size_t(50));
@@ -119,7 +161,7 @@ RC_GTEST_PROP(PerformanceMonitorPropertyTest, PropertyStatisticsConsistency,
 
 // Feature: userspace-kernel-call, Property: 计时器准确性
 // 验证计时器的准确性
-RC_GTEST_PROP(PerformanceMonitorPropertyTest, PropertyTimerAccuracy,
+RC_GTEST_FIXTURE_PROP(PerformanceMonitorPropertyTest, PropertyTimerAccuracy,
               (int sleepMs)) {
     // 限制睡眠时间
     sleepMs = std::abs(sleepMs) % 100 + 1;
@@ -146,7 +188,7 @@ RC_GTEST_PROP(PerformanceMonitorPropertyTest, PropertyTimerAccuracy,
 
 // Feature: userspace-kernel-call, Property: 多操作独立性
 // 验证不同操作的统计信息是独立的
-RC_GTEST_PROP(PerformanceMonitorPropertyTest, PropertyMultipleOperationsIndependence,
+RC_GTEST_FIXTURE_PROP(PerformanceMonitorPropertyTest, PropertyMultipleOperationsIndependence,
               (size_t operationCount)) {
     // 限制操作数量
     operationCount = std::min(operationCount, size_t(10));
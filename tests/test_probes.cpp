@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include "probes.h"
+#include "signature_scanner.h"
+#include "process_manager.h"
+#include "userspace_kernel_call.h"
+#include <unistd.h>
+#include <vector>
+
+using namespace ukc;
+
+class ProbesTest : public ::testing::Test {
+protected:
+    static uint64_t stageCount(probes::Stage stage) {
+        auto stats = probes::monitor().getStats(static_cast<OperationId>(stage));
+        return stats.isSuccess() ? stats.value().operationCount : 0;
+    }
+
+    static uint64_t counterValue(probes::Counter counter) {
+        return probes::monitor().getCounter(probes::counterName(counter)).value();
+    }
+};
+
+// Test: 阶段和计数器按枚举顺序注册
+TEST_F(ProbesTest, RegisteredInEnumOrder) {
+    PerformanceMonitor& monitor = probes::monitor();
+    for (size_t i = 0; i < static_cast<size_t>(probes::Stage::Count); ++i) {
+        auto stage = static_cast<probes::Stage>(i);
+        auto id = monitor.registerOperation(probes::stageName(stage));
+        ASSERT_TRUE(id.isSuccess());
+        EXPECT_EQ(id.value(), i);
+    }
+    for (size_t i = 0; i < static_cast<size_t>(probes::Counter::Count); ++i) {
+        auto counter = static_cast<probes::Counter>(i);
+        auto id = monitor.registerCounter(probes::counterName(counter));
+        ASSERT_TRUE(id.isSuccess());
+        EXPECT_EQ(id.value(), i);
+    }
+}
+
+// Test: 扫描和 maps 解析触发探针
+TEST_F(ProbesTest, ScanAndMapsParseRecorded) {
+    if (!probes::enabled()) {
+        GTEST_SKIP() << "Probes disabled at compile time";
+    }
+
+    uint64_t scansBefore = stageCount(probes::Stage::ScanPerMB);
+    uint64_t bytesBefore = counterValue(probes::Counter::ScanBytes);
+    uint64_t mapsBefore = stageCount(probes::Stage::MapsParse);
+
+    std::vector<uint8_t> buffer(1024 * 1024, 0);
+    auto pattern = SignaturePattern::fromHexString("DE AD BE EF");
+    ASSERT_TRUE(SignatureScanner::scan(buffer.data(), buffer.size(), pattern).isSuccess());
+
+    ProcessManager processManager;
+    ASSERT_TRUE(processManager.getMemoryMaps(getpid()).isSuccess());
+
+    EXPECT_EQ(stageCount(probes::Stage::ScanPerMB), scansBefore + 1);
+    EXPECT_EQ(counterValue(probes::Counter::ScanBytes), bytesBefore + buffer.size());
+    EXPECT_EQ(stageCount(probes::Stage::MapsParse), mapsBefore + 1);
+}
+
+// Test: 通过统一 API 访问探针统计
+TEST_F(ProbesTest, ReachableFromUserspaceKernelCall) {
+    UserspaceKernelCall ukc;
+    EXPECT_EQ(ukc.probesEnabled(), probes::enabled());
+    EXPECT_EQ(&ukc.getPerformanceMonitor(), &probes::monitor());
+
+    auto counters = ukc.getPerformanceMonitor().getAllCounters();
+    ASSERT_TRUE(counters.isSuccess());
+    EXPECT_EQ(counters.value().size(), static_cast<size_t>(probes::Counter::Count));
+}
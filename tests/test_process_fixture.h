@@ -0,0 +1,191 @@
+#ifndef USERSPACE_KERNEL_CALL_TEST_PROCESS_FIXTURE_H
+#define USERSPACE_KERNEL_CALL_TEST_PROCESS_FIXTURE_H
+
+#include "data_models.h"
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+namespace ukc {
+namespace test {
+
+/**
+ * 测试用的匿名私有映射，析构时解除映射
+ */
+class TestMapping {
+public:
+    explicit TestMapping(size_t size) : size_(size) {
+        void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping != MAP_FAILED) {
+            data_ = static_cast<uint8_t*>(mapping);
+        }
+    }
+
+    ~TestMapping() {
+        if (data_) {
+            munmap(data_, size_);
+        }
+    }
+
+    TestMapping(const TestMapping&) = delete;
+    TestMapping& operator=(const TestMapping&) = delete;
+
+    bool isValid() const {
+        return data_ != nullptr;
+    }
+
+    uint8_t* data() const {
+        return data_;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    /**
+     * 解除 size 之后的部分，映射末尾紧跟一段未映射的空洞
+     */
+    void shrink(size_t size) {
+        if (data_ && size < size_) {
+            munmap(data_ + size, size_ - size);
+            size_ = size;
+        }
+    }
+
+    /**
+     * 覆盖整个映射的区域（子进程中被 mprotect 拆开时仍按一段描述）
+     */
+    MemoryRegion region() const {
+        MemoryRegion region;
+        region.start = reinterpret_cast<uintptr_t>(data_);
+        region.end = region.start + size_;
+        region.permissions = "rw-p";
+        return region;
+    }
+
+private:
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/**
+ * fork 出的测试子进程，析构时结束并回收
+ * 子进程拥有 fork 时父进程内存的副本，之后父进程修改自己的副本不影响子进程
+ */
+class TestChild {
+public:
+    TestChild() = default;
+
+    ~TestChild() {
+        stop();
+    }
+
+    TestChild(const TestChild&) = delete;
+    TestChild& operator=(const TestChild&) = delete;
+
+    /**
+     * 子进程先执行 setup，然后阻塞在 pause() 直到被结束
+     *
+     * @return 子进程 pid，fork 失败时为 -1
+     */
+    pid_t spawn(const std::function<void()>& setup = nullptr) {
+        pid_ = fork();
+        if (pid_ == 0) {
+            if (setup) {
+                setup();
+            }
+            for (;;) {
+                pause();
+            }
+        }
+        return pid_;
+    }
+
+    /**
+     * 子进程每从管道读到一个页号，就翻转 base 中该页的第一个字节并回应
+     *
+     * @return 子进程 pid，失败时为 -1
+     */
+    pid_t spawnToggler(uint8_t* base, size_t pageSize) {
+        int down[2];
+        int up[2];
+        if (pipe(down) != 0) {
+            return -1;
+        }
+        if (pipe(up) != 0) {
+            close(down[0]);
+            close(down[1]);
+            return -1;
+        }
+        pid_ = fork();
+        if (pid_ == 0) {
+            close(down[1]);
+            close(up[0]);
+            uint8_t page;
+            while (read(down[0], &page, 1) == 1) {
+                base[page * pageSize] ^= 0xFF;
+                (void)write(up[1], &page, 1);
+            }
+            _exit(0);
+        }
+        close(down[0]);
+        close(up[1]);
+        toChild_ = down[1];
+        fromChild_ = up[0];
+        base_ = base;
+        pageSize_ = pageSize;
+        return pid_;
+    }
+
+    /**
+     * 让 spawnToggler 启动的子进程翻转第 page 页的第一个字节并等待完成，
+     * 父进程的副本同步翻转，两者保持一致
+     */
+    bool togglePage(uint8_t page) {
+        uint8_t ack;
+        if (write(toChild_, &page, 1) != 1 || read(fromChild_, &ack, 1) != 1) {
+            return false;
+        }
+        base_[page * pageSize_] ^= 0xFF;
+        return true;
+    }
+
+    /**
+     * 结束并回收子进程
+     */
+    void stop() {
+        if (toChild_ >= 0) {
+            close(toChild_);
+            close(fromChild_);
+            toChild_ = -1;
+            fromChild_ = -1;
+        }
+        if (pid_ > 0) {
+            kill(pid_, SIGKILL);
+            waitpid(pid_, nullptr, 0);
+            pid_ = -1;
+        }
+    }
+
+    pid_t pid() const {
+        return pid_;
+    }
+
+private:
+    pid_t pid_ = -1;
+    int toChild_ = -1;
+    int fromChild_ = -1;
+    uint8_t* base_ = nullptr;
+    size_t pageSize_ = 0;
+};
+
+} // namespace test
+} // namespace ukc
+
+#endif // USERSPACE_KERNEL_CALL_TEST_PROCESS_FIXTURE_H
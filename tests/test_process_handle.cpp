@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include "process_handle.h"
+#include "process_manager.h"
+#include "test_process_fixture.h"
+#include <cstdint>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+using namespace ukc;
+
+class ProcessHandleTest : public ::testing::Test {
+protected:
+    ProcessManager pm;
+    test::TestChild child_;
+};
+
+// Test: 打开当前进程并通过句柄访问
+TEST_F(ProcessHandleTest, OpenSelf) {
+    auto result = ProcessHandle::open(getpid());
+    ASSERT_TRUE(result.isSuccess()) << result.errorMessage();
+
+    const ProcessHandle& process = result.value();
+    EXPECT_TRUE(process.isOpen());
+    EXPECT_TRUE(process.isAlive());
+    EXPECT_EQ(process.pid(), getpid());
+    EXPECT_GE(process.mapsFd(), 0);
+
+    uint64_t localValue = 0x1122334455667788ULL;
+    uint64_t readValue = 0;
+    auto readResult = pm.readProcessMemory(
+        process, reinterpret_cast<uintptr_t>(&localValue),
+        reinterpret_cast<uint8_t*>(&readValue), sizeof(readValue)
+    );
+    ASSERT_TRUE(readResult.isSuccess()) << readResult.errorMessage();
+    EXPECT_EQ(readValue, localValue);
+
+    EXPECT_TRUE(pm.isValidAddress(process, reinterpret_cast<uintptr_t>(&localValue)));
+    auto maps = pm.getMemoryMaps(process);
+    ASSERT_TRUE(maps.isSuccess());
+    EXPECT_FALSE(maps.value().empty());
+}
+
+// Test: 打开不存在的进程
+TEST_F(ProcessHandleTest, OpenNonexistent) {
+    auto result = ProcessHandle::open(99999);
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(result.errorCode(), ErrorCode::ProcessGone);
+
+    auto invalid = ProcessHandle::open(-1);
+    ASSERT_TRUE(invalid.isError());
+    EXPECT_EQ(invalid.errorCode(), ErrorCode::InvalidArgument);
+}
+
+// Test: 进程退出后句柄报告不存活，读取返回 ProcessGone
+TEST_F(ProcessHandleTest, DetectsExit) {
+    pid_t child = child_.spawn();
+    ASSERT_GT(child, 0);
+
+    auto result = ProcessHandle::open(child);
+    ASSERT_TRUE(result.isSuccess()) << result.errorMessage();
+    const ProcessHandle& process = result.value();
+    EXPECT_TRUE(process.isAlive());
+
+    auto maps = pm.getMemoryMaps(process);
+    ASSERT_TRUE(maps.isSuccess());
+    ASSERT_FALSE(maps.value().empty());
+    uintptr_t address = maps.value().front().start;
+
+    child_.stop();
+
+    EXPECT_FALSE(process.isAlive());
+
+    uint8_t buffer[8];
+    auto readResult = pm.readProcessMemory(process, address, buffer, sizeof(buffer));
+    ASSERT_TRUE(readResult.isError());
+    EXPECT_EQ(readResult.errorCode(), ErrorCode::ProcessGone);
+    EXPECT_FALSE(pm.isProcessAlive(child));
+}
+
+// Test: ProcessManager 按 pid 复用缓存的句柄
+TEST_F(ProcessHandleTest, ManagerCachesHandle) {
+    auto first = pm.handle(getpid());
+    auto second = pm.handle(getpid());
+    ASSERT_TRUE(first.isSuccess());
+    ASSERT_TRUE(second.isSuccess());
+    EXPECT_EQ(first.value().get(), second.value().get());
+
+    // 进程退出后按 pid 查询会丢弃过期句柄
+    pid_t child = child_.spawn();
+    ASSERT_GT(child, 0);
+    EXPECT_TRUE(pm.isProcessAlive(child));
+    child_.stop();
+    EXPECT_FALSE(pm.isProcessAlive(child));
+}
+
+// Test: 没有 ptrace 读权限的进程（root 拥有的 pid 1）仍报告存活
+TEST_F(ProcessHandleTest, UntraceableProcessIsAlive) {
+    EXPECT_TRUE(pm.isProcessAlive(1));
+
+    // 以 root 运行时在子进程中降权，确认 maps 打不开也不影响存活检查
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        if (getuid() == 0 && (setgid(65534) != 0 || setuid(65534) != 0)) {
+            _exit(2);
+        }
+        ProcessManager manager;
+        auto process = ProcessHandle::open(1);
+        if (process.isError() || !process.value().isAlive() || !manager.isProcessAlive(1)) {
+            _exit(1);
+        }
+        auto maps = manager.getMemoryMaps(1);
+        bool mapsConsistent = process.value().mapsFd() >= 0
+            ? maps.isSuccess()
+            : maps.isError() && maps.errorCode() == ErrorCode::Unavailable;
+        _exit(mapsConsistent ? 0 : 3);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+
+// Test: 移动后原句柄不再持有描述符
+TEST_F(ProcessHandleTest, MoveTransfersDescriptors) {
+    auto result = ProcessHandle::open(getpid());
+    ASSERT_TRUE(result.isSuccess());
+
+    ProcessHandle moved = result.moveValue();
+    EXPECT_TRUE(moved.isOpen());
+    EXPECT_TRUE(moved.isAlive());
+
+    ProcessHandle target;
+    EXPECT_FALSE(target.isOpen());
+    EXPECT_FALSE(target.isAlive());
+    target = std::move(moved);
+    EXPECT_TRUE(target.isOpen());
+    EXPECT_FALSE(moved.isOpen());
+}
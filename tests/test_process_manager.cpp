@@ -1,7 +1,9 @@
 #include <gtest/gtest.h>
 #include "process_manager.h"
 #include <unistd.h>
+#include <sys/mman.h>
 #include <sys/types.h>
+#include <fstream>
 
 using namespace ukc;
 
@@ -80,6 +82,7 @@ TEST_F(ProcessManagerTest, GetMemoryMaps) {
 TEST_F(ProcessManagerTest, GetMemoryMapsNonexistent) {
     auto result = pm.getMemoryMaps(99999);
     ASSERT_TRUE(result.isError());
+    EXPECT_EQ(result.errorCode(), ErrorCode::ProcessGone);
 }
 
 // Test: 验证有效地址
@@ -98,6 +101,45 @@ TEST_F(ProcessManagerTest, IsValidAddress) {
     EXPECT_TRUE(pm.isValidAddress(currentPid, validAddr));
 }
 
+// Test: 流式地址校验与完整映射解析结果一致
+TEST_F(ProcessManagerTest, IsValidAddressMatchesMemoryMaps) {
+    pid_t currentPid = getpid();
+    auto mapsResult = pm.getMemoryMaps(currentPid);
+    ASSERT_TRUE(mapsResult.isSuccess());
+    
+    for (const auto& region : mapsResult.value()) {
+        EXPECT_TRUE(pm.isValidAddress(currentPid, region.start));
+        EXPECT_TRUE(pm.isValidAddress(currentPid, region.end - 1));
+    }
+    
+    int stackValue = 0;
+    EXPECT_TRUE(pm.isValidAddress(currentPid, reinterpret_cast<uintptr_t>(&stackValue)));
+}
+
+// Test: 单地址查询与完整映射解析结果一致（PROCMAP_QUERY 或文本回退）
+TEST_F(ProcessManagerTest, FindRegionMatchesMemoryMaps) {
+    pid_t currentPid = getpid();
+    auto mapsResult = pm.getMemoryMaps(currentPid);
+    ASSERT_TRUE(mapsResult.isSuccess());
+    
+    for (const auto& expected : mapsResult.value()) {
+        auto regionResult = pm.findRegion(currentPid, expected.start);
+        ASSERT_TRUE(regionResult.isSuccess()) << std::hex << expected.start;
+        const auto& region = regionResult.value();
+        EXPECT_EQ(region.start, expected.start);
+        EXPECT_EQ(region.end, expected.end);
+        EXPECT_EQ(region.permissions, expected.permissions);
+    }
+    
+    auto missing = pm.findRegion(currentPid, 0);
+    ASSERT_TRUE(missing.isError());
+    EXPECT_EQ(missing.errorCode(), ErrorCode::InvalidAddress);
+    
+    auto gone = pm.findRegion(99999, 0x1000);
+    ASSERT_TRUE(gone.isError());
+    EXPECT_EQ(gone.errorCode(), ErrorCode::ProcessGone);
+}
+
 // Test: 验证无效地址
 TEST_F(ProcessManagerTest, IsInvalidAddress) {
     pid_t currentPid = getpid();
@@ -140,3 +182,52 @@ TEST_F(ProcessManagerTest, MemoryMapsOrdering) {
         EXPECT_LE(regions[i-1].start, regions[i].start);
     }
 }
+
+// Test: 批量读取 pagemap，写过的页在内存中，未访问的页不在
+TEST_F(ProcessManagerTest, ReadPagemap) {
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    void* mapping = mmap(nullptr, 4 * pageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(mapping, MAP_FAILED);
+    uint8_t* pages = static_cast<uint8_t*>(mapping);
+    pages[0] = 1;
+    pages[2 * pageSize] = 1;
+    
+    uint64_t entries[4] = {};
+    auto result = pm.readPagemap(getpid(), reinterpret_cast<uintptr_t>(pages), entries, 4);
+    ASSERT_TRUE(result.isSuccess()) << result.errorMessage();
+    EXPECT_EQ(result.value(), 4u);
+    EXPECT_NE(entries[0] & ProcessManager::kPagemapPresent, 0u);
+    EXPECT_EQ(entries[1] & ProcessManager::kPagemapPresent, 0u);
+    EXPECT_NE(entries[2] & ProcessManager::kPagemapPresent, 0u);
+    EXPECT_EQ(entries[3] & ProcessManager::kPagemapPresent, 0u);
+    munmap(mapping, 4 * pageSize);
+    
+    EXPECT_TRUE(pm.readPagemap(99999, 0x1000, entries, 4).isError());
+}
+
+// Test: 清除 soft-dirty 后只有再次写入的页带有 soft-dirty 位，不支持时返回 Unavailable
+TEST_F(ProcessManagerTest, ClearSoftDirty) {
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    void* mapping = mmap(nullptr, 2 * pageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(mapping, MAP_FAILED);
+    volatile uint8_t* pages = static_cast<uint8_t*>(mapping);
+    pages[0] = 1;
+    pages[pageSize] = 1;
+    
+    auto cleared = pm.clearSoftDirty(getpid());
+    if (!ProcessManager::softDirtySupported()) {
+        ASSERT_TRUE(cleared.isError());
+        EXPECT_EQ(cleared.errorCode(), ErrorCode::Unavailable);
+        munmap(mapping, 2 * pageSize);
+        return;
+    }
+    ASSERT_TRUE(cleared.isSuccess()) << cleared.errorMessage();
+    pages[pageSize] = 2;
+    
+    uint64_t entries[2] = {};
+    auto result = pm.readPagemap(getpid(), reinterpret_cast<uintptr_t>(mapping), entries, 2);
+    ASSERT_TRUE(result.isSuccess()) << result.errorMessage();
+    EXPECT_EQ(entries[0] & ProcessManager::kPagemapSoftDirty, 0u);
+    EXPECT_NE(entries[1] & ProcessManager::kPagemapSoftDirty, 0u);
+    munmap(mapping, 2 * pageSize);
+}
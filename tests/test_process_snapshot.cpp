@@ -0,0 +1,243 @@
+#include <gtest/gtest.h>
+#include "process_snapshot.h"
+#include "signature_scanner.h"
+#include "test_process_fixture.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+using namespace ukc;
+
+class ProcessSnapshotTest : public ::testing::Test {
+protected:
+    static constexpr size_t kPageSize = 4096;
+    static constexpr size_t kPages = 8;
+    static constexpr size_t kHolePage = 5;          // 子进程中不可读的页
+    
+    test::TestMapping mapping_{kPages * kPageSize};
+    test::TestChild process_;
+    uint8_t* region_ = nullptr;
+    pid_t child_ = -1;
+    std::string path_;
+    
+    void SetUp() override {
+        path_ = "/tmp/ukc_snapshot_test_" + std::to_string(getpid()) + ".snap";
+        
+        // 前 4 页为可压缩的数据，第 4 页全零，第 5 页在子进程中不可读
+        ASSERT_TRUE(mapping_.isValid());
+        region_ = mapping_.data();
+        for (size_t i = 0; i < kPages * kPageSize; ++i) {
+            region_[i] = expected(i);
+        }
+        std::memset(region_ + 4 * kPageSize, 0, kPageSize);
+        
+        // 特征码跨越第 1、2 页的边界
+        static const uint8_t marker[] = {0x5A, 0xC3, 0x17, 0xE9, 0x42, 0x8B, 0x6D, 0x01};
+        std::memcpy(region_ + 2 * kPageSize - 3, marker, sizeof(marker));
+        
+        uint8_t* hole = region_ + kHolePage * kPageSize;
+        child_ = process_.spawn([hole]() { mprotect(hole, kPageSize, PROT_NONE); });
+        ASSERT_GT(child_, 0);
+        
+        // 等子进程完成 mprotect
+        for (int i = 0; i < 1000 && childPermissions().empty(); ++i) {
+            usleep(1000);
+        }
+    }
+    
+    void TearDown() override {
+        process_.stop();
+        unlink(path_.c_str());
+    }
+    
+    static uint8_t expected(size_t offset) {
+        return static_cast<uint8_t>((offset / 64) % 7);
+    }
+    
+    /**
+     * 子进程中不可读页的权限，mprotect 之前为空
+     */
+    std::string childPermissions() {
+        std::ifstream maps("/proc/" + std::to_string(child_) + "/maps");
+        uintptr_t hole = reinterpret_cast<uintptr_t>(region_) + kHolePage * kPageSize;
+        std::string line;
+        while (std::getline(maps, line)) {
+            if (std::stoull(line.substr(0, line.find('-')), nullptr, 16) == hole) {
+                return line.substr(line.find(' ') + 1, 4);
+            }
+        }
+        return "";
+    }
+    
+    SnapshotWriterConfig smallBlocks(SnapshotCompression compression) {
+        SnapshotWriterConfig config;
+        config.blockSize = kPageSize;
+        config.readBatchSize = 4 * kPageSize;
+        config.compression = compression;
+        return config;
+    }
+};
+
+// Test: 捕获后读回的数据与子进程内存一致，全零页和不可读页不占数据空间
+TEST_F(ProcessSnapshotTest, CaptureAndReadBack) {
+    SnapshotWriter writer(smallBlocks(SnapshotCompression::None));
+    auto stats = writer.capture(child_, {mapping_.region()}, path_);
+    ASSERT_TRUE(stats.isSuccess()) << stats.errorMessage();
+    EXPECT_EQ(stats.value().regions, 1u);
+    EXPECT_EQ(stats.value().bytesCaptured, (kPages - 1) * kPageSize);
+    EXPECT_EQ(stats.value().bytesUnreadable, kPageSize);
+    EXPECT_EQ(stats.value().zeroBlocks, 1u);
+    EXPECT_EQ(stats.value().bytesStored, (kPages - 2) * kPageSize);
+    EXPECT_GE(stats.value().readCalls, 2u);
+    
+    auto snapshot = SnapshotReader::open(path_);
+    ASSERT_TRUE(snapshot.isSuccess()) << snapshot.errorMessage();
+    const SnapshotReader& reader = snapshot.value();
+    EXPECT_EQ(reader.info().pid, child_);
+    EXPECT_EQ(reader.info().blockSize, kPageSize);
+    ASSERT_EQ(reader.regions().size(), 1u);
+    EXPECT_EQ(reader.regions()[0].start, mapping_.region().start);
+    EXPECT_EQ(reader.regions()[0].permissions, "rw-p");
+    
+    std::vector<uint8_t> buffer(kPages * kPageSize);
+    auto read = reader.read(mapping_.region().start, buffer.data(), buffer.size());
+    ASSERT_TRUE(read.isSuccess()) << read.errorMessage();
+    ASSERT_EQ(read.value(), kHolePage * kPageSize);
+    EXPECT_EQ(std::memcmp(buffer.data(), region_, read.value()), 0);
+    
+    // 连续的未压缩块直接指向映射
+    auto span = reader.span(mapping_.region().start, 2 * kPageSize, buffer.data());
+    EXPECT_NE(span.data, buffer.data());
+    EXPECT_EQ(span.size, 2 * kPageSize);
+    
+    auto hole = reader.read(mapping_.region().start + kHolePage * kPageSize, buffer.data(), 16);
+    ASSERT_TRUE(hole.isError());
+    EXPECT_EQ(hole.errorCode(), ErrorCode::ReadFailed);
+    
+    auto outside = reader.read(mapping_.region().end, buffer.data(), 16);
+    ASSERT_TRUE(outside.isError());
+    EXPECT_EQ(outside.errorCode(), ErrorCode::InvalidAddress);
+    
+    auto tail = reader.read(mapping_.region().start + (kHolePage + 1) * kPageSize, buffer.data(), 2 * kPageSize);
+    ASSERT_TRUE(tail.isSuccess());
+    EXPECT_EQ(std::memcmp(buffer.data(), region_ + (kHolePage + 1) * kPageSize, 2 * kPageSize), 0);
+}
+
+// Test: LZ4 压缩的快照更小，读回的数据相同
+TEST_F(ProcessSnapshotTest, Lz4Compression) {
+    SnapshotWriter writer(smallBlocks(SnapshotCompression::Lz4));
+    auto stats = writer.capture(child_, {mapping_.region()}, path_);
+    ASSERT_TRUE(stats.isSuccess()) << stats.errorMessage();
+    EXPECT_LT(stats.value().bytesStored, kPageSize);
+    
+    auto snapshot = SnapshotReader::open(path_);
+    ASSERT_TRUE(snapshot.isSuccess()) << snapshot.errorMessage();
+    std::vector<uint8_t> buffer(kPages * kPageSize);
+    
+    // 从块中间开始读，跨越多个压缩块
+    auto read = snapshot.value().read(mapping_.region().start + 100, buffer.data(), 3 * kPageSize);
+    ASSERT_TRUE(read.isSuccess()) << read.errorMessage();
+    EXPECT_EQ(read.value(), 3 * kPageSize);
+    EXPECT_EQ(std::memcmp(buffer.data(), region_ + 100, 3 * kPageSize), 0);
+}
+
+// Test: 覆盖已有快照时先写临时文件再替换，失败不破坏旧快照，已打开的读取器不受影响
+TEST_F(ProcessSnapshotTest, ReplacesExistingSnapshotAtomically) {
+    SnapshotWriter lz4Writer(smallBlocks(SnapshotCompression::Lz4));
+    ASSERT_TRUE(lz4Writer.capture(child_, {mapping_.region()}, path_).isSuccess());
+    auto previous = SnapshotReader::open(path_);
+    ASSERT_TRUE(previous.isSuccess()) << previous.errorMessage();
+    
+    SnapshotWriter writer(smallBlocks(SnapshotCompression::None));
+    auto replaced = writer.capture(child_, {mapping_.region()}, path_);
+    ASSERT_TRUE(replaced.isSuccess()) << replaced.errorMessage();
+    
+    // 旧的映射仍指向被替换的文件
+    std::vector<uint8_t> buffer(kHolePage * kPageSize);
+    auto read = previous.value().read(mapping_.region().start, buffer.data(), buffer.size());
+    ASSERT_TRUE(read.isSuccess()) << read.errorMessage();
+    EXPECT_EQ(std::memcmp(buffer.data(), region_, buffer.size()), 0);
+    
+    // 临时文件无法创建时捕获失败，目标路径上的快照保持不变
+    std::string tempPath = path_ + ".tmp";
+    ASSERT_EQ(mkdir(tempPath.c_str(), 0755), 0);
+    auto failed = lz4Writer.capture(child_, {mapping_.region()}, path_);
+    rmdir(tempPath.c_str());
+    ASSERT_TRUE(failed.isError());
+    
+    auto current = SnapshotReader::open(path_);
+    ASSERT_TRUE(current.isSuccess()) << current.errorMessage();
+    EXPECT_EQ(current.value().info().pid, child_);
+    EXPECT_GT(current.value().info().fileSize, previous.value().info().fileSize);
+    read = current.value().read(mapping_.region().start, buffer.data(), buffer.size());
+    ASSERT_TRUE(read.isSuccess()) << read.errorMessage();
+    EXPECT_EQ(std::memcmp(buffer.data(), region_, buffer.size()), 0);
+}
+
+// Test: 扫描快照与扫描原进程的结果相同，包括跨块的命中
+TEST_F(ProcessSnapshotTest, ScanSnapshotMatchesProcess) {
+    SignaturePattern pattern;
+    pattern.bytes = {0x5A, 0xC3, 0x17, 0xE9, 0x42, 0x8B, 0x6D, 0x01};
+    pattern.mask.assign(pattern.bytes.size(), true);
+    pattern.alignment = 1;
+    RegionFilter filter;
+    filter.permissions = "rw?";
+    ProcessScanConfig scanConfig;
+    scanConfig.chunkSize = kPageSize;
+    
+    auto live = SignatureScanner::scanProcess(child_, {pattern}, filter, scanConfig);
+    ASSERT_TRUE(live.isSuccess()) << live.errorMessage();
+    
+    for (auto compression : {SnapshotCompression::None, SnapshotCompression::Lz4}) {
+        SnapshotWriter writer(smallBlocks(compression));
+        auto stats = writer.capture(child_, path_, filter);
+        ASSERT_TRUE(stats.isSuccess()) << stats.errorMessage();
+        
+        auto snapshot = SnapshotReader::open(path_);
+        ASSERT_TRUE(snapshot.isSuccess()) << snapshot.errorMessage();
+        auto offline = SignatureScanner::scanSnapshot(snapshot.value(), {pattern}, filter, scanConfig);
+        ASSERT_TRUE(offline.isSuccess()) << offline.errorMessage();
+        
+        ASSERT_EQ(offline.value().matches.size(), live.value().matches.size());
+        for (size_t i = 0; i < live.value().matches.size(); ++i) {
+            EXPECT_EQ(offline.value().matches[i].address, live.value().matches[i].address);
+        }
+        bool found = false;
+        for (const auto& match : offline.value().matches) {
+            found = found || match.address == reinterpret_cast<uintptr_t>(region_ + 2 * kPageSize - 3);
+        }
+        EXPECT_TRUE(found);
+        EXPECT_EQ(offline.value().bytesScanned + offline.value().bytesUnreadable,
+                  live.value().bytesScanned + live.value().bytesUnreadable + live.value().bytesNonResident);
+    }
+}
+
+// Test: 打开不存在或格式错误的文件返回错误
+TEST_F(ProcessSnapshotTest, RejectsInvalidFiles) {
+    auto missing = SnapshotReader::open(path_ + ".missing");
+    ASSERT_TRUE(missing.isError());
+    EXPECT_EQ(missing.errorCode(), ErrorCode::Unavailable);
+    
+    FILE* file = fopen(path_.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    std::vector<uint8_t> garbage(4096, 0x5A);
+    fwrite(garbage.data(), 1, garbage.size(), file);
+    fclose(file);
+    auto corrupt = SnapshotReader::open(path_);
+    ASSERT_TRUE(corrupt.isError());
+    EXPECT_EQ(corrupt.errorCode(), ErrorCode::InvalidArgument);
+    
+    // 截断的快照（表超出文件范围）
+    SnapshotWriter writer(smallBlocks(SnapshotCompression::None));
+    ASSERT_TRUE(writer.capture(child_, {mapping_.region()}, path_).isSuccess());
+    ASSERT_EQ(truncate(path_.c_str(), 2 * kPageSize), 0);
+    auto truncated = SnapshotReader::open(path_);
+    ASSERT_TRUE(truncated.isError());
+    EXPECT_EQ(truncated.errorCode(), ErrorCode::InvalidArgument);
+}
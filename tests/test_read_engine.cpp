@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include "read_engine.h"
+#include "test_process_fixture.h"
+#include <cstdint>
+#include <cstring>
+#include <unistd.h>
+#include <sys/types.h>
+
+using namespace ukc;
+
+class ReadEngineTest : public ::testing::Test {
+protected:
+    static constexpr size_t kPageSize = 4096;
+    static constexpr size_t kPages = 4;
+    
+    test::TestMapping mapping_{(kPages + 1) * kPageSize};
+    test::TestChild process_;
+    uint8_t* region_ = nullptr;
+    uintptr_t hole_ = 0;
+    pid_t child_ = -1;
+    
+    void SetUp() override {
+        // 数据页之后紧跟一个未映射的页，fork 后子进程拥有相同布局
+        ASSERT_TRUE(mapping_.isValid());
+        mapping_.shrink(kPages * kPageSize);
+        region_ = mapping_.data();
+        hole_ = reinterpret_cast<uintptr_t>(region_ + kPages * kPageSize);
+        for (size_t i = 0; i < kPages * kPageSize; ++i) {
+            region_[i] = static_cast<uint8_t>(i * 7 + 3);
+        }
+        
+        child_ = process_.spawn();
+        ASSERT_GT(child_, 0);
+        
+        // 子进程退出前修改父进程的副本，确认读到的是子进程的内存
+        std::memset(region_, 0, kPages * kPageSize);
+    }
+    
+    MemoryOperation readOp(uintptr_t address, size_t size) {
+        MemoryOperation op;
+        op.type = OperationType::Read;
+        op.address = address;
+        op.size = size;
+        return op;
+    }
+    
+    bool matchesChild(const MemoryOperation& op) {
+        size_t offset = op.address - reinterpret_cast<uintptr_t>(region_);
+        for (size_t i = 0; i < op.size; ++i) {
+            if (op.result[i] != static_cast<uint8_t>((offset + i) * 7 + 3)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    void runBatch(ReadEngine& engine, ReadEngineStats& stats) {
+        auto handle = ProcessHandle::open(child_);
+        ASSERT_TRUE(handle.isSuccess()) << handle.errorMessage();
+        const ProcessHandle& process = handle.value();
+        if (process.memFd() < 0) {
+            GTEST_SKIP() << "/proc/<pid>/mem unavailable";
+        }
+        
+        uintptr_t base = reinterpret_cast<uintptr_t>(region_);
+        std::vector<MemoryOperation> operations;
+        operations.push_back(readOp(base, 16));
+        operations.push_back(readOp(base + 16, 48));           // 与上一个首尾相接
+        operations.push_back(readOp(base + 3 * kPageSize, 2 * kPageSize));  // 跨入未映射页
+        operations.push_back(readOp(base + kPageSize, 2 * kPageSize));  // 超过槽大小
+        operations.push_back(readOp(hole_, 8));
+        operations.push_back(readOp(base + 100, 0));
+        MemoryOperation write;
+        write.type = OperationType::Write;
+        write.address = base;
+        write.data = {1, 2, 3};
+        operations.push_back(write);
+        
+        auto result = engine.read(process, operations.data(), operations.size(), &stats);
+        ASSERT_TRUE(result.isSuccess()) << result.errorMessage();
+        EXPECT_EQ(result.value(), 4u);
+        EXPECT_EQ(stats.reads, 6u);
+        EXPECT_EQ(stats.failed, 2u);
+        
+        EXPECT_TRUE(operations[0].success);
+        EXPECT_TRUE(matchesChild(operations[0]));
+        EXPECT_TRUE(operations[1].success);
+        EXPECT_TRUE(matchesChild(operations[1]));
+        EXPECT_FALSE(operations[2].success);
+        EXPECT_EQ(operations[2].error.code(), ErrorCode::ReadFailed);
+        EXPECT_TRUE(operations[3].success);
+        EXPECT_TRUE(matchesChild(operations[3]));
+        EXPECT_FALSE(operations[4].success);
+        EXPECT_EQ(operations[4].error.code(), ErrorCode::ReadFailed);
+        EXPECT_EQ(operations[4].error.address(), hole_);
+        EXPECT_TRUE(operations[5].success);
+        EXPECT_FALSE(operations[6].success);  // 写操作不由引擎执行
+    }
+};
+
+// Test: io_uring 后端读取子进程内存，逐个回填结果
+TEST_F(ReadEngineTest, IoUringBackend) {
+    ReadEngineConfig config;
+    config.queueDepth = 2;  // 小于读操作数，覆盖队列复用
+    ReadEngine engine(config);
+    if (engine.backend() != ReadBackend::IoUring) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    
+    ReadEngineStats stats;
+    runBatch(engine, stats);
+    EXPECT_GT(stats.fixedReads, 0u);
+}
+
+// Test: preadv 后端读取子进程内存，首尾相接的读取合并
+TEST_F(ReadEngineTest, PreadvBackend) {
+    ReadEngineConfig config;
+    config.backend = ReadBackend::Preadv;
+    ReadEngine engine(config);
+    EXPECT_EQ(engine.backend(), ReadBackend::Preadv);
+    
+    ReadEngineStats stats;
+    runBatch(engine, stats);
+    EXPECT_EQ(stats.fixedReads, 0u);
+    EXPECT_EQ(stats.syscalls, 4u);  // 前两个读取合并为一次 preadv
+}
+
+// Test: 进程退出后读取报告 ProcessGone
+TEST_F(ReadEngineTest, ProcessGone) {
+    auto handle = ProcessHandle::open(child_);
+    ASSERT_TRUE(handle.isSuccess());
+    if (handle.value().memFd() < 0) {
+        GTEST_SKIP() << "/proc/<pid>/mem unavailable";
+    }
+    
+    kill(child_, SIGKILL);
+    waitpid(child_, nullptr, 0);
+    child_ = -1;
+    
+    for (ReadBackend backend : {ReadBackend::IoUring, ReadBackend::Preadv}) {
+        ReadEngineConfig config;
+        config.backend = backend;
+        ReadEngine engine(config);
+        std::vector<MemoryOperation> operations{readOp(reinterpret_cast<uintptr_t>(region_), 8)};
+        auto result = engine.read(handle.value(), operations.data(), operations.size());
+        ASSERT_TRUE(result.isSuccess());
+        EXPECT_EQ(result.value(), 0u);
+        EXPECT_EQ(operations[0].error.code(), ErrorCode::ProcessGone);
+    }
+}
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 #include "result.h"
+#include <cerrno>
+#include <cstring>
+#include <string>
 
 using namespace ukc;
 
@@ -24,11 +27,11 @@ TEST_F(ResultTest, ErrorResult) {
     EXPECT_EQ(result.errorMessage(), "Test error");
 }
 
-// 测试从错误结果获取值会抛出异常
-TEST_F(ResultTest, GetValueFromErrorThrows) {
+// 测试从错误结果获取值会终止进程（Result 不抛出异常）
+TEST_F(ResultTest, GetValueFromErrorAborts) {
     Result<int> result = Result<int>::error("Test error");
     
-    EXPECT_THROW(result.value(), std::runtime_error);
+    EXPECT_DEATH((void)result.value(), "Test error");
 }
 
 // 测试 Result<void> 成功
@@ -55,3 +58,87 @@ TEST_F(ResultTest, MoveValue) {
     std::string value = result.moveValue();
     EXPECT_EQ(value, "Hello");
 }
+
+// 测试值类型不需要默认构造
+TEST_F(ResultTest, NonDefaultConstructibleValue) {
+    struct Handle {
+        explicit Handle(int fd) : fd(fd) {}
+        int fd;
+    };
+    
+    Result<Handle> ok = Result<Handle>::success(Handle(3));
+    Result<Handle> failed = Result<Handle>::error("no handle");
+    
+    EXPECT_EQ(ok.value().fd, 3);
+    EXPECT_TRUE(failed.isError());
+}
+
+// 测试结构化错误按需格式化
+TEST_F(ResultTest, StructuredError) {
+    Result<int> result = Error(ErrorCode::ReadFailed, EACCES, "process_vm_readv");
+    
+    EXPECT_TRUE(result.isError());
+    EXPECT_EQ(result.errorCode(), ErrorCode::ReadFailed);
+    EXPECT_EQ(result.errorInfo().sysErrno(), EACCES);
+    EXPECT_EQ(result.errorMessage(),
+              std::string("Read failed: process_vm_readv: ") + std::strerror(EACCES));
+    
+    Result<int> legacy = Result<int>::error("Test error");
+    EXPECT_EQ(legacy.errorCode(), ErrorCode::Unknown);
+    
+    Result<int> ok = Result<int>::success(1);
+    EXPECT_EQ(ok.errorCode(), ErrorCode::None);
+    EXPECT_TRUE(ok.errorMessage().empty());
+}
+
+// 测试错误负载的格式化
+TEST_F(ResultTest, ErrorPayloadMessage) {
+    Error error = Error(ErrorCode::ReadFailed, EFAULT, "process_vm_readv")
+        .withAddress(0x7f0010)
+        .withSize(16)
+        .withPid(42);
+    
+    EXPECT_TRUE(error.hasAddress());
+    EXPECT_FALSE(Error(ErrorCode::ReadFailed).hasAddress());
+    EXPECT_EQ(error.message(),
+              std::string("Read failed at 0x7f0010 (16 bytes, pid 42): process_vm_readv: ") +
+              std::strerror(EFAULT));
+    
+    Error symbol = Error(ErrorCode::SymbolNotFound, 0, "/proc/kallsyms").withName("do_sys_open");
+    EXPECT_EQ(symbol.name(), "do_sys_open");
+    EXPECT_EQ(symbol.message(), "Symbol not found 'do_sys_open': /proc/kallsyms");
+    
+    EXPECT_TRUE(Error::fromMessage("plain").name().empty());
+}
+
+// 测试 and_then 和 map 链式调用
+TEST_F(ResultTest, MonadicChaining) {
+    auto half = [](int value) {
+        return value % 2 == 0 ? Result<int>::success(value / 2)
+                              : Result<int>::error("odd value");
+    };
+    
+    auto chained = Result<int>::success(8).and_then(half).and_then(half).map(
+        [](int value) { return std::to_string(value); }
+    );
+    ASSERT_TRUE(chained.isSuccess());
+    EXPECT_EQ(chained.value(), "2");
+    
+    auto failed = Result<int>::success(6).and_then(half).and_then(half).map(
+        [](int value) { return value * 10; }
+    );
+    ASSERT_TRUE(failed.isError());
+    EXPECT_EQ(failed.errorMessage(), "odd value");
+    
+    int calls = 0;
+    Result<void> done = Result<void>::success().map([&calls]() { calls++; });
+    Result<void> skipped = Result<void>::error("stop").and_then([&calls]() {
+        calls++;
+        return Result<void>::success();
+    });
+    EXPECT_TRUE(done.isSuccess());
+    EXPECT_TRUE(skipped.isError());
+    EXPECT_EQ(calls, 1);
+    
+    EXPECT_EQ(Result<int>::error("x").valueOr(7), 7);
+}
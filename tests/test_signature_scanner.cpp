@@ -1,5 +1,11 @@
 #include <gtest/gtest.h>
 #include "signature_scanner.h"
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 
 using namespace ukc;
 
@@ -88,3 +94,166 @@ TEST_F(SignatureScannerTest, ScanFirstNotFound) {
     
     EXPECT_TRUE(result.isError());
 }
+
+// 在映射中写入一段不会出现在别处的特征码（运行时生成，避免与模式本身的字节重复）
+static SignaturePattern plantSignature(uint8_t* target) {
+    SignaturePattern pattern;
+    for (int i = 0; i < 12; ++i) {
+        pattern.bytes.push_back(static_cast<uint8_t>(0xA5 ^ (i * 29)));
+    }
+    pattern.mask.assign(pattern.bytes.size(), true);
+    pattern.alignment = 1;
+    std::memcpy(target, pattern.bytes.data(), pattern.bytes.size());
+    return pattern;
+}
+
+static bool containsAddress(const ProcessScanResult& result, uintptr_t address) {
+    return std::any_of(result.matches.begin(), result.matches.end(),
+        [address](const ProcessScanMatch& match) { return match.address == address; });
+}
+
+// 测试区域过滤条件
+TEST_F(SignatureScannerTest, RegionFilterMatches) {
+    MemoryRegion region;
+    region.permissions = "r-xp";
+    region.path = "/system/lib64/libc.so";
+    
+    RegionFilter filter;
+    EXPECT_TRUE(filter.matches(region));
+    
+    filter.permissions = "r-x";
+    EXPECT_TRUE(filter.matches(region));
+    filter.permissions = "rw?";
+    EXPECT_FALSE(filter.matches(region));
+    
+    filter.permissions.clear();
+    filter.pathContains = "libc";
+    EXPECT_TRUE(filter.matches(region));
+    filter.pathContains = "libm";
+    EXPECT_FALSE(filter.matches(region));
+    
+    MemoryRegion special;
+    special.permissions = "r--p";
+    special.path = "[vvar]";
+    EXPECT_FALSE(RegionFilter().matches(special));
+    
+    MemoryRegion unreadable;
+    unreadable.permissions = "---p";
+    EXPECT_FALSE(RegionFilter().matches(unreadable));
+}
+
+// 测试扫描当前进程
+TEST_F(SignatureScannerTest, ScanProcessFindsPlantedSignature) {
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    void* mapping = mmap(nullptr, pageSize * 4, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(mapping, MAP_FAILED);
+    
+    // 特征码跨越页边界，块大小设为一页以覆盖跨块命中
+    uint8_t* base = static_cast<uint8_t*>(mapping);
+    uint8_t* target = base + pageSize * 2 - 5;
+    auto pattern = plantSignature(target);
+    
+    RegionFilter filter;
+    filter.permissions = "rw";
+    ProcessScanConfig config;
+    config.chunkSize = pageSize;
+    config.threadCount = 2;
+    
+    auto result = SignatureScanner::scanProcess(getpid(), {pattern}, filter, config);
+    ASSERT_TRUE(result.isSuccess());
+    
+    uintptr_t expected = reinterpret_cast<uintptr_t>(target);
+    EXPECT_EQ(std::count_if(result.value().matches.begin(), result.value().matches.end(),
+        [expected](const ProcessScanMatch& match) { return match.address == expected; }), 1);
+    
+    for (const auto& match : result.value().matches) {
+        const auto& region = result.value().regions[match.regionIndex];
+        EXPECT_GE(match.address, region.start);
+        EXPECT_LT(match.address, region.end);
+    }
+    EXPECT_GT(result.value().bytesScanned, 0);
+    
+    munmap(mapping, pageSize * 4);
+}
+
+// 测试跳过不可读的页
+TEST_F(SignatureScannerTest, ScanProcessSkipsUnreadablePages) {
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    char path[] = "/tmp/ukc_scan_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(ftruncate(fd, static_cast<off_t>(pageSize)), 0);
+    
+    // 文件只有一页，映射三页：超出文件末尾的页不可读
+    void* mapping = mmap(nullptr, pageSize * 3, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ASSERT_NE(mapping, MAP_FAILED);
+    uint8_t* target = static_cast<uint8_t*>(mapping) + 128;
+    auto pattern = plantSignature(target);
+    
+    RegionFilter filter;
+    filter.pathContains = path;
+    auto result = SignatureScanner::scanProcess(getpid(), {pattern}, filter);
+    
+    munmap(mapping, pageSize * 3);
+    close(fd);
+    unlink(path);
+    
+    ASSERT_TRUE(result.isSuccess());
+    ASSERT_EQ(result.value().regions.size(), 1);
+    EXPECT_TRUE(containsAddress(result.value(), reinterpret_cast<uintptr_t>(target)));
+    EXPECT_EQ(result.value().bytesScanned, pageSize);
+    EXPECT_EQ(result.value().bytesUnreadable, pageSize * 2);
+}
+
+// 测试跳过匿名映射中未驻留的页：不读取、不触发缺页，命中不受影响
+TEST_F(SignatureScannerTest, ScanProcessSkipsNonResidentPages) {
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t pages = 256;
+    void* mapping = mmap(nullptr, pageSize * pages, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(mapping, MAP_FAILED);
+    
+    // 只写入第 0 页和第 100 页，特征码放在第 100 页
+    uint8_t* base = static_cast<uint8_t*>(mapping);
+    base[0] = 1;
+    uint8_t* target = base + pageSize * 100 + 64;
+    auto pattern = plantSignature(target);
+    
+    ProcessScanConfig config;
+    config.chunkSize = pageSize * 64;
+    auto scanOnly = [&](bool skip) {
+        config.skipNonResident = skip;
+        ProcessScanResult result;
+        auto scanResult = SignatureScanner::scanProcess(getpid(), {pattern}, RegionFilter(), config);
+        EXPECT_TRUE(scanResult.isSuccess());
+        if (scanResult.isSuccess()) {
+            result = scanResult.value();
+        }
+        return result;
+    };
+    
+    ProcessScanResult skipped = scanOnly(true);
+    EXPECT_TRUE(containsAddress(skipped, reinterpret_cast<uintptr_t>(target)));
+    EXPECT_GE(skipped.bytesNonResident, pageSize * (pages - 2));
+    
+    // 跳过的页仍未驻留
+    unsigned char residency[pages];
+    ASSERT_EQ(mincore(mapping, pageSize * pages, residency), 0);
+    EXPECT_EQ(residency[1] & 1, 0);
+    EXPECT_EQ(residency[200] & 1, 0);
+    
+    ProcessScanResult full = scanOnly(false);
+    EXPECT_TRUE(containsAddress(full, reinterpret_cast<uintptr_t>(target)));
+    EXPECT_EQ(full.bytesNonResident, 0u);
+    
+    munmap(mapping, pageSize * pages);
+}
+
+// 测试扫描参数错误
+TEST_F(SignatureScannerTest, ScanProcessErrors) {
+    auto pattern = SignaturePattern::fromHexString("01 02 03 04");
+    EXPECT_TRUE(SignatureScanner::scanProcess(getpid(), {}).isError());
+    EXPECT_TRUE(SignatureScanner::scanProcess(getpid(), {SignaturePattern()}).isError());
+    EXPECT_TRUE(SignatureScanner::scanProcess(99999, {pattern}).isError());
+}
@@ -0,0 +1,335 @@
+#include <gtest/gtest.h>
+#include "process_manager.h"
+#include "process_snapshot.h"
+#include "signature_scanner.h"
+#include "snapshot_store.h"
+#include "xxhash64.h"
+#include "test_process_fixture.h"
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/types.h>
+
+using namespace ukc;
+
+// Test: XXH64 与参考实现的结果一致
+TEST(XxHash64Test, ReferenceVectors) {
+    EXPECT_EQ(xxhash64("", 0), 0xef46db3751d8e999ull);
+    EXPECT_EQ(xxhash64("a", 1), 0xd24ec4f1a98c6e5bull);
+    EXPECT_EQ(xxhash64("abc", 3), 0x44bc2cf5ad770999ull);
+    EXPECT_EQ(xxhash64("abcdefghijklmnopqrstuvwxyz0123456789", 36), 0x64f23ecf1609b766ull);
+    
+    std::vector<uint8_t> bytes(100);
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<uint8_t>(i);
+    }
+    EXPECT_EQ(xxhash64(bytes.data(), bytes.size()), 0x6ac1e58032166597ull);
+    
+    std::vector<uint8_t> page(4096);
+    for (size_t i = 0; i < page.size(); ++i) {
+        page[i] = static_cast<uint8_t>(i * 7 + 3);
+    }
+    EXPECT_EQ(xxhash64(page.data(), page.size()), 0x796398cd432797ccull);
+    EXPECT_EQ(xxhash64(page.data(), page.size(), 1), 0x22154cb5a9b7bbefull);
+}
+
+class SnapshotStoreTest : public ::testing::Test {
+protected:
+    static constexpr size_t kPageSize = 4096;
+    static constexpr size_t kPages = 16;
+    
+    std::string directory_;
+    test::TestMapping mapping_{kPages * kPageSize};
+    test::TestChild process_;
+    uint8_t* region_ = nullptr;
+    pid_t child_ = -1;
+    
+    void SetUp() override {
+        directory_ = "/tmp/ukc_store_test_" + std::to_string(getpid());
+        std::filesystem::remove_all(directory_);
+        
+        ASSERT_TRUE(mapping_.isValid());
+        region_ = mapping_.data();
+        for (size_t i = 0; i < kPages * kPageSize; ++i) {
+            region_[i] = static_cast<uint8_t>((i * 31) ^ (i >> 12));
+        }
+    }
+    
+    void TearDown() override {
+        process_.stop();
+        std::filesystem::remove_all(directory_);
+    }
+    
+    std::string path(const std::string& name) {
+        return directory_ + "/" + name;
+    }
+    
+    /**
+     * 启动子进程，之后可用 touchChildPage 修改子进程中的页
+     */
+    void startChild() {
+        child_ = process_.spawnToggler(region_, kPageSize);
+        ASSERT_GT(child_, 0);
+    }
+    
+    /**
+     * 翻转子进程（以及本进程副本）中第 page 页的第一个字节
+     */
+    void touchChildPage(uint8_t page) {
+        ASSERT_TRUE(process_.togglePage(page));
+    }
+    
+    void expectMatchesRegion(const std::string& snapshotPath) {
+        auto snapshot = SnapshotReader::open(snapshotPath);
+        ASSERT_TRUE(snapshot.isSuccess()) << snapshot.errorMessage();
+        std::vector<uint8_t> buffer(kPages * kPageSize);
+        auto copied = snapshot.value().read(mapping_.region().start, buffer.data(), buffer.size());
+        ASSERT_TRUE(copied.isSuccess()) << copied.errorMessage();
+        ASSERT_EQ(copied.value(), buffer.size());
+        EXPECT_EQ(std::memcmp(buffer.data(), region_, buffer.size()), 0);
+    }
+};
+
+// Test: 相同内容的页只存一份，重新打开后仍能去重
+TEST_F(SnapshotStoreTest, PutDeduplicatesAndPersists) {
+    std::vector<uint8_t> a(kPageSize, 0x11);
+    std::vector<uint8_t> b(kPageSize, 0x22);
+    uint64_t offsetA = 0;
+    {
+        auto store = SnapshotStore::open(directory_, kPageSize);
+        ASSERT_TRUE(store.isSuccess()) << store.errorMessage();
+        
+        bool existed = true;
+        auto first = store.value().put(a.data(), &existed);
+        ASSERT_TRUE(first.isSuccess());
+        EXPECT_FALSE(existed);
+        offsetA = first.value();
+        
+        auto second = store.value().put(b.data(), &existed);
+        ASSERT_TRUE(second.isSuccess());
+        EXPECT_FALSE(existed);
+        EXPECT_NE(second.value(), offsetA);
+        
+        auto again = store.value().put(a.data(), &existed);
+        ASSERT_TRUE(again.isSuccess());
+        EXPECT_TRUE(existed);
+        EXPECT_EQ(again.value(), offsetA);
+        EXPECT_EQ(store.value().pageCount(), 2u);
+        ASSERT_TRUE(store.value().flush().isSuccess());
+    }
+    
+    auto reopened = SnapshotStore::open(directory_, kPageSize);
+    ASSERT_TRUE(reopened.isSuccess()) << reopened.errorMessage();
+    EXPECT_EQ(reopened.value().pageCount(), 2u);
+    bool existed = false;
+    auto again = reopened.value().put(a.data(), &existed);
+    ASSERT_TRUE(again.isSuccess());
+    EXPECT_TRUE(existed);
+    EXPECT_EQ(again.value(), offsetA);
+}
+
+// Test: 同一存储不能被两个写入器同时打开，页大小必须一致
+TEST_F(SnapshotStoreTest, ExclusiveOpen) {
+    auto store = SnapshotStore::open(directory_, kPageSize);
+    ASSERT_TRUE(store.isSuccess()) << store.errorMessage();
+    
+    auto second = SnapshotStore::open(directory_, kPageSize);
+    ASSERT_TRUE(second.isError());
+    EXPECT_EQ(second.errorCode(), ErrorCode::Unavailable);
+    
+    store.value() = SnapshotStore();
+    auto wrongPageSize = SnapshotStore::open(directory_, 2 * kPageSize);
+    ASSERT_TRUE(wrongPageSize.isError());
+    EXPECT_EQ(wrongPageSize.errorCode(), ErrorCode::InvalidArgument);
+}
+
+// Test: 第二次捕获只写入改动过的页，两个快照都能读回各自的内容
+TEST_F(SnapshotStoreTest, IncrementalCaptureReusesPages) {
+    startChild();
+    auto store = SnapshotStore::open(directory_, kPageSize);
+    ASSERT_TRUE(store.isSuccess()) << store.errorMessage();
+    
+    SnapshotWriterConfig config;
+    config.store = &store.value();
+    SnapshotWriter writer(config);
+    
+    auto first = writer.capture(child_, {mapping_.region()}, path("first.snap"));
+    ASSERT_TRUE(first.isSuccess()) << first.errorMessage();
+    EXPECT_EQ(first.value().storePagesWritten, kPages);
+    EXPECT_EQ(first.value().storePagesReused, 0u);
+    expectMatchesRegion(path("first.snap"));
+    std::vector<uint8_t> before(region_, region_ + kPages * kPageSize);
+    
+    touchChildPage(3);
+    touchChildPage(9);
+    auto second = writer.capture(child_, {mapping_.region()}, path("second.snap"));
+    ASSERT_TRUE(second.isSuccess()) << second.errorMessage();
+    EXPECT_EQ(second.value().storePagesWritten, 2u);
+    EXPECT_EQ(second.value().storePagesReused, kPages - 2);
+    EXPECT_EQ(store.value().pageCount(), kPages + 2);
+    expectMatchesRegion(path("second.snap"));
+    
+    // 旧快照引用的页没有被覆盖
+    auto old = SnapshotReader::open(path("first.snap"));
+    ASSERT_TRUE(old.isSuccess()) << old.errorMessage();
+    std::vector<uint8_t> buffer(kPages * kPageSize);
+    auto copied = old.value().read(mapping_.region().start, buffer.data(), buffer.size());
+    ASSERT_TRUE(copied.isSuccess());
+    EXPECT_EQ(buffer, before);
+}
+
+// Test: 扫描引用页存储的快照，结果与扫描原进程一致
+TEST_F(SnapshotStoreTest, ScanStoreBackedSnapshot) {
+    static const uint8_t marker[] = {0x5A, 0xC3, 0x17, 0xE9, 0x42, 0x8B, 0x6D, 0x01};
+    std::memcpy(region_ + 6 * kPageSize - 3, marker, sizeof(marker));
+    startChild();
+    
+    auto store = SnapshotStore::open(directory_, kPageSize);
+    ASSERT_TRUE(store.isSuccess()) << store.errorMessage();
+    SnapshotWriterConfig config;
+    config.store = &store.value();
+    SnapshotWriter writer(config);
+    auto stats = writer.capture(child_, {mapping_.region()}, path("scan.snap"));
+    ASSERT_TRUE(stats.isSuccess()) << stats.errorMessage();
+    
+    auto snapshot = SnapshotReader::open(path("scan.snap"));
+    ASSERT_TRUE(snapshot.isSuccess()) << snapshot.errorMessage();
+    SignaturePattern pattern;
+    pattern.bytes.assign(marker, marker + sizeof(marker));
+    pattern.mask.assign(pattern.bytes.size(), true);
+    pattern.alignment = 1;
+    ProcessScanConfig scanConfig;
+    scanConfig.chunkSize = kPageSize;
+    auto result = SignatureScanner::scanSnapshot(snapshot.value(), {pattern}, RegionFilter(), scanConfig);
+    ASSERT_TRUE(result.isSuccess()) << result.errorMessage();
+    ASSERT_EQ(result.value().matches.size(), 1u);
+    EXPECT_EQ(result.value().matches[0].address, mapping_.region().start + 6 * kPageSize - 3);
+}
+
+// Test: 以跟踪 soft-dirty 的快照为 base 增量捕获，只读取写过的页；内核不支持时退回完整读取
+TEST_F(SnapshotStoreTest, IncrementalCaptureFromBase) {
+    startChild();
+    auto store = SnapshotStore::open(directory_, kPageSize);
+    ASSERT_TRUE(store.isSuccess()) << store.errorMessage();
+    
+    SnapshotWriterConfig config;
+    config.store = &store.value();
+    config.trackDirtyPages = true;
+    auto first = SnapshotWriter(config).capture(child_, {mapping_.region()}, path("first.snap"));
+    ASSERT_TRUE(first.isSuccess()) << first.errorMessage();
+    auto base = SnapshotReader::open(path("first.snap"));
+    ASSERT_TRUE(base.isSuccess()) << base.errorMessage();
+    bool supported = ProcessManager::softDirtySupported();
+    EXPECT_EQ(base.value().info().dirtyTracked, supported);
+    
+    touchChildPage(3);
+    touchChildPage(9);
+    config.base = &base.value();
+    auto second = SnapshotWriter(config).capture(child_, {mapping_.region()}, path("second.snap"));
+    ASSERT_TRUE(second.isSuccess()) << second.errorMessage();
+    if (supported) {
+        EXPECT_EQ(second.value().bytesUnchanged, (kPages - 2) * kPageSize);
+        EXPECT_EQ(second.value().bytesCaptured, 2 * kPageSize);
+    } else {
+        EXPECT_EQ(second.value().bytesUnchanged, 0u);
+        EXPECT_EQ(second.value().bytesCaptured, kPages * kPageSize);
+    }
+    EXPECT_EQ(second.value().storePagesWritten, 2u);
+    expectMatchesRegion(path("second.snap"));
+}
+
+// Test: 以不是最后一次清除 soft-dirty 的快照为 base 时退回完整读取，结果与进程一致
+TEST_F(SnapshotStoreTest, IncrementalCaptureFromStaleBaseReadsEverything) {
+    startChild();
+    auto store = SnapshotStore::open(directory_, kPageSize);
+    ASSERT_TRUE(store.isSuccess()) << store.errorMessage();
+    
+    SnapshotWriterConfig config;
+    config.store = &store.value();
+    config.trackDirtyPages = true;
+    auto first = SnapshotWriter(config).capture(child_, {mapping_.region()}, path("a.snap"));
+    ASSERT_TRUE(first.isSuccess()) << first.errorMessage();
+    auto a = SnapshotReader::open(path("a.snap"));
+    ASSERT_TRUE(a.isSuccess()) << a.errorMessage();
+    
+    // B 清除了 soft-dirty，第 5 页在 A 之后被写过，但 B 之后没有再写
+    touchChildPage(5);
+    auto second = SnapshotWriter(config).capture(child_, {mapping_.region()}, path("b.snap"));
+    ASSERT_TRUE(second.isSuccess()) << second.errorMessage();
+    auto b = SnapshotReader::open(path("b.snap"));
+    ASSERT_TRUE(b.isSuccess()) << b.errorMessage();
+    if (ProcessManager::softDirtySupported()) {
+        EXPECT_NE(a.value().info().dirtyGeneration, 0u);
+        EXPECT_NE(b.value().info().dirtyGeneration, a.value().info().dirtyGeneration);
+        EXPECT_EQ(store.value().dirtyGeneration(child_), b.value().info().dirtyGeneration);
+    }
+    
+    config.base = &a.value();
+    auto third = SnapshotWriter(config).capture(child_, {mapping_.region()}, path("c.snap"));
+    ASSERT_TRUE(third.isSuccess()) << third.errorMessage();
+    EXPECT_EQ(third.value().bytesUnchanged, 0u);
+    EXPECT_EQ(third.value().bytesCaptured, kPages * kPageSize);
+    expectMatchesRegion(path("c.snap"));
+}
+
+// Test: 登记的 soft-dirty 代号在重新打开存储后保留，并且不会重复
+TEST_F(SnapshotStoreTest, DirtyGenerationPersists) {
+    uint64_t first = 0;
+    uint64_t second = 0;
+    {
+        auto store = SnapshotStore::open(directory_, kPageSize);
+        ASSERT_TRUE(store.isSuccess()) << store.errorMessage();
+        EXPECT_EQ(store.value().dirtyGeneration(100), 0u);
+        auto generation = store.value().beginDirtyGeneration(100);
+        ASSERT_TRUE(generation.isSuccess()) << generation.errorMessage();
+        first = generation.value();
+        generation = store.value().beginDirtyGeneration(200);
+        ASSERT_TRUE(generation.isSuccess()) << generation.errorMessage();
+        second = generation.value();
+        EXPECT_GT(first, 0u);
+        EXPECT_GT(second, first);
+    }
+    
+    auto store = SnapshotStore::open(directory_, kPageSize);
+    ASSERT_TRUE(store.isSuccess()) << store.errorMessage();
+    EXPECT_EQ(store.value().dirtyGeneration(100), first);
+    EXPECT_EQ(store.value().dirtyGeneration(200), second);
+    auto generation = store.value().beginDirtyGeneration(100);
+    ASSERT_TRUE(generation.isSuccess()) << generation.errorMessage();
+    EXPECT_GT(generation.value(), second);
+    EXPECT_EQ(store.value().dirtyGeneration(100), generation.value());
+}
+
+// Test: base 与页存储或进程不匹配时拒绝增量捕获
+TEST_F(SnapshotStoreTest, IncrementalCaptureRejectsMismatchedBase) {
+    startChild();
+    auto store = SnapshotStore::open(directory_, kPageSize);
+    ASSERT_TRUE(store.isSuccess()) << store.errorMessage();
+    SnapshotWriterConfig config;
+    config.store = &store.value();
+    auto first = SnapshotWriter(config).capture(child_, {mapping_.region()}, path("first.snap"));
+    ASSERT_TRUE(first.isSuccess()) << first.errorMessage();
+    auto base = SnapshotReader::open(path("first.snap"));
+    ASSERT_TRUE(base.isSuccess()) << base.errorMessage();
+    
+    SnapshotWriterConfig noStore;
+    noStore.base = &base.value();
+    auto result = SnapshotWriter(noStore).capture(child_, {mapping_.region()}, path("second.snap"));
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(result.errorCode(), ErrorCode::InvalidArgument);
+    
+    config.base = &base.value();
+    result = SnapshotWriter(config).capture(getpid(), {mapping_.region()}, path("second.snap"));
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(result.errorCode(), ErrorCode::InvalidArgument);
+    
+    // 不登记代号就清除 soft-dirty 会使已有的增量链失效
+    SnapshotWriterConfig trackWithoutStore;
+    trackWithoutStore.trackDirtyPages = true;
+    result = SnapshotWriter(trackWithoutStore).capture(child_, {mapping_.region()}, path("second.snap"));
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(result.errorCode(), ErrorCode::InvalidArgument);
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "stealth_verifier.h"
 #include <unistd.h>
+#include <fcntl.h>
 
 using namespace ukc;
 
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include "trace_recorder.h"
+#include "userspace_kernel_call.h"
+#include "probes.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+using namespace ukc;
+
+class TraceRecorderTest : public ::testing::Test {
+protected:
+    static size_t countOccurrences(const std::string& text, const std::string& needle) {
+        size_t count = 0;
+        for (size_t pos = text.find(needle); pos != std::string::npos;
+             pos = text.find(needle, pos + 1)) {
+            count++;
+        }
+        return count;
+    }
+};
+
+// Test: 未启用时不记录
+TEST_F(TraceRecorderTest, DisabledByDefault) {
+    TraceRecorder recorder;
+    EXPECT_FALSE(recorder.isEnabled());
+    recorder.begin("ignored");
+    {
+        TraceRecorder::Scope scope(recorder, "ignored_scope");
+    }
+    EXPECT_TRUE(recorder.collect().empty());
+}
+
+// Test: 记录 B/E 事件并按时间排序
+TEST_F(TraceRecorderTest, RecordsScopes) {
+    TraceRecorder recorder;
+    recorder.enable();
+    {
+        TraceRecorder::Scope outer(recorder, "outer", 42);
+        TraceRecorder::Scope inner(recorder, "inner");
+        recorder.instant("marker");
+    }
+
+    auto threads = recorder.collect();
+    ASSERT_EQ(threads.size(), 1u);
+    const auto& events = threads[0].events;
+    ASSERT_EQ(events.size(), 5u);
+    EXPECT_STREQ(events[0].name, "outer");
+    EXPECT_EQ(events[0].phase, TracePhase::Begin);
+    EXPECT_EQ(events[0].arg, 42u);
+    EXPECT_STREQ(events[2].name, "marker");
+    EXPECT_EQ(events[2].phase, TracePhase::Instant);
+    EXPECT_STREQ(events[3].name, "inner");
+    EXPECT_EQ(events[3].phase, TracePhase::End);
+    EXPECT_EQ(events[4].phase, TracePhase::End);
+    for (size_t i = 1; i < events.size(); ++i) {
+        EXPECT_LE(events[i - 1].timestampNs, events[i].timestampNs);
+    }
+}
+
+// Test: 环形缓冲区覆盖最旧的事件
+TEST_F(TraceRecorderTest, RingBufferWraps) {
+    TraceRecorder recorder(8);
+    recorder.enable();
+    for (uint64_t i = 0; i < 20; ++i) {
+        recorder.instant("tick", i + 1);
+    }
+
+    auto threads = recorder.collect();
+    ASSERT_EQ(threads.size(), 1u);
+    ASSERT_EQ(threads[0].events.size(), 8u);
+    EXPECT_EQ(threads[0].events.front().arg, 13u);
+    EXPECT_EQ(threads[0].events.back().arg, 20u);
+    EXPECT_EQ(recorder.droppedEvents(), 12u);
+
+    recorder.clear();
+    EXPECT_TRUE(recorder.collect().empty());
+    EXPECT_EQ(recorder.droppedEvents(), 0u);
+}
+
+// Test: 每个线程独立的缓冲区
+TEST_F(TraceRecorderTest, PerThreadBuffers) {
+    TraceRecorder recorder;
+    recorder.enable();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 100; ++i) {
+                TraceRecorder::Scope scope(recorder, "work");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto collected = recorder.collect();
+    ASSERT_EQ(collected.size(), 4u);
+    for (const auto& thread : collected) {
+        EXPECT_EQ(thread.events.size(), 200u);
+        EXPECT_NE(thread.threadId, 0);
+    }
+}
+
+// Test: 导出 Chrome trace-event JSON
+TEST_F(TraceRecorderTest, ChromeJson) {
+    TraceRecorder recorder;
+    recorder.enable();
+    {
+        TraceRecorder::Scope scope(recorder, "quoted \"name\"", 7);
+    }
+
+    std::string json = recorder.toChromeJson();
+    EXPECT_EQ(json.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["), 0u);
+    EXPECT_NE(json.find("\"name\":\"quoted \\\"name\\\"\",\"ph\":\"B\""), std::string::npos);
+    EXPECT_NE(json.find("\"pid\":" + std::to_string(getpid())), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"value\":7}"), std::string::npos);
+    EXPECT_EQ(countOccurrences(json, "\"ph\":\"E\""), 1u);
+
+    std::string path = "/tmp/ukc_trace_test_" + std::to_string(getpid()) + ".json";
+    ASSERT_TRUE(recorder.writeChromeJson(path).isSuccess());
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    EXPECT_EQ(contents.str(), json);
+    std::remove(path.c_str());
+
+    EXPECT_TRUE(recorder.writeChromeJson("/nonexistent/dir/trace.json").isError());
+}
+
+// Test: 追踪库内置阶段
+TEST_F(TraceRecorderTest, LibraryStagesTraced) {
+    if (!probes::enabled()) {
+        GTEST_SKIP() << "Probes disabled at compile time";
+    }
+
+    UserspaceKernelCall ukc;
+    TraceRecorder& recorder = ukc.getTraceRecorder();
+    recorder.clear();
+    recorder.enable();
+    ASSERT_TRUE(ukc.initialize().isSuccess());
+    ASSERT_TRUE(ukc.warmup(Subsystem::Locator).get().isSuccess());
+    ASSERT_TRUE(ukc.getProcessMemoryMaps(getpid()).isSuccess());
+    recorder.disable();
+
+    std::string json = recorder.toChromeJson();
+    EXPECT_NE(json.find("\"name\":\"ukc.initialize\",\"ph\":\"B\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"ukc.initialize.locator\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"kallsyms_parse\""), std::string::npos);
+    EXPECT_EQ(countOccurrences(json, "\"name\":\"maps_parse\""), 2u);
+    recorder.clear();
+}
@@ -2,6 +2,11 @@
 #include "userspace_kernel_call.h"
 #include <unistd.h>
 #include <memory>
+#include <fstream>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include <vector>
 
 using namespace ukc;
 
@@ -177,3 +182,202 @@ TEST_F(UserspaceKernelCallIntegrationTest, MultipleInitialize) {
     auto result2 = ukc_system_->initialize();
     ASSERT_TRUE(result2.isSuccess());
 }
+
+// Test: 并发的异步读取经合并器成批执行，结果各自返回
+TEST_F(UserspaceKernelCallIntegrationTest, ReadMemoryAsync) {
+    auto notReady = ukc_system_->readMemoryAsync(getpid(), 0x1000, 8).get();
+    EXPECT_TRUE(notReady.isError());
+    
+    auto initResult = ukc_system_->initialize();
+    ASSERT_TRUE(initResult.isSuccess());
+    
+    std::vector<uint64_t> values(64);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = 0xA5A5000000000000ULL + i;
+    }
+    
+    std::vector<std::future<Result<std::vector<uint8_t>>>> futures;
+    for (const auto& value : values) {
+        futures.push_back(ukc_system_->readMemoryAsync(
+            getpid(), reinterpret_cast<uintptr_t>(&value), sizeof(value)
+        ));
+    }
+    auto invalid = ukc_system_->readMemoryAsync(getpid(), 0x1000, 8);
+    
+    for (size_t i = 0; i < futures.size(); ++i) {
+        auto result = futures[i].get();
+        ASSERT_TRUE(result.isSuccess()) << result.errorMessage();
+        ASSERT_EQ(result.value().size(), sizeof(uint64_t));
+        uint64_t readValue = 0;
+        std::memcpy(&readValue, result.value().data(), sizeof(readValue));
+        EXPECT_EQ(readValue, values[i]);
+    }
+    auto invalidResult = invalid.get();
+    ASSERT_TRUE(invalidResult.isError());
+    EXPECT_EQ(invalidResult.errorCode(), ErrorCode::InvalidAddress);
+    
+    auto stats = ukc_system_->getReadCoalescerStats();
+    EXPECT_EQ(stats.requests, values.size() + 1);
+    EXPECT_LE(stats.batches, stats.requests);
+    EXPECT_GE(stats.maxBatchSize, 1u);
+}
+
+// Test: 同步读取与异步读取对同一地址返回相同的真实数据
+TEST_F(UserspaceKernelCallIntegrationTest, SyncAndAsyncReadsAgree) {
+    auto initResult = ukc_system_->initialize();
+    ASSERT_TRUE(initResult.isSuccess());
+    
+    static const uint64_t value = 0x0123456789ABCDEFULL;
+    uintptr_t address = reinterpret_cast<uintptr_t>(&value);
+    
+    auto syncResult = ukc_system_->readMemory(getpid(), address, sizeof(value));
+    ASSERT_TRUE(syncResult.isSuccess()) << syncResult.errorMessage();
+    auto asyncResult = ukc_system_->readMemoryAsync(getpid(), address, sizeof(value)).get();
+    ASSERT_TRUE(asyncResult.isSuccess()) << asyncResult.errorMessage();
+    EXPECT_EQ(syncResult.value(), asyncResult.value());
+    
+    auto typed = ukc_system_->read<uint64_t>(getpid(), address);
+    ASSERT_TRUE(typed.isSuccess()) << typed.errorMessage();
+    EXPECT_EQ(typed.value(), value);
+    
+    std::vector<BatchReadRequest> requests(1);
+    requests[0].address = address;
+    requests[0].size = sizeof(value);
+    std::vector<BatchReadResult> results;
+    BatchArena arena;
+    auto batch = ukc_system_->batchRead(getpid(), requests, results, arena);
+    ASSERT_TRUE(batch.isSuccess()) << batch.errorMessage();
+    ASSERT_EQ(batch.value(), 1u);
+    ASSERT_EQ(results[0].size, sizeof(value));
+    EXPECT_EQ(std::memcmp(results[0].data, &value, sizeof(value)), 0);
+}
+
+// Test: 异步扫描与同步扫描结果一致
+TEST_F(UserspaceKernelCallIntegrationTest, ScanAsync) {
+    auto initResult = ukc_system_->initialize();
+    ASSERT_TRUE(initResult.isSuccess());
+    
+    static const uint8_t marker[] = {0x5A, 0xC3, 0x17, 0xE9, 0x42, 0x8B, 0x6D, 0x01};
+    SignaturePattern pattern;
+    pattern.bytes.assign(marker, marker + sizeof(marker));
+    pattern.mask.assign(sizeof(marker), true);
+    pattern.alignment = 1;
+    RegionFilter filter;
+    filter.permissions = "r??";
+    
+    auto future = ukc_system_->scanAsync(getpid(), {pattern}, filter);
+    auto result = future.get();
+    ASSERT_TRUE(result.isSuccess()) << result.errorMessage();
+    
+    bool found = false;
+    for (const auto& match : result.value().matches) {
+        found = found || match.address == reinterpret_cast<uintptr_t>(marker);
+    }
+    EXPECT_TRUE(found);
+}
+
+// Test: 初始化不加载任何子系统，各子系统在第一次使用时初始化
+TEST_F(UserspaceKernelCallIntegrationTest, LazySubsystemInitialization) {
+    auto initResult = ukc_system_->initialize();
+    ASSERT_TRUE(initResult.isSuccess());
+    EXPECT_EQ(ukc_system_->readySubsystems(), Subsystem::None);
+    
+    // 读取 maps 不需要任何子系统
+    ASSERT_TRUE(ukc_system_->getProcessMemoryMaps(getpid()).isSuccess());
+    EXPECT_EQ(ukc_system_->readySubsystems(), Subsystem::None);
+    EXPECT_TRUE(ukc_system_->getExecutorStats().empty());
+    
+    // 读写内存只初始化注入器（和它使用的执行器），不解析 kallsyms
+    static const uint32_t value = 0x1234ABCD;
+    auto readResult = ukc_system_->readMemory(
+        getpid(), reinterpret_cast<uintptr_t>(&value), sizeof(value));
+    ASSERT_TRUE(readResult.isSuccess()) << readResult.errorMessage();
+    EXPECT_EQ(ukc_system_->readySubsystems(), Subsystem::Executor | Subsystem::Injector);
+    
+    // 写入路径还需要调用器，第一次写入时执行其中的权限检查
+    uint32_t target = 0;
+    std::vector<uint8_t> data(sizeof(target), 0x5A);
+    auto writeResult = ukc_system_->writeMemory(getpid(), reinterpret_cast<uintptr_t>(&target), data);
+    Subsystem ready = ukc_system_->readySubsystems();
+    if (geteuid() == 0) {
+        EXPECT_NE(ready & Subsystem::Caller, Subsystem::None);
+    } else {
+        ASSERT_TRUE(writeResult.isError());
+        EXPECT_EQ(ready & Subsystem::Caller, Subsystem::None);
+    }
+    EXPECT_EQ(ready & Subsystem::Locator, Subsystem::None);
+}
+
+// Test: warmup 在后台初始化指定的子系统
+TEST_F(UserspaceKernelCallIntegrationTest, WarmupSubsystems) {
+    auto notInitialized = ukc_system_->warmup(Subsystem::Locator).get();
+    EXPECT_TRUE(notInitialized.isError());
+    
+    ASSERT_TRUE(ukc_system_->initialize().isSuccess());
+    auto result = ukc_system_->warmup(Subsystem::Locator).get();
+    ASSERT_TRUE(result.isSuccess()) << result.errorMessage();
+    
+    Subsystem ready = ukc_system_->readySubsystems();
+    EXPECT_NE(ready & Subsystem::Locator, Subsystem::None);
+    EXPECT_NE(ready & Subsystem::Executor, Subsystem::None);
+    EXPECT_EQ(ready & Subsystem::Caller, Subsystem::None);
+    
+    // 重复预热直接返回缓存的结果
+    EXPECT_TRUE(ukc_system_->warmup(Subsystem::Locator).get().isSuccess());
+}
+
+// Test: 预热定位器期间并发提交异步定位，不会因 kallsyms 解析的 parallelFor 重入而死锁
+TEST_F(UserspaceKernelCallIntegrationTest, LocateFunctionsAsyncDuringWarmup) {
+    ExecutorConfig config;
+    config.threadCount = 2;
+    UserspaceKernelCall system(config);
+    ASSERT_TRUE(system.initialize().isSuccess());
+    
+    auto warmup = system.warmup(Subsystem::Locator);
+    std::vector<std::future<Result<std::vector<KernelFunctionInfo>>>> locates;
+    for (int i = 0; i < 2000; ++i) {
+        locates.push_back(system.locateFunctionsAsync({}));
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+    }
+    
+    ASSERT_EQ(warmup.wait_for(std::chrono::seconds(30)), std::future_status::ready);
+    auto warmupResult = warmup.get();
+    ASSERT_TRUE(warmupResult.isSuccess()) << warmupResult.errorMessage();
+    for (auto& locate : locates) {
+        ASSERT_EQ(locate.wait_for(std::chrono::seconds(30)), std::future_status::ready);
+        EXPECT_TRUE(locate.get().isSuccess());
+    }
+}
+
+// Test: 同步扫描经共享执行器并行执行
+TEST_F(UserspaceKernelCallIntegrationTest, ScanUsesSharedExecutor) {
+    EXPECT_TRUE(ukc_system_->getExecutorStats().empty());
+    auto initResult = ukc_system_->initialize();
+    ASSERT_TRUE(initResult.isSuccess());
+    
+    SignaturePattern pattern;
+    pattern.bytes = {0x7F, 0x45, 0x4C, 0x46};
+    pattern.mask.assign(4, true);
+    auto result = ukc_system_->scanProcess(getpid(), {pattern});
+    ASSERT_TRUE(result.isSuccess()) << result.errorMessage();
+    
+    auto stats = ukc_system_->getExecutorStats();
+    ASSERT_EQ(stats.size(), static_cast<size_t>(ExecutorStage::Count));
+    EXPECT_GE(stats[static_cast<size_t>(ExecutorStage::Scan)].tasks, 1u);
+}
+
+// Test: 异步定位内核函数，找不到的函数单独标记
+TEST_F(UserspaceKernelCallIntegrationTest, LocateFunctionsAsync) {
+    auto initResult = ukc_system_->initialize();
+    ASSERT_TRUE(initResult.isSuccess());
+    
+    KernelFunctionInfo missing;
+    missing.name = "ukc_no_such_function";
+    missing.pattern = SignaturePattern::fromHexString("FF 43 00 D1");
+    
+    auto result = ukc_system_->locateFunctionsAsync({missing}).get();
+    ASSERT_TRUE(result.isSuccess());
+    ASSERT_EQ(result.value().size(), 1u);
+    EXPECT_EQ(result.value()[0].name, missing.name);
+    EXPECT_FALSE(result.value()[0].isLocated);
+}